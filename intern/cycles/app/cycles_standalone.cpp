@@ -407,6 +407,7 @@ static void options_parse(const int argc, const char **argv)
   bool profile = false;
   bool version = false;
   string log_level;
+  int checkpoint_interval = 300;
 
   ap.usage("cycles [options] file.xml");
   ap.arg("filename").hidden().action([&](auto argv) { options.filepath = argv[0]; });
@@ -439,6 +440,12 @@ static void options_parse(const int argc, const char **argv)
   ap.arg("--tile-size %d:TILE_SIZE").help("Tile size in pixels").action([&](auto argv) {
     parse_int(argv, &options.session_params.tile_size);
   });
+  ap.arg("--checkpoint %s:FILEPATH")
+      .help("File to save render progress to, and to resume rendering from")
+      .action([&](auto argv) { parse_string(argv, &options.session_params.checkpoint_filepath); });
+  ap.arg("--checkpoint-interval %d:SECONDS")
+      .help("Interval in seconds between writing checkpoints (default 300)")
+      .action([&](auto argv) { parse_int(argv, &checkpoint_interval); });
   ap.arg("--list-devices", &list).help("List information about all available devices");
   ap.arg("--profile", &profile).help("Enable profile logging");
   ap.arg("--log-level %s:LEVEL")
@@ -496,6 +503,10 @@ static void options_parse(const int argc, const char **argv)
     options.session_params.use_auto_tile = true;
   }
 
+  if (!options.session_params.checkpoint_filepath.empty()) {
+    options.session_params.checkpoint_interval = max(checkpoint_interval, 1);
+  }
+
   /* find matching device */
   const DeviceType device_type = Device::type_from_string(devicename.c_str());
   vector<DeviceInfo> devices = Device::available_devices(DEVICE_MASK(device_type));
@@ -1068,6 +1068,27 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         min=8, max=8192,
     )
 
+    use_checkpoint: BoolProperty(
+        name="Use Checkpoints",
+        description="Periodically save the render progress to disk, and resume rendering from it when "
+        "the render of the frame is restarted after it was interrupted. Not supported with tiled rendering",
+        default=False,
+    )
+    checkpoint_interval: FloatProperty(
+        name="Checkpoint Interval",
+        description="Time between saving render progress to disk",
+        min=1.0,
+        default=300.0,
+        step=100.0,
+        unit='TIME_ABSOLUTE',
+    )
+    checkpoint_directory: StringProperty(
+        name="Checkpoint Directory",
+        description="Directory to save render progress to",
+        subtype='DIR_PATH',
+        default="//checkpoints/",
+    )
+
     # Various fine-tuning debug flags
 
     def _devices_update_callback(self, context):
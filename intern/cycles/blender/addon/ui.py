@@ -864,6 +864,13 @@ class CYCLES_RENDER_PT_performance_memory(CyclesButtonsPanel, Panel):
         sub.active = cscene.use_auto_tile
         sub.prop(cscene, "tile_size")
 
+        col = layout.column()
+        col.prop(cscene, "use_checkpoint")
+        sub = col.column()
+        sub.active = cscene.use_checkpoint
+        sub.prop(cscene, "checkpoint_interval", text="Interval")
+        sub.prop(cscene, "checkpoint_directory", text="Directory")
+
 
 class CYCLES_RENDER_PT_performance_acceleration_structure(CyclesButtonsPanel, Panel):
     bl_label = "Acceleration Structure"
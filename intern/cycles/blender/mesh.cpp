@@ -905,6 +905,13 @@ void BlenderSync::sync_mesh(BObjectInfo &b_ob_info, Mesh *mesh)
 
   mesh->clear_non_sockets();
 
+  /* Track which vertices were deformed, so that the BVH refit can skip unmodified parts. */
+  if (mesh->get_subdivision_type() == Mesh::SUBDIVISION_NONE &&
+      new_mesh.get_subdivision_type() == Mesh::SUBDIVISION_NONE)
+  {
+    mesh->update_verts_modified_range(new_mesh.get_verts());
+  }
+
   for (const SocketType &socket : new_mesh.type->inputs) {
     /* Those sockets are updated in sync_object, so do not modify them. */
     if (socket.name == "use_motion_blur" || socket.name == "used_shaders") {
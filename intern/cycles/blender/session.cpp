@@ -347,6 +347,19 @@ void BlenderSession::render(BL::Depsgraph &b_depsgraph_)
   BufferParams buffer_params = BlenderSync::get_buffer_params(
       b_v3d, b_rv3d, scene->camera, width, height);
 
+  /* Checkpoint file is unique for the scene, frame, view layer and view. Construct the common
+   * part of its path now, since the Blender scene might be freed during synchronization. */
+  string checkpoint_filepath_prefix;
+  if (session_params.checkpoint_interval > 0.0) {
+    PointerRNA cscene = RNA_pointer_get(&b_scene.ptr, "cycles");
+    BL::ID b_scene_id(b_scene);
+    const string checkpoint_dir = blender_absolute_path(
+        b_data, b_scene_id, get_string(cscene, "checkpoint_directory"));
+    checkpoint_filepath_prefix = path_join(
+        checkpoint_dir,
+        string_printf("%s_%04d_", b_scene.name().c_str(), b_scene.frame_current()));
+  }
+
   /* temporary render result to find needed passes and views */
   BL::RenderResult b_rr = b_engine.begin_result(0, 0, 1, 1, b_view_layer.name().c_str(), nullptr);
   BL::RenderResult::layers_iterator b_single_rlay;
@@ -434,6 +447,12 @@ void BlenderSession::render(BL::Depsgraph &b_depsgraph_)
       effective_session_params.samples = samples;
     }
 
+    if (!checkpoint_filepath_prefix.empty()) {
+      effective_session_params.checkpoint_filepath = checkpoint_filepath_prefix +
+                                                     b_view_layer.name() + "_" + b_rview_name +
+                                                     ".exr";
+    }
+
     /* Update session itself. */
     session->reset(effective_session_params, buffer_params);
 
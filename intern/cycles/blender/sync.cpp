@@ -1014,6 +1014,12 @@ SessionParams BlenderSync::get_session_params(BL::RenderEngine &b_engine,
     params.use_auto_tile = false;
   }
 
+  /* Checkpoints. The file path is specific to the frame and the view layer and is set by the
+   * session. */
+  if (background && !b_engine.is_preview() && get_boolean(cscene, "use_checkpoint")) {
+    params.checkpoint_interval = (double)get_float(cscene, "checkpoint_interval");
+  }
+
   return params;
 }
 
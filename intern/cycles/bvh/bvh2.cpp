@@ -19,9 +19,14 @@
 #include "bvh/unaligned.h"
 
 #include "util/progress.h"
+#include "util/tbb.h"
 
 CCL_NAMESPACE_BEGIN
 
+/* Depth of the tree up to which child nodes are refit in parallel. Deeper subtrees are too small
+ * to amortize the overhead of the tasks. */
+static const int BVH_REFIT_PARALLEL_DEPTH = 8;
+
 BVHStackEntry::BVHStackEntry(const BVHNode *n, const int i) : node(n), idx(i) {}
 
 int BVHStackEntry::encodeIdx() const
@@ -299,7 +304,7 @@ void BVH2::refit_nodes()
   refit_node(0, (pack.root_index == -1) ? true : false, bbox, visibility);
 }
 
-void BVH2::refit_node(const int idx, bool leaf, BoundBox &bbox, uint &visibility)
+void BVH2::refit_node(const int idx, bool leaf, BoundBox &bbox, uint &visibility, const int depth)
 {
   if (leaf) {
     /* refit leaf node */
@@ -331,8 +336,15 @@ void BVH2::refit_node(const int idx, bool leaf, BoundBox &bbox, uint &visibility
     uint visibility0 = 0;
     uint visibility1 = 0;
 
-    refit_node((c0 < 0) ? -c0 - 1 : c0, (c0 < 0), bbox0, visibility0);
-    refit_node((c1 < 0) ? -c1 - 1 : c1, (c1 < 0), bbox1, visibility1);
+    if (depth < BVH_REFIT_PARALLEL_DEPTH) {
+      parallel_invoke(
+          [&] { refit_child(idx, 0, is_unaligned, bbox0, visibility0, depth + 1); },
+          [&] { refit_child(idx, 1, is_unaligned, bbox1, visibility1, depth + 1); });
+    }
+    else {
+      refit_child(idx, 0, is_unaligned, bbox0, visibility0, depth + 1);
+      refit_child(idx, 1, is_unaligned, bbox1, visibility1, depth + 1);
+    }
 
     if (is_unaligned) {
       const Transform aligned_space = transform_identity();
@@ -349,8 +361,57 @@ void BVH2::refit_node(const int idx, bool leaf, BoundBox &bbox, uint &visibility
   }
 }
 
+void BVH2::refit_child(const int idx,
+                       const int child,
+                       const bool is_unaligned,
+                       BoundBox &bbox,
+                       uint &visibility,
+                       const int depth)
+{
+  const int4 *data = &pack.nodes[idx];
+  const int c = (child == 0) ? data[0].z : data[0].w;
+
+  if (c < 0 && !is_unaligned && !refit_leaf_is_modified(-c - 1)) {
+    /* None of the primitives of the leaf moved, reuse the bounds stored in the parent. */
+    bbox.min = make_float3(__int_as_float(data[1][child]),
+                           __int_as_float(data[2][child]),
+                           __int_as_float(data[3][child]));
+    bbox.max = make_float3(__int_as_float(data[1][child + 2]),
+                           __int_as_float(data[2][child + 2]),
+                           __int_as_float(data[3][child + 2]));
+    visibility = pack.leaf_nodes[-c - 1].z;
+    return;
+  }
+
+  refit_node((c < 0) ? -c - 1 : c, (c < 0), bbox, visibility, depth);
+}
+
 /* Refitting */
 
+bool BVH2::refit_leaf_is_modified(const int idx) const
+{
+  const int4 *data = &pack.leaf_nodes[idx];
+  if (data[0].x < 0) {
+    /* Object instance. */
+    return true;
+  }
+
+  for (int prim = data[0].x; prim < data[0].y; prim++) {
+    const int pidx = pack.prim_index[prim];
+    if (pidx == -1 || pack.prim_type[prim] != PRIMITIVE_TRIANGLE) {
+      /* Only track modifications of static triangles, assume anything else moved. */
+      return true;
+    }
+
+    const Mesh *mesh = static_cast<const Mesh *>(objects[pack.prim_object[prim]]->get_geometry());
+    if (mesh->use_motion_blur || mesh->is_triangle_modified(pidx)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
 void BVH2::refit_primitives(const int start, const int end, BoundBox &bbox, uint &visibility)
 {
   /* Refit range of primitives. */
@@ -82,7 +82,14 @@ class BVH2 : public BVH {
 
   /* refit */
   void refit_nodes();
-  void refit_node(const int idx, bool leaf, BoundBox &bbox, uint &visibility);
+  void refit_node(const int idx, bool leaf, BoundBox &bbox, uint &visibility, const int depth = 0);
+  void refit_child(const int idx,
+                   const int child,
+                   const bool is_unaligned,
+                   BoundBox &bbox,
+                   uint &visibility,
+                   const int depth);
+  bool refit_leaf_is_modified(const int idx) const;
 
   /* Refit range of primitives. */
   void refit_primitives(const int start, const int end, BoundBox &bbox, uint &visibility);
@@ -377,6 +377,13 @@ void PathTrace::init_render_buffers(const RenderWork &render_work)
 
     tile_buffer_read();
   }
+
+  /* Continue accumulating samples on top of the checkpoint. */
+  if (checkpoint_resume_buffers_) {
+    DCHECK_EQ(render_work.resolution_divider, 1);
+    copy_from_render_buffers(checkpoint_resume_buffers_.get());
+    checkpoint_resume_buffers_.reset();
+  }
 }
 
 void PathTrace::path_trace(RenderWork &render_work)
@@ -1084,6 +1091,50 @@ void PathTrace::process_full_buffer_from_disk(string_view filename)
   full_frame_state_.render_buffers = nullptr;
 }
 
+bool PathTrace::write_checkpoint(const string &filepath)
+{
+  const int num_rendered_samples = render_scheduler_.get_num_rendered_samples();
+  if (num_rendered_samples == 0) {
+    return true;
+  }
+
+  /* Get access to the CPU-side render buffers of the current big tile. */
+  RenderBuffers *buffers;
+  RenderBuffers big_tile_cpu_buffers(cpu_device_.get());
+
+  if (path_trace_works_.size() == 1) {
+    path_trace_works_[0]->copy_render_buffers_from_device();
+    buffers = path_trace_works_[0]->get_render_buffers();
+  }
+  else {
+    big_tile_cpu_buffers.reset(render_state_.effective_big_tile_params);
+    copy_to_render_buffers(&big_tile_cpu_buffers);
+
+    buffers = &big_tile_cpu_buffers;
+  }
+
+  return tile_manager_.write_checkpoint(filepath, *buffers, num_rendered_samples);
+}
+
+int PathTrace::read_checkpoint(const string &filepath, const BufferParams &big_tile_params)
+{
+  unique_ptr<RenderBuffers> buffers = make_unique<RenderBuffers>(cpu_device_.get());
+
+  int num_samples = 0;
+  if (!tile_manager_.read_checkpoint(filepath, big_tile_params, buffers.get(), &num_samples)) {
+    return 0;
+  }
+
+  if (num_samples > render_scheduler_.get_num_samples()) {
+    LOG_WARNING << "Checkpoint has more samples than requested for the render, ignoring.";
+    return 0;
+  }
+
+  checkpoint_resume_buffers_ = std::move(buffers);
+
+  return num_samples;
+}
+
 int PathTrace::get_num_render_tile_samples() const
 {
   if (full_frame_state_.render_buffers) {
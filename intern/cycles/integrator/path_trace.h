@@ -140,6 +140,17 @@ class PathTrace {
    * via the write callback. */
   void process_full_buffer_from_disk(string_view filename);
 
+  /* Write render buffers of the current big tile to the checkpoint file.
+   * Returns true on success. */
+  bool write_checkpoint(const string &filepath);
+
+  /* Read render buffers of the big tile with the given parameters from the checkpoint file. The
+   * buffers are copied to the path trace works at the beginning of the next render work.
+   *
+   * Returns the number of samples stored in the checkpoint, or 0 if the checkpoint can not be used
+   * for the big tile. */
+  int read_checkpoint(const string &filepath, const BufferParams &big_tile_params);
+
   /* Get number of samples in the current big tile render buffers. */
   int get_num_render_tile_samples() const;
 
@@ -356,6 +367,9 @@ class PathTrace {
   struct {
     RenderBuffers *render_buffers = nullptr;
   } full_frame_state_;
+
+  /* Render buffers read from the checkpoint which are yet to be copied to the path trace works. */
+  unique_ptr<RenderBuffers> checkpoint_resume_buffers_;
 };
 
 CCL_NAMESPACE_END
@@ -171,6 +171,14 @@ void RenderScheduler::reset(const BufferParams &buffer_params)
   rebalance_time_.reset();
 }
 
+void RenderScheduler::resume(const int num_samples)
+{
+  DCHECK_EQ(state_.num_rendered_samples, 0);
+  DCHECK_EQ(state_.resolution_divider, pixel_size_);
+
+  state_.num_rendered_samples = num_samples;
+}
+
 void RenderScheduler::reset_for_next_tile()
 {
   reset(buffer_params_);
@@ -164,6 +164,11 @@ class RenderScheduler {
    * Resets current rendered state, as well as scheduling information. */
   void reset(const BufferParams &buffer_params);
 
+  /* Continue rendering on top of render buffers which already have the given number of samples
+   * accumulated in them, for example when they were read from a checkpoint.
+   * Is to be called after `reset()`, before any work is scheduled. */
+  void resume(const int num_samples);
+
   /* Reset scheduler upon switching to a next tile.
    * Will keep the same number of samples and full-frame render parameters, but will reset progress
    * and allow schedule renders works from the beginning of the new tile. */
@@ -25,6 +25,7 @@ SHADER_NODE_TYPE(NODE_CONVERT)
 SHADER_NODE_TYPE(NODE_TEX_COORD)
 SHADER_NODE_TYPE(NODE_VALUE_F)
 SHADER_NODE_TYPE(NODE_VALUE_V)
+SHADER_NODE_TYPE(NODE_VALUE_F2)
 SHADER_NODE_TYPE(NODE_ATTR)
 SHADER_NODE_TYPE(NODE_VERTEX_COLOR)
 SHADER_NODE_TYPE(NODE_GEOMETRY_BUMP_DX)
@@ -17,6 +17,17 @@ ccl_device void svm_node_value_f(ccl_private float *stack,
   stack_store_float(stack, out_offset, __uint_as_float(ivalue));
 }
 
+/* Two fused NODE_VALUE_F, saving a dispatch of the interpreter loop. */
+ccl_device void svm_node_value_f2(ccl_private float *stack, const uint4 node)
+{
+  uint a_out_offset;
+  uint b_out_offset;
+  svm_unpack_node_uchar2(node.w, &a_out_offset, &b_out_offset);
+
+  stack_store_float(stack, a_out_offset, __uint_as_float(node.y));
+  stack_store_float(stack, b_out_offset, __uint_as_float(node.z));
+}
+
 ccl_device int svm_node_value_v(KernelGlobals kg,
                                 ccl_private float *stack,
                                 const uint out_offset,
@@ -765,6 +765,8 @@ void GeometryManager::device_update(Device *device,
   }
 
   size_t i = 0;
+  size_t num_subd_faces_split = 0;
+  size_t num_subd_faces_reused = 0;
   for (Geometry *geom : scene->geometry) {
     if (!(geom->is_modified() && geom->is_mesh())) {
       continue;
@@ -792,6 +794,9 @@ void GeometryManager::device_update(Device *device,
 
       mesh->tessellate(subd_params);
 
+      num_subd_faces_split += mesh->subd_split_cache->num_faces_split;
+      num_subd_faces_reused += mesh->subd_split_cache->num_faces_reused;
+
       i++;
     }
 
@@ -805,6 +810,11 @@ void GeometryManager::device_update(Device *device,
     }
   }
 
+  if (num_tessellation) {
+    LOG_INFO << "Tessellation: " << num_subd_faces_split << " faces split, "
+             << num_subd_faces_reused << " faces reused from previous tessellation.";
+  }
+
   if (progress.get_cancel()) {
     return;
   }
@@ -940,6 +950,7 @@ void GeometryManager::device_update(Device *device,
       }
     });
     TaskPool pool;
+    GeometryBVHStats bvh_stats;
 
     /* Work around Embree/oneAPI bug #129596 with BVH updates. */
     const bool use_multithreaded_build = first_bvh_build ||
@@ -958,12 +969,13 @@ void GeometryManager::device_update(Device *device,
         }
 
         if (use_multithreaded_build) {
-          pool.push([geom, device, dscene, scene, &progress, i, &num_bvh] {
-            geom->compute_bvh(device, dscene, &scene->params, &progress, i, num_bvh);
+          pool.push([geom, device, dscene, scene, &progress, i, &num_bvh, &bvh_stats] {
+            geom->compute_bvh(
+                device, dscene, &scene->params, &progress, i, num_bvh, &bvh_stats);
           });
         }
         else {
-          geom->compute_bvh(device, dscene, &scene->params, &progress, i, num_bvh);
+          geom->compute_bvh(device, dscene, &scene->params, &progress, i, num_bvh, &bvh_stats);
         }
       }
     }
@@ -971,6 +983,19 @@ void GeometryManager::device_update(Device *device,
     TaskPool::Summary summary;
     pool.wait_work(&summary);
     LOG_WORK << "Objects BVH build pool statistics:\n" << summary.full_report();
+
+    if (num_bvh) {
+      LOG_INFO << "Object BVHs: " << bvh_stats.num_built << " built in "
+               << bvh_stats.time_build << "s, " << bvh_stats.num_refitted << " refitted in "
+               << bvh_stats.time_refit << "s, " << bvh_stats.num_skipped << " unchanged.";
+    }
+
+    if (scene->update_stats) {
+      scene->update_stats->geometry.times.add_entry(
+          {"device_update (object BVHs build, accumulated)", bvh_stats.time_build});
+      scene->update_stats->geometry.times.add_entry(
+          {"device_update (object BVHs refit, accumulated)", bvh_stats.time_refit});
+    }
   }
 
   for (Shader *shader : scene->shaders) {
@@ -12,6 +12,7 @@
 
 #include "util/boundbox.h"
 #include "util/set.h"
+#include "util/thread.h"
 #include "util/transform.h"
 #include "util/types.h"
 #include "util/vector.h"
@@ -62,6 +63,19 @@ enum {
   DEVICE_CURVE_DATA_NEEDS_REALLOC = (CURVE_DATA_NEED_REALLOC | ATTRS_NEED_REALLOC),
 };
 
+/* Statistics of the object BVH updates of a single scene update. Updated from multiple
+ * threads, the times are accumulated over all of them. */
+struct GeometryBVHStats {
+  thread_mutex mutex;
+
+  int num_built = 0;
+  int num_refitted = 0;
+  int num_skipped = 0;
+
+  double time_build = 0.0;
+  double time_refit = 0.0;
+};
+
 /* Geometry
  *
  * Base class for geometric types like Mesh and Hair. */
@@ -144,7 +158,8 @@ class Geometry : public Node {
                    SceneParams *params,
                    Progress *progress,
                    const size_t n,
-                   size_t total);
+                   size_t total,
+                   GeometryBVHStats *stats = nullptr);
 
   virtual PrimitiveType primitive_type() const = 0;
 
@@ -159,6 +174,10 @@ class Geometry : public Node {
    */
   bool need_build_bvh(BVHLayout layout) const;
 
+  /* Check whether the BVH of the geometry depends on the data which was modified since the last
+   * BVH update, assuming the topology did not change. */
+  bool need_refit_bvh(BVHLayout layout) const;
+
   /* Test if the geometry should be treated as instanced. */
   bool is_instanced() const;
 
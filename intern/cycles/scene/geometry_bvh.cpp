@@ -20,6 +20,7 @@
 
 #include "util/log.h"
 #include "util/progress.h"
+#include "util/time.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -28,7 +29,8 @@ void Geometry::compute_bvh(Device *device,
                            SceneParams *params,
                            Progress *progress,
                            const size_t n,
-                           const size_t total)
+                           const size_t total,
+                           GeometryBVHStats *stats)
 {
   if (progress->get_cancel()) {
     return;
@@ -61,12 +63,28 @@ void Geometry::compute_bvh(Device *device,
     vector<Object *> objects;
     objects.push_back(&object);
 
-    if (bvh && !need_update_rebuild && params->bvh_type == BVH_TYPE_DYNAMIC) {
+    const bool can_refit = bvh && !need_update_rebuild && params->bvh_type == BVH_TYPE_DYNAMIC;
+    const double time_start = time_dt();
+
+    if (can_refit && !need_update_bvh_for_offset && !need_refit_bvh(bvh_layout)) {
+      /* Only data which the BVH does not depend on was modified, for example attributes. */
+      if (stats) {
+        const thread_scoped_lock lock(stats->mutex);
+        stats->num_skipped++;
+      }
+    }
+    else if (can_refit) {
       progress->set_status(msg, "Refitting BVH");
 
       bvh->replace_geometry(geometry, objects);
 
       device->build_bvh(bvh.get(), *progress, true);
+
+      if (stats) {
+        const thread_scoped_lock lock(stats->mutex);
+        stats->num_refitted++;
+        stats->time_refit += time_dt() - time_start;
+      }
     }
     else {
       progress->set_status(msg, "Building BVH");
@@ -85,11 +103,38 @@ void Geometry::compute_bvh(Device *device,
 
       bvh = BVH::create(bparams, geometry, objects, device);
       MEM_GUARDED_CALL(progress, device->build_bvh, bvh.get(), *progress, false);
+
+      if (stats) {
+        const thread_scoped_lock lock(stats->mutex);
+        stats->num_built++;
+        stats->time_build += time_dt() - time_start;
+      }
     }
   }
 
   need_update_rebuild = false;
   need_update_bvh_for_offset = false;
+
+  if (is_mesh() || is_volume()) {
+    static_cast<Mesh *>(this)->tag_verts_modified();
+  }
+}
+
+bool Geometry::need_refit_bvh(BVHLayout layout) const
+{
+  /* Skipping the refit relies on the BVH not referencing any device memory, which is only the
+   * case for the CPU layouts. */
+  if (layout != BVH_LAYOUT_BVH2 && layout != BVH_LAYOUT_EMBREE) {
+    return true;
+  }
+
+  if (!is_mesh() || has_true_displacement() || has_motion_blur()) {
+    return true;
+  }
+
+  const Mesh *mesh = static_cast<const Mesh *>(this);
+  return mesh->get_subdivision_type() != Mesh::SUBDIVISION_NONE ||
+         mesh->verts_modified_begin < mesh->verts_modified_end;
 }
 
 void GeometryManager::device_update_bvh(Device *device,
@@ -3,6 +3,7 @@
  * SPDX-License-Identifier: Apache-2.0 */
 
 #include <algorithm>
+#include <limits>
 
 #include "bvh/build.h"
 #include "bvh/bvh.h"
@@ -325,11 +326,15 @@ Mesh::Mesh(const NodeType *node_type, Type geom_type_)
   num_subd_added_verts = 0;
   num_subd_faces = 0;
 
+  tag_verts_modified();
+
   subdivision_type = SUBDIVISION_NONE;
 }
 
 Mesh::Mesh() : Mesh(get_node_type(), Geometry::MESH) {}
 
+Mesh::~Mesh() = default;
+
 void Mesh::resize_mesh(const int numverts, const int numtris)
 {
   verts.resize(numverts);
@@ -389,6 +394,8 @@ void Mesh::clear_non_sockets()
 
   num_subd_added_verts = 0;
   num_subd_faces = 0;
+
+  tag_verts_modified();
 }
 
 void Mesh::clear(bool preserve_shaders, bool preserve_voxel_data)
@@ -531,6 +538,36 @@ void Mesh::copy_center_to_motion_step(const int motion_step)
   }
 }
 
+void Mesh::update_verts_modified_range(const array<float3> &new_verts)
+{
+  const size_t num_verts = verts.size();
+  if (new_verts.size() != num_verts) {
+    tag_verts_modified();
+    return;
+  }
+
+  /* Deformation often only affects a part of the mesh, for example a face rig. Find the first
+   * and last vertex which differ, which is enough to skip most of the unmodified triangles. */
+  size_t begin = 0;
+  while (begin < num_verts && verts[begin] == new_verts[begin]) {
+    begin++;
+  }
+
+  size_t end = num_verts;
+  while (end > begin && verts[end - 1] == new_verts[end - 1]) {
+    end--;
+  }
+
+  verts_modified_begin = begin;
+  verts_modified_end = end;
+}
+
+void Mesh::tag_verts_modified()
+{
+  verts_modified_begin = 0;
+  verts_modified_end = std::numeric_limits<size_t>::max();
+}
+
 void Mesh::get_uv_tiles(ustring map, unordered_set<int> &tiles)
 {
   Attribute *attr;
@@ -603,6 +640,7 @@ void Mesh::compute_bounds()
 void Mesh::apply_transform(const Transform &tfm, const bool apply_to_motion)
 {
   transform_normal = transform_transposed_inverse(tfm);
+  tag_verts_modified();
 
   /* apply to mesh vertices */
   const size_t num_verts = verts.size();
@@ -25,6 +25,7 @@ class Attribute;
 class BVH;
 class Device;
 class DeviceScene;
+class DiagSplitCache;
 class Mesh;
 class Progress;
 class RenderStats;
@@ -170,6 +171,12 @@ class Mesh : public Geometry {
   /* BVH */
   size_t vert_offset;
 
+  /* Range of vertices which were modified since the last BVH update, used to skip refitting of
+   * unmodified parts of the BVH. Unless narrowed down by update_verts_modified_range(), all
+   * vertices are considered to be modified. */
+  size_t verts_modified_begin;
+  size_t verts_modified_end;
+
   size_t face_offset;
   size_t corner_offset;
 
@@ -187,9 +194,13 @@ class Mesh : public Geometry {
 
   unique_ptr<SubdParams> subd_params;
 
+  /* Edge factors of the previous tessellation, reused if the base mesh did not change. */
+  unique_ptr<DiagSplitCache> subd_split_cache;
+
  public:
   /* Functions */
   Mesh();
+  ~Mesh() override;
 
   void resize_mesh(const int numverts, const int numtris);
   void reserve_mesh(const int numverts, const int numtris);
@@ -207,6 +218,20 @@ class Mesh : public Geometry {
 
   void copy_center_to_motion_step(const int motion_step);
 
+  /* Narrow down range of modified vertices by comparing against the new vertex positions, before
+   * they are assigned to the mesh. */
+  void update_verts_modified_range(const array<float3> &new_verts);
+  void tag_verts_modified();
+  bool is_triangle_modified(const size_t tri) const
+  {
+    const size_t v0 = triangles[tri * 3 + 0];
+    const size_t v1 = triangles[tri * 3 + 1];
+    const size_t v2 = triangles[tri * 3 + 2];
+    return (v0 >= verts_modified_begin && v0 < verts_modified_end) ||
+           (v1 >= verts_modified_begin && v1 < verts_modified_end) ||
+           (v2 >= verts_modified_begin && v2 < verts_modified_end);
+  }
+
   void compute_bounds() override;
   void apply_transform(const Transform &tfm, const bool apply_to_motion) override;
   void add_vertex_normals();
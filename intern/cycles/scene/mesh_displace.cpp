@@ -145,6 +145,9 @@ bool GeometryManager::displace(Device *device, Scene *scene, Mesh *mesh, Progres
   /* Add undisplaced attributes right before doing displacement. */
   mesh->add_undisplaced(scene);
 
+  /* Displacement is applied to all vertices. */
+  mesh->tag_verts_modified();
+
   const size_t num_verts = mesh->verts.size();
   const size_t num_triangles = mesh->num_triangles();
 
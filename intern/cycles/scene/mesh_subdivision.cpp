@@ -20,6 +20,7 @@ void Mesh::tessellate(SubdParams &params)
   /* reset the number of subdivision vertices, in case the Mesh was not cleared
    * between calls or data updates */
   num_subd_added_verts = 0;
+  tag_verts_modified();
 
 #ifdef WITH_OPENSUBDIV
   OsdMesh osd_mesh(*this);
@@ -39,6 +40,12 @@ void Mesh::tessellate(SubdParams &params)
     subdivision_type = SUBDIVISION_LINEAR;
   }
 
+  /* Reuse edge factors of the previous tessellation if possible. */
+  if (!subd_split_cache) {
+    subd_split_cache = make_unique<DiagSplitCache>();
+  }
+  subd_split_cache->validate(params);
+
   /* count patches */
   const int num_faces = get_num_subd_faces();
   int num_patches = 0;
@@ -81,7 +88,7 @@ void Mesh::tessellate(SubdParams &params)
     }
 
     /* Split patches. */
-    DiagSplit split(params);
+    DiagSplit split(params, subd_split_cache.get());
     split.split_patches(osd_patches.data(), sizeof(OsdPatch));
 
     /* Setup interpolation. */
@@ -150,7 +157,7 @@ void Mesh::tessellate(SubdParams &params)
     }
 
     /* Split patches. */
-    DiagSplit split(params);
+    DiagSplit split(params, subd_split_cache.get());
     split.split_patches(linear_patches.data(), sizeof(LinearQuadPatch));
 
     /* Setup interpolation. */
@@ -165,6 +172,8 @@ void Mesh::tessellate(SubdParams &params)
     dice.dice(split);
   }
 
+  subd_split_cache->limit_memory();
+
   // TODO: Free subd base data? Or will this break interactive updates?
 }
 
@@ -159,6 +159,8 @@ SVMCompiler::SVMCompiler(Scene *scene) : scene(scene)
   mix_weight_offset = SVM_STACK_INVALID;
   bump_state_offset = SVM_STACK_INVALID;
   compile_failed = false;
+  value_f_fuse_index = -1;
+  num_fused_nodes = 0;
 
   /* This struct has one entry for every node, in order of ShaderNodeType definition. */
   svm_node_types_used = (std::atomic_int *)&scene->dscene.data.svm_usage;
@@ -254,12 +256,11 @@ int SVMCompiler::stack_assign(ShaderInput *input)
       input->stack_offset = stack_find_offset(input->type());
 
       if (input->type() == SocketType::FLOAT) {
-        add_node(NODE_VALUE_F,
-                 __float_as_int(node->get_float(input->socket_type)),
-                 input->stack_offset);
+        add_value_f_node(__float_as_int(node->get_float(input->socket_type)),
+                         input->stack_offset);
       }
       else if (input->type() == SocketType::INT) {
-        add_node(NODE_VALUE_F, node->get_int(input->socket_type), input->stack_offset);
+        add_value_f_node(node->get_int(input->socket_type), input->stack_offset);
       }
       else if (input->type() == SocketType::VECTOR || input->type() == SocketType::NORMAL ||
                input->type() == SocketType::POINT || input->type() == SocketType::COLOR)
@@ -404,6 +405,28 @@ void SVMCompiler::add_node(const float4 &f)
       __float_as_int(f.x), __float_as_int(f.y), __float_as_int(f.z), __float_as_int(f.w)));
 }
 
+void SVMCompiler::add_value_f_node(const int value, const int out_offset)
+{
+  if (value_f_fuse_index != -1 && value_f_fuse_index == int(current_svm_nodes.size()) - 1) {
+    int4 &node = current_svm_nodes[value_f_fuse_index];
+    assert(node.x == NODE_VALUE_F);
+
+    svm_node_types_used[NODE_VALUE_F2] = true;
+    node = make_int4(NODE_VALUE_F2, node.y, value, encode_uchar4(node.z, out_offset));
+
+    /* Keep fusing enabled, with an index that doesn't match the last node. */
+    value_f_fuse_index = current_svm_nodes.size();
+    num_fused_nodes++;
+    return;
+  }
+
+  add_node(NODE_VALUE_F, value, out_offset);
+
+  if (value_f_fuse_index != -1) {
+    value_f_fuse_index = current_svm_nodes.size() - 1;
+  }
+}
+
 uint SVMCompiler::attribute(ustring name)
 {
   return scene->shader_manager->get_attribute_id(name);
@@ -438,7 +461,11 @@ void SVMCompiler::find_dependencies(ShaderNodeSet &dependencies,
 
 void SVMCompiler::generate_node(ShaderNode *node, ShaderNodeSet &done)
 {
+  /* Allow fusing of constant loads of the node inputs. Any valid index enables fusing. */
+  value_f_fuse_index = current_svm_nodes.size();
   node->compile(*this);
+  value_f_fuse_index = -1;
+
   stack_clear_users(node, done);
   stack_clear_temporary(node);
 
@@ -877,6 +904,7 @@ void SVMCompiler::compile(Shader *shader,
   /* copy graph for shader with bump mapping */
   ShaderNode *output = shader->graph->output();
   const int start_num_svm_nodes = svm_nodes.size();
+  num_fused_nodes = 0;
 
   const double time_start = time_dt();
 
@@ -945,6 +973,7 @@ void SVMCompiler::compile(Shader *shader,
     summary->time_total = time_dt() - time_start;
     summary->peak_stack_usage = max_stack_use;
     summary->num_svm_nodes = svm_nodes.size() - start_num_svm_nodes;
+    summary->num_fused_svm_nodes = num_fused_nodes;
   }
 
   /* Estimate emission for MIS. */
@@ -955,6 +984,7 @@ void SVMCompiler::compile(Shader *shader,
 
 SVMCompiler::Summary::Summary()
     : num_svm_nodes(0),
+      num_fused_svm_nodes(0),
       peak_stack_usage(0),
       time_finalize(0.0),
       time_generate_surface(0.0),
@@ -969,6 +999,7 @@ string SVMCompiler::Summary::full_report() const
 {
   string report;
   report += string_printf("Number of SVM nodes: %d\n", num_svm_nodes);
+  report += string_printf("Fused SVM nodes:     %d\n", num_fused_svm_nodes);
   report += string_printf("Peak stack usage:    %d\n", peak_stack_usage);
 
   report += string_printf("Time (in seconds):\n");
@@ -53,6 +53,9 @@ class SVMCompiler {
     /* Number of SVM nodes shader was compiled into. */
     int num_svm_nodes;
 
+    /* Number of SVM nodes which were eliminated by fusing them into other nodes. */
+    int num_fused_svm_nodes;
+
     /* Peak stack usage during shader evaluation. */
     int peak_stack_usage;
 
@@ -98,6 +101,9 @@ class SVMCompiler {
   void add_node(const int a = 0, const int b = 0, const int c = 0, const int d = 0);
   void add_node(ShaderNodeType type, const float3 &f);
   void add_node(const float4 &f);
+  /* Add node which loads a constant float (or integer) value to the stack.
+   * Consecutive loads within a single shader node are fused into one NODE_VALUE_F2. */
+  void add_value_f_node(const int value, const int out_offset);
   uint attribute(ustring name);
   uint attribute(AttributeStandard std);
   uint attribute_standard(ustring name);
@@ -221,6 +227,15 @@ class SVMCompiler {
 
   std::atomic_int *svm_node_types_used;
   array<int4> current_svm_nodes;
+
+  /* Index of the NODE_VALUE_F which the next constant load can be fused into, or -1 when fusing
+   * is disabled. Fusing only happens when the index is the last node.
+   *
+   * Fusing is only done within compilation of a single shader node: nodes outside of it might be
+   * a target of a jump, which must not end up in the middle of a fused node. */
+  int value_f_fuse_index;
+  int num_fused_nodes;
+
   ShaderType current_type;
   Shader *current_shader;
   Stack active_stack;
@@ -8,6 +8,7 @@
 #include "device/device.h"
 #include "integrator/path_trace.h"
 #include "scene/background.h"
+#include "scene/bake.h"
 #include "scene/camera.h"
 #include "scene/integrator.h"
 #include "scene/light.h"
@@ -22,6 +23,7 @@
 
 #include "util/log.h"
 #include "util/math.h"
+#include "util/path.h"
 #include "util/task.h"
 #include "util/time.h"
 
@@ -176,6 +178,10 @@ void Session::run_main_render_loop()
       if (params.background) {
         /* if no work left and in background mode, we can stop immediately. */
         progress.set_status("Finished");
+        /* The result is delivered, there is nothing to resume anymore. */
+        if (!progress.get_cancel()) {
+          checkpoint_remove();
+        }
         break;
       }
     }
@@ -218,6 +224,12 @@ void Session::run_main_render_loop()
         progress.set_error(device->error_message());
         break;
       }
+
+      /* Always write a checkpoint when the render is canceled, so that a job which was asked to
+       * terminate loses none of its samples. */
+      if (did_cancel || time_dt() - last_checkpoint_time_ >= params.checkpoint_interval) {
+        checkpoint_write_if_needed(render_work);
+      }
     }
 
     progress.set_update();
@@ -321,6 +333,10 @@ RenderWork Session::run_update_for_next_iteration()
     /* After reset make sure the tile manager is at the first big tile. */
     have_tiles = tile_manager_.next();
     switched_to_new_tile = true;
+
+    if (have_tiles) {
+      checkpoint_resume_if_possible();
+    }
   }
 
   /* Update denoiser settings. */
@@ -367,26 +383,7 @@ RenderWork Session::run_update_for_next_iteration()
     const scoped_timer update_timer;
 
     if (switched_to_new_tile) {
-      BufferParams tile_params = buffer_params_;
-
-      const Tile &tile = tile_manager_.get_current_tile();
-
-      tile_params.width = tile.width;
-      tile_params.height = tile.height;
-
-      tile_params.window_x = tile.window_x;
-      tile_params.window_y = tile.window_y;
-      tile_params.window_width = tile.window_width;
-      tile_params.window_height = tile.window_height;
-
-      tile_params.full_x = tile.x + buffer_params_.full_x;
-      tile_params.full_y = tile.y + buffer_params_.full_y;
-      tile_params.full_width = buffer_params_.full_width;
-      tile_params.full_height = buffer_params_.full_height;
-
-      tile_params.update_offset_stride();
-
-      path_trace_->reset(buffer_params_, tile_params, reset_buffers);
+      path_trace_->reset(buffer_params_, get_current_tile_buffer_params(), reset_buffers);
     }
 
     /* Update camera if dimensions changed for progressive render. the camera
@@ -468,6 +465,30 @@ void Session::draw()
   path_trace_->draw();
 }
 
+BufferParams Session::get_current_tile_buffer_params() const
+{
+  BufferParams tile_params = buffer_params_;
+
+  const Tile &tile = tile_manager_.get_current_tile();
+
+  tile_params.width = tile.width;
+  tile_params.height = tile.height;
+
+  tile_params.window_x = tile.window_x;
+  tile_params.window_y = tile.window_y;
+  tile_params.window_width = tile.window_width;
+  tile_params.window_height = tile.window_height;
+
+  tile_params.full_x = tile.x + buffer_params_.full_x;
+  tile_params.full_y = tile.y + buffer_params_.full_y;
+  tile_params.full_width = buffer_params_.full_width;
+  tile_params.full_height = buffer_params_.full_height;
+
+  tile_params.update_offset_stride();
+
+  return tile_params;
+}
+
 int2 Session::get_effective_tile_size() const
 {
   const int image_width = buffer_params_.width;
@@ -552,6 +573,8 @@ void Session::update_buffers_for_params()
   const double time_limit = params.time_limit * ((double)tile_manager_.get_num_tiles());
   progress.set_render_start_time();
   progress.set_time_limit(time_limit);
+
+  last_checkpoint_time_ = time_dt();
 }
 
 void Session::reset(const SessionParams &session_params, const BufferParams &buffer_params)
@@ -768,6 +791,88 @@ void Session::collect_statistics(RenderStats *render_stats)
   }
 }
 
+/* --------------------------------------------------------------------
+ * Checkpoints.
+ */
+
+bool Session::use_checkpoint() const
+{
+  if (!params.background || params.checkpoint_interval <= 0.0 ||
+      params.checkpoint_filepath.empty())
+  {
+    return false;
+  }
+
+  /* Buffers of the baking are initialized from the output driver, and are not to be resumed. */
+  if (scene->bake_manager->get_baking()) {
+    return false;
+  }
+
+  return !tile_manager_.has_multiple_tiles();
+}
+
+void Session::checkpoint_resume_if_possible()
+{
+  if (!use_checkpoint()) {
+    if (params.checkpoint_interval > 0.0 && tile_manager_.has_multiple_tiles()) {
+      LOG_WARNING << "Render checkpoints are not supported with tiled rendering.";
+    }
+    return;
+  }
+
+  if (!path_exists(params.checkpoint_filepath)) {
+    return;
+  }
+
+  const int num_samples = path_trace_->read_checkpoint(params.checkpoint_filepath,
+                                                       get_current_tile_buffer_params());
+  if (num_samples == 0) {
+    return;
+  }
+
+  LOG_INFO << "Resuming render from " << num_samples << " samples of the checkpoint "
+           << params.checkpoint_filepath;
+
+  render_scheduler_.resume(num_samples);
+
+  progress.add_samples(
+      static_cast<uint64_t>(buffer_params_.width) * buffer_params_.height * num_samples,
+      num_samples);
+}
+
+void Session::checkpoint_write_if_needed(const RenderWork &render_work)
+{
+  if (!render_work.path_trace.num_samples && !progress.get_cancel()) {
+    /* No new samples were added since the previous checkpoint. */
+    return;
+  }
+
+  if (!use_checkpoint()) {
+    return;
+  }
+
+  progress.set_status("Writing checkpoint");
+
+  if (!path_trace_->write_checkpoint(params.checkpoint_filepath)) {
+    LOG_ERROR << "Error writing render checkpoint " << params.checkpoint_filepath;
+  }
+
+  last_checkpoint_time_ = time_dt();
+
+  update_status_time();
+}
+
+void Session::checkpoint_remove()
+{
+  if (!use_checkpoint() || !path_exists(params.checkpoint_filepath)) {
+    return;
+  }
+
+  if (!path_remove(params.checkpoint_filepath)) {
+    LOG_WARNING << "Error removing render checkpoint " << params.checkpoint_filepath;
+  }
+}
+
 /* --------------------------------------------------------------------
  * Full-frame on-disk storage.
  */
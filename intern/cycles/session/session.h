@@ -68,6 +68,14 @@ class SessionParams {
   /* Session-specific temporary directory to store in-progress EXR files in. */
   string temp_dir;
 
+  /* Interval in seconds at which the render buffers are written to the checkpoint file.
+   * Zero means no checkpoints are written.
+   *
+   * When the checkpoint file exists at the beginning of rendering and it is compatible with the
+   * current render buffers the rendering continues from the samples stored in the checkpoint. */
+  double checkpoint_interval;
+  string checkpoint_filepath;
+
   SessionParams()
   {
     headless = false;
@@ -89,6 +97,8 @@ class SessionParams {
 
     use_resolution_divider = true;
 
+    checkpoint_interval = 0.0;
+
     shadingsystem = SHADINGSYSTEM_SVM;
   }
 
@@ -211,6 +221,19 @@ class Session {
   bool delayed_reset_buffer_params();
   void update_buffers_for_params();
 
+  /* Checkpoints of the render buffers, which allows to resume an offline render which got
+   * terminated before it was finished.
+   *
+   * Only the render of a single big tile is supported: with multiple tiles the already finished
+   * tiles live in the session-specific tile file which does not survive the process. */
+  bool use_checkpoint() const;
+  void checkpoint_resume_if_possible();
+  void checkpoint_write_if_needed(const RenderWork &render_work);
+  void checkpoint_remove();
+
+  /* Get buffer parameters of the current big tile of the tile manager. */
+  BufferParams get_current_tile_buffer_params() const;
+
   int2 get_effective_tile_size() const;
 
   /* Get device used for denoising, may be the same as render device. */
@@ -242,6 +265,9 @@ class Session {
   TileManager tile_manager_;
   BufferParams buffer_params_;
 
+  /* Point in time at which the last checkpoint was written (or the rendering has started). */
+  double last_checkpoint_time_ = 0.0;
+
   /* Render scheduler is used to get work to be rendered with the current big tile. */
   RenderScheduler render_scheduler_;
 
@@ -31,6 +31,9 @@ static const char *ATTR_PASSES_COUNT = "cycles.passes.count";
 static const char *ATTR_PASS_SOCKET_PREFIX_FORMAT = "cycles.passes.%d.";
 static const char *ATTR_BUFFER_SOCKET_PREFIX = "cycles.buffer.";
 static const char *ATTR_DENOISE_SOCKET_PREFIX = "cycles.denoise.";
+static const char *ATTR_CHECKPOINT_NUM_SAMPLES = "cycles.checkpoint.num_samples";
+static const char *ATTR_CHECKPOINT_SEED = "cycles.checkpoint.seed";
+static const char *ATTR_CHECKPOINT_SAMPLE_OFFSET = "cycles.checkpoint.sample_offset";
 
 /* Global counter of ToleManager object instances. */
 static std::atomic<uint64_t> g_instance_index = 0;
@@ -355,6 +358,11 @@ void TileManager::update(const BufferParams &params, const Scene *scene)
 
   buffer_params_ = params;
 
+  sampling_.seed = scene->integrator->get_seed();
+  sampling_.sample_offset = scene->integrator->get_use_sample_subset() ?
+                                scene->integrator->get_sample_subset_offset() :
+                                0;
+
   if (has_multiple_tiles()) {
     /* TODO(sergey): Proper Error handling, so that if configuration has failed we don't attempt to
      * write to a partially configured file. */
@@ -625,6 +633,117 @@ void TileManager::finish_write_tiles()
   write_state_.filename = "";
 }
 
+bool TileManager::write_checkpoint(const string &filepath,
+                                   const RenderBuffers &buffers,
+                                   const int num_samples)
+{
+  const double time_start = time_dt();
+
+  ImageSpec image_spec;
+  if (!configure_image_spec_from_buffer(&image_spec, buffers.params)) {
+    LOG_ERROR << "Error configuring checkpoint image specification.";
+    return false;
+  }
+
+  image_spec.attribute(ATTR_CHECKPOINT_NUM_SAMPLES, num_samples);
+  image_spec.attribute(ATTR_CHECKPOINT_SEED, sampling_.seed);
+  image_spec.attribute(ATTR_CHECKPOINT_SAMPLE_OFFSET, sampling_.sample_offset);
+
+  const string temp_filepath = filepath + ".tmp";
+
+  path_create_directories(filepath);
+
+  unique_ptr<ImageOutput> out = ImageOutput::create(temp_filepath);
+  if (!out) {
+    LOG_ERROR << "Error creating image output for " << temp_filepath;
+    return false;
+  }
+
+  if (!out->open(temp_filepath, image_spec)) {
+    LOG_ERROR << "Error opening checkpoint file: " << out->geterror();
+    return false;
+  }
+
+  if (!out->write_image(TypeDesc::FLOAT, buffers.buffer.data())) {
+    LOG_ERROR << "Error writing checkpoint file: " << out->geterror();
+    out->close();
+    path_remove(temp_filepath);
+    return false;
+  }
+
+  if (!out->close()) {
+    LOG_ERROR << "Error closing checkpoint file: " << out->geterror();
+    path_remove(temp_filepath);
+    return false;
+  }
+
+  if (!path_rename(temp_filepath, filepath)) {
+    LOG_ERROR << "Error moving checkpoint file to " << filepath;
+    path_remove(temp_filepath);
+    return false;
+  }
+
+  LOG_WORK << "Checkpoint with " << num_samples << " samples written to " << filepath << " in "
+           << time_dt() - time_start << " seconds.";
+
+  return true;
+}
+
+bool TileManager::read_checkpoint(const string &filepath,
+                                  const BufferParams &params,
+                                  RenderBuffers *buffers,
+                                  int *num_samples)
+{
+  unique_ptr<ImageInput> in(ImageInput::open(filepath));
+  if (!in) {
+    LOG_ERROR << "Error opening checkpoint file " << filepath;
+    return false;
+  }
+
+  const ImageSpec &image_spec = in->spec();
+
+  BufferParams buffer_params;
+  if (!buffer_params_from_image_spec_atttributes(&buffer_params, image_spec)) {
+    return false;
+  }
+
+  if (buffer_params.modified(params)) {
+    LOG_WARNING << "Checkpoint " << filepath << " does not match the render buffers, ignoring.";
+    return false;
+  }
+
+  if (image_spec.get_int_attribute(ATTR_CHECKPOINT_SEED, 0) != sampling_.seed ||
+      image_spec.get_int_attribute(ATTR_CHECKPOINT_SAMPLE_OFFSET, 0) != sampling_.sample_offset)
+  {
+    LOG_WARNING << "Checkpoint " << filepath
+                << " uses different sampling pattern than the scene, ignoring.";
+    return false;
+  }
+
+  const int checkpoint_num_samples = image_spec.get_int_attribute(ATTR_CHECKPOINT_NUM_SAMPLES, 0);
+  if (checkpoint_num_samples <= 0) {
+    LOG_ERROR << "Missing number of samples in the checkpoint " << filepath;
+    return false;
+  }
+
+  buffers->reset(params);
+
+  const int num_channels = image_spec.nchannels;
+  if (!in->read_image(0, 0, 0, num_channels, TypeDesc::FLOAT, buffers->buffer.data())) {
+    LOG_ERROR << "Error reading pixels from the checkpoint file " << in->geterror();
+    return false;
+  }
+
+  if (!in->close()) {
+    LOG_ERROR << "Error closing checkpoint file " << in->geterror();
+    return false;
+  }
+
+  *num_samples = checkpoint_num_samples;
+
+  return true;
+}
+
 bool TileManager::read_full_buffer_from_disk(const string_view filename,
                                              RenderBuffers *buffers,
                                              DenoiseParams *denoise_params)
@@ -107,6 +107,29 @@ class TileManager {
                                   RenderBuffers *buffers,
                                   DenoiseParams *denoise_params);
 
+  /* Write render buffers of the current big tile to a checkpoint file on disk, together with the
+   * number of samples accumulated in them and the sampling pattern configuration.
+   *
+   * The file is written under a temporary name first and is then moved in place, so that the
+   * process being terminated in the middle of writing never leaves a corrupted checkpoint.
+   *
+   * Returns true on success. */
+  bool write_checkpoint(const string &filepath,
+                        const RenderBuffers &buffers,
+                        const int num_samples);
+
+  /* Read render buffers from the checkpoint file.
+   *
+   * The checkpoint is only accepted if it was written for buffers of the given parameters and
+   * with the same sampling pattern configuration as the current scene, so that continuing the
+   * sampling gives the same result as an uninterrupted render.
+   *
+   * Returns true on success, and sets the number of samples stored in the checkpoint. */
+  bool read_checkpoint(const string &filepath,
+                       const BufferParams &params,
+                       RenderBuffers *buffers,
+                       int *num_samples);
+
   /* Compute valid tile size compatible with image saving. */
   int compute_render_tile_size(const int suggested_tile_size) const;
 
@@ -138,6 +161,12 @@ class TileManager {
   /* Number of extra pixels around the actual tile to render. */
   int overscan_ = 0;
 
+  /* Sampling pattern configuration of the scene, used to validate checkpoints. */
+  struct {
+    int seed = 0;
+    int sample_offset = 0;
+  } sampling_;
+
   BufferParams buffer_params_;
 
   /* Tile scheduling state. */
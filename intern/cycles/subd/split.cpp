@@ -13,13 +13,159 @@
 #include "util/algorithm.h"
 
 #include "util/math.h"
+#include "util/tbb.h"
 #include "util/types.h"
 
 CCL_NAMESPACE_BEGIN
 
+/* Maximum movement of the dicing camera relative to its distance to the mesh, and minimum cosine
+ * of the rotation of the dicing camera, for which edge factors of a previous tessellation are
+ * reused. */
+static constexpr float DSPLIT_CACHE_MAX_MOVE = 0.01f;
+static constexpr float DSPLIT_CACHE_MIN_COS_ROTATION = 0.99985f; /* cos(1 degree). */
+
+/* Maximum number of edge factors kept for the next tessellation of a mesh, which is roughly 64 MB
+ * of memory. Edge factors of meshes with more are only used during their own split. */
+static constexpr size_t DSPLIT_CACHE_MAX_EDGE_FACTORS = 1 << 20;
+
+/* DiagSplitCache */
+
+bool DiagSplitCache::validate(const SubdParams &params)
+{
+  const Mesh &mesh = *params.mesh;
+
+  const bool valid = !faces.empty() && faces.size() == mesh.get_num_subd_faces() &&
+                     subdivision_type == mesh.get_subdivision_type() &&
+                     dicing_rate == params.dicing_rate && max_level == params.max_level &&
+                     test_steps == params.test_steps &&
+                     split_threshold == params.split_threshold &&
+                     objecttoworld == params.objecttoworld && base_mesh_matches(mesh) &&
+                     camera_matches(params);
+
+  if (!valid) {
+    free_memory();
+    store(params);
+  }
+
+  return valid;
+}
+
+void DiagSplitCache::limit_memory()
+{
+  size_t num_edge_factors = 0;
+  for (const FaceEdgeFactors &face_edge_factors : faces) {
+    num_edge_factors += face_edge_factors.size();
+  }
+
+  if (num_edge_factors > DSPLIT_CACHE_MAX_EDGE_FACTORS) {
+    /* Without stored faces the next validation fails, so the stored parameters are not needed. */
+    free_memory();
+  }
+}
+
+void DiagSplitCache::free_memory()
+{
+  faces.free_memory();
+
+  verts.clear();
+  subd_start_corner.clear();
+  subd_num_corners.clear();
+  subd_face_corners.clear();
+  subd_creases_edge.clear();
+  subd_creases_weight.clear();
+  subd_vert_creases.clear();
+  subd_vert_creases_weight.clear();
+}
+
+bool DiagSplitCache::base_mesh_matches(const Mesh &mesh) const
+{
+  return verts == mesh.get_verts() && subd_start_corner == mesh.get_subd_start_corner() &&
+         subd_num_corners == mesh.get_subd_num_corners() &&
+         subd_face_corners == mesh.get_subd_face_corners() &&
+         subd_creases_edge == mesh.get_subd_creases_edge() &&
+         subd_creases_weight == mesh.get_subd_creases_weight() &&
+         subd_vert_creases == mesh.get_subd_vert_creases() &&
+         subd_vert_creases_weight == mesh.get_subd_vert_creases_weight();
+}
+
+bool DiagSplitCache::camera_matches(const SubdParams &params) const
+{
+  const Camera *cam = params.camera;
+  if (cam == nullptr || !has_camera) {
+    return cam == nullptr && !has_camera;
+  }
+
+  if (cam->get_camera_type() != camera_type || cam->get_full_width() != camera_width ||
+      cam->get_full_height() != camera_height || cam->get_fov() != camera_fov)
+  {
+    return false;
+  }
+
+  const Transform &matrix = cam->get_matrix();
+  if (matrix == camera_matrix) {
+    return true;
+  }
+
+  /* Only allow perspective cameras to move, where the dicing rate changes smoothly with the
+   * distance to the mesh. */
+  if (camera_type != CAMERA_PERSPECTIVE) {
+    return false;
+  }
+
+  const float3 dir = normalize(transform_get_column(&matrix, 2));
+  const float3 cached_dir = normalize(transform_get_column(&camera_matrix, 2));
+  if (dot(dir, cached_dir) < DSPLIT_CACHE_MIN_COS_ROTATION) {
+    return false;
+  }
+
+  BoundBox bounds = BoundBox::empty;
+  for (const float3 &co : verts) {
+    bounds.grow(transform_point(&objecttoworld, co));
+  }
+
+  const float3 P = transform_get_column(&matrix, 3);
+  const float3 cached_P = transform_get_column(&camera_matrix, 3);
+  const float distance = len(cached_P - clamp(cached_P, bounds.min, bounds.max));
+
+  return len(P - cached_P) <= DSPLIT_CACHE_MAX_MOVE * distance;
+}
+
+void DiagSplitCache::store(const SubdParams &params)
+{
+  const Mesh &mesh = *params.mesh;
+
+  subdivision_type = mesh.get_subdivision_type();
+  dicing_rate = params.dicing_rate;
+  max_level = params.max_level;
+  test_steps = params.test_steps;
+  split_threshold = params.split_threshold;
+  objecttoworld = params.objecttoworld;
+
+  verts = mesh.get_verts();
+  subd_start_corner = mesh.get_subd_start_corner();
+  subd_num_corners = mesh.get_subd_num_corners();
+  subd_face_corners = mesh.get_subd_face_corners();
+  subd_creases_edge = mesh.get_subd_creases_edge();
+  subd_creases_weight = mesh.get_subd_creases_weight();
+  subd_vert_creases = mesh.get_subd_vert_creases();
+  subd_vert_creases_weight = mesh.get_subd_vert_creases_weight();
+
+  has_camera = (params.camera != nullptr);
+  if (has_camera) {
+    camera_type = params.camera->get_camera_type();
+    camera_width = params.camera->get_full_width();
+    camera_height = params.camera->get_full_height();
+    camera_fov = params.camera->get_fov();
+    camera_matrix = params.camera->get_matrix();
+  }
+}
+
 /* DiagSplit */
 
-DiagSplit::DiagSplit(const SubdParams &params_) : params(params_) {}
+DiagSplit::DiagSplit(const SubdParams &params_, DiagSplitCache *cache_)
+    : params(params_), cache(cache_)
+{
+}
 
 int DiagSplit::alloc_verts(int num)
 {
@@ -99,6 +245,19 @@ std::pair<int, float> DiagSplit::T(const Patch *patch,
                                    const int depth,
                                    const bool recursive_resolve)
 {
+  /* Use edge factor computed before for the same patch and edge, if any. */
+  DiagSplitCache::FaceEdgeFactors *face_edge_factors = nullptr;
+  const DiagSplitCache::Key key = {
+      patch->patch_index, depth, uv_start, uv_end, recursive_resolve};
+
+  if (cache) {
+    face_edge_factors = &cache->faces[cache_face_index];
+    const auto it = face_edge_factors->find(key);
+    if (it != face_edge_factors->end()) {
+      return it->second;
+    }
+  }
+
   /* May not be necessary, but better to be safe. */
   if (uv_end.x < uv_start.x || uv_end.y < uv_start.y) {
     swap(uv_start, uv_end);
@@ -162,7 +321,12 @@ std::pair<int, float> DiagSplit::T(const Patch *patch,
     res = DSPLIT_MAX_SEGMENTS;
   }
 
-  return std::make_pair(res, Lsum_world);
+  const std::pair<int, float> result(res, Lsum_world);
+  if (face_edge_factors) {
+    face_edge_factors->emplace(key, result);
+  }
+
+  return result;
 }
 
 int DiagSplit::limit_edge_factor(const Patch *patch,
@@ -753,11 +917,73 @@ void DiagSplit::split_ngon(const Mesh::SubdFace &face,
   }
 }
 
+void DiagSplit::split_face(const int face_index,
+                           const Patch *patches,
+                           const size_t patches_byte_stride)
+{
+  const Mesh::SubdFace face = params.mesh->get_subd_face(face_index);
+  const Patch *patch = (const Patch *)(((char *)patches) +
+                                       (face.ptex_offset * patches_byte_stride));
+
+  cache_face_index = face_index;
+
+  if (face.is_quad()) {
+    split_quad(face, face_index, patch);
+  }
+  else {
+    split_ngon(face, face_index, patch, patches_byte_stride);
+  }
+}
+
+void DiagSplit::split_patches_speculative(const Patch *patches, const size_t patches_byte_stride)
+{
+  const int num_faces = params.mesh->get_num_subd_faces();
+  const int num_base_verts = params.mesh->get_num_subd_base_verts();
+
+  /* Split every face on its own, only to fill the cache with edge factors. The subpatches are
+   * discarded. Edges shared with neighboring faces may end up with different edge factors in the
+   * serial split, in which case it evaluates the missing edge factors itself. */
+  parallel_for(blocked_range<int>(0, num_faces, 16), [&](const blocked_range<int> &r) {
+    DiagSplit split(params, cache);
+
+    for (int f = r.begin(); f != r.end(); f++) {
+      /* Edge factors reused from a previous tessellation. */
+      if (!cache->faces[f].empty()) {
+        continue;
+      }
+
+      split.num_verts = num_base_verts;
+      split.num_triangles = 0;
+      split.edges.clear();
+      split.subpatches.clear();
+
+      split.split_face(f, patches, patches_byte_stride);
+    }
+  });
+}
+
 void DiagSplit::split_patches(const Patch *patches, const size_t patches_byte_stride)
 {
   /* TODO: reuse edge factor vertex position computations. */
   /* TODO: support not splitting n-gons if not needed. */
-  /* TODO: multi-threading. */
+
+  const int num_faces = params.mesh->get_num_subd_faces();
+
+  /* Compute edge factors in parallel first. The split itself remains serial, as vertex and edge
+   * allocation must be deterministic, but then mostly finds edge factors in the cache. */
+  if (cache) {
+    cache->faces.resize(num_faces);
+
+    cache->num_faces_reused = 0;
+    for (const DiagSplitCache::FaceEdgeFactors &face_edge_factors : cache->faces) {
+      if (!face_edge_factors.empty()) {
+        cache->num_faces_reused++;
+      }
+    }
+    cache->num_faces_split = num_faces - cache->num_faces_reused;
+
+    split_patches_speculative(patches, patches_byte_stride);
+  }
 
   /* Keep base mesh vertices, create new triangles. */
   num_verts = params.mesh->get_num_subd_base_verts();
@@ -766,16 +992,8 @@ void DiagSplit::split_patches(const Patch *patches, const size_t patches_byte_st
   owned_verts.resize(num_verts, false);
 
   /* Split all faces in the mesh. */
-  for (int f = 0; f < params.mesh->get_num_subd_faces(); f++) {
-    Mesh::SubdFace face = params.mesh->get_subd_face(f);
-    const Patch *patch = (const Patch *)(((char *)patches) +
-                                         (face.ptex_offset * patches_byte_stride));
-    if (face.is_quad()) {
-      split_quad(face, f, patch);
-    }
-    else {
-      split_ngon(face, f, patch, patches_byte_stride);
-    }
+  for (int f = 0; f < num_faces; f++) {
+    split_face(f, patches, patches_byte_stride);
   }
 }
 
@@ -14,6 +14,7 @@
 #include "subd/dice.h"
 #include "subd/subpatch.h"
 
+#include "util/map.h"
 #include "util/set.h"
 #include "util/types.h"
 #include "util/vector.h"
@@ -24,9 +25,95 @@ class Mesh;
 class Patch;
 class SubdAttributeInterpolation;
 
+/* Edge factors computed while splitting, stored per base mesh face. Edge factors only depend on
+ * the patch, the edge and the subdivision parameters, so stored results can be used in place of
+ * evaluating the patch again. This is used to compute edge factors for all faces in parallel
+ * ahead of the deterministic serial split, and to reuse the split of the previous tessellation
+ * of the same mesh when the dicing camera only moved a little. */
+class DiagSplitCache {
+ public:
+  struct Key {
+    int patch_index;
+    int depth;
+    float2 uv_start;
+    float2 uv_end;
+    bool recursive_resolve;
+
+    struct Hash {
+      size_t operator()(const Key &key) const
+      {
+        return hash_uint4(__float_as_uint(key.uv_start.x),
+                          __float_as_uint(key.uv_start.y),
+                          __float_as_uint(key.uv_end.x),
+                          __float_as_uint(key.uv_end.y)) ^
+               hash_uint3(key.patch_index, key.depth, key.recursive_resolve);
+      }
+    };
+
+    struct Equal {
+      bool operator()(const Key &a, const Key &b) const
+      {
+        return a.patch_index == b.patch_index && a.depth == b.depth &&
+               a.uv_start == b.uv_start && a.uv_end == b.uv_end &&
+               a.recursive_resolve == b.recursive_resolve;
+      }
+    };
+  };
+
+  using FaceEdgeFactors = unordered_map<Key, std::pair<int, float>, Key::Hash, Key::Equal>;
+
+  /* Edge factors per base mesh face. */
+  vector<FaceEdgeFactors> faces;
+
+  /* Statistics of the last split. */
+  size_t num_faces_reused = 0;
+  size_t num_faces_split = 0;
+
+  /* Test if the stored edge factors are still usable for the given parameters, and free them if
+   * not. Must be called before splitting, while the mesh only contains the base vertices. */
+  bool validate(const SubdParams &params);
+
+  /* Free the stored edge factors after splitting if there are too many of them to keep around
+   * for the next tessellation, so that the memory used by the cache stays bounded. */
+  void limit_memory();
+
+ private:
+  /* Parameters and base mesh the edge factors were computed for. */
+  Mesh::SubdivisionType subdivision_type = Mesh::SUBDIVISION_NONE;
+  float dicing_rate = 0.0f;
+  int max_level = 0;
+  int test_steps = 0;
+  int split_threshold = 0;
+  Transform objecttoworld = transform_identity();
+
+  array<float3> verts;
+  array<int> subd_start_corner;
+  array<int> subd_num_corners;
+  array<int> subd_face_corners;
+  array<int> subd_creases_edge;
+  array<float> subd_creases_weight;
+  array<int> subd_vert_creases;
+  array<float> subd_vert_creases_weight;
+
+  /* Dicing camera the edge factors were computed with. */
+  bool has_camera = false;
+  CameraType camera_type = CAMERA_PERSPECTIVE;
+  int camera_width = 0;
+  int camera_height = 0;
+  float camera_fov = 0.0f;
+  Transform camera_matrix = transform_identity();
+
+  bool base_mesh_matches(const Mesh &mesh) const;
+  bool camera_matches(const SubdParams &params) const;
+  void store(const SubdParams &params);
+  void free_memory();
+};
+
 class DiagSplit {
  private:
   SubdParams params;
+  DiagSplitCache *cache = nullptr;
+  int cache_face_index = -1;
   vector<SubPatch> subpatches;
   vector<bool> owned_verts;
   unordered_set<SubEdge, SubEdge::Hash, SubEdge::Equal> edges;
@@ -77,9 +164,13 @@ class DiagSplit {
                   const int face_index,
                   const Patch *patches,
                   const size_t patches_byte_stride);
+  void split_face(const int face_index, const Patch *patches, const size_t patches_byte_stride);
+
+  /* Compute edge factors of faces in parallel and store them in the cache. */
+  void split_patches_speculative(const Patch *patches, const size_t patches_byte_stride);
 
  public:
-  explicit DiagSplit(const SubdParams &params);
+  explicit DiagSplit(const SubdParams &params, DiagSplitCache *cache = nullptr);
 
   void split_patches(const Patch *patches, const size_t patches_byte_stride);
 
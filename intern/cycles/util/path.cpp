@@ -780,6 +780,15 @@ bool path_remove(const string &path)
   return remove(path.c_str()) == 0;
 }
 
+bool path_rename(const string &from, const string &to)
+{
+#ifdef _WIN32
+  /* Unlike POSIX, rename on Windows fails when the destination exists. */
+  remove(to.c_str());
+#endif
+  return rename(from.c_str(), to.c_str()) == 0;
+}
+
 struct SourceReplaceState {
   using ProcessedMapping = map<string, string>;
   /* Base director for all relative include headers. */
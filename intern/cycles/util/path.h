@@ -52,6 +52,8 @@ bool path_read_compressed_text(const string &path, string &text);
 
 /* File manipulation. */
 bool path_remove(const string &path);
+/* Move file to a new location, replacing the destination file if it exists. */
+bool path_rename(const string &from, const string &to);
 
 /* source code utility */
 string path_source_replace_includes(const string &source, const string &path);
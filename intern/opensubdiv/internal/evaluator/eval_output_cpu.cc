@@ -4,6 +4,107 @@
  *
  * Author: Sergey Sharybin. */
 
+#include "internal/evaluator/eval_output_cpu.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "BLI_index_range.hh"
+#include "BLI_task.hh"
+#include "BLI_vector.hh"
+
 namespace blender::opensubdiv {
 
+// Number of stencils or patch coordinates which are evaluated by a single task. Stencils are
+// cheap, so ranges need to be relatively big to make threading worth it.
+static constexpr int stencils_grain_size = 4096;
+static constexpr int patch_coords_grain_size = 1024;
+
+bool ParallelCpuEvaluator::EvalStencils(const float *src,
+                                        const BufferDescriptor &srcDesc,
+                                        float *dst,
+                                        const BufferDescriptor &dstDesc,
+                                        const int *sizes,
+                                        const int *offsets,
+                                        const int *indices,
+                                        const float *weights,
+                                        const int numStencils)
+{
+  const int length = std::min(srcDesc.length, dstDesc.length);
+  src += srcDesc.offset;
+  dst += dstDesc.offset;
+
+  threading::parallel_for(IndexRange(numStencils), stencils_grain_size, [&](IndexRange range) {
+    // Accumulate in a separate buffer, the source and destination can be the same buffer.
+    Vector<float, 16> result(length);
+    for (const int stencil : range) {
+      std::fill(result.begin(), result.end(), 0.0f);
+      const int offset = offsets[stencil];
+      for (int i = 0; i < sizes[stencil]; ++i) {
+        const float *src_value = src + indices[offset + i] * srcDesc.stride;
+        const float weight = weights[offset + i];
+        for (int j = 0; j < length; ++j) {
+          result[j] += weight * src_value[j];
+        }
+      }
+      std::copy(result.begin(), result.end(), dst + int64_t(stencil) * dstDesc.stride);
+    }
+  });
+  return true;
+}
+
+bool ParallelCpuEvaluator::EvalPatches(const float *src,
+                                       const BufferDescriptor &srcDesc,
+                                       float *dst,
+                                       const BufferDescriptor &dstDesc,
+                                       float *du,
+                                       const BufferDescriptor &duDesc,
+                                       float *dv,
+                                       const BufferDescriptor &dvDesc,
+                                       int numPatchCoords,
+                                       const PatchCoord *patchCoords,
+                                       const OpenSubdiv::Osd::PatchArray *patchArrays,
+                                       const int *patchIndexBuffer,
+                                       const OpenSubdiv::Osd::PatchParam *patchParamBuffer)
+{
+  // The CPU evaluator writes the result of every patch coordinate relative to the given buffers,
+  // so ranges are evaluated by offsetting the patch coordinates and the buffers.
+  std::atomic<bool> success = true;
+  threading::parallel_for(
+      IndexRange(numPatchCoords), patch_coords_grain_size, [&](IndexRange range) {
+        float *range_dst = dst + range.start() * dstDesc.stride;
+        bool range_success;
+        if (du == nullptr || dv == nullptr) {
+          range_success = CpuEvaluator::EvalPatches(src,
+                                                    srcDesc,
+                                                    range_dst,
+                                                    dstDesc,
+                                                    range.size(),
+                                                    patchCoords + range.start(),
+                                                    patchArrays,
+                                                    patchIndexBuffer,
+                                                    patchParamBuffer);
+        }
+        else {
+          range_success = CpuEvaluator::EvalPatches(src,
+                                                    srcDesc,
+                                                    range_dst,
+                                                    dstDesc,
+                                                    du + range.start() * duDesc.stride,
+                                                    duDesc,
+                                                    dv + range.start() * dvDesc.stride,
+                                                    dvDesc,
+                                                    range.size(),
+                                                    patchCoords + range.start(),
+                                                    patchArrays,
+                                                    patchIndexBuffer,
+                                                    patchParamBuffer);
+        }
+        if (!range_success) {
+          success.store(false, std::memory_order_relaxed);
+        }
+      });
+  return success.load();
+}
+
 }  // namespace blender::opensubdiv
@@ -19,13 +19,191 @@ using OpenSubdiv::Osd::CpuVertexBuffer;
 
 namespace blender::opensubdiv {
 
+// Evaluator with the same interface as Osd::CpuEvaluator, which splits the stencils and patch
+// coordinates into ranges that are evaluated in parallel. The kernels of Osd::CpuEvaluator are
+// single threaded, which makes refinement run on one core per object.
+//
+// NOTE: Stencils are evaluated independently of each other, which relies on stencil tables being
+// factorized to only reference control vertices, which is the default of StencilTableFactory.
+class ParallelCpuEvaluator {
+ public:
+  template<typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+  static bool EvalStencils(SRC_BUFFER *srcBuffer,
+                           const BufferDescriptor &srcDesc,
+                           DST_BUFFER *dstBuffer,
+                           const BufferDescriptor &dstDesc,
+                           const STENCIL_TABLE *stencilTable,
+                           const ParallelCpuEvaluator * /*instance*/ = nullptr,
+                           void * /*deviceContext*/ = nullptr)
+  {
+    if (stencilTable->GetNumStencils() == 0) {
+      return false;
+    }
+    return EvalStencils(srcBuffer->BindCpuBuffer(),
+                        srcDesc,
+                        dstBuffer->BindCpuBuffer(),
+                        dstDesc,
+                        stencilTable->GetSizes().data(),
+                        stencilTable->GetOffsets().data(),
+                        stencilTable->GetControlIndices().data(),
+                        stencilTable->GetWeights().data(),
+                        stencilTable->GetNumStencils());
+  }
+
+  static bool EvalStencils(const float *src,
+                           const BufferDescriptor &srcDesc,
+                           float *dst,
+                           const BufferDescriptor &dstDesc,
+                           const int *sizes,
+                           const int *offsets,
+                           const int *indices,
+                           const float *weights,
+                           int numStencils);
+
+  template<typename SRC_BUFFER,
+           typename DST_BUFFER,
+           typename PATCHCOORD_BUFFER,
+           typename PATCH_TABLE>
+  static bool EvalPatches(SRC_BUFFER *srcBuffer,
+                          const BufferDescriptor &srcDesc,
+                          DST_BUFFER *dstBuffer,
+                          const BufferDescriptor &dstDesc,
+                          int numPatchCoords,
+                          PATCHCOORD_BUFFER *patchCoords,
+                          PATCH_TABLE *patchTable,
+                          const ParallelCpuEvaluator * /*instance*/ = nullptr,
+                          void * /*deviceContext*/ = nullptr)
+  {
+    return EvalPatches(srcBuffer->BindCpuBuffer(),
+                       srcDesc,
+                       dstBuffer->BindCpuBuffer(),
+                       dstDesc,
+                       nullptr,
+                       BufferDescriptor(),
+                       nullptr,
+                       BufferDescriptor(),
+                       numPatchCoords,
+                       (const PatchCoord *)patchCoords->BindCpuBuffer(),
+                       patchTable->GetPatchArrayBuffer(),
+                       patchTable->GetPatchIndexBuffer(),
+                       patchTable->GetPatchParamBuffer());
+  }
+
+  template<typename SRC_BUFFER,
+           typename DST_BUFFER,
+           typename PATCHCOORD_BUFFER,
+           typename PATCH_TABLE>
+  static bool EvalPatches(SRC_BUFFER *srcBuffer,
+                          const BufferDescriptor &srcDesc,
+                          DST_BUFFER *dstBuffer,
+                          const BufferDescriptor &dstDesc,
+                          DST_BUFFER *duBuffer,
+                          const BufferDescriptor &duDesc,
+                          DST_BUFFER *dvBuffer,
+                          const BufferDescriptor &dvDesc,
+                          int numPatchCoords,
+                          PATCHCOORD_BUFFER *patchCoords,
+                          PATCH_TABLE *patchTable,
+                          const ParallelCpuEvaluator * /*instance*/ = nullptr,
+                          void * /*deviceContext*/ = nullptr)
+  {
+    return EvalPatches(srcBuffer->BindCpuBuffer(),
+                       srcDesc,
+                       dstBuffer->BindCpuBuffer(),
+                       dstDesc,
+                       duBuffer->BindCpuBuffer(),
+                       duDesc,
+                       dvBuffer->BindCpuBuffer(),
+                       dvDesc,
+                       numPatchCoords,
+                       (const PatchCoord *)patchCoords->BindCpuBuffer(),
+                       patchTable->GetPatchArrayBuffer(),
+                       patchTable->GetPatchIndexBuffer(),
+                       patchTable->GetPatchParamBuffer());
+  }
+
+  template<typename SRC_BUFFER,
+           typename DST_BUFFER,
+           typename PATCHCOORD_BUFFER,
+           typename PATCH_TABLE>
+  static bool EvalPatchesVarying(SRC_BUFFER *srcBuffer,
+                                 const BufferDescriptor &srcDesc,
+                                 DST_BUFFER *dstBuffer,
+                                 const BufferDescriptor &dstDesc,
+                                 int numPatchCoords,
+                                 PATCHCOORD_BUFFER *patchCoords,
+                                 PATCH_TABLE *patchTable,
+                                 const ParallelCpuEvaluator * /*instance*/ = nullptr,
+                                 void * /*deviceContext*/ = nullptr)
+  {
+    return EvalPatches(srcBuffer->BindCpuBuffer(),
+                       srcDesc,
+                       dstBuffer->BindCpuBuffer(),
+                       dstDesc,
+                       nullptr,
+                       BufferDescriptor(),
+                       nullptr,
+                       BufferDescriptor(),
+                       numPatchCoords,
+                       (const PatchCoord *)patchCoords->BindCpuBuffer(),
+                       patchTable->GetVaryingPatchArrayBuffer(),
+                       patchTable->GetVaryingPatchIndexBuffer(),
+                       patchTable->GetPatchParamBuffer());
+  }
+
+  template<typename SRC_BUFFER,
+           typename DST_BUFFER,
+           typename PATCHCOORD_BUFFER,
+           typename PATCH_TABLE>
+  static bool EvalPatchesFaceVarying(SRC_BUFFER *srcBuffer,
+                                     const BufferDescriptor &srcDesc,
+                                     DST_BUFFER *dstBuffer,
+                                     const BufferDescriptor &dstDesc,
+                                     int numPatchCoords,
+                                     PATCHCOORD_BUFFER *patchCoords,
+                                     PATCH_TABLE *patchTable,
+                                     int fvarChannel,
+                                     const ParallelCpuEvaluator * /*instance*/ = nullptr,
+                                     void * /*deviceContext*/ = nullptr)
+  {
+    return EvalPatches(srcBuffer->BindCpuBuffer(),
+                       srcDesc,
+                       dstBuffer->BindCpuBuffer(),
+                       dstDesc,
+                       nullptr,
+                       BufferDescriptor(),
+                       nullptr,
+                       BufferDescriptor(),
+                       numPatchCoords,
+                       (const PatchCoord *)patchCoords->BindCpuBuffer(),
+                       patchTable->GetFVarPatchArrayBuffer(fvarChannel),
+                       patchTable->GetFVarPatchIndexBuffer(fvarChannel),
+                       patchTable->GetFVarPatchParamBuffer(fvarChannel));
+  }
+
+  // Evaluate the patches, with optional derivatives when du and dv are not null.
+  static bool EvalPatches(const float *src,
+                          const BufferDescriptor &srcDesc,
+                          float *dst,
+                          const BufferDescriptor &dstDesc,
+                          float *du,
+                          const BufferDescriptor &duDesc,
+                          float *dv,
+                          const BufferDescriptor &dvDesc,
+                          int numPatchCoords,
+                          const PatchCoord *patchCoords,
+                          const OpenSubdiv::Osd::PatchArray *patchArrays,
+                          const int *patchIndexBuffer,
+                          const OpenSubdiv::Osd::PatchParam *patchParamBuffer);
+};
+
 // NOTE: Define as a class instead of typedef to make it possible
 // to have anonymous class in opensubdiv_evaluator_internal.h
 class CpuEvalOutput : public VolatileEvalOutput<CpuVertexBuffer,
                                                 CpuVertexBuffer,
                                                 StencilTable,
                                                 CpuPatchTable,
-                                                CpuEvaluator> {
+                                                ParallelCpuEvaluator> {
  public:
   CpuEvalOutput(const StencilTable *vertex_stencils,
                 const StencilTable *varying_stencils,
@@ -37,12 +215,12 @@ class CpuEvalOutput : public VolatileEvalOutput<CpuVertexBuffer,
                            CpuVertexBuffer,
                            StencilTable,
                            CpuPatchTable,
-                           CpuEvaluator>(vertex_stencils,
-                                         varying_stencils,
-                                         all_face_varying_stencils,
-                                         face_varying_width,
-                                         patch_table,
-                                         evaluator_cache)
+                           ParallelCpuEvaluator>(vertex_stencils,
+                                                 varying_stencils,
+                                                 all_face_varying_stencils,
+                                                 face_varying_width,
+                                                 patch_table,
+                                                 evaluator_cache)
   {
   }
 };
@@ -34,6 +34,7 @@ const UserDef U_default = {
     .fontdir = "//",
     .renderdir = "//",
     .render_cachedir = "",
+    .sequencer_disk_cache_dir = "",
     .textudir = "//",
     .script_directories = {NULL, NULL},
     .sounddir = "//",
@@ -106,6 +107,7 @@ const UserDef U_default = {
 
     .undosteps = 32,
     .undomemory = 0,
+    .sculpt_undo_memory = 0,
     .gp_manhattandist = 1,
     .gp_euclideandist = 2,
     .gp_eraser = 25,
@@ -226,6 +228,7 @@ const UserDef U_default = {
         },
 
     .sequencer_proxy_setup = USER_SEQ_PROXY_SETUP_AUTOMATIC,
+    .sequencer_disk_cache_size_limit = 100,
 
     .collection_instance_empty_size = 1.0f,
 
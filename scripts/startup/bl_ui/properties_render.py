@@ -83,6 +83,7 @@ class RENDER_PT_color_management(RenderButtonsPanel, Panel):
         col.separator()
 
         col.prop(scene.sequencer_colorspace_settings, "name", text="Sequencer")
+        col.prop(view, "use_baked_display_transform")
 
 
 class RENDER_PT_color_management_display_settings(RenderButtonsPanel, Panel):
@@ -763,6 +764,8 @@ class CompositorPerformanceButtonsPanel:
         row.prop(rd, "compositor_device", text="Device", expand=True)
         if rd.compositor_device == 'GPU':
             col.prop(rd, "compositor_precision", text="Precision")
+        else:
+            col.prop(rd, "compositor_memory_limit", text="Memory Limit")
 
 
 class CompositorDenoisePerformanceButtonsPanel:
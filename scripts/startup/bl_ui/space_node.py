@@ -892,6 +892,8 @@ class NODE_PT_quality(Panel):
         col.prop(rd, "compositor_device", text="Device")
         if rd.compositor_device == 'GPU':
             col.prop(rd, "compositor_precision", text="Precision")
+        else:
+            col.prop(rd, "compositor_memory_limit", text="Memory Limit")
 
         col = layout.column()
         col.prop(tree, "use_viewer_border")
@@ -2606,11 +2606,13 @@ class SEQUENCER_PT_cache_settings(SequencerButtonsPanel, Panel):
         col = layout.column()
         if ed:
             col.prop(ed, "use_prefetch")
+            col.prop(ed, "use_parallel_strip_render")
 
         col = layout.column(heading="Cache", align=True)
 
         col.prop(ed, "use_cache_raw", text="Raw")
         col.prop(ed, "use_cache_final", text="Final")
+        col.prop(ed, "use_cache_disk", text="Disk")
 
 
 class SEQUENCER_PT_cache_view_settings(SequencerButtonsPanel, Panel):
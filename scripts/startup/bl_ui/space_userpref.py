@@ -790,6 +790,7 @@ class USERPREF_PT_system_memory(SystemPanel, CenterAlignMixIn, Panel):
         col = layout.column()
         col.prop(edit, "undo_steps", text="Undo Steps")
         col.prop(edit, "undo_memory_limit", text="Undo Memory Limit")
+        col.prop(edit, "sculpt_undo_memory_limit", text="Sculpt Undo Memory Limit")
         col.prop(edit, "use_global_undo")
 
         layout.separator()
@@ -831,6 +832,12 @@ class USERPREF_PT_system_video_sequencer(SystemPanel, CenterAlignMixIn, Panel):
 
         layout.prop(system, "sequencer_proxy_setup")
 
+        layout.separator()
+
+        col = layout.column()
+        col.prop(prefs.filepaths, "sequencer_disk_cache_directory", text="Disk Cache Directory")
+        col.prop(system, "sequencer_disk_cache_size_limit")
+
 
 # -----------------------------------------------------------------------------
 # Viewport Panels
@@ -1023,6 +1023,7 @@ class VIEW3D_PT_sculpt_dyntopo(Panel, View3DPaintPanel):
         else:
             sub.prop(sculpt, "detail_size")
         sub.prop(sculpt, "detail_refine_method", text="Refine Method")
+        sub.prop(sculpt, "use_parallel_refine")
         sub.prop(sculpt, "detail_type_method", text="Detailing")
 
         if sculpt.detail_type_method in {'CONSTANT', 'MANUAL'}:
@@ -7,8 +7,10 @@
 #include "BKE_animsys.h"
 #include "BKE_fcurve.hh"
 
+#include "BLI_array.hh"
 #include "BLI_map.hh"
 #include "BLI_math_base.hh"
+#include "BLI_vector.hh"
 
 #include "CLG_log.h"
 
@@ -151,17 +153,20 @@ static EvaluationResult evaluate_keyframe_data(PointerRNA &animated_id_ptr,
     return {};
   }
 
-  EvaluationResult evaluation_result;
-  for (FCurve *fcu : channelbag_for_slot->fcurves()) {
-    /* Blatant copy of animsys_evaluate_fcurves(). */
-
+  /* Blatant copy of animsys_evaluate_fcurves(). */
+  Span<FCurve *> fcurves = channelbag_for_slot->fcurves();
+  Vector<FCurve *> resolved_fcurves;
+  Vector<PathResolvedRNA> resolved_rna;
+  resolved_fcurves.reserve(fcurves.size());
+  resolved_rna.reserve(fcurves.size());
+  for (FCurve *fcu : fcurves) {
     if (!is_fcurve_evaluatable(fcu)) {
       continue;
     }
 
     PathResolvedRNA anim_rna;
-    if (!BKE_animsys_rna_path_resolve(
-            &animated_id_ptr, fcu->rna_path, fcu->array_index, &anim_rna))
+    if (!BKE_animsys_rna_path_resolve_cached(
+            &offset_eval_context, &animated_id_ptr, fcu, &anim_rna))
     {
       /* Log this at quite a high level, because it can get _very_ noisy when playing back
        * animation. */
@@ -173,8 +178,17 @@ static EvaluationResult evaluate_keyframe_data(PointerRNA &animated_id_ptr,
       continue;
     }
 
-    const float curval = calculate_fcurve(&anim_rna, fcu, &offset_eval_context);
-    evaluation_result.store(fcu->rna_path, fcu->array_index, curval, anim_rna);
+    resolved_fcurves.append(fcu);
+    resolved_rna.append(std::move(anim_rna));
+  }
+
+  Array<float> values(resolved_fcurves.size());
+  calculate_fcurves(resolved_fcurves, &offset_eval_context, values);
+
+  EvaluationResult evaluation_result;
+  for (const int i : resolved_fcurves.index_range()) {
+    const FCurve *fcu = resolved_fcurves[i];
+    evaluation_result.store(fcu->rna_path, fcu->array_index, values[i], resolved_rna[i]);
   }
 
   return evaluation_result;
@@ -0,0 +1,78 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+/** \file
+ * \ingroup bke
+ *
+ * Runtime cache of RNA paths resolved by the animation system on evaluated data-blocks.
+ *
+ * Resolving an RNA path parses the path string and walks the RNA structs on every evaluation,
+ * which shows up in profiles of heavily rigged scenes where every F-Curve and driver target does
+ * this on every frame. The resolved pointers stay valid for as long as the evaluated data-block
+ * they point into is neither freed nor re-copied, which is tracked with a global generation
+ * number: see #BKE_anim_rna_path_cache_invalidate_all().
+ */
+
+#include "BLI_map.hh"
+
+#include "RNA_types.hh"
+
+struct ID;
+
+/**
+ * Invalidate every #AnimRNAPathCache. Has to be called whenever evaluated data that cached paths
+ * can point into is freed or reallocated without the owning cache being freed as well, e.g. when
+ * the depsgraph re-copies an evaluated data-block or when the channels of a pose are rebuilt.
+ */
+void BKE_anim_rna_path_cache_invalidate_all();
+
+namespace blender::bke {
+
+struct AnimRNAPathCache {
+ private:
+  struct Item {
+    /** The data-block and path the item was resolved from, to detect changed targets. */
+    const ID *id;
+    const char *rna_path;
+    int array_index;
+    PathResolvedRNA resolved;
+  };
+
+  uint64_t generation_ = 0;
+  Map<const void *, Item> items_;
+
+ public:
+  /**
+   * Whether paths resolved from the given data-block can be cached. This is only the case for
+   * evaluated data-blocks whose RNA data is not modified in place by the depsgraph.
+   */
+  static bool is_supported(const ID *id);
+
+  /**
+   * Find the previously resolved path for the given key, which is typically the F-Curve or
+   * driver target that owns the path. Returns null when nothing was cached or the cache was
+   * invalidated since.
+   */
+  PathResolvedRNA *lookup(const void *key,
+                          const ID *id,
+                          const char *rna_path,
+                          int array_index);
+
+  /**
+   * Remember a successfully resolved path. Paths that lead out of the given data-block are not
+   * stored, as the data-block they point into can be re-copied independently.
+   */
+  void add(const void *key,
+           const ID *id,
+           const char *rna_path,
+           int array_index,
+           const PathResolvedRNA &resolved);
+
+ private:
+  void ensure_valid();
+};
+
+}  // namespace blender::bke
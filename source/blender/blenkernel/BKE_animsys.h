@@ -30,6 +30,10 @@ struct PropertyRNA;
 struct bAction;
 struct bActionGroup;
 
+namespace blender::bke {
+struct AnimRNAPathCache;
+}
+
 /** Container for data required to do FCurve and Driver evaluation. */
 typedef struct AnimationEvalContext {
   /* For drivers, so that they have access to the dependency graph and the current view layer. See
@@ -40,6 +44,10 @@ typedef struct AnimationEvalContext {
    * example when evaluating NLA strips. This means that, even though the current time is stored in
    * the dependency graph, we need an explicit evaluation time. */
   float eval_time;
+
+  /* Paths resolved in earlier evaluations of the animated ID, only set when evaluating the
+   * animation of an evaluated ID. See #BKE_animsys_rna_path_resolve_cached. */
+  blender::bke::AnimRNAPathCache *rna_path_cache = nullptr;
 } AnimationEvalContext;
 
 AnimationEvalContext BKE_animsys_eval_context_construct(struct Depsgraph *depsgraph,
@@ -290,6 +298,14 @@ bool BKE_animsys_rna_path_resolve(struct PointerRNA *ptr,
                                   const char *rna_path,
                                   int array_index,
                                   struct PathResolvedRNA *r_result);
+/**
+ * Same as #BKE_animsys_rna_path_resolve for the path of the given F-Curve, but reuses the result
+ * of earlier evaluations when the context has a path cache and `ptr` is the animated ID itself.
+ */
+bool BKE_animsys_rna_path_resolve_cached(const AnimationEvalContext *anim_eval_context,
+                                         struct PointerRNA *ptr,
+                                         const struct FCurve *fcu,
+                                         struct PathResolvedRNA *r_result);
 bool BKE_animsys_read_from_rna_path(struct PathResolvedRNA *anim_rna, float *r_value);
 /**
  * Write the given value to a setting using RNA, and return success.
@@ -8,6 +8,9 @@
  * \ingroup bke
  */
 
+#include "BLI_vector.hh"
+
+struct BoidParticle;
 struct BoidSettings;
 struct BoidState;
 struct Object;
@@ -16,6 +19,12 @@ struct ParticleSettings;
 struct ParticleSimulationData;
 struct RNG;
 
+/** Damage dealt to a boid in a fight, see #BoidBrainData::damage. */
+struct BoidDamage {
+  struct BoidParticle *boid;
+  float damage;
+};
+
 typedef struct BoidBrainData {
   struct ParticleSimulationData *sim;
   struct ParticleSettings *part;
@@ -29,6 +38,16 @@ typedef struct BoidBrainData {
   float goal_priority;
 
   struct RNG *rng;
+
+  /** Velocity of a jump decided by #boid_brain, applied by #boid_body. */
+  float jump_vel[3];
+  bool do_jump;
+
+  /**
+   * When set, the damage that fights deal to other boids is added here instead of being applied
+   * directly, so that boids can think in parallel without reading the health others write.
+   */
+  blender::Vector<BoidDamage> *damage;
 } BoidBrainData;
 
 void boids_precalc_rules(struct ParticleSettings *part, float cfra);
@@ -7,10 +7,13 @@
  * \ingroup bke
  */
 
+namespace blender {
+class RandomNumberGenerator;
+}
+
 struct Collection;
 struct Depsgraph;
 struct ListBase;
-struct RNG;
 struct Object;
 struct ParticleData;
 struct ParticleKey;
@@ -73,8 +76,10 @@ typedef struct EffectorCache {
 
   struct PartDeflect *pd;
 
-  /** Random noise generator, e.g. for wind. */
-  struct RNG *rng;
+  /** Seed of the random noise, e.g. for wind. */
+  unsigned int rng_seed;
+  /** Random noise generator shared by all points, only used with #PFIELD_LEGACY_NOISE. */
+  blender::RandomNumberGenerator *legacy_rng;
 
   /* precalculated for guides */
   struct GuideEffectorData *guide_data;
@@ -125,6 +130,17 @@ void BKE_effectors_apply(struct ListBase *effectors,
                          float *force,
                          float *wind_force,
                          float *impulse);
+/**
+ * Same as #BKE_effectors_apply for many points, evaluating every effector for all points before
+ * moving on to the next one. The result is the same as when applying them point by point.
+ */
+void BKE_effectors_apply_batch(struct ListBase *effectors,
+                               struct ListBase *colliders,
+                               struct EffectorWeights *weights,
+                               struct EffectedPoint *points,
+                               int points_num,
+                               float (*forces)[3],
+                               float (*impulses)[3]);
 void BKE_effectors_free(struct ListBase *lb);
 
 void pd_point_from_particle(struct ParticleSimulationData *sim,
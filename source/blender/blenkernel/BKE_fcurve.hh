@@ -617,6 +617,15 @@ bool BKE_fcurve_is_empty(const FCurve *fcu);
 float calculate_fcurve(PathResolvedRNA *anim_rna,
                        FCurve *fcu,
                        const AnimationEvalContext *anim_eval_context);
+/**
+ * Calculate the values of the given keyframed F-Curves at the given frame, like
+ * #calculate_fcurve. Large numbers of F-Curves are evaluated in parallel, which is possible
+ * because unlike drivers, keyframes don't depend on the animated data. Resolving and writing the
+ * animated properties is not thread-safe, so that is left to the caller.
+ */
+void calculate_fcurves(blender::Span<FCurve *> fcurves,
+                       const AnimationEvalContext *anim_eval_context,
+                       blender::MutableSpan<float> r_values);
 
 /* ************* F-Curve Samples API ******************** */
 
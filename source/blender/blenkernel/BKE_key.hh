@@ -3,12 +3,15 @@
  * SPDX-License-Identifier: GPL-2.0-or-later */
 #pragma once
 
+#include <memory>
 #include <optional>
 #include <string>
 
 #include "BLI_array.hh"
+#include "BLI_map.hh"
 #include "BLI_math_matrix_types.hh"
 #include "BLI_math_vector_types.hh"
+#include "BLI_mutex.hh"
 #include "BLI_span.hh"
 
 #include "DNA_key_types.h"
@@ -26,6 +29,34 @@ struct Main;
 struct Mesh;
 struct Object;
 
+namespace blender::bke {
+
+/**
+ * The elements of a coordinate key-block that differ from its reference key, and their offsets
+ * from it. Corrective shape keys usually only move a small part of the geometry, so relative
+ * evaluation only has to visit the moved elements.
+ */
+struct KeyBlockDeltas {
+  /** Sorted indices of the elements that differ from the reference key. */
+  Array<int> indices;
+  /** Offset from the reference key for every index. */
+  Array<float3> deltas;
+};
+
+struct KeyRuntime {
+  /**
+   * Sparse offsets of key-blocks, only built for evaluated copies, which are copied again from
+   * the original when the shape key data changes. Filled lazily during evaluation, which may run
+   * from multiple threads for objects sharing the same geometry.
+   */
+  Map<const KeyBlock *, std::unique_ptr<KeyBlockDeltas>> deltas;
+  Mutex deltas_mutex;
+
+  MEM_CXX_CLASS_ALLOC_FUNCS("KeyRuntime");
+};
+
+}  // namespace blender::bke
+
 void BKE_key_free_nolib(Key *key);
 Key *BKE_key_add(Main *bmain, ID *id);
 /**
@@ -129,6 +129,33 @@ struct TrianglesCache {
   void tag_dirty();
 };
 
+/**
+ * Vertex group weights of all vertices stored contiguously, which is much faster to iterate over
+ * than the separate allocations of #MDeformVert when deforming every vertex.
+ */
+struct DeformWeights {
+  /** Offsets into #groups and #weights for every vertex, with one extra value at the end. */
+  Array<int> offsets;
+  /** Vertex group index (#MDeformWeight::def_nr) of every weight. */
+  Array<int> groups;
+  Array<float> weights;
+};
+
+/**
+ * Cache of #DeformWeights shared between a mesh and its copies made during evaluation. Changes
+ * to vertex group weights aren't tagged on the mesh, so the cache is validated with the version
+ * of the implicit sharing info of the #MDeformVert layer instead.
+ */
+struct DeformWeightsCache {
+  Mutex mutex;
+  /** Weak user of the sharing info of the layer that the weights were computed from. */
+  const ImplicitSharingInfo *sharing_info = nullptr;
+  int64_t sharing_info_version = 0;
+  std::shared_ptr<const DeformWeights> weights;
+
+  ~DeformWeightsCache();
+};
+
 struct MeshGroup {
   /** Range of unique vertices in reordered mesh. */
   IndexRange unique_verts;
@@ -277,6 +304,13 @@ struct MeshRuntime {
   /** Cache of non-manifold boundary data for shrinkwrap target Project. */
   SharedCache<ShrinkwrapBoundaryData> shrinkwrap_boundary_cache;
 
+  /**
+   * Compact vertex group weights used by the armature deformation. Only shared with copies of
+   * evaluated meshes, since original meshes may be edited without updating the layer version.
+   */
+  std::shared_ptr<DeformWeightsCache> deform_weights_cache =
+      std::make_shared<DeformWeightsCache>();
+
   /**
    * A bit vector the size of the number of vertices, set to true for the center vertices of
    * subdivided faces. The values are set by the subdivision surface modifier and used by
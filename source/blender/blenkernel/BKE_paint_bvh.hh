@@ -478,8 +478,10 @@ int BKE_pbvh_get_grid_num_faces(const Object &object);
 enum PBVHTopologyUpdateMode {
   PBVH_Subdivide = 1,
   PBVH_Collapse = 2,
+  /** Process nodes that don't share vertices on multiple threads, see #SCULPT_DYNTOPO_PARALLEL. */
+  PBVH_Parallel = 4,
 };
-ENUM_OPERATORS(PBVHTopologyUpdateMode, PBVH_Collapse);
+ENUM_OPERATORS(PBVHTopologyUpdateMode, PBVH_Parallel);
 
 namespace blender::bke::pbvh {
 
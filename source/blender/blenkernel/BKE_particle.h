@@ -11,8 +11,11 @@
 
 #include <optional>
 
+#include "BLI_array.hh"
 #include "BLI_compiler_attrs.h"
+#include "BLI_function_ref.hh"
 #include "BLI_map.hh"
+#include "BLI_math_vector.hh"
 #include "BLI_ordered_edge.hh"
 #include "BLI_vector.hh"
 
@@ -63,6 +66,64 @@ struct Scene;
 #define PARTICLE_PSMD \
   ParticleSystemModifierData *psmd = sim->psmd ? sim->psmd : psys_get_modifier(sim->ob, sim->psys)
 
+namespace blender::bke {
+
+/**
+ * Uniform grid of the alive particles of a system, for finding the neighbors within a radius in
+ * the boids and SPH fluid solvers. The cells are stored in a hash table and the particles are
+ * sorted by their slot in the table, so searches don't traverse a tree or allocate their result.
+ */
+class ParticleGrid {
+  float cell_size_ = 1.0f;
+  uint32_t slots_mask_ = 0;
+  /** Offsets into #indices_ and #positions_ for every slot of the hash table. */
+  Array<int> slot_offsets_;
+  /** Index of every particle in its system, sorted by slot. */
+  Array<int> indices_;
+  Array<float3> positions_;
+
+ public:
+  ParticleGrid() = default;
+  /**
+   * Add the alive particles, at the same positions as #psys_update_particle_tree.
+   * \param cell_size: The most common search radius works best.
+   */
+  ParticleGrid(const ParticleSystem &psys, float cfra, float cell_size);
+
+  /**
+   * Call the function with the index, position and squared distance of every particle within the
+   * radius of the position. The order is deterministic, but not sorted by distance.
+   */
+  template<typename Fn>
+  void foreach_in_radius(const float3 &position, const float radius, const Fn &fn) const
+  {
+    if (indices_.is_empty()) {
+      return;
+    }
+    const float radius_squared = radius * radius;
+    this->foreach_slot_in_bounds(position - radius, position + radius, [&](const int slot) {
+      for (int i = slot_offsets_[slot]; i < slot_offsets_[slot + 1]; i++) {
+        const float distance_squared = math::distance_squared(position, positions_[i]);
+        if (distance_squared <= radius_squared) {
+          fn(indices_[i], positions_[i], distance_squared);
+        }
+      }
+    });
+  }
+
+ private:
+  int3 cell_of(const float3 &position) const;
+  int slot_of(const int3 &cell) const;
+  /** Call the function once for every non-empty slot that contains cells within the bounds. */
+  void foreach_slot_in_bounds(const float3 &min,
+                              const float3 &max,
+                              FunctionRef<void(int slot)> fn) const;
+};
+
+using ParticleGridMap = Map<const ParticleSystem *, ParticleGrid>;
+
+}  // namespace blender::bke
+
 /* common stuff that many particle functions need */
 typedef struct ParticleSimulationData {
   struct Depsgraph *depsgraph;
@@ -77,6 +138,13 @@ typedef struct ParticleSimulationData {
   float courant_num;
   /* Only valid during dynamics_step(). */
   struct RNG *rng;
+  /**
+   * Neighbor search grids of this and the target systems, only valid during dynamics_step().
+   * Null with #PART_LEGACY_DYNAMICS, which searches the particle trees instead.
+   */
+  const blender::bke::ParticleGridMap *grids;
+  /** Grids with a cell size that fits the distance of boid fight rules, if there are any. */
+  const blender::bke::ParticleGridMap *fight_grids;
 } ParticleSimulationData;
 
 typedef struct SPHData {
@@ -84,6 +152,8 @@ typedef struct SPHData {
   ParticleData *pa;
   float mass;
   const blender::Map<blender::OrderedEdge, int> *eh;
+  /** Neighbor search grids of the systems in #psys, null to search their BVH trees instead. */
+  const blender::bke::ParticleGridMap *grids;
 
   /** The gravity as a `float[3]`, may also be null when the simulation doesn't use gravity. */
   const float *gravity;
@@ -452,7 +522,7 @@ void psys_sph_finalize(struct SPHData *sphdata);
 /**
  * Sample the density field at a point in space.
  */
-void psys_sph_density(struct BVHTree *tree, struct SPHData *data, float co[3], float vars[2]);
+void psys_sph_density(struct SPHData *data, float co[3], float vars[2]);
 
 /* For anim.c */
 
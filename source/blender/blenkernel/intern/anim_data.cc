@@ -12,6 +12,7 @@
 
 #include "BKE_action.hh"
 #include "BKE_anim_data.hh"
+#include "BKE_anim_rna_path_cache.hh"
 #include "BKE_animsys.h"
 #include "BKE_context.hh"
 #include "BKE_fcurve.hh"
@@ -227,6 +228,9 @@ void BKE_animdata_free(ID *id, const bool do_id_user)
   /* free driver array cache */
   MEM_SAFE_FREE(adt->driver_array);
 
+  /* free resolved path cache */
+  MEM_delete(adt->rna_path_cache);
+
   /* free overrides */
   /* TODO... */
 
@@ -337,6 +341,7 @@ AnimData *BKE_animdata_copy_in_lib(Main *bmain,
   /* duplicate drivers (F-Curves) */
   BKE_fcurves_copy(&dadt->drivers, &adt->drivers);
   dadt->driver_array = nullptr;
+  dadt->rna_path_cache = nullptr;
 
   /* don't copy overrides */
   BLI_listbase_clear(&dadt->overrides);
@@ -1349,6 +1354,7 @@ void BKE_animdata_blend_read_data(BlendDataReader *reader, ID *id)
   BLO_read_struct_list(reader, FCurve, &adt->drivers);
   BKE_fcurve_blend_read_data_listbase(reader, &adt->drivers);
   adt->driver_array = nullptr;
+  adt->rna_path_cache = nullptr;
 
   /* link overrides */
   /* TODO... */
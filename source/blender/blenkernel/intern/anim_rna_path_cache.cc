@@ -0,0 +1,80 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup bke
+ */
+
+#include <atomic>
+
+#include "DNA_ID.h"
+
+#include "BLI_utildefines.h"
+
+#include "BKE_anim_rna_path_cache.hh"
+
+/**
+ * Bumped whenever cached paths may have become dangling. Caches store the generation they were
+ * filled at, and drop all their items when it changed. Depsgraph evaluation orders re-copying a
+ * data-block before the evaluation of anything that reads from it, so that ordering also makes
+ * the new generation visible to the readers.
+ */
+static std::atomic<uint64_t> rna_path_cache_generation = 1;
+
+void BKE_anim_rna_path_cache_invalidate_all()
+{
+  rna_path_cache_generation.fetch_add(1, std::memory_order_release);
+}
+
+namespace blender::bke {
+
+bool AnimRNAPathCache::is_supported(const ID *id)
+{
+  if (id == nullptr || (id->tag & ID_TAG_COPIED_ON_EVAL) == 0) {
+    return false;
+  }
+  /* Geometry data-blocks are excluded because their implicitly shared arrays can be reallocated
+   * during evaluation, and scenes because the depsgraph synchronizes parts of them in place. */
+  return ELEM(GS(id->name), ID_OB, ID_KE, ID_AR);
+}
+
+void AnimRNAPathCache::ensure_valid()
+{
+  const uint64_t generation = rna_path_cache_generation.load(std::memory_order_acquire);
+  if (generation_ != generation) {
+    items_.clear();
+    generation_ = generation;
+  }
+}
+
+PathResolvedRNA *AnimRNAPathCache::lookup(const void *key,
+                                          const ID *id,
+                                          const char *rna_path,
+                                          const int array_index)
+{
+  this->ensure_valid();
+  Item *item = items_.lookup_ptr(key);
+  if (item == nullptr) {
+    return nullptr;
+  }
+  if (item->id != id || item->rna_path != rna_path || item->array_index != array_index) {
+    return nullptr;
+  }
+  return &item->resolved;
+}
+
+void AnimRNAPathCache::add(const void *key,
+                           const ID *id,
+                           const char *rna_path,
+                           const int array_index,
+                           const PathResolvedRNA &resolved)
+{
+  if (resolved.ptr.owner_id != id || !is_supported(id)) {
+    return;
+  }
+  this->ensure_valid();
+  items_.add_overwrite(key, Item{id, rna_path, array_index, resolved});
+}
+
+}  // namespace blender::bke
@@ -14,6 +14,7 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_array.hh"
 #include "BLI_bit_vector.hh"
 #include "BLI_listbase.h"
 #include "BLI_listbase_wrapper.hh"
@@ -39,6 +40,7 @@
 
 #include "BKE_action.hh"
 #include "BKE_anim_data.hh"
+#include "BKE_anim_rna_path_cache.hh"
 #include "BKE_animsys.h"
 #include "BKE_context.hh"
 #include "BKE_fcurve.hh"
@@ -393,6 +395,29 @@ bool BKE_animsys_rna_path_resolve(
   return true;
 }
 
+bool BKE_animsys_rna_path_resolve_cached(const AnimationEvalContext *anim_eval_context,
+                                         PointerRNA *ptr,
+                                         const FCurve *fcu,
+                                         PathResolvedRNA *r_result)
+{
+  blender::bke::AnimRNAPathCache *cache = anim_eval_context->rna_path_cache;
+  if (cache == nullptr || ptr->data != ptr->owner_id) {
+    return BKE_animsys_rna_path_resolve(ptr, fcu->rna_path, fcu->array_index, r_result);
+  }
+
+  const PathResolvedRNA *cached = cache->lookup(
+      fcu, ptr->owner_id, fcu->rna_path, fcu->array_index);
+  if (cached != nullptr) {
+    *r_result = *cached;
+    return true;
+  }
+  if (!BKE_animsys_rna_path_resolve(ptr, fcu->rna_path, fcu->array_index, r_result)) {
+    return false;
+  }
+  cache->add(fcu, ptr->owner_id, fcu->rna_path, fcu->array_index, *r_result);
+  return true;
+}
+
 /* less than 1.0 evaluates to false, use epsilon to avoid float error */
 #define ANIMSYS_FLOAT_AS_BOOL(value) ((value) > (1.0f - FLT_EPSILON))
 
@@ -575,20 +600,32 @@ static void animsys_evaluate_fcurves(PointerRNA *ptr,
                                      const AnimationEvalContext *anim_eval_context,
                                      bool flush_to_original)
 {
-  /* Calculate then execute each curve. */
+  /* Resolve all paths first, so that the curves can be calculated in parallel. Resolving and
+   * writing the properties is not thread-safe, and remains in the order of the curves. */
+  Vector<FCurve *> resolved_fcurves;
+  Vector<PathResolvedRNA> resolved_rna;
+  resolved_fcurves.reserve(fcurves.size());
+  resolved_rna.reserve(fcurves.size());
   for (FCurve *fcu : fcurves) {
-
     if (!is_fcurve_evaluatable(fcu)) {
       continue;
     }
 
     PathResolvedRNA anim_rna;
-    if (BKE_animsys_rna_path_resolve(ptr, fcu->rna_path, fcu->array_index, &anim_rna)) {
-      const float curval = calculate_fcurve(&anim_rna, fcu, anim_eval_context);
-      BKE_animsys_write_to_rna_path(&anim_rna, curval);
-      if (flush_to_original) {
-        animsys_write_orig_anim_rna(ptr, fcu->rna_path, fcu->array_index, curval);
-      }
+    if (BKE_animsys_rna_path_resolve_cached(anim_eval_context, ptr, fcu, &anim_rna)) {
+      resolved_fcurves.append(fcu);
+      resolved_rna.append(std::move(anim_rna));
+    }
+  }
+
+  Array<float> values(resolved_fcurves.size());
+  calculate_fcurves(resolved_fcurves, anim_eval_context, values);
+
+  for (const int i : resolved_fcurves.index_range()) {
+    const FCurve *fcu = resolved_fcurves[i];
+    BKE_animsys_write_to_rna_path(&resolved_rna[i], values[i]);
+    if (flush_to_original) {
+      animsys_write_orig_anim_rna(ptr, fcu->rna_path, fcu->array_index, values[i]);
     }
   }
 }
@@ -746,7 +783,9 @@ AnimationEvalContext BKE_animsys_eval_context_construct(Depsgraph *depsgraph, fl
 AnimationEvalContext BKE_animsys_eval_context_construct_at(
     const AnimationEvalContext *anim_eval_context, float eval_time)
 {
-  return BKE_animsys_eval_context_construct(anim_eval_context->depsgraph, eval_time);
+  AnimationEvalContext ctx = *anim_eval_context;
+  ctx.eval_time = eval_time;
+  return ctx;
 }
 
 /* Evaluate Drivers */
@@ -3980,14 +4019,27 @@ void BKE_animsys_evaluate_animdata(ID *id,
     }
 
     if (!did_nla_evaluate_anything && adt->action) {
+      /* Evaluated IDs remember the paths resolved by their active action, see
+       * #AnimRNAPathCache for when these are invalidated. */
+      AnimationEvalContext action_eval_context = *anim_eval_context;
+      if (blender::bke::AnimRNAPathCache::is_supported(id)) {
+        if (adt->rna_path_cache == nullptr) {
+          adt->rna_path_cache = MEM_new<blender::bke::AnimRNAPathCache>(__func__);
+        }
+        action_eval_context.rna_path_cache = adt->rna_path_cache;
+      }
+
       blender::animrig::Action &action = adt->action->wrap();
       if (action.is_action_layered()) {
         blender::animrig::evaluate_and_apply_action(
-            id_ptr, action, adt->slot_handle, *anim_eval_context, flush_to_original);
+            id_ptr, action, adt->slot_handle, action_eval_context, flush_to_original);
       }
       else {
-        animsys_evaluate_action(
-            &id_ptr, adt->action, animrig::Slot::unassigned, anim_eval_context, flush_to_original);
+        animsys_evaluate_action(&id_ptr,
+                                adt->action,
+                                animrig::Slot::unassigned,
+                                &action_eval_context,
+                                flush_to_original);
       }
     }
   }
@@ -40,6 +40,7 @@
 
 #include "BKE_action.hh"
 #include "BKE_anim_data.hh"
+#include "BKE_anim_rna_path_cache.hh"
 #include "BKE_anim_visualization.h"
 #include "BKE_armature.hh"
 #include "BKE_constraint.h"
@@ -2924,6 +2925,9 @@ void BKE_pose_rebuild(Main *bmain, Object *ob, bArmature *arm, const bool do_id_
   pose->flag &= ~POSE_RECALC;
   pose->flag |= POSE_WAS_REBUILT;
 
+  /* Channels may have been freed, animation paths resolved into them are dangling now. */
+  BKE_anim_rna_path_cache_invalidate_all();
+
   /* Rebuilding poses forces us to also rebuild the dependency graph,
    * since there is one node per pose/bone. */
   if (bmain != nullptr) {
@@ -22,8 +22,10 @@
 #include "BLI_math_quaternion.hh"
 #include "BLI_math_rotation.h"
 #include "BLI_math_vector.h"
+#include "BLI_offset_indices.hh"
 #include "BLI_task.h"
 #include "BLI_task.hh"
+#include "BLI_time.h"
 
 #include "DNA_armature_types.h"
 #include "DNA_lattice_types.h"
@@ -39,6 +41,7 @@
 #include "BKE_editmesh.hh"
 #include "BKE_lattice.hh"
 #include "BKE_mesh.hh"
+#include "BKE_mesh_types.hh"
 
 #include "CLG_log.h"
 
@@ -358,11 +361,135 @@ static ArmatureDeformParams get_armature_deform_params(
   return deform_params;
 }
 
+static DeformWeights calc_deform_weights(const Span<MDeformVert> dverts)
+{
+  constexpr int grain_size = 4096;
+  DeformWeights result;
+  result.offsets.reinitialize(dverts.size() + 1);
+  threading::parallel_for(dverts.index_range(), grain_size, [&](const IndexRange range) {
+    for (const int i : range) {
+      result.offsets[i] = dverts[i].totweight;
+    }
+  });
+  const OffsetIndices<int> offsets = offset_indices::accumulate_counts_to_offsets(result.offsets);
+
+  result.groups.reinitialize(offsets.total_size());
+  result.weights.reinitialize(offsets.total_size());
+  threading::parallel_for(dverts.index_range(), grain_size, [&](const IndexRange range) {
+    for (const int i : range) {
+      const Span<MDeformWeight> dweights(dverts[i].dw, dverts[i].totweight);
+      MutableSpan<int> groups = result.groups.as_mutable_span().slice(offsets[i]);
+      MutableSpan<float> weights = result.weights.as_mutable_span().slice(offsets[i]);
+      for (const int j : dweights.index_range()) {
+        groups[j] = int(dweights[j].def_nr);
+        weights[j] = dweights[j].weight;
+      }
+    }
+  });
+  return result;
+}
+
+/**
+ * Get the compact vertex group weights of an evaluated mesh. They are shared with the copies of
+ * the mesh made during evaluation, so they are usually only computed once and then reused on
+ * following frames, until the vertex group layer is changed.
+ */
+static std::shared_ptr<const DeformWeights> ensure_deform_weights(const Mesh &mesh)
+{
+  BLI_assert(mesh.id.tag & ID_TAG_NO_MAIN);
+  const int layer_index = CustomData_get_layer_index(&mesh.vert_data, CD_MDEFORMVERT);
+  if (layer_index == -1) {
+    return {};
+  }
+  const ImplicitSharingInfo *sharing_info = mesh.vert_data.layers[layer_index].sharing_info;
+  if (sharing_info == nullptr) {
+    return {};
+  }
+
+  DeformWeightsCache &cache = *mesh.runtime->deform_weights_cache;
+  std::scoped_lock lock(cache.mutex);
+  const int64_t version = sharing_info->version();
+  if (cache.weights && cache.sharing_info == sharing_info &&
+      cache.sharing_info_version == version)
+  {
+    BLI_assert(cache.weights->offsets.size() == mesh.verts_num + 1);
+    return cache.weights;
+  }
+
+  const double start_time = BLI_time_now_seconds();
+  /* Isolate the computation, since the same cache may be requested by another task that could be
+   * executed by this thread while waiting, which would deadlock. */
+  threading::isolate_task([&]() {
+    cache.weights = std::make_shared<const DeformWeights>(
+        calc_deform_weights(mesh.deform_verts()));
+  });
+  CLOG_DEBUG(&LOG,
+             "Compact vertex group weights of '%s' took %f seconds.",
+             mesh.id.name + 2,
+             BLI_time_now_seconds() - start_time);
+
+  if (cache.sharing_info != sharing_info) {
+    if (cache.sharing_info) {
+      cache.sharing_info->remove_weak_user_and_delete_if_last();
+    }
+    sharing_info->add_weak_user();
+    cache.sharing_info = sharing_info;
+  }
+  cache.sharing_info_version = version;
+  return cache.weights;
+}
+
+/* Vertex group weights of a single vertex, read from its #MDeformVert. */
+struct DVertWeights {
+  const MDeformVert *dvert = nullptr;
+
+  bool exists() const
+  {
+    return dvert != nullptr;
+  }
+
+  float find(const int def_nr) const
+  {
+    return BKE_defvert_find_weight(dvert, def_nr);
+  }
+
+  template<typename Fn> void foreach_weight(const Fn &fn) const
+  {
+    for (const MDeformWeight &dw : Span<MDeformWeight>(dvert->dw, dvert->totweight)) {
+      fn(int(dw.def_nr), dw.weight);
+    }
+  }
+};
+
+/* Vertex group weights of a single vertex, read from the compact #DeformWeights. */
+struct CompactVertWeights {
+  Span<int> groups;
+  Span<float> weights;
+
+  bool exists() const
+  {
+    return true;
+  }
+
+  float find(const int def_nr) const
+  {
+    const int64_t index = groups.first_index_try(def_nr);
+    return index == -1 ? 0.0f : weights[index];
+  }
+
+  template<typename Fn> void foreach_weight(const Fn &fn) const
+  {
+    for (const int i : groups.index_range()) {
+      fn(groups[i], weights[i]);
+    }
+  }
+};
+
 /* Accumulate bone deformations using the mixer implementation. */
-template<typename MixerT>
+template<typename MixerT, typename VertWeightsT>
 static void armature_vert_task_with_mixer(const ArmatureDeformParams &params,
                                           const int i,
-                                          const MDeformVert *dvert,
+                                          const VertWeightsT &vert_weights,
                                           MixerT &mixer)
 {
   const bool full_deform = params.vert_deform_mats.has_value();
@@ -370,8 +497,8 @@ static void armature_vert_task_with_mixer(const ArmatureDeformParams &params,
   /* Overall influence, can change by masking with a vertex group. */
   float armature_weight = 1.0f;
   float prevco_weight = 0.0f; /* weight for optional cached vertexcos */
-  if (params.armature_def_nr != -1 && dvert) {
-    const float mask_weight = BKE_defvert_find_weight(dvert, params.armature_def_nr);
+  if (params.armature_def_nr != -1 && vert_weights.exists()) {
+    const float mask_weight = vert_weights.find(params.armature_def_nr);
     /* On multi-modifier the mask is used to blend with previous coordinates. */
     if (params.vert_coords_prev) {
       prevco_weight = params.invert_vgroup ? mask_weight : 1.0f - mask_weight;
@@ -395,20 +522,17 @@ static void armature_vert_task_with_mixer(const ArmatureDeformParams &params,
   float contrib = 0.0f;
   bool deformed = false;
   /* Apply vertex group deformation if enabled. */
-  if (params.use_dverts && dvert) {
+  if (params.use_dverts && vert_weights.exists()) {
     /* Range of valid def_nr in MDeformWeight. */
     const IndexRange def_nr_range = params.pose_channel_by_vertex_group.index_range();
-    const Span<MDeformWeight> dweights(dvert->dw, dvert->totweight);
-    for (const auto &dw : dweights) {
-      const bPoseChannel *pchan = def_nr_range.contains(dw.def_nr) ?
-                                      params.pose_channel_by_vertex_group[dw.def_nr] :
+    vert_weights.foreach_weight([&](const int def_nr, float weight) {
+      const bPoseChannel *pchan = def_nr_range.contains(def_nr) ?
+                                      params.pose_channel_by_vertex_group[def_nr] :
                                       nullptr;
       if (pchan == nullptr) {
-        continue;
+        return;
       }
 
-      float weight = dw.weight;
-
       /* Bone option to mix with envelope weight. */
       const Bone *bone = pchan->bone;
       if (bone && bone->flag & BONE_MULT_VG_ENV) {
@@ -422,7 +546,7 @@ static void armature_vert_task_with_mixer(const ArmatureDeformParams &params,
 
       contrib += pchan_bone_deform(*pchan, weight, co, mixer);
       deformed = true;
-    }
+    });
   }
   /* Use envelope if enabled and no bone deformed the vertex yet. */
   if (!deformed && params.use_envelope) {
@@ -462,30 +586,31 @@ static void armature_vert_task_with_mixer(const ArmatureDeformParams &params,
 }
 
 /* Accumulate bone deformations for a vertex. */
-static void armature_vert_task_with_dvert(const ArmatureDeformParams &deform_params,
-                                          const int i,
-                                          const MDeformVert *dvert,
-                                          const bool use_quaternion)
+template<typename VertWeightsT>
+static void armature_vert_task_with_weights(const ArmatureDeformParams &deform_params,
+                                            const int i,
+                                            const VertWeightsT &vert_weights,
+                                            const bool use_quaternion)
 {
   const bool full_deform = deform_params.vert_deform_mats.has_value();
   if (use_quaternion) {
     if (full_deform) {
       bke::BoneDeformDualQuaternionMixer<true> mixer;
-      armature_vert_task_with_mixer(deform_params, i, dvert, mixer);
+      armature_vert_task_with_mixer(deform_params, i, vert_weights, mixer);
     }
     else {
       bke::BoneDeformDualQuaternionMixer<false> mixer;
-      armature_vert_task_with_mixer(deform_params, i, dvert, mixer);
+      armature_vert_task_with_mixer(deform_params, i, vert_weights, mixer);
     }
   }
   else {
     if (full_deform) {
       bke::BoneDeformLinearMixer<true> mixer;
-      armature_vert_task_with_mixer(deform_params, i, dvert, mixer);
+      armature_vert_task_with_mixer(deform_params, i, vert_weights, mixer);
     }
     else {
       bke::BoneDeformLinearMixer<false> mixer;
-      armature_vert_task_with_mixer(deform_params, i, dvert, mixer);
+      armature_vert_task_with_mixer(deform_params, i, vert_weights, mixer);
     }
   }
 }
@@ -511,12 +636,33 @@ static void armature_deform_coords(const Object &ob_arm,
                                                                   defgrp_name,
                                                                   dverts.has_value());
 
+  const bool use_weights = deform_params.use_dverts || deform_params.armature_def_nr >= 0;
+
+  /* Evaluated meshes are deformed on every frame with the same weights, so iterate over the
+   * compact weights that are cached on the mesh instead of the separately allocated weight
+   * arrays of every vertex. */
+  std::shared_ptr<const DeformWeights> compact_weights;
+  if (use_weights && me_target && dverts && (me_target->id.tag & ID_TAG_NO_MAIN)) {
+    compact_weights = ensure_deform_weights(*me_target);
+  }
+
+  const double start_time = BLI_time_now_seconds();
   const bool use_quaternion = bool(deformflag & ARM_DEF_QUATERNION);
   constexpr int grain_size = 32;
   threading::parallel_for(vert_coords.index_range(), grain_size, [&](const IndexRange range) {
+    if (compact_weights) {
+      const OffsetIndices<int> offsets = compact_weights->offsets.as_span();
+      const Span<int> groups = compact_weights->groups;
+      const Span<float> weights = compact_weights->weights;
+      for (const int i : range) {
+        const CompactVertWeights vert_weights{groups.slice(offsets[i]), weights.slice(offsets[i])};
+        armature_vert_task_with_weights(deform_params, i, vert_weights, use_quaternion);
+      }
+      return;
+    }
     for (const int i : range) {
       const MDeformVert *dvert = nullptr;
-      if (deform_params.use_dverts || deform_params.armature_def_nr >= 0) {
+      if (use_weights) {
         if (me_target) {
           BLI_assert(i < me_target->verts_num);
           if (dverts) {
@@ -528,9 +674,13 @@ static void armature_deform_coords(const Object &ob_arm,
         }
       }
 
-      armature_vert_task_with_dvert(deform_params, i, dvert, use_quaternion);
+      armature_vert_task_with_weights(deform_params, i, DVertWeights{dvert}, use_quaternion);
     }
   });
+  CLOG_DEBUG(&LOG,
+             "Armature deform of %d vertices took %f seconds.",
+             int(vert_coords.size()),
+             BLI_time_now_seconds() - start_time);
 }
 
 struct ArmatureEditMeshUserdata {
@@ -550,8 +700,8 @@ static void armature_vert_task_editmesh(void *__restrict userdata,
   const MDeformVert *dvert = use_dvert ? static_cast<const MDeformVert *>(
                                              BM_ELEM_CD_GET_VOID_P(v, data.cd_dvert_offset)) :
                                          nullptr;
-  armature_vert_task_with_dvert(
-      data.deform_params, BM_elem_index_get(v), dvert, data.use_quaternion);
+  armature_vert_task_with_weights(
+      data.deform_params, BM_elem_index_get(v), DVertWeights{dvert}, data.use_quaternion);
 }
 
 static void armature_deform_editmesh(const Object &ob_arm,
@@ -29,6 +29,7 @@
 #include "BKE_effect.h"
 #include "BKE_particle.h"
 #include "BLI_kdopbvh.hh"
+#include "BLI_math_vector.hh"
 
 #include "BLT_translation.hh"
 
@@ -399,10 +400,38 @@ static bool rule_avoid_collision(BoidRule *rule,
 
   return ret;
 }
-static bool rule_separate(BoidRule * /*rule*/,
-                          BoidBrainData *bbd,
-                          BoidValues *val,
-                          ParticleData *pa)
+/** Find the closest particle within the radius, the nearest distance is -1 if there is none. */
+static void boid_find_nearest_in_radius(const blender::bke::ParticleGrid &grid,
+                                        const float co[3],
+                                        const float radius,
+                                        const int skip_index,
+                                        int *r_index,
+                                        float r_co[3],
+                                        float *r_dist)
+{
+  using namespace blender;
+  float nearest_dist_sq = FLT_MAX;
+  *r_index = -1;
+  *r_dist = -1.0f;
+  grid.foreach_in_radius(
+      float3(co), radius, [&](const int index, const float3 &position, const float dist_sq) {
+        if (index == skip_index) {
+          return;
+        }
+        /* Smallest index on ties, to not depend on the order in the grid. */
+        if (dist_sq < nearest_dist_sq || (dist_sq == nearest_dist_sq && index < *r_index)) {
+          nearest_dist_sq = dist_sq;
+          *r_index = index;
+          copy_v3_v3(r_co, position);
+        }
+      });
+  if (*r_index != -1) {
+    *r_dist = std::sqrt(nearest_dist_sq);
+  }
+}
+
+/** Separation with the particle trees, for #PART_LEGACY_DYNAMICS. */
+static bool rule_separate_legacy(BoidBrainData *bbd, BoidValues *val, ParticleData *pa)
 {
   KDTreeNearest_3d *ptn = nullptr;
   float len = 2.0f * val->personal_space * pa->size + 1.0f;
@@ -430,8 +459,11 @@ static bool rule_separate(BoidRule * /*rule*/,
           epsys->tree, pa->prev_state.co, &ptn, 2.0f * val->personal_space * pa->size);
 
       if (neighbors > 0 && ptn[0].dist < len) {
+        /* The distance of the second neighbor is kept for existing results, but the nearest one
+         * is used when there is no second neighbor instead of reading past the end. */
+        const float dist = (neighbors > 1) ? ptn[1].dist : ptn[0].dist;
         sub_v3_v3v3(vec, pa->prev_state.co, ptn[0].co);
-        mul_v3_fl(vec, (2.0f * val->personal_space * pa->size - ptn[0].dist) / ptn[1].dist);
+        mul_v3_fl(vec, (2.0f * val->personal_space * pa->size - ptn[0].dist) / dist);
         add_v3_v3(bbd->wanted_co, vec);
         bbd->wanted_speed = val->max_speed;
         len = ptn[0].dist;
@@ -443,6 +475,70 @@ static bool rule_separate(BoidRule * /*rule*/,
   }
   return ret;
 }
+
+static bool rule_separate(BoidRule * /*rule*/,
+                          BoidBrainData *bbd,
+                          BoidValues *val,
+                          ParticleData *pa)
+{
+  if (bbd->sim->grids == nullptr) {
+    return rule_separate_legacy(bbd, val, pa);
+  }
+
+  const blender::bke::ParticleGridMap &grids = *bbd->sim->grids;
+  const float radius = 2.0f * val->personal_space * pa->size;
+  float len = radius + 1.0f;
+  float vec[3] = {0.0f, 0.0f, 0.0f};
+  float nearest_co[3];
+  float nearest_dist;
+  int nearest_index;
+  bool ret = false;
+
+  const int index = int(pa - bbd->sim->psys->particles);
+  boid_find_nearest_in_radius(grids.lookup(bbd->sim->psys),
+                              pa->prev_state.co,
+                              radius,
+                              index,
+                              &nearest_index,
+                              nearest_co,
+                              &nearest_dist);
+
+  /* The position in the grid is used rather than the current state of the neighbor, which may be
+   * written by another thread. */
+  if (nearest_dist > 0.0f) {
+    sub_v3_v3v3(vec, pa->prev_state.co, nearest_co);
+    mul_v3_fl(vec, (radius - nearest_dist) / nearest_dist);
+    add_v3_v3(bbd->wanted_co, vec);
+    bbd->wanted_speed = val->max_speed;
+    len = nearest_dist;
+    ret = true;
+  }
+
+  /* check other boid systems */
+  LISTBASE_FOREACH (ParticleTarget *, pt, &bbd->sim->psys->targets) {
+    ParticleSystem *epsys = psys_get_target_system(bbd->sim->ob, pt);
+
+    if (epsys) {
+      boid_find_nearest_in_radius(grids.lookup(epsys),
+                                  pa->prev_state.co,
+                                  radius,
+                                  -1,
+                                  &nearest_index,
+                                  nearest_co,
+                                  &nearest_dist);
+
+      if (nearest_dist > 0.0f && nearest_dist < len) {
+        sub_v3_v3v3(vec, pa->prev_state.co, nearest_co);
+        mul_v3_fl(vec, (radius - nearest_dist) / nearest_dist);
+        add_v3_v3(bbd->wanted_co, vec);
+        bbd->wanted_speed = val->max_speed;
+        len = nearest_dist;
+        ret = true;
+      }
+    }
+  }
+  return ret;
+}
 static bool rule_flock(BoidRule * /*rule*/,
                        BoidBrainData *bbd,
                        BoidValues * /*val*/,
@@ -677,20 +773,26 @@ static bool rule_average_speed(BoidRule *rule,
 
   return true;
 }
-static bool rule_fight(BoidRule *rule, BoidBrainData *bbd, BoidValues *val, ParticleData *pa)
+/** The strength of the friends and enemies around a boid, and its closest enemy. */
+struct BoidFightNeighbors {
+  float f_strength = 0.0f;
+  float e_strength = 0.0f;
+  float closest_enemy[3] = {0.0f, 0.0f, 0.0f};
+  float closest_dist = 0.0f;
+  ParticleData *enemy_pa = nullptr;
+};
+
+/** Find the fight neighbors with the particle trees, for #PART_LEGACY_DYNAMICS. */
+static void boid_fight_neighbors_legacy(const BoidRuleFight *fbr,
+                                        BoidBrainData *bbd,
+                                        ParticleData *pa,
+                                        BoidFightNeighbors &r_neighbors)
 {
-  BoidRuleFight *fbr = (BoidRuleFight *)rule;
   KDTreeNearest_3d *ptn = nullptr;
   ParticleData *epars;
-  ParticleData *enemy_pa = nullptr;
   BoidParticle *bpa;
-  /* friends & enemies */
-  float closest_enemy[3] = {0.0f, 0.0f, 0.0f};
-  float closest_dist = fbr->distance + 1.0f;
-  float f_strength = 0.0f, e_strength = 0.0f;
   float health = 0.0f;
   int n;
-  bool ret = false;
 
   /* calculate its own group strength */
   int neighbors = BLI_kdtree_3d_range_search(
@@ -700,7 +802,7 @@ static bool rule_fight(BoidRule *rule, BoidBrainData *bbd, BoidValues *val, Part
     health += bpa->data.health;
   }
 
-  f_strength += bbd->part->boids->strength * health;
+  r_neighbors.f_strength += bbd->part->boids->strength * health;
 
   MEM_SAFE_FREE(ptn);
 
@@ -718,25 +820,112 @@ static bool rule_fight(BoidRule *rule, BoidBrainData *bbd, BoidValues *val, Part
         bpa = epars[ptn[n].index].boid;
         health += bpa->data.health;
 
-        if (n == 0 && pt->mode == PTARGET_MODE_ENEMY && ptn[n].dist < closest_dist) {
-          copy_v3_v3(closest_enemy, ptn[n].co);
-          closest_dist = ptn[n].dist;
-          enemy_pa = epars + ptn[n].index;
+        if (n == 0 && pt->mode == PTARGET_MODE_ENEMY && ptn[n].dist < r_neighbors.closest_dist) {
+          copy_v3_v3(r_neighbors.closest_enemy, ptn[n].co);
+          r_neighbors.closest_dist = ptn[n].dist;
+          r_neighbors.enemy_pa = epars + ptn[n].index;
         }
       }
       if (pt->mode == PTARGET_MODE_ENEMY) {
-        e_strength += epsys->part->boids->strength * health;
+        r_neighbors.e_strength += epsys->part->boids->strength * health;
       }
       else if (pt->mode == PTARGET_MODE_FRIEND) {
-        f_strength += epsys->part->boids->strength * health;
+        r_neighbors.f_strength += epsys->part->boids->strength * health;
       }
 
       MEM_SAFE_FREE(ptn);
     }
   }
+}
+
+/** Find the fight neighbors with the grids that fit the distance of the fight rules. */
+static void boid_fight_neighbors(const BoidRuleFight *fbr,
+                                 BoidBrainData *bbd,
+                                 ParticleData *pa,
+                                 BoidFightNeighbors &r_neighbors)
+{
+  using namespace blender;
+  const bke::ParticleGridMap &grids = *bbd->sim->fight_grids;
+  float health = 0.0f;
+
+  /* calculate its own group strength */
+  grids.lookup(bbd->sim->psys)
+      .foreach_in_radius(
+          float3(pa->prev_state.co),
+          fbr->distance,
+          [&](const int index, const float3 & /*position*/, const float /*dist_sq*/) {
+            health += bbd->sim->psys->particles[index].boid->data.health;
+          });
+
+  r_neighbors.f_strength += bbd->part->boids->strength * health;
+
+  /* add other friendlies and calculate enemy strength and find closest enemy */
+  LISTBASE_FOREACH (ParticleTarget *, pt, &bbd->sim->psys->targets) {
+    ParticleSystem *epsys = psys_get_target_system(bbd->sim->ob, pt);
+    if (epsys && epsys->part->boids) {
+      ParticleData *epars = epsys->particles;
+
+      health = 0.0f;
+      float nearest_dist_sq = FLT_MAX;
+      int nearest_index = -1;
+      float3 nearest_co;
+
+      grids.lookup(epsys).foreach_in_radius(
+          float3(pa->prev_state.co),
+          fbr->distance,
+          [&](const int index, const float3 &position, const float dist_sq) {
+            health += epars[index].boid->data.health;
+            /* Smallest index on ties, to not depend on the order in the grid. */
+            if (dist_sq < nearest_dist_sq ||
+                (dist_sq == nearest_dist_sq && index < nearest_index))
+            {
+              nearest_dist_sq = dist_sq;
+              nearest_index = index;
+              nearest_co = position;
+            }
+          });
+
+      if (nearest_index != -1 && pt->mode == PTARGET_MODE_ENEMY &&
+          std::sqrt(nearest_dist_sq) < r_neighbors.closest_dist)
+      {
+        copy_v3_v3(r_neighbors.closest_enemy, nearest_co);
+        r_neighbors.closest_dist = std::sqrt(nearest_dist_sq);
+        r_neighbors.enemy_pa = epars + nearest_index;
+      }
+      if (pt->mode == PTARGET_MODE_ENEMY) {
+        r_neighbors.e_strength += epsys->part->boids->strength * health;
+      }
+      else if (pt->mode == PTARGET_MODE_FRIEND) {
+        r_neighbors.f_strength += epsys->part->boids->strength * health;
+      }
+    }
+  }
+}
+
+static bool rule_fight(BoidRule *rule, BoidBrainData *bbd, BoidValues *val, ParticleData *pa)
+{
+  BoidRuleFight *fbr = (BoidRuleFight *)rule;
+  BoidParticle *bpa;
+  /* friends & enemies */
+  BoidFightNeighbors neighbors;
+  neighbors.closest_dist = fbr->distance + 1.0f;
+  bool ret = false;
+
+  if (bbd->sim->fight_grids) {
+    boid_fight_neighbors(fbr, bbd, pa, neighbors);
+  }
+  else {
+    boid_fight_neighbors_legacy(fbr, bbd, pa, neighbors);
+  }
+
+  const float f_strength = neighbors.f_strength;
+  const float e_strength = neighbors.e_strength;
+  const float closest_dist = neighbors.closest_dist;
+  ParticleData *enemy_pa = neighbors.enemy_pa;
+
   /* decide action if enemy presence found */
   if (e_strength > 0.0f) {
-    sub_v3_v3v3(bbd->wanted_co, closest_enemy, pa->prev_state.co);
+    sub_v3_v3v3(bbd->wanted_co, neighbors.closest_enemy, pa->prev_state.co);
 
     /* attack if in range */
     if (closest_dist <= bbd->part->boids->range + pa->size + enemy_pa->size) {
@@ -751,9 +940,14 @@ static bool rule_fight(BoidRule *rule, BoidBrainData *bbd, BoidValues *val, Part
       /* must face enemy to fight */
       if (dot_v3v3(pa->prev_state.ave, enemy_dir) > 0.5f) {
         bpa = enemy_pa->boid;
-        bpa->data.health -= bbd->part->boids->strength * bbd->timestep *
-                            ((1.0f - bbd->part->boids->accuracy) * damage +
-                             bbd->part->boids->accuracy);
+        damage = bbd->part->boids->strength * bbd->timestep *
+                 ((1.0f - bbd->part->boids->accuracy) * damage + bbd->part->boids->accuracy);
+        if (bbd->damage) {
+          bbd->damage->append({bpa, damage});
+        }
+        else {
+          bpa->data.health -= damage;
+        }
       }
     }
     else {
@@ -1061,6 +1255,8 @@ void boid_brain(BoidBrainData *bbd, int p, ParticleData *pa)
   ParticleSystem *psys = bbd->sim->psys;
   int rand;
 
+  bbd->do_jump = false;
+
   if (bpa->data.health <= 0.0f) {
     pa->alive = PARS_DYING;
     pa->dietime = bbd->cfra;
@@ -1202,7 +1398,8 @@ void boid_brain(BoidBrainData *bbd, int p, ParticleData *pa)
       }
 
       if (jump) {
-        copy_v3_v3(pa->prev_state.vel, jump_v);
+        copy_v3_v3(bbd->jump_vel, jump_v);
+        bbd->do_jump = true;
         bpa->data.mode = eBoidMode_Falling;
       }
     }
@@ -1226,6 +1423,11 @@ void boid_body(BoidBrainData *bbd, ParticleData *pa)
 
   set_boid_values(&val, boids, pa);
 
+  /* The jump is only applied here, since other boids read the previous velocity while thinking. */
+  if (bbd->do_jump) {
+    copy_v3_v3(pa->prev_state.vel, bbd->jump_vel);
+  }
+
   /* make sure there's something in new velocity, location & rotation */
   copy_particle_key(&pa->state, &pa->prev_state, 0);
 
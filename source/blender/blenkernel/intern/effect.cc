@@ -11,6 +11,7 @@
 #include <cstdarg>
 #include <cstddef>
 #include <cstdlib>
+#include <mutex>
 
 #include "MEM_guardedalloc.h"
 
@@ -24,13 +25,16 @@
 #include "DNA_texture_types.h"
 
 #include "BLI_ghash.h"
+#include "BLI_hash.h"
 #include "BLI_listbase.h"
 #include "BLI_math_base_safe.h"
+#include "BLI_math_bits.h"
 #include "BLI_math_matrix.h"
 #include "BLI_math_rotation.h"
 #include "BLI_math_vector.h"
+#include "BLI_mutex.hh"
 #include "BLI_noise.h"
-#include "BLI_rand.h"
+#include "BLI_rand.hh"
 #include "BLI_string.h"
 #include "BLI_time.h"
 #include "BLI_utildefines.h"
@@ -131,7 +135,10 @@ static void precalculate_effector(Depsgraph *depsgraph, EffectorCache *eff)
   float ctime = DEG_get_ctime(depsgraph);
   uint cfra = uint(ctime >= 0 ? ctime : -ctime);
 
-  eff->rng = BLI_rng_new(eff->pd->seed + cfra);
+  eff->rng_seed = eff->pd->seed + cfra;
+  if (eff->pd->flag & PFIELD_LEGACY_NOISE) {
+    eff->legacy_rng = MEM_new<blender::RandomNumberGenerator>(__func__, eff->rng_seed);
+  }
 
   if (eff->pd->forcefield == PFIELD_GUIDE && eff->ob->type == OB_CURVES_LEGACY) {
     Curve *cu = static_cast<Curve *>(eff->ob->data);
@@ -362,9 +369,7 @@ void BKE_effectors_free(ListBase *lb)
 {
   if (lb) {
     LISTBASE_FOREACH (EffectorCache *, eff, lb) {
-      if (eff->rng) {
-        BLI_rng_free(eff->rng);
-      }
+      MEM_delete(eff->legacy_rng);
       if (eff->guide_data) {
         MEM_freeN(eff->guide_data);
       }
@@ -526,10 +531,10 @@ static float eff_calc_visibility(ListBase *colliders,
 }
 
 /* Noise function for wind e.g. */
-static float wind_func(RNG *rng, float strength)
+static float wind_func(blender::RandomNumberGenerator &rng, float strength)
 {
-  int random = (BLI_rng_get_int(rng) + 1) % 128; /* max 2357 */
-  float force = BLI_rng_get_float(rng) + 1.0f;
+  int random = (rng.get_int32() + 1) % 128; /* max 2357 */
+  float force = rng.get_float() + 1.0f;
   float ret;
   float sign = 0;
 
@@ -541,6 +546,21 @@ static float wind_func(RNG *rng, float strength)
   return ret;
 }
 
+/**
+ * Seed of the noise of an effector at a point. The location is hashed along with the index, so
+ * that points without a meaningful index, like rigid bodies, still get different values.
+ */
+static uint effector_noise_seed(const EffectorCache *eff, const EffectedPoint *point)
+{
+  const uint location_hash = BLI_hash_int_3d(float_as_uint(point->loc[0]),
+                                             float_as_uint(point->loc[1]),
+                                             float_as_uint(point->loc[2]));
+  return BLI_hash_int_3d(eff->rng_seed, uint(point->index), location_hash);
+}
+
+/* Protects the generators of effectors with legacy noise, which are shared by all points. */
+static blender::Mutex legacy_noise_mutex;
+
 /* maxdist: zero effect from this distance outwards (if usemax) */
 /* mindist: full effect up to this distance (if usemin) */
 /* power: falloff with formula 1/r^power */
@@ -949,7 +969,6 @@ static void do_physical_effector(EffectorCache *eff,
                                  float *total_force)
 {
   PartDeflect *pd = eff->pd;
-  RNG *rng = eff->rng;
   float force[3] = {0, 0, 0};
   float temp[3];
   float fac;
@@ -959,10 +978,22 @@ static void do_physical_effector(EffectorCache *eff,
   float flow_falloff = efd->falloff;
 
   if (noise_factor > 0.0f) {
-    strength += wind_func(rng, noise_factor);
-
-    if (ELEM(pd->forcefield, PFIELD_HARMONIC, PFIELD_DRAG)) {
-      damp += wind_func(rng, noise_factor);
+    if (eff->legacy_rng) {
+      /* The result depends on the order in which points are evaluated. */
+      std::scoped_lock lock(legacy_noise_mutex);
+      strength += wind_func(*eff->legacy_rng, noise_factor);
+      if (ELEM(pd->forcefield, PFIELD_HARMONIC, PFIELD_DRAG)) {
+        damp += wind_func(*eff->legacy_rng, noise_factor);
+      }
+    }
+    else {
+      /* Seed the noise per point rather than using a shared generator, so that points can be
+       * evaluated from multiple threads, with the same result regardless of the order. */
+      blender::RandomNumberGenerator rng(effector_noise_seed(eff, point));
+      strength += wind_func(rng, noise_factor);
+      if (ELEM(pd->forcefield, PFIELD_HARMONIC, PFIELD_DRAG)) {
+        damp += wind_func(rng, noise_factor);
+      }
     }
   }
 
@@ -1103,6 +1134,58 @@ static void do_physical_effector(EffectorCache *eff,
   }
 }
 
+/* Add the force of one effector to the point. */
+static void effector_apply(EffectorCache *eff,
+                           ListBase *colliders,
+                           EffectorWeights *weights,
+                           EffectedPoint *point,
+                           float *force,
+                           float *wind_force,
+                           float *impulse)
+{
+  EffectorData efd;
+  int p = 0, tot = 1, step = 1;
+
+  get_effector_tot(eff, &efd, point, &tot, &p, &step);
+
+  for (; p < tot; p += step) {
+    if (get_effector_data(eff, &efd, point, 0)) {
+      efd.falloff = effector_falloff(eff, &efd, point, weights);
+
+      if (efd.falloff > 0.0f) {
+        efd.falloff *= eff_calc_visibility(colliders, eff, &efd, point);
+      }
+      if (efd.falloff > 0.0f) {
+        float out_force[3] = {0, 0, 0};
+
+        if (eff->pd->forcefield == PFIELD_TEXTURE) {
+          do_texture_effector(eff, &efd, point, out_force);
+        }
+        else {
+          do_physical_effector(eff, &efd, point, out_force);
+
+          /* for softbody backward compatibility */
+          if (point->flag & PE_WIND_AS_SPEED && impulse) {
+            sub_v3_v3v3(impulse, impulse, out_force);
+          }
+        }
+
+        if (wind_force) {
+          madd_v3_v3fl(force, out_force, 1.0f - eff->pd->f_wind_factor);
+          madd_v3_v3fl(wind_force, out_force, eff->pd->f_wind_factor);
+        }
+        else {
+          add_v3_v3(force, out_force);
+        }
+      }
+    }
+    else if (eff->flag & PE_VELOCITY_TO_IMPULSE && impulse) {
+      /* special case for harmonic effector */
+      add_v3_v3v3(impulse, impulse, efd.vel);
+    }
+  }
+}
+
 void BKE_effectors_apply(ListBase *effectors,
                          ListBase *colliders,
                          EffectorWeights *weights,
@@ -1140,53 +1223,29 @@ void BKE_effectors_apply(ListBase *effectors,
    *   (particles are guided along a curve bezier or old nurbs)
    *   (is independent of other effectors)
    */
-  EffectorData efd;
-  int p = 0, tot = 1, step = 1;
-
   /* Cycle through collected objects, get total of (1/(gravity_strength * dist^gravity_power)) */
   /* Check for min distance here? (yes would be cool to add that, ton) */
 
   if (effectors) {
     LISTBASE_FOREACH (EffectorCache *, eff, effectors) {
       /* object effectors were fully checked to be OK to evaluate! */
+      effector_apply(eff, colliders, weights, point, force, wind_force, impulse);
+    }
+  }
+}
 
-      get_effector_tot(eff, &efd, point, &tot, &p, &step);
-
-      for (; p < tot; p += step) {
-        if (get_effector_data(eff, &efd, point, 0)) {
-          efd.falloff = effector_falloff(eff, &efd, point, weights);
-
-          if (efd.falloff > 0.0f) {
-            efd.falloff *= eff_calc_visibility(colliders, eff, &efd, point);
-          }
-          if (efd.falloff > 0.0f) {
-            float out_force[3] = {0, 0, 0};
-
-            if (eff->pd->forcefield == PFIELD_TEXTURE) {
-              do_texture_effector(eff, &efd, point, out_force);
-            }
-            else {
-              do_physical_effector(eff, &efd, point, out_force);
-
-              /* for softbody backward compatibility */
-              if (point->flag & PE_WIND_AS_SPEED && impulse) {
-                sub_v3_v3v3(impulse, impulse, out_force);
-              }
-            }
-
-            if (wind_force) {
-              madd_v3_v3fl(force, out_force, 1.0f - eff->pd->f_wind_factor);
-              madd_v3_v3fl(wind_force, out_force, eff->pd->f_wind_factor);
-            }
-            else {
-              add_v3_v3(force, out_force);
-            }
-          }
-        }
-        else if (eff->flag & PE_VELOCITY_TO_IMPULSE && impulse) {
-          /* special case for harmonic effector */
-          add_v3_v3v3(impulse, impulse, efd.vel);
-        }
+void BKE_effectors_apply_batch(ListBase *effectors,
+                               ListBase *colliders,
+                               EffectorWeights *weights,
+                               EffectedPoint *points,
+                               const int points_num,
+                               float (*forces)[3],
+                               float (*impulses)[3])
+{
+  if (effectors) {
+    LISTBASE_FOREACH (EffectorCache *, eff, effectors) {
+      for (int i = 0; i < points_num; i++) {
+        effector_apply(eff, colliders, weights, &points[i], forces[i], nullptr, impulses[i]);
       }
     }
   }
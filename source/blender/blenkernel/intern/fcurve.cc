@@ -2460,6 +2460,27 @@ float calculate_fcurve(PathResolvedRNA *anim_rna,
   return curval;
 }
 
+void calculate_fcurves(const blender::Span<FCurve *> fcurves,
+                       const AnimationEvalContext *anim_eval_context,
+                       blender::MutableSpan<float> r_values)
+{
+  using namespace blender;
+  BLI_assert(fcurves.size() == r_values.size());
+  /* Evaluating a single F-Curve is cheap, only split up larger rigs. */
+  threading::parallel_for(fcurves.index_range(), 256, [&](const IndexRange range) {
+    for (const int64_t i : range) {
+      FCurve *fcu = fcurves[i];
+      BLI_assert(fcu->driver == nullptr);
+      if (BKE_fcurve_is_empty(fcu)) {
+        r_values[i] = 0.0f;
+        continue;
+      }
+      r_values[i] = evaluate_fcurve(fcu, anim_eval_context->eval_time);
+      fcu->curval = r_values[i];
+    }
+  });
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -2610,6 +2631,7 @@ void BKE_fcurve_blend_read_data(BlendDataReader *reader, FCurve *fcu)
      * (old pointer may still be set here). */
     driver->expr_comp = nullptr;
     driver->expr_simple = nullptr;
+    driver->rna_path_cache = nullptr;
 
     /* Give the driver a fresh chance - the operating environment may be different now
      * (addons, etc. may be different) so the driver namespace may be sane now #32155. */
@@ -28,6 +28,7 @@
 #include "BLT_translation.hh"
 
 #include "BKE_action.hh"
+#include "BKE_anim_rna_path_cache.hh"
 #include "BKE_animsys.h"
 #include "BKE_armature.hh"
 #include "BKE_constraint.h"
@@ -177,9 +178,12 @@ static float dtar_get_prop_val(const AnimationEvalContext *anim_eval_context,
 
   /* Get property to resolve the target from.
    * Naming is a bit confusing, but this is what is exposed as "Prop" or "Context Property" in
-   * interface. */
-  const DriverTargetContext driver_target_context = driver_target_context_from_animation_context(
-      anim_eval_context);
+   * interface. The evaluated view layer is looked up by name, so only do that for context
+   * properties, this function runs for every target of every driver on each frame. */
+  DriverTargetContext driver_target_context = {};
+  if (dvar->type == DVAR_TYPE_CONTEXT_PROP) {
+    driver_target_context = driver_target_context_from_animation_context(anim_eval_context);
+  }
   PointerRNA property_ptr;
   if (!driver_get_target_property(&driver_target_context, dvar, dtar, &property_ptr)) {
     if (G.debug & G_DEBUG) {
@@ -191,31 +195,49 @@ static float dtar_get_prop_val(const AnimationEvalContext *anim_eval_context,
     return 0.0f;
   }
 
-  /* Get property to read from, and get value as appropriate. */
-  PointerRNA value_ptr;
-  PropertyRNA *value_prop;
-  int index = -1;
-  float value = 0.0f;
-  if (!RNA_path_resolve_property_full(
-          &property_ptr, dtar->rna_path, &value_ptr, &value_prop, &index))
-  {
-    if (dtar_try_use_fallback(dtar)) {
-      return dtar->fallback_value;
-    }
+  /* Get property to read from, and get value as appropriate. Single property targets on
+   * evaluated data-blocks remember the resolved path, see #AnimRNAPathCache. */
+  const bool use_path_cache = dvar->type == DVAR_TYPE_SINGLE_PROP &&
+                              blender::bke::AnimRNAPathCache::is_supported(dtar->id);
+  PathResolvedRNA *target = nullptr;
+  if (use_path_cache && driver->rna_path_cache) {
+    target = driver->rna_path_cache->lookup(dtar, dtar->id, dtar->rna_path, -1);
+  }
+  PathResolvedRNA resolved;
+  if (target == nullptr) {
+    if (!RNA_path_resolve_property_full(
+            &property_ptr, dtar->rna_path, &resolved.ptr, &resolved.prop, &resolved.prop_index))
+    {
+      if (dtar_try_use_fallback(dtar)) {
+        return dtar->fallback_value;
+      }
 
-    /* Path couldn't be resolved. */
-    if (G.debug & G_DEBUG) {
-      CLOG_ERROR(&LOG,
-                 "Driver Evaluation Error: cannot resolve target for %s -> %s",
-                 property_ptr.owner_id->name,
-                 dtar->rna_path);
-    }
+      /* Path couldn't be resolved. */
+      if (G.debug & G_DEBUG) {
+        CLOG_ERROR(&LOG,
+                   "Driver Evaluation Error: cannot resolve target for %s -> %s",
+                   property_ptr.owner_id->name,
+                   dtar->rna_path);
+      }
 
-    driver->flag |= DRIVER_FLAG_INVALID;
-    dtar->flag |= DTAR_FLAG_INVALID;
-    return 0.0f;
+      driver->flag |= DRIVER_FLAG_INVALID;
+      dtar->flag |= DTAR_FLAG_INVALID;
+      return 0.0f;
+    }
+    if (use_path_cache) {
+      if (driver->rna_path_cache == nullptr) {
+        driver->rna_path_cache = MEM_new<blender::bke::AnimRNAPathCache>(__func__);
+      }
+      driver->rna_path_cache->add(dtar, dtar->id, dtar->rna_path, -1, resolved);
+    }
+    target = &resolved;
   }
 
+  PointerRNA &value_ptr = target->ptr;
+  PropertyRNA *value_prop = target->prop;
+  const int index = target->prop_index;
+  float value = 0.0f;
+
   if (RNA_property_array_check(value_prop)) {
     /* Array. */
     if (index < 0 || index >= RNA_property_array_length(&value_ptr, value_prop)) {
@@ -1065,6 +1087,8 @@ void fcurve_free_driver(FCurve *fcu)
 
   BLI_expr_pylike_free(driver->expr_simple);
 
+  MEM_delete(driver->rna_path_cache);
+
   /* Free driver itself, then set F-Curve's point to this to nullptr
    * (as the curve may still be used). */
   MEM_freeN(driver);
@@ -1084,6 +1108,7 @@ ChannelDriver *fcurve_copy_driver(const ChannelDriver *driver)
   ndriver = static_cast<ChannelDriver *>(MEM_dupallocN(driver));
   ndriver->expr_comp = nullptr;
   ndriver->expr_simple = nullptr;
+  ndriver->rna_path_cache = nullptr;
 
   /* Copy variables. */
 
@@ -4011,7 +4011,7 @@ static void image_create_multilayer(Image *ima, ImBuf *ibuf, int framenr)
 
   /* only load rr once for multiview */
   if (!ima->rr) {
-    ima->rr = RE_MultilayerConvert(ibuf->userdata, colorspace, predivide, ibuf->x, ibuf->y);
+    ima->rr = RE_MultilayerConvert(ibuf->userdata, colorspace, predivide, ibuf->x, ibuf->y, true);
   }
 
   IMB_exr_close(ibuf->userdata);
@@ -4025,6 +4025,57 @@ static void image_create_multilayer(Image *ima, ImBuf *ibuf, int framenr)
   /* set proper views */
   image_init_multilayer_multiview(ima, ima->rr);
 }
+
+/* Load an EXR file through a single handle. Multi-layer files are opened without reading their
+ * pixels, the render result keeps the file open and reads every pass the first time it is
+ * accessed, so only the passes that are displayed or used by the compositor are decoded. Other
+ * files are read from the handle that was opened to test them for layers. Returns false if the
+ * file has to be loaded like any other image, r_ibuf is null for multi-layer files. */
+static bool image_load_exr_from_file(
+    Image *ima, const char *filepath, const int flag, const int framenr, ImBuf **r_ibuf)
+{
+  *r_ibuf = nullptr;
+
+  /* The color-space is determined from the file when it is loaded for the first time. */
+  const char *colorspace = ima->colorspace_settings.name;
+  if (colorspace[0] == '\0' || IMB_test_image_type(filepath) != IMB_FTYPE_OPENEXR) {
+    return false;
+  }
+
+  void *exrhandle = IMB_exr_get_handle();
+  int width, height;
+  if (!IMB_exr_begin_read(exrhandle, filepath, &width, &height, true)) {
+    IMB_exr_close(exrhandle);
+    return false;
+  }
+
+  if (!IMB_exr_has_multilayer(exrhandle)) {
+    *r_ibuf = IMB_load_image_from_exr_handle(
+        exrhandle, filepath, flag, ima->colorspace_settings.name);
+    IMB_exr_close(exrhandle);
+    return *r_ibuf != nullptr;
+  }
+
+  /* only load rr once for multiview */
+  if (ima->rr) {
+    IMB_exr_close(exrhandle);
+  }
+  else {
+    ImBuf *metadata_ibuf = IMB_allocImBuf(width, height, 32, 0);
+    IMB_exr_read_metadata(exrhandle, metadata_ibuf);
+
+    const bool predivide = (ima->alpha_mode == IMA_ALPHA_PREMUL);
+    ima->rr = RE_MultilayerConvert(exrhandle, colorspace, predivide, width, height, false);
+    ima->rr->framenr = framenr;
+    BKE_stamp_info_from_imbuf(ima->rr, metadata_ibuf);
+
+    IMB_freeImBuf(metadata_ibuf);
+  }
+
+  /* set proper views */
+  image_init_multilayer_multiview(ima, ima->rr);
+  return true;
+}
 #endif /* WITH_IMAGE_OPENEXR */
 
 /** Common stuff to do with images after loading. */
@@ -4107,6 +4158,9 @@ static ImBuf *image_load_sequence_multilayer(Image *ima, ImageUser *iuser, int e
   }
   if (ima->rr) {
     RenderPass *rpass = BKE_image_multilayer_index(ima->rr, iuser);
+    if (rpass) {
+      RE_RenderPassEnsureLoaded(ima->rr, rpass);
+    }
 
     if (rpass && rpass->ibuf) {
       ibuf = rpass->ibuf;
@@ -4277,8 +4331,21 @@ static ImBuf *load_image_single(Image *ima,
 
     BKE_image_user_file_path(&iuser_t, ima, filepath);
 
-    /* read ibuf */
-    ibuf = IMB_load_image_from_filepath(filepath, flag, ima->colorspace_settings.name);
+#ifdef WITH_IMAGE_OPENEXR
+    if (image_load_exr_from_file(ima, filepath, flag, cfra, &ibuf)) {
+      if (ibuf == nullptr) {
+        ima->type = IMA_TYPE_MULTILAYER;
+        /* Same as for multilayer images loaded below, pixels are in the RenderResult. */
+        *r_cache_ibuf = false;
+        return nullptr;
+      }
+    }
+    else
+#endif
+    {
+      /* read ibuf */
+      ibuf = IMB_load_image_from_filepath(filepath, flag, ima->colorspace_settings.name);
+    }
   }
 
   if (ibuf) {
@@ -4405,6 +4472,9 @@ static ImBuf *image_get_ibuf_multilayer(Image *ima, ImageUser *iuser)
   }
   if (ima->rr) {
     RenderPass *rpass = BKE_image_multilayer_index(ima->rr, iuser);
+    if (rpass) {
+      RE_RenderPassEnsureLoaded(ima->rr, rpass);
+    }
 
     if (rpass && rpass->ibuf) {
       ibuf = rpass->ibuf;
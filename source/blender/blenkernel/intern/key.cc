@@ -14,13 +14,16 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_index_mask.hh"
 #include "BLI_listbase.h"
 #include "BLI_math_matrix.h"
 #include "BLI_math_vector.h"
 #include "BLI_string.h"
 #include "BLI_string_utf8.h"
 #include "BLI_string_utils.hh"
+#include "BLI_task.hh"
 #include "BLI_utildefines.h"
+#include "BLI_vector.hh"
 
 #include "BLT_translation.hh"
 
@@ -50,6 +53,8 @@
 #include "BKE_mesh.hh"
 #include "BKE_scene.hh"
 
+#include "DEG_depsgraph_query.hh"
+
 #include "RNA_access.hh"
 #include "RNA_path.hh"
 #include "RNA_prototypes.hh"
@@ -58,8 +63,19 @@
 
 using blender::float3;
 using blender::float4x4;
+using blender::GrainSize;
+using blender::IndexMask;
+using blender::IndexMaskMemory;
+using blender::IndexRange;
 using blender::MutableSpan;
 using blender::Span;
+using blender::Vector;
+
+static void shapekey_init_data(ID *id)
+{
+  Key *key = (Key *)id;
+  key->runtime = new blender::bke::KeyRuntime();
+}
 
 static void shapekey_copy_data(Main * /*bmain*/,
                                std::optional<Library *> /*owner_library*/,
@@ -70,6 +86,8 @@ static void shapekey_copy_data(Main * /*bmain*/,
   Key *key_dst = (Key *)id_dst;
   const Key *key_src = (const Key *)id_src;
   BLI_duplicatelist(&key_dst->block, &key_src->block);
+  /* The cached offsets are keyed by key-block, they are not shared with the copy. */
+  key_dst->runtime = new blender::bke::KeyRuntime();
 
   KeyBlock *kb_dst, *kb_src;
   for (kb_src = static_cast<KeyBlock *>(key_src->block.first),
@@ -95,6 +113,8 @@ static void shapekey_free_data(ID *id)
     }
     MEM_freeN(kb);
   }
+  delete key->runtime;
+  key->runtime = nullptr;
 }
 
 static void shapekey_foreach_id(ID *id, LibraryForeachIDData *data)
@@ -157,6 +177,8 @@ static void shapekey_blend_read_data(BlendDataReader *reader, ID *id)
 
   BLO_read_struct(reader, KeyBlock, &key->refkey);
 
+  key->runtime = new blender::bke::KeyRuntime();
+
   LISTBASE_FOREACH (KeyBlock *, kb, &key->block) {
     BLO_read_data_address(reader, &kb->data);
 
@@ -187,7 +209,7 @@ IDTypeInfo IDType_ID_KE = {
     /*flags*/ IDTYPE_FLAGS_NO_LIBLINKING,
     /*asset_type_info*/ nullptr,
 
-    /*init_data*/ nullptr,
+    /*init_data*/ shapekey_init_data,
     /*copy_data*/ shapekey_copy_data,
     /*free_data*/ shapekey_free_data,
     /*make_local*/ nullptr,
@@ -225,6 +247,8 @@ void BKE_key_free_nolib(Key *key)
     }
     MEM_freeN(kb);
   }
+  delete key->runtime;
+  key->runtime = nullptr;
 }
 
 Key *BKE_key_add(Main *bmain, ID *id) /* common function */
@@ -1241,6 +1265,173 @@ static void do_key(const int start,
   }
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Coordinate Key Evaluation
+ *
+ * Mesh and lattice keys store a single coordinate per element, so they can be evaluated in
+ * parallel over ranges of elements. Relative keys are evaluated from the sparse offsets of their
+ * key-blocks (see #blender::bke::KeyBlockDeltas), which are accumulated in the order of the
+ * key-blocks for every element, giving the same result as #key_evaluate_relative.
+ * \{ */
+
+static void keyblock_deltas_calc(const Span<float3> data,
+                                 const Span<float3> ref_data,
+                                 blender::bke::KeyBlockDeltas &r_deltas)
+{
+  IndexMaskMemory memory;
+  const IndexMask mask = IndexMask::from_predicate(
+      data.index_range(), GrainSize(4096), memory, [&](const int i) {
+        return data[i] != ref_data[i];
+      });
+
+  r_deltas.indices.reinitialize(mask.size());
+  r_deltas.deltas.reinitialize(mask.size());
+  mask.to_indices(r_deltas.indices.as_mutable_span());
+  mask.foreach_index(GrainSize(4096), [&](const int i, const int pos) {
+    r_deltas.deltas[pos] = data[i] - ref_data[i];
+  });
+}
+
+static const blender::bke::KeyBlockDeltas &keyblock_deltas_cached_ensure(
+    Key &key, const KeyBlock &kb, const Span<float3> data, const Span<float3> ref_data)
+{
+  using blender::bke::KeyBlockDeltas;
+  blender::bke::KeyRuntime &runtime = *key.runtime;
+  {
+    std::scoped_lock lock(runtime.deltas_mutex);
+    if (const std::unique_ptr<KeyBlockDeltas> *deltas = runtime.deltas.lookup_ptr(&kb)) {
+      return **deltas;
+    }
+  }
+
+  /* Compute without holding the lock, objects sharing the same geometry may be evaluated at the
+   * same time. The first result to be added is used. */
+  std::unique_ptr<KeyBlockDeltas> deltas = std::make_unique<KeyBlockDeltas>();
+  keyblock_deltas_calc(data, ref_data, *deltas);
+
+  std::scoped_lock lock(runtime.deltas_mutex);
+  return *runtime.deltas.lookup_or_add(&kb, std::move(deltas));
+}
+
+static void key_evaluate_relative_coords(Key *key,
+                                         KeyBlock *actkb,
+                                         float **per_keyblock_weights,
+                                         MutableSpan<float3> out)
+{
+  using blender::bke::KeyBlockDeltas;
+  BLI_assert(key->elemsize == sizeof(float3));
+  const int tot = int(out.size());
+
+  cp_key(0, tot, tot, (char *)out.data(), key, actkb, key->refkey, nullptr, KEY_MODE_DUMMY);
+
+  /* Evaluated copies are copied again from the original when the shape key data changes, so the
+   * offsets can be cached there. */
+  const bool use_cache = key->runtime != nullptr && DEG_is_evaluated(key);
+
+  struct WeightedDeltas {
+    const KeyBlockDeltas *deltas;
+    const float *weights;
+    float value;
+  };
+  Vector<WeightedDeltas> blocks;
+  /* Offsets which could not be cached, freed after evaluation. */
+  Vector<std::unique_ptr<KeyBlockDeltas>> uncached_deltas;
+
+  int keyblock_index;
+  LISTBASE_FOREACH_INDEX (KeyBlock *, kb, &key->block, keyblock_index) {
+    if (kb == key->refkey || (kb->flag & KEYBLOCK_MUTE) || kb->curval == 0.0f ||
+        kb->totelem != tot)
+    {
+      continue;
+    }
+    const KeyBlock *refb = static_cast<const KeyBlock *>(BLI_findlink(&key->block, kb->relative));
+    if (refb == nullptr) {
+      continue;
+    }
+
+    char *freefrom;
+    const char *from = key_block_get_data(key, actkb, kb, &freefrom);
+    const Span<float3> data(reinterpret_cast<const float3 *>(from), tot);
+    /* For meshes, use the original values instead of the bmesh values to
+     * maintain a constant offset. */
+    const Span<float3> ref_data(static_cast<const float3 *>(refb->data), tot);
+
+    const KeyBlockDeltas *deltas;
+    if (use_cache && freefrom == nullptr) {
+      deltas = &keyblock_deltas_cached_ensure(*key, *kb, data, ref_data);
+    }
+    else {
+      /* Edit-mode coordinates of the active key change without the key being copied again. */
+      uncached_deltas.append(std::make_unique<KeyBlockDeltas>());
+      keyblock_deltas_calc(data, ref_data, *uncached_deltas.last());
+      deltas = uncached_deltas.last().get();
+    }
+
+    if (freefrom) {
+      MEM_freeN(freefrom);
+    }
+    if (deltas->indices.is_empty()) {
+      continue;
+    }
+    blocks.append({deltas,
+                   per_keyblock_weights ? per_keyblock_weights[keyblock_index] : nullptr,
+                   kb->curval});
+  }
+
+  if (blocks.is_empty()) {
+    return;
+  }
+
+  blender::threading::parallel_for(out.index_range(), 4096, [&](const IndexRange range) {
+    for (const WeightedDeltas &block : blocks) {
+      const Span<int> indices = block.deltas->indices;
+      const Span<float3> deltas = block.deltas->deltas;
+      const int64_t first = std::lower_bound(indices.begin(), indices.end(), range.first()) -
+                            indices.begin();
+      for (int64_t i = first; i < indices.size() && indices[i] <= range.last(); i++) {
+        const int elem = indices[i];
+        const float weight = block.weights ? block.weights[elem] * block.value : block.value;
+        out[elem] += weight * deltas[i];
+      }
+    }
+  });
+}
+
+static void do_key_coords(
+    Key *key, KeyBlock *actkb, KeyBlock **k, float t[4], char *out, const int tot)
+{
+  BLI_assert(key->elemsize == sizeof(float3));
+  if (k[0]->totelem != tot || k[1]->totelem != tot || k[2]->totelem != tot ||
+      k[3]->totelem != tot)
+  {
+    /* Keys with a different number of elements are resampled. */
+    do_key(0, tot, tot, out, key, actkb, k, t, KEY_MODE_DUMMY);
+    return;
+  }
+
+  char *freek[4];
+  const float3 *data[4];
+  for (const int i : IndexRange(4)) {
+    data[i] = reinterpret_cast<const float3 *>(key_block_get_data(key, actkb, k[i], &freek[i]));
+  }
+
+  MutableSpan<float3> positions(reinterpret_cast<float3 *>(out), tot);
+  blender::threading::parallel_for(positions.index_range(), 4096, [&](const IndexRange range) {
+    for (const int i : range) {
+      positions[i] = t[0] * data[0][i] + t[1] * data[1][i] + t[2] * data[2][i] +
+                     t[3] * data[3][i];
+    }
+  });
+
+  for (const int i : IndexRange(4)) {
+    if (freek[i]) {
+      MEM_freeN(freek[i]);
+    }
+  }
+}
+
+/** \} */
+
 static float *get_weights_array(Object *ob, const char *vgroup, WeightsArrayCache *cache)
 {
   const MDeformVert *dvert = nullptr;
@@ -1372,7 +1563,8 @@ static void do_mesh_key(Object *ob, Key *key, char *out, const int tot)
     WeightsArrayCache cache = {0, nullptr};
     float **per_keyblock_weights;
     per_keyblock_weights = keyblock_get_per_block_weights(ob, key, &cache);
-    key_evaluate_relative(0, tot, tot, out, key, actkb, per_keyblock_weights, KEY_MODE_DUMMY);
+    key_evaluate_relative_coords(
+        key, actkb, per_keyblock_weights, MutableSpan(reinterpret_cast<float3 *>(out), tot));
     keyblock_free_per_block_weights(key, per_keyblock_weights, &cache);
   }
   else {
@@ -1381,7 +1573,7 @@ static void do_mesh_key(Object *ob, Key *key, char *out, const int tot)
     flag = setkeys(ctime_scaled, &key->block, k, t, 0);
 
     if (flag == 0) {
-      do_key(0, tot, tot, out, key, actkb, k, t, KEY_MODE_DUMMY);
+      do_key_coords(key, actkb, k, t, out, tot);
     }
     else {
       cp_key(0, tot, tot, out, key, actkb, k[2], nullptr, KEY_MODE_DUMMY);
@@ -1464,7 +1656,8 @@ static void do_latt_key(Object *ob, Key *key, char *out, const int tot)
   if (key->type == KEY_RELATIVE) {
     float **per_keyblock_weights;
     per_keyblock_weights = keyblock_get_per_block_weights(ob, key, nullptr);
-    key_evaluate_relative(0, tot, tot, out, key, actkb, per_keyblock_weights, KEY_MODE_DUMMY);
+    key_evaluate_relative_coords(
+        key, actkb, per_keyblock_weights, MutableSpan(reinterpret_cast<float3 *>(out), tot));
     keyblock_free_per_block_weights(key, per_keyblock_weights, nullptr);
   }
   else {
@@ -1473,7 +1666,7 @@ static void do_latt_key(Object *ob, Key *key, char *out, const int tot)
     flag = setkeys(ctime_scaled, &key->block, k, t, 0);
 
     if (flag == 0) {
-      do_key(0, tot, tot, out, key, actkb, k, t, KEY_MODE_DUMMY);
+      do_key_coords(key, actkb, k, t, out, tot);
     }
     else {
       cp_key(0, tot, tot, out, key, actkb, k[2], nullptr, KEY_MODE_DUMMY);
@@ -198,6 +198,10 @@ static void mesh_copy_data(Main *bmain,
     if (const blender::bke::EditMeshData *edit_data = mesh_src->runtime->edit_data.get()) {
       mesh_dst->runtime->edit_data = std::make_unique<blender::bke::EditMeshData>(*edit_data);
     }
+
+    /* Evaluated vertex group weights are only changed through the layer's sharing info, which
+     * makes it possible to validate the cache, see #DeformWeightsCache. */
+    mesh_dst->runtime->deform_weights_cache = mesh_src->runtime->deform_weights_cache;
   }
 
   mesh_dst->mat = (Material **)MEM_dupallocN(mesh_src->mat);
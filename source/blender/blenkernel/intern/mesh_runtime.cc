@@ -59,6 +59,13 @@ static void free_bvh_caches(MeshRuntime &mesh_runtime)
   mesh_runtime.bvh_cache_loose_edges_no_hidden.tag_dirty();
 }
 
+DeformWeightsCache::~DeformWeightsCache()
+{
+  if (sharing_info) {
+    sharing_info->remove_weak_user_and_delete_if_last();
+  }
+}
+
 MeshRuntime::MeshRuntime() = default;
 
 MeshRuntime::~MeshRuntime()
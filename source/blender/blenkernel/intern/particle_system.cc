@@ -12,6 +12,7 @@
 #include <cstddef>
 #include <cstdlib>
 #include <cstring>
+#include <mutex>
 
 #include "MEM_guardedalloc.h"
 
@@ -27,6 +28,9 @@
 #include "DNA_scene_types.h"
 #include "DNA_texture_types.h"
 
+#include "BLI_array.hh"
+#include "BLI_hash.h"
+#include "BLI_index_mask.hh"
 #include "BLI_kdopbvh.hh"
 #include "BLI_kdtree.h"
 #include "BLI_linklist.h"
@@ -35,11 +39,14 @@
 #include "BLI_math_matrix.h"
 #include "BLI_math_rotation.h"
 #include "BLI_math_vector.h"
+#include "BLI_mutex.hh"
 #include "BLI_rand.h"
 #include "BLI_string.h"
 #include "BLI_string_utils.hh"
 #include "BLI_task.h"
+#include "BLI_task.hh"
 #include "BLI_threads.h"
+#include "BLI_time.h"
 #include "BLI_utildefines.h"
 #include "BLI_vector.hh"
 
@@ -65,6 +72,8 @@
 #include "DEG_depsgraph.hh"
 #include "DEG_depsgraph_query.hh"
 
+#include "CLG_log.h"
+
 /* FLUID sim particle import */
 #ifdef WITH_FLUID
 #  include "DNA_fluid_types.h"
@@ -73,6 +82,8 @@
 
 static ThreadRWMutex psys_bvhtree_rwlock = BLI_RWLOCK_INITIALIZER;
 
+static CLG_LogRef LOG = {"physics.particles"};
+
 /************************************************/
 /*          Reacting to system events           */
 /************************************************/
@@ -1312,6 +1323,7 @@ static void bvhtree_balance_isolated(void *userdata)
 /*          Effectors                           */
 /************************************************/
 
+/* Only used by SPH fluids with #PART_LEGACY_DYNAMICS, others use #blender::bke::ParticleGrid. */
 static void psys_update_particle_bvhtree(ParticleSystem *psys, float cfra)
 {
   if (psys) {
@@ -1385,6 +1397,108 @@ void psys_update_particle_tree(ParticleSystem *psys, float cfra)
   }
 }
 
+namespace blender::bke {
+
+/* Large enough for any reasonable scene, while avoiding overflow when converting to cells. */
+static constexpr float particle_grid_max_cell = float(1 << 30);
+
+ParticleGrid::ParticleGrid(const ParticleSystem &psys, const float cfra, const float cell_size)
+{
+  cell_size_ = cell_size > FLT_EPSILON ? cell_size : 1.0f;
+
+  const Span<ParticleData> particles(psys.particles, psys.totpart);
+  IndexMaskMemory memory;
+  const IndexMask mask = IndexMask::from_predicate(
+      particles.index_range(), GrainSize(4096), memory, [&](const int p) {
+        const ParticleData &pa = particles[p];
+        return (pa.flag & (PARS_UNEXIST | PARS_NO_DISP)) == 0 && pa.alive == PARS_ALIVE;
+      });
+
+  const int slots_num = int(power_of_2_max_u(uint(std::max<int64_t>(mask.size() * 2, 1))));
+  slots_mask_ = uint32_t(slots_num - 1);
+
+  Array<float3> positions(mask.size());
+  Array<int> slots(mask.size());
+  mask.foreach_index(GrainSize(4096), [&](const int p, const int pos) {
+    const ParticleData &pa = particles[p];
+    positions[pos] = float3((pa.state.time == cfra) ? pa.prev_state.co : pa.state.co);
+    slots[pos] = this->slot_of(this->cell_of(positions[pos]));
+  });
+
+  /* Counting sort by slot, which keeps the order of the particles within every slot. */
+  slot_offsets_.reinitialize(slots_num + 1);
+  slot_offsets_.fill(0);
+  for (const int slot : slots) {
+    slot_offsets_[slot]++;
+  }
+  offset_indices::accumulate_counts_to_offsets(slot_offsets_);
+
+  Array<int> fill_offsets(slot_offsets_.as_span().drop_back(1));
+  indices_.reinitialize(mask.size());
+  positions_.reinitialize(mask.size());
+  mask.foreach_index([&](const int p, const int pos) {
+    const int i = fill_offsets[slots[pos]]++;
+    indices_[i] = p;
+    positions_[i] = positions[pos];
+  });
+}
+
+int3 ParticleGrid::cell_of(const float3 &position) const
+{
+  const float3 cell = math::clamp(math::floor(position / cell_size_),
+                                  float3(-particle_grid_max_cell),
+                                  float3(particle_grid_max_cell));
+  return int3(cell);
+}
+
+int ParticleGrid::slot_of(const int3 &cell) const
+{
+  const uint32_t hash = (uint32_t(cell.x) * 73856093u) ^ (uint32_t(cell.y) * 19349663u) ^
+                        (uint32_t(cell.z) * 83492791u);
+  return int(hash & slots_mask_);
+}
+
+void ParticleGrid::foreach_slot_in_bounds(const float3 &min,
+                                          const float3 &max,
+                                          const FunctionRef<void(int slot)> fn) const
+{
+  const int3 min_cell = this->cell_of(min);
+  const int3 max_cell = this->cell_of(max);
+  const int64_t cells_num = (int64_t(max_cell.x) - min_cell.x + 1) *
+                            (int64_t(max_cell.y) - min_cell.y + 1) *
+                            (int64_t(max_cell.z) - min_cell.z + 1);
+  const int slots_num = slot_offsets_.size() - 1;
+  if (cells_num >= slots_num) {
+    /* Visiting every slot is cheaper than hashing all cells in the bounds. */
+    for (const int slot : IndexRange(slots_num)) {
+      if (slot_offsets_[slot] != slot_offsets_[slot + 1]) {
+        fn(slot);
+      }
+    }
+    return;
+  }
+
+  /* Different cells can share a slot, which must only be visited once. */
+  Vector<int, 64> slots;
+  for (int z = min_cell.z; z <= max_cell.z; z++) {
+    for (int y = min_cell.y; y <= max_cell.y; y++) {
+      for (int x = min_cell.x; x <= max_cell.x; x++) {
+        const int slot = this->slot_of(int3(x, y, z));
+        if (slot_offsets_[slot] != slot_offsets_[slot + 1]) {
+          slots.append(slot);
+        }
+      }
+    }
+  }
+  std::sort(slots.begin(), slots.end());
+  const int *slots_end = std::unique(slots.begin(), slots.end());
+  for (const int *slot = slots.begin(); slot != slots_end; slot++) {
+    fn(*slot);
+  }
+}
+
+}  // namespace blender::bke
+
 static void psys_update_effectors(ParticleSimulationData *sim)
 {
   BKE_effectors_free(sim->psys->effectors);
@@ -1680,25 +1794,36 @@ struct SPHRangeData {
   int use_size;
 };
 
-static void sph_evaluate_func(BVHTree *tree,
+static void sph_evaluate_func(const blender::bke::ParticleGridMap *grids,
                               ParticleSystem **psys,
                               const float co[3],
                               SPHRangeData *pfr,
                               float interaction_radius,
                               BVHTree_RangeQuery callback)
 {
+  using namespace blender;
   int i;
 
   pfr->tot_neighbors = 0;
 
   for (i = 0; i < 10 && psys[i]; i++) {
+    const bke::ParticleGrid *grid = grids ? grids->lookup_ptr(psys[i]) : nullptr;
+    if (grids && grid == nullptr) {
+      continue;
+    }
+
     pfr->npsys = psys[i];
     pfr->massfac = psys[i]->part->mass / pfr->mass;
     pfr->use_size = psys[i]->part->flag & PART_SIZEMASS;
 
-    if (tree) {
-      BLI_bvhtree_range_query(tree, co, interaction_radius, callback, pfr);
-      break;
+    if (grid) {
+      grid->foreach_in_radius(
+          float3(co),
+          interaction_radius,
+          [&](const int index, const float3 &position, const float distance_squared) {
+            callback(pfr, index, position, distance_squared);
+          });
+      continue;
     }
 
     BLI_rw_mutex_lock(&psys_bvhtree_rwlock, THREAD_LOCK_READ);
@@ -1825,7 +1950,8 @@ static void sph_force_cb(void *sphdata_v, ParticleKey *state, float *force, floa
   pfr.pa = pa;
   pfr.mass = sphdata->mass;
 
-  sph_evaluate_func(nullptr, psys, state->co, &pfr, interaction_radius, sph_density_accum_cb);
+  sph_evaluate_func(
+      sphdata->grids, psys, state->co, &pfr, interaction_radius, sph_density_accum_cb);
 
   density = data[0];
   near_density = data[1];
@@ -2018,7 +2144,7 @@ static void sphclassical_force_cb(void *sphdata_v,
   pfr.pa = pa;
 
   sph_evaluate_func(
-      nullptr, psys, state->co, &pfr, interaction_radius, sphclassical_neighbor_accum_cb);
+      sphdata->grids, psys, state->co, &pfr, interaction_radius, sphclassical_neighbor_accum_cb);
   pressure = stiffness * (pow7f(pa->sphdensity / rest_density) - 1.0f);
 
   /* Multiply by mass so that we return a force, not acceleration. */
@@ -2101,8 +2227,12 @@ static void sphclassical_calc_dens(ParticleData *pa, float /*dfra*/, SPHData *sp
   pfr.pa = pa;
   pfr.mass = sphdata->mass;
 
-  sph_evaluate_func(
-      nullptr, psys, pa->state.co, &pfr, interaction_radius, sphclassical_density_accum_cb);
+  sph_evaluate_func(sphdata->grids,
+                    psys,
+                    pa->state.co,
+                    &pfr,
+                    interaction_radius,
+                    sphclassical_density_accum_cb);
   pa->sphdensity = min_ff(max_ff(data[0], fluid->rest_density * 0.9f), fluid->rest_density * 1.1f);
 }
 
@@ -2129,6 +2259,7 @@ static void psys_sph_init(ParticleSimulationData *sim,
   }
   r_eh = sph_springhash_build(sim->psys);
   sphdata->eh = &r_eh;
+  sphdata->grids = sim->grids;
 
   /* These per-particle values should be overridden later, but just for
    * completeness we give them default values now. */
@@ -2163,7 +2294,7 @@ void psys_sph_finalize(SPHData *sphdata)
   psys_sph_flush_springs(sphdata);
 }
 
-void psys_sph_density(BVHTree *tree, SPHData *sphdata, float co[3], float vars[2])
+void psys_sph_density(SPHData *sphdata, float co[3], float vars[2])
 {
   ParticleSystem **psys = sphdata->psys;
   SPHFluidSettings *fluid = psys[0]->part->fluid;
@@ -2178,7 +2309,7 @@ void psys_sph_density(BVHTree *tree, SPHData *sphdata, float co[3], float vars[2
   pfr.h = interaction_radius * sphdata->hfac;
   pfr.mass = sphdata->mass;
 
-  sph_evaluate_func(tree, psys, co, &pfr, interaction_radius, sphdata->density_cb);
+  sph_evaluate_func(sphdata->grids, psys, co, &pfr, interaction_radius, sphdata->density_cb);
 
   vars[0] = pfr.data[0];
   vars[1] = pfr.data[1];
@@ -2216,11 +2347,27 @@ static void sph_integrate(ParticleSimulationData *sim,
 /*          Basic physics                       */
 /************************************************/
 
+/** Effector forces on a particle at the start of a step, see #effector_forces_batch. */
+struct BatchedEffectorForces {
+  float force[3];
+  float impulse[3];
+  /** Angular velocity of a particle with dynamic rotation, modified by the effectors. */
+  float ave[3];
+};
+
 struct EfData {
   ParticleTexture ptex;
   ParticleSimulationData *sim;
   ParticleData *pa;
+  /** Forces for the first integration step, when the effectors were evaluated in a batch. */
+  const BatchedEffectorForces *batched;
 };
+
+static bool psys_uses_effectors(const ParticleSettings *part)
+{
+  return part->type != PART_HAIR || part->effector_weights->flag & EFF_WEIGHT_DO_HAIR;
+}
+
 static void basic_force_cb(void *efdata_v, ParticleKey *state, float *force, float *impulse)
 {
   EfData *efdata = (EfData *)efdata_v;
@@ -2232,7 +2379,16 @@ static void basic_force_cb(void *efdata_v, ParticleKey *state, float *force, flo
 
   /* add effectors */
   pd_point_from_particle(efdata->sim, efdata->pa, state, &epoint);
-  if (part->type != PART_HAIR || part->effector_weights->flag & EFF_WEIGHT_DO_HAIR) {
+  if (efdata->batched) {
+    add_v3_v3(force, efdata->batched->force);
+    add_v3_v3(impulse, efdata->batched->impulse);
+    if (epoint.ave) {
+      copy_v3_v3(epoint.ave, efdata->batched->ave);
+    }
+    /* Later integration steps evaluate the effectors at their own state. */
+    efdata->batched = nullptr;
+  }
+  else if (psys_uses_effectors(part)) {
     BKE_effectors_apply(sim->psys->effectors,
                         sim->colliders,
                         part->effector_weights,
@@ -2261,8 +2417,15 @@ static void basic_force_cb(void *efdata_v, ParticleKey *state, float *force, flo
     copy_v3_v3(pa->state.ave, epoint.ave);
   }
 }
-/* gathers all forces that effect particles and calculates a new state for the particle */
-static void basic_integrate(ParticleSimulationData *sim, int p, float dfra, float cfra)
+/**
+ * Gathers all forces that effect particles and calculates a new state for the particle.
+ * \param batched: The effector forces at the start of the step, if they were already evaluated.
+ */
+static void basic_integrate(ParticleSimulationData *sim,
+                            int p,
+                            float dfra,
+                            float cfra,
+                            const BatchedEffectorForces *batched = nullptr)
 {
   ParticleSettings *part = sim->psys->part;
   ParticleData *pa = sim->psys->particles + p;
@@ -2275,6 +2438,7 @@ static void basic_integrate(ParticleSimulationData *sim, int p, float dfra, floa
 
   efdata.pa = pa;
   efdata.sim = sim;
+  efdata.batched = batched;
 
   /* add global acceleration (gravitation) */
   if (psys_uses_gravity(sim) &&
@@ -3805,6 +3969,273 @@ static void dynamics_step_sph_classical_integrate_task_cb_ex(void *__restrict us
   }
 }
 
+/**
+ * Build the neighbor search grids of the system and its targets, with a cell size that fits the
+ * search radius of the system.
+ */
+static void psys_update_particle_grids(const ParticleSimulationData *sim,
+                                       const float cfra,
+                                       const float cell_size,
+                                       blender::bke::ParticleGridMap &grids)
+{
+  using namespace blender;
+  Vector<const ParticleSystem *, 10> systems = {sim->psys};
+  LISTBASE_FOREACH (ParticleTarget *, pt, &sim->psys->targets) {
+    const ParticleSystem *psys_target = psys_get_target_system(sim->ob, pt);
+    if (psys_target) {
+      systems.append_non_duplicates(psys_target);
+    }
+  }
+
+  Array<bke::ParticleGrid> built_grids(systems.size());
+  threading::parallel_for(systems.index_range(), 1, [&](const IndexRange range) {
+    for (const int i : range) {
+      built_grids[i] = bke::ParticleGrid(*systems[i], cfra, cell_size);
+    }
+  });
+  for (const int i : systems.index_range()) {
+    grids.add_new(systems[i], std::move(built_grids[i]));
+  }
+}
+
+/**
+ * Whether the particles of a system have to be simulated one after the other, so that the result
+ * doesn't depend on the number of threads. A system that is its own effector reads the states of
+ * its particles while they are written, and effectors with legacy noise share one random sequence
+ * for all particles.
+ */
+static bool psys_effectors_need_serial(const ParticleSystem *psys)
+{
+  if (psys->effectors == nullptr) {
+    return false;
+  }
+  LISTBASE_FOREACH (const EffectorCache *, eff, psys->effectors) {
+    if (eff->psys == psys || eff->legacy_rng) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Evaluate the effectors at the start of the step for all dynamic particles in the range at once.
+ * Every effector is applied to all particles before the next one, which keeps its data in cache.
+ */
+static void effector_forces_batch(ParticleSimulationData *sim,
+                                  const blender::IndexRange range,
+                                  blender::MutableSpan<BatchedEffectorForces> r_forces)
+{
+  using namespace blender;
+  ParticleSystem *psys = sim->psys;
+  ParticleSettings *part = psys->part;
+
+  Vector<int, 256> indices;
+  Array<ParticleKey, 256> keys(range.size());
+  Array<EffectedPoint, 256> points(range.size());
+  for (const int p : range) {
+    ParticleData *pa = &psys->particles[p];
+    if (pa->state.time <= 0.0f) {
+      continue;
+    }
+    /* The same state as the first step of #integrate_particle. */
+    ParticleKey &key = keys[indices.size()];
+    copy_particle_key(&key, &pa->state, 1);
+    copy_v3_v3(key.ave, pa->prev_state.ave);
+    key.time = 0.0f;
+    pd_point_from_particle(sim, pa, &key, &points[indices.size()]);
+    indices.append(p);
+  }
+
+  Array<float3, 256> forces(indices.size(), float3(0.0f));
+  Array<float3, 256> impulses(indices.size(), float3(0.0f));
+  BKE_effectors_apply_batch(psys->effectors,
+                            sim->colliders,
+                            part->effector_weights,
+                            points.data(),
+                            int(indices.size()),
+                            reinterpret_cast<float(*)[3]>(forces.data()),
+                            reinterpret_cast<float(*)[3]>(impulses.data()));
+
+  for (const int i : indices.index_range()) {
+    BatchedEffectorForces &batched = r_forces[indices[i] - range.start()];
+    copy_v3_v3(batched.force, forces[i]);
+    copy_v3_v3(batched.impulse, impulses[i]);
+    copy_v3_v3(batched.ave, keys[i].ave);
+  }
+}
+
+/**
+ * Integrate the particles independently of each other. The random numbers are seeded per
+ * particle, so that the result doesn't depend on the number of threads.
+ */
+static void dynamics_step_newton(ParticleSimulationData *sim,
+                                 const float cfra,
+                                 const float timestep,
+                                 const uint seed)
+{
+  using namespace blender;
+  ParticleSystem *psys = sim->psys;
+  ParticleSettings *part = psys->part;
+  PARTICLE_P;
+
+  if (part->flag & PART_LEGACY_DYNAMICS) {
+    /* The random sequence is shared by all particles, so they are integrated in order. */
+    LOOP_DYNAMIC_PARTICLES
+    {
+      /* do global forces & effectors */
+      basic_integrate(sim, p, pa->state.time, cfra);
+
+      /* deflection */
+      if (sim->colliders) {
+        collision_check(sim, p, pa->state.time, cfra);
+      }
+
+      /* rotations */
+      basic_rotate(part, pa, pa->state.time, timestep);
+    }
+    return;
+  }
+
+  const bool use_serial = psys_effectors_need_serial(psys);
+  /* Batches evaluate the effectors for a particle before the previous ones moved, which is only
+   * the same when the effectors don't depend on the order. */
+  const bool use_batches = !use_serial && psys->effectors && psys_uses_effectors(part);
+  const int64_t grain_size = use_serial ? psys->totpart : 256;
+
+  threading::parallel_for(IndexRange(psys->totpart), grain_size, [&](const IndexRange range) {
+    ParticleSimulationData sim_local = *sim;
+    sim_local.rng = BLI_rng_new(seed);
+    Array<BatchedEffectorForces, 0> batched_forces;
+    IndexRange batch;
+    for (const int p : range) {
+      ParticleData *pa = &psys->particles[p];
+      if (use_batches && !batch.contains(p)) {
+        batch = IndexRange::from_begin_end(p, std::min<int64_t>(p + 256, range.one_after_last()));
+        batched_forces.reinitialize(batch.size());
+        effector_forces_batch(&sim_local, batch, batched_forces);
+      }
+      if (pa->state.time <= 0.0f) {
+        continue;
+      }
+      BLI_rng_srandom(sim_local.rng, seed + uint(p));
+
+      /* do global forces & effectors */
+      basic_integrate(&sim_local,
+                      p,
+                      pa->state.time,
+                      cfra,
+                      use_batches ? &batched_forces[p - batch.start()] : nullptr);
+
+      /* deflection */
+      if (sim_local.colliders) {
+        collision_check(&sim_local, p, pa->state.time, cfra);
+      }
+
+      /* rotations */
+      basic_rotate(part, pa, pa->state.time, timestep);
+    }
+    BLI_rng_free(sim_local.rng);
+  });
+}
+
+/**
+ * Think and move all boids. Unless the system uses legacy dynamics, all boids think in parallel
+ * first, based on the state of the others at the start of the step, and then move in parallel.
+ * Damage dealt in fights is applied in between, in the order of the boids.
+ */
+static void dynamics_step_boids(ParticleSimulationData *sim,
+                                BoidBrainData &bbd,
+                                const float cfra,
+                                const uint seed)
+{
+  using namespace blender;
+  ParticleSystem *psys = sim->psys;
+  PARTICLE_P;
+
+  if (psys->part->flag & PART_LEGACY_DYNAMICS) {
+    LOOP_DYNAMIC_PARTICLES
+    {
+      bbd.goal_ob = nullptr;
+
+      boid_brain(&bbd, p, pa);
+
+      if (pa->alive != PARS_DYING) {
+        boid_body(&bbd, pa);
+
+        /* deflection */
+        if (sim->colliders) {
+          collision_check(sim, p, pa->state.time, cfra);
+        }
+      }
+    }
+    return;
+  }
+
+  const int64_t grain_size = psys_effectors_need_serial(psys) ? psys->totpart : 256;
+  Array<BoidBrainData> brains(psys->totpart);
+
+  /* Damage of every range of boids, to be applied in order. */
+  Mutex damage_mutex;
+  Vector<std::pair<int64_t, Vector<BoidDamage>>> damage_by_range;
+  threading::parallel_for(IndexRange(psys->totpart), grain_size, [&](const IndexRange range) {
+    ParticleSimulationData sim_local = *sim;
+    sim_local.rng = BLI_rng_new(seed);
+    Vector<BoidDamage> damage;
+    for (const int p : range) {
+      ParticleData *pa = &psys->particles[p];
+      if (pa->state.time <= 0.0f) {
+        continue;
+      }
+      BLI_rng_srandom(sim_local.rng, seed + uint(p));
+      BoidBrainData &brain = brains[p];
+      brain = bbd;
+      brain.sim = &sim_local;
+      brain.rng = sim_local.rng;
+      brain.damage = &damage;
+      brain.goal_ob = nullptr;
+      boid_brain(&brain, p, pa);
+    }
+    BLI_rng_free(sim_local.rng);
+    if (!damage.is_empty()) {
+      std::scoped_lock lock(damage_mutex);
+      damage_by_range.append({range.start(), std::move(damage)});
+    }
+  });
+
+  std::sort(damage_by_range.begin(),
+            damage_by_range.end(),
+            [](const auto &a, const auto &b) { return a.first < b.first; });
+  for (const auto &[range_start, damage] : damage_by_range) {
+    for (const BoidDamage &boid_damage : damage) {
+      boid_damage.boid->data.health -= boid_damage.damage;
+    }
+  }
+
+  threading::parallel_for(IndexRange(psys->totpart), grain_size, [&](const IndexRange range) {
+    ParticleSimulationData sim_local = *sim;
+    sim_local.rng = BLI_rng_new(seed);
+    for (const int p : range) {
+      ParticleData *pa = &psys->particles[p];
+      if (pa->state.time <= 0.0f || pa->alive == PARS_DYING) {
+        continue;
+      }
+      /* Different from the numbers used for thinking. */
+      BLI_rng_srandom(sim_local.rng, BLI_hash_int_2d(seed, uint(p)));
+      BoidBrainData &brain = brains[p];
+      brain.sim = &sim_local;
+      brain.rng = sim_local.rng;
+      brain.damage = nullptr;
+      boid_body(&brain, pa);
+
+      /* deflection */
+      if (sim_local.colliders) {
+        collision_check(&sim_local, p, pa->state.time, cfra);
+      }
+    }
+    BLI_rng_free(sim_local.rng);
+  });
+}
+
 /* unbaked particles are calculated dynamically */
 static void dynamics_step(ParticleSimulationData *sim, float cfra)
 {
@@ -3839,8 +4270,17 @@ static void dynamics_step(ParticleSimulationData *sim, float cfra)
     return;
   }
 
+  const double start_time = BLI_time_now_seconds();
+
   /* for now do both, boids us 'rng' */
-  sim->rng = BLI_rng_new_srandom(31415926 + int(cfra) + psys->seed);
+  const uint seed = uint(31415926 + int(cfra) + psys->seed);
+  sim->rng = BLI_rng_new_srandom(seed);
+
+  /* Legacy dynamics keep the neighbor order of the trees. */
+  const bool use_legacy_dynamics = part->flag & PART_LEGACY_DYNAMICS;
+  bke::ParticleGridMap grids;
+  bke::ParticleGridMap fight_grids;
+  sim->grids = use_legacy_dynamics ? nullptr : &grids;
 
   psys_update_effectors(sim);
 
@@ -3858,7 +4298,10 @@ static void dynamics_step(ParticleSimulationData *sim, float cfra)
       bbd.dfra = dfra;
       bbd.timestep = timestep;
       bbd.rng = sim->rng;
+      bbd.do_jump = false;
+      bbd.damage = nullptr;
 
+      /* The tree is still used for the searches that aren't limited to a radius. */
       psys_update_particle_tree(psys, cfra);
 
       boids_precalc_rules(part, cfra);
@@ -3869,20 +4312,54 @@ static void dynamics_step(ParticleSimulationData *sim, float cfra)
           psys_update_particle_tree(psys_target, cfra);
         }
       }
+
+      if (use_legacy_dynamics) {
+        break;
+      }
+
+      /* Separation is the most common search. */
+      const BoidSettings *boids = part->boids;
+      const float personal_space = std::max(boids->air_personal_space,
+                                            boids->land_personal_space);
+      psys_update_particle_grids(sim, cfra, 2.0f * personal_space * part->size, grids);
+
+      /* Fighting searches a much larger radius, which needs cells of its own size. */
+      float fight_distance = 0.0f;
+      LISTBASE_FOREACH (const BoidState *, state, &boids->states) {
+        LISTBASE_FOREACH (const BoidRule *, rule, &state->rules) {
+          if (rule->type == eBoidRuleType_Fight) {
+            fight_distance = std::max(fight_distance,
+                                      reinterpret_cast<const BoidRuleFight *>(rule)->distance);
+          }
+        }
+      }
+      if (fight_distance > 0.0f) {
+        psys_update_particle_grids(sim, cfra, fight_distance, fight_grids);
+        sim->fight_grids = &fight_grids;
+      }
       break;
     }
     case PART_PHYS_FLUID: {
-      ParticleTarget *pt = static_cast<ParticleTarget *>(psys->targets.first);
-      psys_update_particle_bvhtree(psys, cfra);
-
-      /* Updating others systems particle tree for fluid-fluid interaction. */
-      for (; pt; pt = pt->next) {
-        if (pt->ob) {
-          psys_update_particle_bvhtree(
-              static_cast<ParticleSystem *>(BLI_findlink(&pt->ob->particlesystem, pt->psys - 1)),
-              cfra);
+      if (use_legacy_dynamics) {
+        psys_update_particle_bvhtree(psys, cfra);
+
+        /* Updating others systems particle tree for fluid-fluid interaction. */
+        LISTBASE_FOREACH (ParticleTarget *, pt, &psys->targets) {
+          if (pt->ob) {
+            psys_update_particle_bvhtree(
+                static_cast<ParticleSystem *>(BLI_findlink(&pt->ob->particlesystem, pt->psys - 1)),
+                cfra);
+          }
         }
+        break;
       }
+
+      /* Also add the other systems for fluid-fluid interaction. */
+      const SPHFluidSettings *fluid = part->fluid;
+      const float interaction_radius = fluid->radius * (fluid->flag & SPH_FAC_RADIUS ?
+                                                            4.0f * part->size :
+                                                            1.0f);
+      psys_update_particle_grids(sim, cfra, interaction_radius, grids);
       break;
     }
   }
@@ -3937,37 +4414,11 @@ static void dynamics_step(ParticleSimulationData *sim, float cfra)
 
   switch (part->phystype) {
     case PART_PHYS_NEWTON: {
-      LOOP_DYNAMIC_PARTICLES
-      {
-        /* do global forces & effectors */
-        basic_integrate(sim, p, pa->state.time, cfra);
-
-        /* deflection */
-        if (sim->colliders) {
-          collision_check(sim, p, pa->state.time, cfra);
-        }
-
-        /* rotations */
-        basic_rotate(part, pa, pa->state.time, timestep);
-      }
+      dynamics_step_newton(sim, cfra, timestep, seed);
       break;
     }
     case PART_PHYS_BOIDS: {
-      LOOP_DYNAMIC_PARTICLES
-      {
-        bbd.goal_ob = nullptr;
-
-        boid_brain(&bbd, p, pa);
-
-        if (pa->alive != PARS_DYING) {
-          boid_body(&bbd, pa);
-
-          /* deflection */
-          if (sim->colliders) {
-            collision_check(sim, p, pa->state.time, cfra);
-          }
-        }
-      }
+      dynamics_step_boids(sim, bbd, cfra, seed);
       break;
     }
     case PART_PHYS_FLUID: {
@@ -4070,6 +4521,13 @@ static void dynamics_step(ParticleSimulationData *sim, float cfra)
   BKE_collider_cache_free(&sim->colliders);
   BLI_rng_free(sim->rng);
   sim->rng = nullptr;
+  sim->grids = nullptr;
+  sim->fight_grids = nullptr;
+
+  CLOG_DEBUG(&LOG,
+             "Dynamics step of %d particles took %f seconds.",
+             psys->totpart,
+             BLI_time_now_seconds() - start_time);
 }
 
 static void update_children(ParticleSimulationData *sim, const bool use_render_params)
@@ -6,6 +6,7 @@
  * \ingroup bke
  */
 
+#include "BLI_array.hh"
 #include "BLI_bounds.hh"
 #include "BLI_heap_simple.h"
 #include "BLI_map.hh"
@@ -13,9 +14,13 @@
 #include "BLI_math_vector.h"
 #include "BLI_math_vector.hh"
 #include "BLI_memarena.h"
+#include "BLI_mutex.hh"
+#include "BLI_set.hh"
 #include "BLI_span.hh"
+#include "BLI_task.hh"
 #include "BLI_time.h"
 #include "BLI_utildefines.h"
+#include "BLI_vector.hh"
 
 #include "BKE_global.hh"
 #include "BKE_paint_bvh.hh"
@@ -684,6 +689,23 @@ struct EdgeQueueContext {
   int cd_vert_mask_offset;
   int cd_vert_node_offset;
   int cd_face_node_offset;
+
+  /**
+   * The only node whose elements may be changed, when nodes are processed on multiple threads.
+   * See #edge_in_region.
+   */
+  int region_node = dyntopo_node_none;
+  /** Locked around BMesh element allocation and #BMLog calls when processing a region. */
+  Mutex *bm_mutex = nullptr;
+  /** Edges of the region queue that change other nodes, to be processed serially afterwards. */
+  Vector<std::array<BMVert *, 2>> *deferred = nullptr;
+};
+
+/** A queued edge, taken out of the heap to be processed by the thread of a node. */
+struct QueuedEdge {
+  BMVert *v1;
+  BMVert *v2;
+  float priority;
 };
 
 /* Only tagged edges are in the queue. */
@@ -785,6 +807,66 @@ static void edge_queue_insert(const EdgeQueueContext *eq_ctx, BMEdge *e, const f
   }
 }
 
+/**
+ * Lock the BMesh and the #BMLog while changing elements, if other threads change the elements of
+ * other nodes at the same time.
+ */
+static std::unique_lock<Mutex> topology_lock(const EdgeQueueContext *eq_ctx)
+{
+  if (eq_ctx->bm_mutex) {
+    return std::unique_lock<Mutex>(*eq_ctx->bm_mutex);
+  }
+  return {};
+}
+
+static bool face_in_region(const EdgeQueueContext *eq_ctx, const BMFace *f)
+{
+  return eq_ctx->region_node == dyntopo_node_none ||
+         BM_ELEM_CD_GET_INT(f, eq_ctx->cd_face_node_offset) == eq_ctx->region_node;
+}
+
+/** Return true if the vertex and all faces around it belong to the region node. */
+static bool vert_in_region(const EdgeQueueContext *eq_ctx, BMVert *v)
+{
+  if (BM_ELEM_CD_GET_INT(v, eq_ctx->cd_vert_node_offset) != eq_ctx->region_node) {
+    return false;
+  }
+  BMFace *f;
+  BM_FACES_OF_VERT_ITER_BEGIN (f, v) {
+    if (BM_ELEM_CD_GET_INT(f, eq_ctx->cd_face_node_offset) != eq_ctx->region_node) {
+      return false;
+    }
+  }
+  BM_FACES_OF_VERT_ITER_END;
+  return true;
+}
+
+/**
+ * Return true if the edge can be subdivided or collapsed by the thread of the region node. Both
+ * operations only change the faces around the edge vertices and the vertices of those faces. When
+ * all of them, and all faces around those vertices, belong to the region node, no other thread
+ * reads or writes them. Always true when nodes are processed serially.
+ */
+static bool edge_in_region(const EdgeQueueContext *eq_ctx, BMEdge *e)
+{
+  if (eq_ctx->region_node == dyntopo_node_none) {
+    return true;
+  }
+  for (BMVert *v : {e->v1, e->v2}) {
+    if (!vert_in_region(eq_ctx, v)) {
+      return false;
+    }
+    BMLoop *l;
+    BM_LOOPS_OF_VERT_ITER_BEGIN (l, v) {
+      if (!vert_in_region(eq_ctx, l->next->v) || !vert_in_region(eq_ctx, l->prev->v)) {
+        return false;
+      }
+    }
+    BM_LOOPS_OF_VERT_ITER_END;
+  }
+  return true;
+}
+
 /** Return true if the edge is a boundary edge: both its vertices are on a boundary. */
 static bool is_boundary_edge(const BMEdge &edge)
 {
@@ -912,6 +994,10 @@ static void long_edge_queue_edge_add_recursive(const EdgeQueueContext *eq_ctx,
 
     const BMLoop *l_iter = l_edge;
     do {
+      /* Other threads may change the faces of other nodes. */
+      if (!face_in_region(eq_ctx, l_iter->f)) {
+        continue;
+      }
       std::array<BMLoop *, 2> l_adjacent = {l_iter->next, l_iter->prev};
       for (int i = 0; i < l_adjacent.size(); i++) {
         const float len_sq_other = BM_edge_calc_length_squared(l_adjacent[i]->e);
@@ -925,55 +1011,67 @@ static void long_edge_queue_edge_add_recursive(const EdgeQueueContext *eq_ctx,
   }
 }
 
-static void short_edge_queue_edge_add(const EdgeQueueContext *eq_ctx, BMEdge *e)
+static bool edge_queue_face_in_range(const EdgeQueue &queue, BMFace *f)
 {
-  if (!EDGE_QUEUE_TEST(e)) {
-    if (BM_edge_calc_length_squared(e) < eq_ctx->queue->limit_len_squared) {
-      edge_queue_insert(eq_ctx, e, short_edge_queue_priority(*e));
+  if (queue.use_front_face) {
+    if (dot_v3v3(f->no, *queue.view_normal) < 0.0f) {
+      return false;
     }
   }
+  return queue.edge_queue_tri_in_range(&queue, f);
 }
 
-static void long_edge_queue_face_add(const EdgeQueueContext *eq_ctx, BMFace *f)
+static bool node_needs_topology_update(const BMeshNode &node)
 {
-  if (eq_ctx->queue->use_front_face) {
-    if (dot_v3v3(f->no, *eq_ctx->queue->view_normal) < 0.0f) {
-      return;
-    }
-  }
+  return (node.flag_ & Node::Leaf) && (node.flag_ & Node::UpdateTopology) &&
+         !(node.flag_ & Node::FullyHidden);
+}
 
-  if (eq_ctx->queue->edge_queue_tri_in_range(eq_ctx->queue, f)) {
-    /* Check each edge of the face. */
-    const BMLoop *l_first = BM_FACE_FIRST_LOOP(f);
-    const BMLoop *l_iter = l_first;
-    do {
-      const float len_sq = BM_edge_calc_length_squared(l_iter->e);
-      if (len_sq > eq_ctx->queue->limit_len_squared) {
-        long_edge_queue_edge_add_recursive(
-            eq_ctx, l_iter->radial_next, l_iter, len_sq, eq_ctx->queue->limit_len);
+/**
+ * Gather the faces in range of the queue from the leaf nodes marked for topology update. Testing
+ * the faces doesn't modify anything, so it is done for all nodes in parallel. The edges are added
+ * to the queue afterwards in the same order as when the faces were tested serially, so that the
+ * result of the topology update doesn't depend on the number of threads.
+ */
+static Array<Vector<BMFace *>> edge_queue_faces_in_range_gather(const EdgeQueue &queue,
+                                                                 const Span<BMeshNode> nodes)
+{
+  Array<Vector<BMFace *>> faces_by_node(nodes.size());
+  threading::parallel_for(nodes.index_range(), 1, [&](const IndexRange range) {
+    for (const int i : range) {
+      const BMeshNode &node = nodes[i];
+      if (!node_needs_topology_update(node)) {
+        continue;
       }
-    } while ((l_iter = l_iter->next) != l_first);
-  }
+      for (BMFace *f : node.bm_faces_) {
+        if (edge_queue_face_in_range(queue, f)) {
+          faces_by_node[i].append(f);
+        }
+      }
+    }
+  });
+  return faces_by_node;
 }
 
-static void short_edge_queue_face_add(const EdgeQueueContext *eq_ctx, BMFace *f)
+static void long_edge_queue_face_add(const EdgeQueueContext *eq_ctx, BMFace *f)
 {
-  if (eq_ctx->queue->use_front_face) {
-    if (dot_v3v3(f->no, *eq_ctx->queue->view_normal) < 0.0f) {
-      return;
+  /* Check each edge of the face. */
+  const BMLoop *l_first = BM_FACE_FIRST_LOOP(f);
+  const BMLoop *l_iter = l_first;
+  do {
+    const float len_sq = BM_edge_calc_length_squared(l_iter->e);
+    if (len_sq > eq_ctx->queue->limit_len_squared) {
+      long_edge_queue_edge_add_recursive(
+          eq_ctx, l_iter->radial_next, l_iter, len_sq, eq_ctx->queue->limit_len);
     }
-  }
-
-  if (eq_ctx->queue->edge_queue_tri_in_range(eq_ctx->queue, f)) {
-    /* Check each edge of the face. */
-    const BMLoop *l_first = BM_FACE_FIRST_LOOP(f);
-    const BMLoop *l_iter = l_first;
-    do {
-      short_edge_queue_edge_add(eq_ctx, l_iter->e);
-    } while ((l_iter = l_iter->next) != l_first);
-  }
+  } while ((l_iter = l_iter->next) != l_first);
 }
 
+struct ShortEdgeCandidate {
+  BMEdge *edge;
+  float priority;
+};
+
 /**
  * Create a priority queue containing vertex pairs connected by a long
  * edge as defined by Tree.bm_max_edge_len.
@@ -1019,16 +1117,19 @@ static void long_edge_queue_create(const EdgeQueueContext *eq_ctx,
   pbvh_bmesh_edge_tag_verify(pbvh);
 #endif
 
-  for (BMeshNode &node : nodes) {
-    /* Check leaf nodes marked for topology update. */
-    if ((node.flag_ & Node::Leaf) && (node.flag_ & Node::UpdateTopology) &&
-        !(node.flag_ & Node::FullyHidden))
-    {
-      for (BMFace *f : node.bm_faces_) {
-        long_edge_queue_face_add(eq_ctx, f);
-      }
+  const double start_time = BLI_time_now_seconds();
+
+  /* Adding edges recursively visits and tags edges outside of the faces, so it stays serial. */
+  const Array<Vector<BMFace *>> faces_by_node = edge_queue_faces_in_range_gather(*eq_ctx->queue,
+                                                                                 nodes);
+  for (const Span<BMFace *> faces : faces_by_node) {
+    for (BMFace *f : faces) {
+      long_edge_queue_face_add(eq_ctx, f);
     }
   }
+
+  CLOG_DEBUG(
+      &LOG, "Long edge queue creation took %f seconds.", BLI_time_now_seconds() - start_time);
 }
 
 /**
@@ -1072,16 +1173,46 @@ static void short_edge_queue_create(const EdgeQueueContext *eq_ctx,
     eq_ctx->queue->edge_queue_tri_in_range = edge_queue_tri_in_sphere;
   }
 
-  for (BMeshNode &node : nodes) {
-    /* Check leaf nodes marked for topology update */
-    if ((node.flag_ & Node::Leaf) && (node.flag_ & Node::UpdateTopology) &&
-        !(node.flag_ & Node::FullyHidden))
-    {
+  const double start_time = BLI_time_now_seconds();
+
+  /* Computing the priority of the edges is comparatively expensive because of the boundary
+   * checks, so it is done in parallel for the short edges of all faces in range. Edges used by
+   * multiple faces are only inserted the first time, like when processing the faces serially. */
+  const EdgeQueue &queue = *eq_ctx->queue;
+  Array<Vector<ShortEdgeCandidate>> candidates_by_node(nodes.size());
+  threading::parallel_for(nodes.index_range(), 1, [&](const IndexRange range) {
+    for (const int i : range) {
+      const BMeshNode &node = nodes[i];
+      if (!node_needs_topology_update(node)) {
+        continue;
+      }
       for (BMFace *f : node.bm_faces_) {
-        short_edge_queue_face_add(eq_ctx, f);
+        if (!edge_queue_face_in_range(queue, f)) {
+          continue;
+        }
+        /* Check each edge of the face. */
+        const BMLoop *l_first = BM_FACE_FIRST_LOOP(f);
+        const BMLoop *l_iter = l_first;
+        do {
+          BMEdge *e = l_iter->e;
+          if (BM_edge_calc_length_squared(e) < queue.limit_len_squared) {
+            candidates_by_node[i].append({e, short_edge_queue_priority(*e)});
+          }
+        } while ((l_iter = l_iter->next) != l_first);
+      }
+    }
+  });
+
+  for (const Span<ShortEdgeCandidate> candidates : candidates_by_node) {
+    for (const ShortEdgeCandidate &candidate : candidates) {
+      if (!EDGE_QUEUE_TEST(candidate.edge)) {
+        edge_queue_insert(eq_ctx, candidate.edge, candidate.priority);
       }
     }
   }
+
+  CLOG_DEBUG(
+      &LOG, "Short edge queue creation took %f seconds.", BLI_time_now_seconds() - start_time);
 }
 
 /*************************** Topology update **************************/
@@ -1128,17 +1259,21 @@ static void pbvh_bmesh_split_edge(const EdgeQueueContext *eq_ctx,
   const float3 midpoint_no = math::normalize(math::midpoint<float3>(e->v1->no, e->v2->no));
 
   int node_index = BM_ELEM_CD_GET_INT(e->v1, eq_ctx->cd_vert_node_offset);
-  BMVert *v_new = pbvh_bmesh_vert_create(bm,
-                                         nodes,
-                                         node_changed,
-                                         bm_log,
-                                         e->v1,
-                                         e->v2,
-                                         node_index,
-                                         midpoint_co,
-                                         midpoint_no,
-                                         cd_vert_node_offset,
-                                         eq_ctx->cd_vert_mask_offset);
+  BMVert *v_new;
+  {
+    std::unique_lock lock = topology_lock(eq_ctx);
+    v_new = pbvh_bmesh_vert_create(bm,
+                                   nodes,
+                                   node_changed,
+                                   bm_log,
+                                   e->v1,
+                                   e->v2,
+                                   node_index,
+                                   midpoint_co,
+                                   midpoint_no,
+                                   cd_vert_node_offset,
+                                   eq_ctx->cd_vert_mask_offset);
+  }
 
   /* For each face, add two new triangles and delete the original. */
   for (const int i : edge_loops.index_range()) {
@@ -1187,30 +1322,49 @@ static void pbvh_bmesh_split_edge(const EdgeQueueContext *eq_ctx,
 
     /* Create first face (v1, v_new, v_opp). */
     const std::array<BMVert *, 3> first_tri({v1, v_new, v_opp});
-    const std::array<BMEdge *, 3> first_edges = bm_edges_from_tri(bm, first_tri);
-    copy_edge_data(bm, *first_edges[0], *e);
+    std::array<BMEdge *, 3> first_edges;
+    BMFace *f_new_first;
+    {
+      std::unique_lock lock = topology_lock(eq_ctx);
+      first_edges = bm_edges_from_tri(bm, first_tri);
+      copy_edge_data(bm, *first_edges[0], *e);
 
-    BMFace *f_new_first = pbvh_bmesh_face_create(
-        bm, nodes, node_changed, cd_face_node_offset, bm_log, ni, first_tri, first_edges, f_adj);
+      f_new_first = pbvh_bmesh_face_create(
+          bm, nodes, node_changed, cd_face_node_offset, bm_log, ni, first_tri, first_edges, f_adj);
+    }
     long_edge_queue_face_add(eq_ctx, f_new_first);
 
     /* Create second face (v_new, v2, v_opp). */
     const std::array<BMVert *, 3> second_tri({v_new, v2, v_opp});
-    const std::array<BMEdge *, 3> second_edges{
-        BM_edge_create(&bm, second_tri[0], second_tri[1], nullptr, BM_CREATE_NO_DOUBLE),
-        BM_edge_create(&bm, second_tri[1], second_tri[2], nullptr, BM_CREATE_NO_DOUBLE),
-        first_edges[1],
-    };
-    copy_edge_data(bm, *second_edges[0], *e);
-
-    BMFace *f_new_second = pbvh_bmesh_face_create(
-        bm, nodes, node_changed, cd_face_node_offset, bm_log, ni, second_tri, second_edges, f_adj);
+    BMFace *f_new_second;
+    {
+      std::unique_lock lock = topology_lock(eq_ctx);
+      const std::array<BMEdge *, 3> second_edges{
+          BM_edge_create(&bm, second_tri[0], second_tri[1], nullptr, BM_CREATE_NO_DOUBLE),
+          BM_edge_create(&bm, second_tri[1], second_tri[2], nullptr, BM_CREATE_NO_DOUBLE),
+          first_edges[1],
+      };
+      copy_edge_data(bm, *second_edges[0], *e);
+
+      f_new_second = pbvh_bmesh_face_create(bm,
+                                            nodes,
+                                            node_changed,
+                                            cd_face_node_offset,
+                                            bm_log,
+                                            ni,
+                                            second_tri,
+                                            second_edges,
+                                            f_adj);
+    }
     long_edge_queue_face_add(eq_ctx, f_new_second);
 
     /* Delete original */
-    pbvh_bmesh_face_remove(
-        nodes, node_changed, cd_vert_node_offset, cd_face_node_offset, bm_log, f_adj);
-    BM_face_kill(&bm, f_adj);
+    {
+      std::unique_lock lock = topology_lock(eq_ctx);
+      pbvh_bmesh_face_remove(
+          nodes, node_changed, cd_vert_node_offset, cd_face_node_offset, bm_log, f_adj);
+      BM_face_kill(&bm, f_adj);
+    }
 
     /* Ensure new vertex is in the node */
     if (!nodes[ni].bm_unique_verts_.contains(v_new)) {
@@ -1226,19 +1380,184 @@ static void pbvh_bmesh_split_edge(const EdgeQueueContext *eq_ctx,
     }
   }
 
+  std::unique_lock lock = topology_lock(eq_ctx);
   BM_edge_kill(&bm, e);
 }
 
-static bool pbvh_bmesh_subdivide_long_edges(const EdgeQueueContext *eq_ctx,
-                                            BMesh &bm,
-                                            MutableSpan<BMeshNode> nodes,
-                                            MutableSpan<bool> node_changed,
-                                            const int cd_vert_node_offset,
-                                            const int cd_face_node_offset,
-                                            BMLog &bm_log)
+/**
+ * Split the nodes that need a topology update into groups of nodes that don't share any vertex.
+ * The nodes of a group can be changed on separate threads, as long as only the elements that
+ * belong entirely to one node are changed, see #edge_in_region.
+ */
+static Vector<Vector<int>> topology_update_node_groups(const Span<BMeshNode> nodes,
+                                                       const int cd_face_node_offset)
 {
-  const double start_time = BLI_time_now_seconds();
+  /* Nodes share the vertices in their "other" vertices with the nodes of the faces around them. */
+  Array<Vector<int>> neighbors(nodes.size());
+  threading::parallel_for(nodes.index_range(), 1, [&](const IndexRange range) {
+    for (const int i : range) {
+      const BMeshNode &node = nodes[i];
+      if (!node_needs_topology_update(node)) {
+        continue;
+      }
+      Set<int> node_neighbors;
+      for (BMVert *v : node.bm_other_verts_) {
+        BMFace *f;
+        BM_FACES_OF_VERT_ITER_BEGIN (f, v) {
+          node_neighbors.add(pbvh_bmesh_node_index_from_face(cd_face_node_offset, f));
+        }
+        BM_FACES_OF_VERT_ITER_END;
+      }
+      node_neighbors.remove(i);
+      for (const int neighbor : node_neighbors) {
+        neighbors[i].append(neighbor);
+      }
+    }
+  });
+  /* A node that owns a shared vertex doesn't find the other nodes by itself. */
+  Array<Vector<int>> reverse_neighbors(nodes.size());
+  for (const int i : nodes.index_range()) {
+    for (const int neighbor : neighbors[i]) {
+      reverse_neighbors[neighbor].append(i);
+    }
+  }
 
+  /* Greedy coloring in the order of the nodes, so the groups don't depend on the threads. */
+  Array<int> node_groups(nodes.size(), -1);
+  Vector<Vector<int>> groups;
+  for (const int i : nodes.index_range()) {
+    if (!node_needs_topology_update(nodes[i])) {
+      continue;
+    }
+    Vector<bool, 16> group_used(groups.size(), false);
+    for (const Span<int> node_neighbors : {neighbors[i].as_span(), reverse_neighbors[i].as_span()})
+    {
+      for (const int neighbor : node_neighbors) {
+        if (node_groups[neighbor] != -1) {
+          group_used[node_groups[neighbor]] = true;
+        }
+      }
+    }
+    const int64_t free_group = group_used.first_index_of_try(false);
+    const int group = free_group == -1 ? int(groups.size()) : int(free_group);
+    if (group == groups.size()) {
+      groups.append({});
+    }
+    node_groups[i] = group;
+    groups[group].append(i);
+  }
+  return groups;
+}
+
+/**
+ * Process the queued edges of the nodes of every group on multiple threads, one group after the
+ * other. Each edge is processed by the thread of the node that owns its first vertex, with a
+ * queue of its own. The BMesh element pools and the #BMLog are shared, so they are locked around
+ * every change.
+ *
+ * \param process: Process the queue of a region, returning true if anything was changed. It
+ * receives a map to add the vertices it deletes to, see #bm_vert_hash_lookup_chain.
+ * \param deleted_verts: The vertices deleted by all threads, gathered after every group.
+ * \param r_deferred: The queued edges that could not be processed without changing other nodes,
+ * in a deterministic order. They have to be queued again to be processed serially.
+ */
+template<typename ProcessFn>
+static bool edge_queue_process_parallel(const EdgeQueueContext *eq_ctx,
+                                        const Span<BMeshNode> nodes,
+                                        const ProcessFn &process,
+                                        Map<BMVert *, BMVert *> &deleted_verts,
+                                        Vector<std::array<BMVert *, 2>> &r_deferred)
+{
+  const Vector<Vector<int>> groups = topology_update_node_groups(nodes,
+                                                                 eq_ctx->cd_face_node_offset);
+  Array<bool> node_in_group(nodes.size(), false);
+  for (const Span<int> group : groups) {
+    node_in_group.as_mutable_span().fill_indices(group, true);
+  }
+
+  /* Take the edges out of the shared queue, keeping their order. */
+  Array<Vector<QueuedEdge>> edges_by_node(nodes.size());
+  while (!BLI_heapsimple_is_empty(eq_ctx->queue->heap)) {
+    const float priority = BLI_heapsimple_top_value(eq_ctx->queue->heap);
+    BMVert **pair = static_cast<BMVert **>(BLI_heapsimple_pop_min(eq_ctx->queue->heap));
+    const QueuedEdge edge{pair[0], pair[1], priority};
+    BLI_mempool_free(eq_ctx->pool, pair);
+
+    const int node = BM_ELEM_CD_GET_INT(edge.v1, eq_ctx->cd_vert_node_offset);
+    if (node != dyntopo_node_none && node_in_group[node]) {
+      edges_by_node[node].append(edge);
+      continue;
+    }
+    if (BMEdge *e = BM_edge_exists(edge.v1, edge.v2)) {
+      EDGE_QUEUE_DISABLE(e);
+    }
+    r_deferred.append({edge.v1, edge.v2});
+  }
+
+  Mutex bm_mutex;
+  Array<Vector<std::array<BMVert *, 2>>> deferred_by_node(nodes.size());
+  Array<Map<BMVert *, BMVert *>> deleted_verts_by_node(nodes.size());
+  Array<bool> node_processed(nodes.size(), false);
+  for (const Span<int> group : groups) {
+    threading::parallel_for(group.index_range(), 1, [&](const IndexRange range) {
+      for (const int node_index : group.slice(range)) {
+        const Span<QueuedEdge> edges = edges_by_node[node_index];
+        if (edges.is_empty()) {
+          continue;
+        }
+        EdgeQueue queue = *eq_ctx->queue;
+        queue.heap = BLI_heapsimple_new();
+        BLI_mempool *pool = BLI_mempool_create(sizeof(BMVert *) * 2, 0, 128, BLI_MEMPOOL_NOP);
+
+        EdgeQueueContext region_ctx = *eq_ctx;
+        region_ctx.queue = &queue;
+        region_ctx.pool = pool;
+        region_ctx.region_node = node_index;
+        region_ctx.bm_mutex = &bm_mutex;
+        region_ctx.deferred = &deferred_by_node[node_index];
+
+        for (const QueuedEdge &edge : edges) {
+          /* Vertices deleted by previous groups, only read while no thread adds to the map. */
+          BMVert *v1 = bm_vert_hash_lookup_chain(deleted_verts, edge.v1);
+          BMVert *v2 = bm_vert_hash_lookup_chain(deleted_verts, edge.v2);
+          if (!v1 || !v2 || (v1 == v2)) {
+            continue;
+          }
+          BMVert **pair = static_cast<BMVert **>(BLI_mempool_alloc(pool));
+          pair[0] = v1;
+          pair[1] = v2;
+          BLI_heapsimple_insert(queue.heap, edge.priority, pair);
+        }
+
+        node_processed[node_index] = process(region_ctx, deleted_verts_by_node[node_index]);
+
+        BLI_heapsimple_free(queue.heap, nullptr);
+        BLI_mempool_destroy(pool);
+      }
+    });
+
+    for (const int node_index : group) {
+      for (const auto item : deleted_verts_by_node[node_index].items()) {
+        deleted_verts.add_new(item.key, item.value);
+      }
+      deleted_verts_by_node[node_index].clear();
+    }
+  }
+
+  for (const Span<std::array<BMVert *, 2>> deferred : deferred_by_node) {
+    r_deferred.extend(deferred);
+  }
+  return node_processed.as_span().contains(true);
+}
+
+static bool subdivide_queued_edges(const EdgeQueueContext *eq_ctx,
+                                   BMesh &bm,
+                                   MutableSpan<BMeshNode> nodes,
+                                   MutableSpan<bool> node_changed,
+                                   const int cd_vert_node_offset,
+                                   const int cd_face_node_offset,
+                                   BMLog &bm_log)
+{
   bool any_subdivided = false;
 
   while (!BLI_heapsimple_is_empty(eq_ctx->queue->heap)) {
@@ -1268,12 +1587,61 @@ static bool pbvh_bmesh_subdivide_long_edges(const EdgeQueueContext *eq_ctx,
       continue;
     }
 
+    if (!edge_in_region(eq_ctx, e)) {
+      eq_ctx->deferred->append({v1, v2});
+      continue;
+    }
+
     any_subdivided = true;
 
     pbvh_bmesh_split_edge(
         eq_ctx, bm, nodes, node_changed, cd_vert_node_offset, cd_face_node_offset, bm_log, e);
   }
 
+  return any_subdivided;
+}
+
+static bool pbvh_bmesh_subdivide_long_edges(const EdgeQueueContext *eq_ctx,
+                                            BMesh &bm,
+                                            MutableSpan<BMeshNode> nodes,
+                                            MutableSpan<bool> node_changed,
+                                            const int cd_vert_node_offset,
+                                            const int cd_face_node_offset,
+                                            BMLog &bm_log,
+                                            const bool use_parallel)
+{
+  const double start_time = BLI_time_now_seconds();
+
+  bool any_subdivided = false;
+
+  if (use_parallel) {
+    /* Subdivision doesn't delete vertices. */
+    Map<BMVert *, BMVert *> deleted_verts;
+    Vector<std::array<BMVert *, 2>> deferred;
+    any_subdivided |= edge_queue_process_parallel(
+        eq_ctx,
+        nodes,
+        [&](const EdgeQueueContext &region_ctx, Map<BMVert *, BMVert *> & /*deleted_verts*/) {
+          return subdivide_queued_edges(&region_ctx,
+                                        bm,
+                                        nodes,
+                                        node_changed,
+                                        cd_vert_node_offset,
+                                        cd_face_node_offset,
+                                        bm_log);
+        },
+        deleted_verts,
+        deferred);
+    for (const std::array<BMVert *, 2> &verts : deferred) {
+      if (BMEdge *e = BM_edge_exists(verts[0], verts[1])) {
+        long_edge_queue_edge_add(eq_ctx, e);
+      }
+    }
+  }
+
+  any_subdivided |= subdivide_queued_edges(
+      eq_ctx, bm, nodes, node_changed, cd_vert_node_offset, cd_face_node_offset, bm_log);
+
 #ifdef USE_EDGEQUEUE_TAG_VERIFY
   pbvh_bmesh_edge_tag_verify(pbvh);
 #endif
@@ -1606,19 +1974,23 @@ static void pbvh_bmesh_collapse_edge(BMesh &bm,
   }
   BM_LOOPS_OF_VERT_ITER_END;
 
-  /* Remove all faces adjacent to the edge. */
-  BMLoop *l_adj;
-  while ((l_adj = e->l)) {
-    BMFace *f_adj = l_adj->f;
+  {
+    std::unique_lock lock = topology_lock(eq_ctx);
 
-    pbvh_bmesh_face_remove(
-        nodes, node_changed, cd_vert_node_offset, cd_face_node_offset, bm_log, f_adj);
-    BM_face_kill(&bm, f_adj);
-  }
+    /* Remove all faces adjacent to the edge. */
+    BMLoop *l_adj;
+    while ((l_adj = e->l)) {
+      BMFace *f_adj = l_adj->f;
 
-  /* Kill the edge. */
-  BLI_assert(BM_edge_is_wire(e));
-  BM_edge_kill(&bm, e);
+      pbvh_bmesh_face_remove(
+          nodes, node_changed, cd_vert_node_offset, cd_face_node_offset, bm_log, f_adj);
+      BM_face_kill(&bm, f_adj);
+    }
+
+    /* Kill the edge. */
+    BLI_assert(BM_edge_is_wire(e));
+    BM_edge_kill(&bm, e);
+  }
 
   BM_LOOPS_OF_VERT_ITER_BEGIN (l, v_del) {
     /* Get vertices, replace use of v_del with v_conn */
@@ -1633,9 +2005,13 @@ static void pbvh_bmesh_collapse_edge(BMesh &bm,
       BLI_assert(!BM_face_exists(v_tri.data(), 3));
       BMeshNode *n = pbvh_bmesh_node_from_face(nodes, cd_face_node_offset, f);
       const int ni = n - nodes.data();
-      const std::array<BMEdge *, 3> e_tri = bm_edges_from_tri(bm, v_tri);
-      BMFace *new_face = pbvh_bmesh_face_create(
-          bm, nodes, node_changed, cd_face_node_offset, bm_log, ni, v_tri, e_tri, f);
+      BMFace *new_face;
+      {
+        std::unique_lock lock = topology_lock(eq_ctx);
+        const std::array<BMEdge *, 3> e_tri = bm_edges_from_tri(bm, v_tri);
+        new_face = pbvh_bmesh_face_create(
+            bm, nodes, node_changed, cd_face_node_offset, bm_log, ni, v_tri, e_tri, f);
+      }
 
       merge_face_edge_data(bm, f, new_face, v_del, l, v_conn);
 
@@ -1660,6 +2036,8 @@ static void pbvh_bmesh_collapse_edge(BMesh &bm,
      * to the mesh. */
     try_merge_flap_edge_data_before_dissolve(bm, *f_del);
 
+    std::unique_lock lock = topology_lock(eq_ctx);
+
     /* Remove the face */
     pbvh_bmesh_face_remove(
         nodes, node_changed, cd_vert_node_offset, cd_face_node_offset, bm_log, f_del);
@@ -1697,7 +2075,10 @@ static void pbvh_bmesh_collapse_edge(BMesh &bm,
    * However, if the vertex is on a boundary, do not move it to preserve the shape of the
    * boundary. */
   if (v_conn != nullptr && !is_boundary_vert(*v_conn)) {
-    BM_log_vert_before_modified(&bm_log, v_conn, eq_ctx->cd_vert_mask_offset);
+    {
+      std::unique_lock lock = topology_lock(eq_ctx);
+      BM_log_vert_before_modified(&bm_log, v_conn, eq_ctx->cd_vert_mask_offset);
+    }
     mid_v3_v3v3(v_conn->co, v_conn->co, v_del->co);
     add_v3_v3(v_conn->no, v_del->no);
     normalize_v3(v_conn->no);
@@ -1715,27 +2096,24 @@ static void pbvh_bmesh_collapse_edge(BMesh &bm,
 
   /* Delete v_del */
   BLI_assert(!BM_vert_face_check(v_del));
+  std::unique_lock lock = topology_lock(eq_ctx);
   BM_log_vert_removed(&bm_log, v_del, eq_ctx->cd_vert_mask_offset);
   /* v_conn == nullptr is OK */
   deleted_verts.add_new(v_del, v_conn);
   BM_vert_kill(&bm, v_del);
 }
 
-static bool pbvh_bmesh_collapse_short_edges(const EdgeQueueContext *eq_ctx,
-                                            const float min_edge_len,
-                                            BMesh &bm,
-                                            MutableSpan<BMeshNode> nodes,
-                                            MutableSpan<bool> node_changed,
-                                            const int cd_vert_node_offset,
-                                            const int cd_face_node_offset,
-                                            BMLog &bm_log)
+static bool collapse_queued_edges(const EdgeQueueContext *eq_ctx,
+                                  const float min_len_squared,
+                                  BMesh &bm,
+                                  MutableSpan<BMeshNode> nodes,
+                                  MutableSpan<bool> node_changed,
+                                  const int cd_vert_node_offset,
+                                  const int cd_face_node_offset,
+                                  BMLog &bm_log,
+                                  Map<BMVert *, BMVert *> &deleted_verts)
 {
-  const double start_time = BLI_time_now_seconds();
-
-  const float min_len_squared = min_edge_len * min_edge_len;
   bool any_collapsed = false;
-  /* Deleted verts point to vertices they were merged into, or nullptr when removed. */
-  Map<BMVert *, BMVert *> deleted_verts;
 
   while (!BLI_heapsimple_is_empty(eq_ctx->queue->heap)) {
     BMVert **pair = static_cast<BMVert **>(BLI_heapsimple_pop_min(eq_ctx->queue->heap));
@@ -1771,6 +2149,11 @@ static bool pbvh_bmesh_collapse_short_edges(const EdgeQueueContext *eq_ctx,
       continue;
     }
 
+    if (!edge_in_region(eq_ctx, e)) {
+      eq_ctx->deferred->append({v1, v2});
+      continue;
+    }
+
     any_collapsed = true;
 
     pbvh_bmesh_collapse_edge(bm,
@@ -1786,6 +2169,67 @@ static bool pbvh_bmesh_collapse_short_edges(const EdgeQueueContext *eq_ctx,
                              eq_ctx);
   }
 
+  return any_collapsed;
+}
+
+static bool pbvh_bmesh_collapse_short_edges(const EdgeQueueContext *eq_ctx,
+                                            const float min_edge_len,
+                                            BMesh &bm,
+                                            MutableSpan<BMeshNode> nodes,
+                                            MutableSpan<bool> node_changed,
+                                            const int cd_vert_node_offset,
+                                            const int cd_face_node_offset,
+                                            BMLog &bm_log,
+                                            const bool use_parallel)
+{
+  const double start_time = BLI_time_now_seconds();
+
+  const float min_len_squared = min_edge_len * min_edge_len;
+  bool any_collapsed = false;
+  /* Deleted verts point to vertices they were merged into, or nullptr when removed. */
+  Map<BMVert *, BMVert *> deleted_verts;
+
+  if (use_parallel) {
+    Vector<std::array<BMVert *, 2>> deferred;
+    any_collapsed |= edge_queue_process_parallel(
+        eq_ctx,
+        nodes,
+        [&](const EdgeQueueContext &region_ctx, Map<BMVert *, BMVert *> &region_deleted_verts) {
+          return collapse_queued_edges(&region_ctx,
+                                       min_len_squared,
+                                       bm,
+                                       nodes,
+                                       node_changed,
+                                       cd_vert_node_offset,
+                                       cd_face_node_offset,
+                                       bm_log,
+                                       region_deleted_verts);
+        },
+        deleted_verts,
+        deferred);
+    for (const std::array<BMVert *, 2> &verts : deferred) {
+      BMVert *v1 = bm_vert_hash_lookup_chain(deleted_verts, verts[0]);
+      BMVert *v2 = bm_vert_hash_lookup_chain(deleted_verts, verts[1]);
+      if (!v1 || !v2 || (v1 == v2)) {
+        continue;
+      }
+      BMEdge *e = BM_edge_exists(v1, v2);
+      if (e && !EDGE_QUEUE_TEST(e) && BM_edge_calc_length_squared(e) < min_len_squared) {
+        edge_queue_insert(eq_ctx, e, short_edge_queue_priority(*e));
+      }
+    }
+  }
+
+  any_collapsed |= collapse_queued_edges(eq_ctx,
+                                         min_len_squared,
+                                         bm,
+                                         nodes,
+                                         node_changed,
+                                         cd_vert_node_offset,
+                                         cd_face_node_offset,
+                                         bm_log,
+                                         deleted_verts);
+
   CLOG_DEBUG(&LOG, "Short edge collapse took %f seconds.", BLI_time_now_seconds() - start_time);
 
   return any_collapsed;
@@ -2262,6 +2706,7 @@ bool bmesh_update_topology(BMesh &bm,
 
   MutableSpan<BMeshNode> nodes = pbvh.nodes<BMeshNode>();
   Array<bool> node_changed(nodes.size(), false);
+  const bool use_parallel = mode & PBVH_Parallel;
 
   if (mode & PBVH_Collapse) {
     EdgeQueue queue;
@@ -2284,7 +2729,8 @@ bool bmesh_update_topology(BMesh &bm,
                                                 node_changed,
                                                 cd_vert_node_offset,
                                                 cd_face_node_offset,
-                                                bm_log);
+                                                bm_log,
+                                                use_parallel);
     BLI_heapsimple_free(queue.heap, nullptr);
     BLI_mempool_destroy(queue_pool);
   }
@@ -2303,8 +2749,14 @@ bool bmesh_update_topology(BMesh &bm,
 
     long_edge_queue_create(
         &eq_ctx, max_edge_len, nodes, center, view_normal, radius, use_frontface, use_projected);
-    modified |= pbvh_bmesh_subdivide_long_edges(
-        &eq_ctx, bm, nodes, node_changed, cd_vert_node_offset, cd_face_node_offset, bm_log);
+    modified |= pbvh_bmesh_subdivide_long_edges(&eq_ctx,
+                                                bm,
+                                                nodes,
+                                                node_changed,
+                                                cd_vert_node_offset,
+                                                cd_face_node_offset,
+                                                bm_log,
+                                                use_parallel);
     BLI_heapsimple_free(q.heap, nullptr);
     BLI_mempool_destroy(queue_pool);
   }
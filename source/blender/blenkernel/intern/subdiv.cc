@@ -163,6 +163,9 @@ Subdiv *update_from_converter(Subdiv *subdiv,
     can_reuse_subdiv = false;
   }
   if (can_reuse_subdiv) {
+    /* The topology refiner and evaluator of the previous update are kept, only the comparison
+     * contributes to the time spent on topology for this update. */
+    stats_reset(&subdiv->stats, SUBDIV_STATS_TOPOLOGY_REFINER_CREATION_TIME);
     return subdiv;
   }
   /* Create new subdiv. */
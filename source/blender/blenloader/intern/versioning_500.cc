@@ -18,6 +18,9 @@
 #include "DNA_grease_pencil_types.h"
 #include "DNA_mesh_types.h"
 #include "DNA_node_types.h"
+#include "DNA_object_force_types.h"
+#include "DNA_object_types.h"
+#include "DNA_particle_types.h"
 #include "DNA_rigidbody_types.h"
 #include "DNA_screen_types.h"
 #include "DNA_sequence_types.h"
@@ -2063,6 +2066,23 @@ void blo_do_versions_500(FileData * /*fd*/, Library * /*lib*/, Main *bmain)
     }
   }
 
+  if (!MAIN_VERSION_FILE_ATLEAST(bmain, 500, 52)) {
+    /* Keep the random sequences and neighbor order of existing simulations. */
+    LISTBASE_FOREACH (Object *, ob, &bmain->objects) {
+      if (ob->pd) {
+        ob->pd->flag |= PFIELD_LEGACY_NOISE;
+      }
+    }
+    LISTBASE_FOREACH (ParticleSettings *, part, &bmain->particles) {
+      part->flag |= PART_LEGACY_DYNAMICS;
+      for (PartDeflect *pd : {part->pd, part->pd2}) {
+        if (pd) {
+          pd->flag |= PFIELD_LEGACY_NOISE;
+        }
+      }
+    }
+  }
+
   /**
    * Always bump subversion in BKE_blender_version.h when adding versioning
    * code here, and wrap it inside a MAIN_VERSION_FILE_ATLEAST check.
@@ -1622,6 +1622,10 @@ void blo_do_versions_userdef(UserDef *userdef)
     userdef->gpu_flag &= ~USER_GPU_FLAG_UNUSED_0;
   }
 
+  if (!USER_VERSION_ATLEAST(500, 51)) {
+    userdef->sequencer_disk_cache_size_limit = 100;
+  }
+
   /**
    * Always bump subversion in BKE_blender_version.h when adding versioning
    * code here, and wrap it inside a USER_VERSION_ATLEAST check.
@@ -7,6 +7,7 @@
 #include <optional>
 
 #include "BLI_map.hh"
+#include "BLI_vector.hh"
 
 #include "NOD_derived_node_tree.hh"
 
@@ -14,6 +15,7 @@
 #include "COM_domain.hh"
 #include "COM_node_operation.hh"
 #include "COM_pixel_operation.hh"
+#include "COM_region_of_interest.hh"
 #include "COM_scheduler.hh"
 
 namespace blender::compositor {
@@ -117,7 +119,12 @@ using namespace nodes::derived_node_tree_types;
  * the should_compile_pixel_compile_unit method. Node single value types and domains are computed
  * in the is_pixel_node_single_value and compute_pixel_node_domain methods respectively, the latter
  * of which is analogous to the Operation::compute_domain method for nodes that are not yet
- * compiled. */
+ * compiled.
+ *
+ * When independent parts of the schedule are compiled concurrently, each part is compiled using
+ * its own compile state, which only maps the nodes of its part. So the compile states of the parts
+ * that the part depends on are added as dependencies, such that the results of their nodes can be
+ * retrieved, see the add_dependency method and Evaluator::evaluate_concurrently. */
 class CompileState {
  private:
   /* A reference to the compositor context. */
@@ -141,11 +148,35 @@ class CompileState {
   /* The domain of the pixel compile unit if it was not a single value. Only initialized when the
    * pixel compile unit is not empty and is not a single value. */
   std::optional<Domain> pixel_compile_unit_domain_;
+  /* The regions of interest of the outputs of the scheduled nodes, computed ahead of compilation.
+   * Only computed if they were not given to the constructor. See COM_region_of_interest.hh for
+   * more information. */
+  RegionsOfInterest computed_regions_of_interest_;
+  /* A reference to either the computed regions of interest above or to the ones given to the
+   * constructor. */
+  const RegionsOfInterest &regions_of_interest_;
+  /* The compile states of the parts of the schedule that the part compiled by this compile state
+   * depends on, see the add_dependency method. */
+  Vector<const CompileState *> dependencies_;
 
  public:
   /* Construct a compile state from the node execution schedule being compiled. */
   CompileState(const Context &context, const Schedule &schedule);
 
+  /* Construct a compile state from the node execution schedule being compiled and the regions of
+   * interest of its outputs computed ahead of time. This is used when multiple compile states
+   * compile parts of the same schedule, such that the regions of interest are only computed once.
+   * The regions of interest should outlive the compile state. */
+  CompileState(const Context &context,
+               const Schedule &schedule,
+               const RegionsOfInterest &regions_of_interest);
+
+  /* Adds the given compile state as a dependency of this one, such that the results of the nodes
+   * compiled by it can be retrieved using the get_result_from_output_socket method. This is used
+   * when parts of the schedule are compiled concurrently, and the given compile state should have
+   * finished compiling its part before this compile state starts compiling. */
+  void add_dependency(const CompileState &compile_state);
+
   /* Get a reference to the node execution schedule being compiled. */
   const Schedule &get_schedule();
 
@@ -185,7 +216,17 @@ class CompileState {
    * in PixelOperation::populate_results_for_node. */
   int compute_pixel_node_operation_outputs_count(DNode node);
 
+  /* Computes the region of interest of the given pixel operation as the union of the regions of
+   * interest of its outputs. Returns nullopt if the result of any of the outputs is read entirely.
+   * See COM_region_of_interest.hh for more information. */
+  std::optional<Bounds<int2>> compute_pixel_operation_region_of_interest(
+      PixelOperation &operation);
+
  private:
+  /* Returns the compile state that compiled the given node, which is either this compile state
+   * or one of its dependencies. */
+  const CompileState &get_compile_state_of_node(DNode node) const;
+
   /* Determines if the given pixel node operates on single values or not. The node operates on
    * single values if all its inputs are single values, and consequently will also output single
    * values. */
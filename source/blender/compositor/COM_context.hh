@@ -8,6 +8,7 @@
 
 #include "BLI_bounds_types.hh"
 #include "BLI_math_vector_types.hh"
+#include "BLI_mutex.hh"
 #include "BLI_string_ref.hh"
 
 #include "DNA_scene_types.h"
@@ -47,6 +48,9 @@ class Context {
    * efficiently. */
   StaticCacheManager cache_manager_;
 
+  /* Guards the reference counts of the results of this context, see results_mutex(). */
+  Mutex results_mutex_;
+
  public:
   /* Get the compositing scene. */
   virtual const Scene &get_scene() const = 0;
@@ -122,6 +126,23 @@ class Context {
    * executing as soon as possible. */
   virtual bool is_canceled() const;
 
+  /* Returns true if the results of node operations should be kept in the node result cache of the
+   * static cache manager, such that they can be reused by later evaluations. This is only useful
+   * for interactive evaluations where the same node tree is evaluated repeatedly and is only
+   * supported for CPU contexts. Defaults to false. See COM_node_result_cache.hh. */
+  virtual bool use_node_result_cache() const;
+
+  /* Returns true if independent branches of the node tree should be evaluated concurrently. This
+   * is only supported for CPU contexts, and contexts that return true should make sure their
+   * methods can be called from multiple threads at the same time. Defaults to false. See
+   * Evaluator::evaluate_concurrently. */
+  virtual bool use_concurrent_evaluation() const;
+
+  /* Returns the maximum total size in bytes of the CPU data of the results of the evaluation,
+   * beyond which the least recently used results are spilled to disk, or zero if the memory usage
+   * of results should not be limited. Defaults to zero. See COM_result_spill_manager.hh. */
+  virtual int64_t get_results_memory_budget() const;
+
   /* Resets the context's internal structures like the cache manager. This should be called before
    * every evaluation. */
   void reset();
@@ -162,6 +183,13 @@ class Context {
 
   /* Get a reference to the static cache manager of this context. */
   StaticCacheManager &cache_manager();
+
+  /* Get a reference to the mutex that guards the reference counts of the results of this context
+   * as well as the allocation of their derived resources, since results might be shared and
+   * released concurrently by operations that are evaluated in parallel, see
+   * Evaluator::evaluate_concurrently. Results of different contexts do not share data, so each
+   * context has its own mutex. */
+  Mutex &results_mutex();
 };
 
 }  // namespace blender::compositor
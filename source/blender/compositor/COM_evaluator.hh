@@ -4,8 +4,13 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <optional>
 
+#include "BLI_map.hh"
+#include "BLI_mutex.hh"
+#include "BLI_span.hh"
 #include "BLI_vector.hh"
 
 #include "NOD_derived_node_tree.hh"
@@ -13,6 +18,8 @@
 #include "COM_compile_state.hh"
 #include "COM_context.hh"
 #include "COM_node_operation.hh"
+#include "COM_node_result_cache.hh"
+#include "COM_result_spill_manager.hh"
 #include "COM_operation.hh"
 
 namespace blender::compositor {
@@ -84,15 +91,43 @@ using namespace nodes::derived_node_tree_types;
  * unit. Node 5 is then added to the now empty compile unit similar to node 3. Node 6 is not a
  * pixel node, so the compile unit is considered complete and is compiled first, adding the first
  * pixel operation to the operations stream and resetting the compile unit. Finally, node 6 is
- * compiled into a node operation similar to nodes 1 and 2 and added to the operations stream. */
+ * compiled into a node operation similar to nodes 1 and 2 and added to the operations stream.
+ *
+ * For CPU contexts that support it, independent branches of the node tree are evaluated
+ * concurrently. The schedule is split into tasks, each of which is either a single non pixel node
+ * or a run of consecutive pixel nodes, such that pixel nodes are compiled into the same pixel
+ * operations as in sequential evaluation. Each task depends on the tasks that evaluate the nodes
+ * linked to the inputs of its nodes, and the tasks are evaluated as a task graph. For the node
+ * tree above, nodes 1 and 2 are evaluated concurrently, then nodes 3, 4, and 5 are evaluated in a
+ * single task, and finally node 6 is evaluated. Results are still released by their last user as
+ * in sequential evaluation, so results are freed as early as they would have been freed in
+ * sequential evaluation. See the evaluate_concurrently method for more information. */
 class Evaluator {
  private:
+  /* A task that evaluates a part of the schedule, see the evaluate_concurrently method. */
+  struct EvaluationTask;
+
   /* A reference to the compositor context. */
   Context &context_;
   /* A derived node tree representing the compositor node tree. */
   std::unique_ptr<DerivedNodeTree> derived_node_tree_;
   /* The compiled operations stream, which contains all compiled operations so far. */
   Vector<std::unique_ptr<Operation>> operations_stream_;
+  /* The keys of the results of the outputs evaluated so far, used to compute the keys of the nodes
+   * linked to them in the node result cache. Outputs whose results can't be identified by a key
+   * are not stored. Only computed if the context uses the node result cache, see
+   * COM_node_result_cache.hh. */
+  Map<DOutputSocket, NodeResultKey> output_result_keys_;
+  /* Guards the operations stream and the output result keys, since operations are compiled and
+   * evaluated from multiple threads when the node tree is evaluated concurrently. */
+  Mutex mutex_;
+  /* True if the evaluation was canceled while the node tree is evaluated concurrently, such that
+   * the tasks that were not evaluated yet are skipped. */
+  std::atomic<bool> is_canceled_ = false;
+  /* Spills the least recently used results to disk when the memory budget of results of the
+   * context is exceeded. Only created for sequential evaluation if the context has a memory
+   * budget, see Context::get_results_memory_budget and COM_result_spill_manager.hh. */
+  std::unique_ptr<ResultSpillManager> result_spill_manager_;
 
  public:
   /* Construct an evaluator from a context. */
@@ -109,6 +144,29 @@ class Evaluator {
    * method. */
   bool validate_node_tree();
 
+  /* Returns true if the node tree should be evaluated concurrently, see the evaluate_concurrently
+   * method. */
+  bool should_evaluate_concurrently() const;
+
+  /* Splits the given schedule into tasks and evaluates them concurrently as a task graph, where
+   * each task depends on the tasks that evaluate the nodes linked to its inputs. Each task
+   * compiles its nodes using its own compile state, which has the compile states of the tasks it
+   * depends on as dependencies. The evaluation is canceled if the context is canceled during
+   * evaluation. */
+  void evaluate_concurrently(const Schedule &schedule);
+
+  /* Evaluates the nodes of the given evaluation task. This is the run function of the tasks of the
+   * task graph in the evaluate_concurrently method. */
+  static void evaluate_task(void *task_data);
+
+  /* Compiles and evaluates the given scheduled node using the given compile state. Pixel nodes
+   * are added to the pixel compile unit, which is compiled and evaluated once a node that can't
+   * be added to it is encountered. */
+  void evaluate_scheduled_node(DNode node, CompileState &compile_state);
+
+  /* Adds the given operation to the operations stream. */
+  void add_operation(std::unique_ptr<Operation> operation);
+
   /* Compile the given node into a node operation, map each input to the result of the output
    * linked to it, update the compile state, add the newly created operation to the operations
    * stream, and evaluate the operation. */
@@ -134,6 +192,30 @@ class Evaluator {
   void map_pixel_operation_inputs_to_their_results(PixelOperation *operation,
                                                    CompileState &compile_state);
 
+  /* Computes the key of the given node in the node result cache from the keys of the outputs
+   * linked to its inputs. Returns nullopt if the context doesn't use the node result cache or if
+   * the node can't be identified by a key. */
+  std::optional<NodeResultKey> compute_node_result_key(DNode node);
+
+  /* Computes and stores the keys of the results of the outputs of the given node, which has the
+   * given key. The results of the outputs of nodes that are not deterministic are hashed, so the
+   * given operation should be the evaluated operation of the node in that case, otherwise, it can
+   * be null. See is_node_result_deterministic. */
+  void add_output_result_keys(DNode node,
+                              const NodeResultKey &node_key,
+                              NodeOperation *operation);
+
+  /* Computes and stores the keys of the results of the outputs of the given pixel node. Pixel
+   * nodes are evaluated as part of a pixel operation whose results are not cached, but their keys
+   * are still needed to compute the keys of the nodes linked to them. */
+  void add_pixel_node_output_result_keys(DNode node);
+
+  /* Updates the keys of the outputs of the given pixel operation to include its region of
+   * interest, since their results are only computed inside it, so they differ from the results of
+   * the same nodes computed over the entire domain. */
+  void add_pixel_operation_region_to_output_keys(PixelOperation &operation,
+                                                 const Bounds<int2> &region);
+
   /* Cancels the evaluation by informing the static cache manager of the cancellation and freeing
    * the results of the operations that were already evaluated, that's because later operations
    * that use the already allocated results will not be evaluated, so they consequently will not
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <optional>
+
 #include "BLI_string_ref.hh"
 
 #include "DNA_node_types.h"
@@ -11,6 +13,7 @@
 #include "NOD_derived_node_tree.hh"
 
 #include "COM_context.hh"
+#include "COM_node_result_cache.hh"
 #include "COM_operation.hh"
 #include "COM_result.hh"
 #include "COM_scheduler.hh"
@@ -32,6 +35,10 @@ class NodeOperation : public Operation {
  private:
   /* The node that this operation represents. */
   DNode node_;
+  /* The key of the node in the node result cache of the context, see COM_node_result_cache.hh. If
+   * set, the results of the operation are retrieved from the cache if they are cached, otherwise,
+   * the operation is evaluated and its results are added to the cache. */
+  std::optional<NodeResultKey> result_cache_key_;
 
  public:
   /* Populate the output results based on the node outputs and populate the input descriptors based
@@ -48,6 +55,10 @@ class NodeOperation : public Operation {
    * output corresponding to each result. The node execution schedule is given as an input. */
   void compute_results_reference_counts(const Schedule &schedule);
 
+  /* Sets the key of the node in the node result cache, enabling caching of the results of the
+   * operation. See the result_cache_key_ member for more information. */
+  void set_result_cache_key(const NodeResultKey &key);
+
  protected:
   /* Compute a node preview using the result returned from the get_preview_result method. */
   void compute_preview() override;
@@ -67,6 +78,14 @@ class NodeOperation : public Operation {
    * of the node, if no outputs exist, then the first allocated input will be chosen. Returns
    * nullptr if no result is viewable. */
   Result *get_preview_result();
+
+  /* Shares the data of the cached results of the outputs that should be computed and returns
+   * true, unless any of them is not cached, in which case, false is returned and nothing is done.
+   * The inputs are released and previews are computed as if the operation was evaluated. */
+  bool retrieve_cached_results();
+
+  /* Adds the computed results of the operation to the node result cache. */
+  void add_results_to_cache();
 };
 
 }  // namespace blender::compositor
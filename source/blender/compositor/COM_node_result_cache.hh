@@ -0,0 +1,166 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+#include "BLI_bounds_types.hh"
+#include "BLI_map.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_mutex.hh"
+#include "BLI_span.hh"
+#include "BLI_string_ref.hh"
+#include "BLI_struct_equality_utils.hh"
+
+#include "NOD_derived_node_tree.hh"
+
+#include "COM_result.hh"
+
+namespace blender::compositor {
+
+using namespace nodes::derived_node_tree_types;
+
+class Context;
+
+/* ------------------------------------------------------------------------------------------------
+ * Node Result Key
+ *
+ * A hash that identifies the content of the result of a node output. Two results with the same key
+ * are assumed to be identical, so the hash has enough bits to make collisions practically
+ * impossible. The key of an output is computed from the type and properties of its node, the
+ * values of the unlinked inputs of the node, the keys of the outputs linked to the inputs of the
+ * node, and the evaluation parameters of the context like the frame number and the compositing
+ * region. See the compute_node_result_key function for more information. */
+struct NodeResultKey {
+  uint64_t v1 = 0;
+  uint64_t v2 = 0;
+
+  uint64_t hash() const
+  {
+    return v1;
+  }
+
+  BLI_STRUCT_EQUALITY_OPERATORS_2(NodeResultKey, v1, v2)
+};
+
+/* Returns true if the results of the given node only depend on its properties and inputs, such
+ * that they can be identified by a key that is computed before the node is evaluated. Nodes that
+ * reference data-blocks like images, scenes, or movie clips are not, since the data they read
+ * can change without any change to the node tree, so the keys of their results are computed from
+ * the content of the results after evaluation instead, see compute_output_result_key. */
+bool is_node_result_deterministic(const DNode &node);
+
+/* Computes the key of the given node from its type, properties, and inputs, see the NodeResultKey
+ * class for more information. The given output keys should contain the keys of all outputs linked
+ * to the inputs of the node. Returns nullopt if the node can't be identified by a key, for
+ * instance, because one of its linked outputs doesn't have a key or its properties can't be
+ * hashed. */
+std::optional<NodeResultKey> compute_node_result_key(
+    const Context &context,
+    const DNode &node,
+    const Map<DOutputSocket, NodeResultKey> &output_keys);
+
+/* Computes the key of the output of the node with the given key that is identified by the given
+ * identifier. */
+NodeResultKey compute_output_result_key(const NodeResultKey &node_key,
+                                        StringRef output_identifier);
+
+/* Identical to the above function, but additionally hashes the content of the given result, which
+ * is used for nodes whose results are not deterministic, see is_node_result_deterministic. */
+NodeResultKey compute_output_result_key(const NodeResultKey &node_key,
+                                        StringRef output_identifier,
+                                        const Result &result);
+
+/* Computes the key of an output result with the given key that was only computed inside the given
+ * region, since it differs from the result computed over its entire domain. Such results are
+ * computed by pixel operations whose region of interest is limited, see COM_region_of_interest.hh
+ * for more information. */
+NodeResultKey compute_region_result_key(const NodeResultKey &output_key,
+                                        const Bounds<int2> &region);
+
+/* ------------------------------------------------------------------------------------------------
+ * Node Result Cache
+ *
+ * A cache that keeps the results of node operations alive across evaluations of the compositor,
+ * such that editing a node only requires evaluating the nodes that depend on it, while the results
+ * of the unchanged nodes are retrieved from the cache. Results are identified by their content
+ * keys, see the NodeResultKey class, so a result is retrieved whenever the same node is evaluated
+ * with the same properties and inputs, regardless of the edits done to the rest of the node tree.
+ *
+ * Cached results share the data of the evaluated results, see Result::share_data, so caching a
+ * result doesn't copy any data. The memory of the cached results is bounded by a memory budget,
+ * and the least recently used results are evicted when the budget is exceeded. Only CPU results
+ * that own their data are cached, since GPU textures are pooled and external data is not owned by
+ * the compositor.
+ *
+ * The methods of the cache are thread safe, since nodes might be evaluated concurrently, see the
+ * Evaluator class. */
+class NodeResultCache {
+ private:
+  struct CachedResult {
+    /* A result that shares the data of the cached result. */
+    Result result;
+    /* The size of the data of the result in bytes. */
+    int64_t size = 0;
+    /* The value of the use_clock_ when the result was last added or retrieved. */
+    uint64_t last_use = 0;
+  };
+
+  /* The cached results identified by their keys. */
+  Map<NodeResultKey, CachedResult> cached_results_;
+  /* The total size of the data of the cached results in bytes. */
+  int64_t memory_usage_ = 0;
+  /* The maximum total size of the data of the cached results in bytes. */
+  int64_t memory_budget_;
+  /* A counter that is incremented every time a result is added or retrieved, used to identify the
+   * least recently used results. */
+  uint64_t use_clock_ = 0;
+  /* Guards all of the members above. */
+  mutable Mutex mutex_;
+
+ public:
+  /* Constructs a cache with a default memory budget of an eighth of the system memory. */
+  NodeResultCache();
+
+  ~NodeResultCache();
+
+  /* Returns the cached result identified by the given key, or nullptr if it is not cached. The
+   * result is marked as the most recently used one. The returned result should only be shared
+   * using the Result::share_data method and should not be modified. */
+  const Result *lookup(const NodeResultKey &key);
+
+  /* Returns true if a result identified by the given key is cached, without marking it as used. */
+  bool contains(const NodeResultKey &key) const;
+
+  /* Shares the data of the cached results identified by the given keys with the given results,
+   * which are expected to be unallocated, and marks them as the most recently used ones. If any
+   * of the results is not cached, no data is shared and false is returned. Prefer this over the
+   * lookup method when results might be retrieved concurrently, since the returned pointer of the
+   * latter might be evicted by other threads. */
+  bool retrieve(Span<NodeResultKey> keys, Span<Result *> results);
+
+  /* Adds the given result to the cache identified by the given key, sharing its data, then evicts
+   * the least recently used results if the memory budget is exceeded. Results that are not
+   * allocated, are stored on the GPU, or wrap external data are not added. The given context is
+   * the one that owns the cache, see StaticCacheManager. */
+  void add(Context &context, const NodeResultKey &key, const Result &result);
+
+  /* Sets the memory budget in bytes and evicts results until the budget is no longer exceeded. */
+  void set_memory_budget(int64_t budget);
+
+  /* Frees all cached results. */
+  void clear();
+
+  /* Returns the total size of the data of the cached results in bytes. */
+  int64_t memory_usage() const;
+
+ private:
+  /* Evicts the least recently used results until the memory usage is no larger than the
+   * budget. Assumes the mutex is locked. */
+  void evict();
+};
+
+}  // namespace blender::compositor
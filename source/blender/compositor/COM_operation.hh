@@ -98,6 +98,13 @@ class Operation {
   /* Get a reference to the output result identified by the given identifier. */
   Result &get_result(StringRef identifier);
 
+  /* Get a reference to the output results of the operation identified by their identifiers. */
+  Map<std::string, Result> &get_results();
+
+  /* Get a reference to the results mapped to the inputs of the operation, see
+   * results_mapped_to_inputs_ for more details. */
+  const Map<StringRef, Result *> &get_results_mapped_to_inputs() const;
+
   /* Map the input identified by the given identifier to the result providing its data. See
    * results_mapped_to_inputs_ for more details. This should be called by the evaluator to
    * establish links between different operations. */
@@ -161,15 +168,15 @@ class Operation {
   /* Returns a reference to the compositor context. */
   Context &context() const;
 
- private:
-  /* Evaluate the input processors. If the input processors were already added they will be
-   * evaluated directly. Otherwise, the input processors will be added and evaluated. */
-  void evaluate_input_processors();
-
   /* Release the results that are mapped to the inputs of the operation. This is called after the
    * evaluation of the operation to declare that the results are no longer needed by this
    * operation. */
   void release_inputs();
+
+ private:
+  /* Evaluate the input processors. If the input processors were already added they will be
+   * evaluated directly. Otherwise, the input processors will be added and evaluated. */
+  void evaluate_input_processors();
 };
 
 }  // namespace blender::compositor
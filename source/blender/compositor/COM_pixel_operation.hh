@@ -4,7 +4,11 @@
 
 #pragma once
 
+#include <optional>
+
+#include "BLI_bounds_types.hh"
 #include "BLI_map.hh"
+#include "BLI_math_vector_types.hh"
 #include "BLI_string_ref.hh"
 #include "BLI_vector_set.hh"
 
@@ -97,6 +101,11 @@ class PixelOperation : public Operation {
   /* A vector set that stores all output sockets that are used as previews for nodes inside the
    * pixel operation. */
   VectorSet<DOutputSocket> preview_outputs_;
+  /* The region of the operation domain that the operations using the results of the operation
+   * read, or nullopt if the entire domain is read. Pixel operations may only compute the pixels
+   * inside this region and leave the rest uninitialized. See COM_region_of_interest.hh for more
+   * information. */
+  std::optional<Bounds<int2>> region_of_interest_;
 
  public:
   PixelOperation(Context &context, PixelCompileUnit &compile_unit, const Schedule &schedule);
@@ -129,6 +138,14 @@ class PixelOperation : public Operation {
    * results. See implicit_inputs_to_input_identifiers_map_ for more information. */
   Map<ImplicitInput, std::string> &get_implicit_inputs_to_input_identifiers_map();
 
+  /* Get a reference to the output sockets to output identifiers map of the operation. This is
+   * called by the compiler to compute the region of interest of the operation. See
+   * output_sockets_to_output_identifiers_map_ for more information. */
+  Map<DOutputSocket, std::string> &get_output_sockets_to_output_identifiers_map();
+
+  /* Set the region of interest of the operation. See region_of_interest_ for more information. */
+  void set_region_of_interest(const std::optional<Bounds<int2>> &region);
+
   /* Returns the internal reference count of the operation input with the given identifier. See the
    * inputs_to_reference_counts_map_ member for more information. */
   int get_internal_input_reference_count(const StringRef &identifier);
@@ -4,7 +4,10 @@
 
 #pragma once
 
+#include <cstdint>
+
 #include "BLI_map.hh"
+#include "BLI_mutex.hh"
 #include "BLI_timeit.hh"
 
 #include "DNA_node_types.h"
@@ -19,6 +22,34 @@ class Context;
  * A class that profiles the evaluation of the compositor and tracks information like the
  * evaluation time of every node. */
 class Profiler {
+ public:
+  /* The number of pixels computed for the results of a node, as well as the number of pixels in
+   * the domains of those results, which would have been computed if the results were computed
+   * entirely regardless of their regions of interest. See COM_region_of_interest.hh. */
+  struct ComputedPixels {
+    int64_t computed = 0;
+    int64_t domain = 0;
+  };
+
+  /* The number of node operations whose results were retrieved from the node result cache and
+   * the number of those that were evaluated because their results were not cached, as well as the
+   * memory used by the cache after evaluation. See COM_node_result_cache.hh. */
+  struct NodeResultCacheStatistics {
+    int64_t hits = 0;
+    int64_t misses = 0;
+    int64_t memory_usage = 0;
+  };
+
+  /* The number of tiles of results that were spilled to the scratch file because the memory
+   * budget of results was exceeded and the number of those that were restored, as well as the
+   * size of the spilled data before and after compression. See COM_result_spill_manager.hh. */
+  struct ResultSpillStatistics {
+    int64_t spilled_tiles = 0;
+    int64_t restored_tiles = 0;
+    int64_t spilled_size = 0;
+    int64_t compressed_size = 0;
+  };
+
  private:
   /* Stores the evaluation time of each node instance keyed by its instance key. Note that
    * pixel-wise nodes like Math nodes will not be measured, that's because they are compiled
@@ -26,6 +57,23 @@ class Profiler {
    * evaluation time of each individual node. */
   Map<bNodeInstanceKey, timeit::Nanoseconds> nodes_evaluation_times_;
 
+  /* Stores the number of computed pixels of each node instance keyed by its instance key. This is
+   * currently only tracked for pixel-wise nodes, since those are the ones which compute their
+   * regions of interest only. */
+  Map<bNodeInstanceKey, ComputedPixels> nodes_computed_pixels_;
+
+  /* Stores whether the results of each node instance were retrieved from the node result cache,
+   * keyed by its instance key. Only nodes whose results can be cached are stored. */
+  Map<bNodeInstanceKey, bool> nodes_result_cache_hits_;
+
+  NodeResultCacheStatistics node_result_cache_statistics_;
+
+  ResultSpillStatistics result_spill_statistics_;
+
+  /* Guards the members above, since nodes might be evaluated concurrently, see the Evaluator
+   * class. */
+  Mutex mutex_;
+
  public:
   /* Returns a reference to the nodes evaluation times. */
   Map<bNodeInstanceKey, timeit::Nanoseconds> &get_nodes_evaluation_times();
@@ -33,6 +81,42 @@ class Profiler {
   /* Set the evaluation time of the node identified by the given node instance key. */
   void set_node_evaluation_time(bNodeInstanceKey node_instance_key, timeit::Nanoseconds time);
 
+  /* Returns a reference to the number of computed pixels of the nodes. */
+  Map<bNodeInstanceKey, ComputedPixels> &get_nodes_computed_pixels();
+
+  /* Add the given number of computed pixels and domain pixels to the node identified by the given
+   * node instance key. */
+  void add_node_computed_pixels(bNodeInstanceKey node_instance_key,
+                                int64_t computed_pixels,
+                                int64_t domain_pixels);
+
+  /* Returns the number of computed pixels and domain pixels accumulated over all nodes. */
+  ComputedPixels get_total_computed_pixels() const;
+
+  /* Returns a reference to whether the results of the nodes were retrieved from the node result
+   * cache. */
+  Map<bNodeInstanceKey, bool> &get_nodes_result_cache_hits();
+
+  /* Records that the results of the node identified by the given node instance key were looked up
+   * in the node result cache, and whether they were found. */
+  void add_node_result_cache_lookup(bNodeInstanceKey node_instance_key, bool is_hit);
+
+  /* Sets the memory used by the node result cache after evaluation. */
+  void set_node_result_cache_memory_usage(int64_t memory_usage);
+
+  /* Returns the statistics of the node result cache in the profiled evaluation. */
+  const NodeResultCacheStatistics &get_node_result_cache_statistics() const;
+
+  /* Records that the given number of tiles of results were spilled, whose data had the given size
+   * before and after compression. */
+  void add_spilled_tiles(int64_t tiles_count, int64_t size, int64_t compressed_size);
+
+  /* Records that the given number of spilled tiles were restored. */
+  void add_restored_tiles(int64_t tiles_count);
+
+  /* Returns the statistics of the spilled results in the profiled evaluation. */
+  const ResultSpillStatistics &get_result_spill_statistics() const;
+
   /* Finalize profiling by computing node group times. This should be called after evaluation. */
   void finalize(const bNodeTree &node_tree);
 
@@ -0,0 +1,46 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include "BLI_bounds_types.hh"
+#include "BLI_map.hh"
+#include "BLI_math_vector_types.hh"
+
+#include "NOD_derived_node_tree.hh"
+
+#include "COM_context.hh"
+#include "COM_scheduler.hh"
+
+namespace blender::compositor {
+
+using namespace nodes::derived_node_tree_types;
+
+/* A type representing the region of interest of the results of output sockets, that is, the
+ * region of the result in its own pixel space that is read by the nodes linked to the output.
+ * Outputs whose results are read entirely are not stored in the map. */
+using RegionsOfInterest = Map<DOutputSocket, Bounds<int2>>;
+
+/* ------------------------------------------------------------------------------------------------
+ * Region Of Interest
+ *
+ * Computes the regions of interest of the outputs of the scheduled nodes by propagating the
+ * regions read by nodes backwards through the schedule. Consider the following node graph, where
+ * a large image is color corrected then cropped to a small region:
+ *
+ *   .-------.    .-------------.    .------------.    .--------.
+ *   | Image |----| Hue/Sat/Val |----| Brightness |----|  Crop  |
+ *   '-------'    '-------------'    '------------'    '--------'
+ *
+ * The Crop node only reads its cropping bounds from its input, and since pixel nodes with a single
+ * non single value input read the same pixels that they write, the region propagates to the
+ * output of the Hue/Sat/Val node, and both pixel nodes only need to compute the cropped region.
+ *
+ * Regions are only computed for nodes whose domains are known to match the domains of their
+ * inputs without evaluating the node tree, so the propagation stops at all other nodes, which are
+ * assumed to read their inputs entirely. Regions are not computed for GPU contexts or if node
+ * previews are needed, since previews read the entire results. */
+RegionsOfInterest compute_regions_of_interest(const Context &context, const Schedule &schedule);
+
+}  // namespace blender::compositor
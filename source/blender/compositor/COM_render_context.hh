@@ -9,6 +9,7 @@
 
 #include "BLI_map.hh"
 #include "BLI_math_vector_types.hh"
+#include "BLI_mutex.hh"
 
 #include "DNA_scene_types.h"
 
@@ -95,6 +96,8 @@ class RenderContext {
    * get_file_output method and saved in the save_file_outputs method. See those methods for more
    * information. */
   Map<std::string, std::unique_ptr<FileOutput>> file_outputs_;
+  /* Guards the file outputs map, since File Output nodes might be evaluated concurrently. */
+  Mutex mutex_;
 
  public:
   /* Check if there is an available file output with the given path in the context, if one exists,
@@ -86,6 +86,10 @@ enum class ResultStorageType : uint8_t {
  * every time the data is shared by a call to the share_data method, and decremented during
  * freeing, where the data is only freed if the reference count is 1, that is, no longer shared.
  *
+ * The reference counts are guarded by the results mutex of the context, since independent branches
+ * of the node tree might be evaluated concurrently, in which case, results might be shared and
+ * released from multiple threads, see the Evaluator class.
+ *
  * A result can wrap external data that is not allocated nor managed by the result. This is set up
  * by a call to the wrap_external method. In that case, when the reference count eventually reach
  * zero, the data will not be freed.
@@ -146,6 +150,9 @@ class Result {
   /* Stores resources that are derived from this result. Lazily allocated if needed. See the class
    * description for more information. */
   DerivedResources *derived_resources_ = nullptr;
+  /* If true, the CPU data of the result was spilled to a scratch file to reduce memory usage and
+   * is not currently allocated, see the spill method. */
+  bool is_spilled_ = false;
 
  public:
   /* Stores extra information about the result such as image meta data that can eventually be
@@ -337,6 +344,29 @@ class Result {
   /* Returns true if the result is allocated. */
   bool is_allocated() const;
 
+  /* Returns true if the result wraps external data. See the is_external_ member. */
+  bool is_external() const;
+
+  /* Returns true if the data of the result is shared with other results, see share_data. */
+  bool is_data_shared() const;
+
+  /* Returns true if the data of the result was spilled, see the spill method. */
+  bool is_spilled() const;
+
+  /* Frees the CPU data of the result while keeping the result itself allocated, such that its data
+   * can later be restored using the unspill method. This is used to reduce memory usage by
+   * storing the data elsewhere while it is not used, which is the responsibility of the caller,
+   * see COM_result_spill_manager.hh. The result is expected to be a CPU image result that owns
+   * its data, and its data shouldn't be shared with other results. */
+  void spill();
+
+  /* Reallocates the CPU data of a result that was spilled using the spill method. The data is left
+   * uninitialized, and it is the responsibility of the caller to restore it. */
+  void unspill();
+
+  /* Returns the type of storage used to hold the data of the result. */
+  ResultStorageType storage_type() const;
+
   /* Returns the reference count of the result. */
   int reference_count() const;
 
@@ -464,6 +494,9 @@ class Result {
                      const bool from_pool = true,
                      const std::optional<ResultStorageType> storage_type = std::nullopt);
 
+  /* Identical to the free method, but assumes the results mutex of the context is locked. */
+  void free_data();
+
   /* Same as get_pixel_index but can be used when the type of the result is not known at compile
    * time. */
   int64_t get_pixel_index(const int2 &texel) const;
@@ -0,0 +1,111 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "BLI_map.hh"
+#include "BLI_vector.hh"
+
+#include "COM_context.hh"
+#include "COM_operation.hh"
+#include "COM_result.hh"
+
+namespace blender::compositor {
+
+/* ------------------------------------------------------------------------------------------------
+ * Result Spill Manager
+ *
+ * Limits the memory used by the CPU data of the results of an evaluation by spilling the least
+ * recently used results to a scratch file in the temporary directory of the session when the
+ * total size of the resident results exceeds a memory budget, see
+ * Context::get_results_memory_budget. This allows compositing images whose intermediate results
+ * don't fit in memory, at the cost of the time needed to write and read them back.
+ *
+ * The data of spilled results is split into tiles of whole rows, which are compressed in parallel
+ * and written sequentially to the scratch file. Since operations read their inputs as contiguous
+ * buffers, a spilled result is restored entirely before the evaluation of any operation that uses
+ * it, and its tiles are decompressed in parallel. The inputs of the operation that is about to be
+ * evaluated are never spilled, and neither are results whose data is shared with other results,
+ * like results retrieved from the node result cache, since spilling them wouldn't free any memory.
+ *
+ * The manager is expected to be used by the evaluator as follows. Before an operation is
+ * evaluated, the prepare_operation method should be called to make room for and restore its
+ * inputs, and after it is evaluated, the add_operation_results method should be called to track
+ * its newly allocated results. */
+class ResultSpillManager {
+ private:
+  /* A compressed tile of the data of a spilled result in the scratch file. */
+  struct SpilledTile {
+    /* The offset of the compressed data of the tile in the scratch file. */
+    int64_t offset = 0;
+    /* The size of the compressed data of the tile in bytes. */
+    int64_t compressed_size = 0;
+    /* The size of the uncompressed data of the tile in bytes. */
+    int64_t size = 0;
+  };
+
+  struct TrackedResult {
+    /* The size of the data of the result in bytes. */
+    int64_t size = 0;
+    /* The value of the use_clock_ when the result was last added or used by an operation. */
+    uint64_t last_use = 0;
+    /* The tiles of the result in the scratch file if it is spilled. */
+    Vector<SpilledTile> tiles;
+  };
+
+  Context &context_;
+  /* The maximum total size in bytes of the data of the resident tracked results. */
+  int64_t memory_budget_;
+  /* The tracked results, which are owned by the operations of the evaluator. */
+  Map<Result *, TrackedResult> tracked_results_;
+  /* The total size in bytes of the data of the tracked results that are not spilled. */
+  int64_t memory_usage_ = 0;
+  /* A counter that is incremented every time a result is added or used, used to identify the
+   * least recently used results. */
+  uint64_t use_clock_ = 0;
+  /* The scratch file that stores the data of spilled results, lazily created when the first result
+   * is spilled and deleted when the manager is destructed. */
+  FILE *file_ = nullptr;
+  std::string file_path_;
+  /* The size of the written data of the scratch file, which is where the next tile is written. */
+  int64_t file_end_ = 0;
+  /* The number of tracked results that are currently spilled. Once no results are spilled, the
+   * scratch file is reused from its start. */
+  int spilled_results_count_ = 0;
+
+ public:
+  ResultSpillManager(Context &context, int64_t memory_budget);
+
+  ~ResultSpillManager();
+
+  /* Spills the least recently used results until the inputs of the given operation fit in the
+   * memory budget, if possible, then restores the inputs that are spilled. Should be called before
+   * the operation is evaluated. */
+  void prepare_operation(Operation &operation);
+
+  /* Tracks the allocated CPU image results of the given operation, such that they can be spilled
+   * when the memory budget is exceeded. Should be called after the operation is evaluated. */
+  void add_operation_results(Operation &operation);
+
+ private:
+  /* Stops tracking results that were freed since they were added. */
+  void remove_freed_results();
+
+  /* Spills the given result to the scratch file. Returns false if the result couldn't be spilled,
+   * for instance, because the scratch file couldn't be written, in which case the result stays in
+   * memory. */
+  bool spill(Result &result, TrackedResult &tracked_result);
+
+  /* Restores the data of the given spilled result from the scratch file. */
+  void restore(Result &result, TrackedResult &tracked_result);
+
+  /* Opens the scratch file if it is not already open. Returns false if it couldn't be opened. */
+  bool ensure_file();
+};
+
+}  // namespace blender::compositor
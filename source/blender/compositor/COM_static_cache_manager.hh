@@ -14,6 +14,7 @@
 #include "COM_image_coordinates.hh"
 #include "COM_keying_screen.hh"
 #include "COM_morphological_distance_feather_weights.hh"
+#include "COM_node_result_cache.hh"
 #include "COM_ocio_color_space_conversion_shader.hh"
 #include "COM_smaa_precomputed_textures.hh"
 #include "COM_symmetric_blur_weights.hh"
@@ -45,7 +46,10 @@ namespace blender::compositor {
  * evaluation will be deleted before the next evaluation. This mechanism is implemented in the
  * reset() method of the class, which should be called before every evaluation. The reset for the
  * next evaluation can be skipped by calling the skip_next_reset() method, see its description for
- * more information. */
+ * more information.
+ *
+ * The node results cache is an exception, since its results are kept across evaluations as long as
+ * they fit in its memory budget, see the NodeResultCache class for more information. */
 class StaticCacheManager {
  public:
   SymmetricBlurWeightsContainer symmetric_blur_weights;
@@ -63,6 +67,7 @@ class StaticCacheManager {
   VanVlietGaussianCoefficientsContainer van_vliet_gaussian_coefficients;
   FogGlowKernelContainer fog_glow_kernels;
   ImageCoordinatesContainer image_coordinates;
+  NodeResultCache node_results;
 
  private:
   /* The cache manager should skip the next reset. See the skip_next_reset() method for more
@@ -5,6 +5,7 @@
 #include "BLI_index_range.hh"
 #include "BLI_math_color.h"
 #include "BLI_math_vector_types.hh"
+#include "BLI_mutex.hh"
 #include "BLI_task.hh"
 
 #include "DNA_node_types.h"
@@ -119,6 +120,10 @@ static int2 compute_preview_size(int2 size)
   return int2(int(greater_dimension_size * (float(size.x) / size.y)), greater_dimension_size);
 }
 
+/* Guards the previews map of the node tree, since previews of multiple nodes might be computed
+ * concurrently, see the Evaluator class. */
+static Mutex previews_mutex;
+
 void compute_preview(Context &context, const DNode &node, const Result &input_result)
 {
   /* Initialize node tree previews if not already initialized. */
@@ -127,8 +132,12 @@ void compute_preview(Context &context, const DNode &node, const Result &input_re
 
   const int2 preview_size = compute_preview_size(input_result.domain().size);
 
-  bke::bNodePreview *preview = bke::node_preview_verify(
-      root_tree->runtime->previews, node.instance_key(), preview_size.x, preview_size.y, true);
+  bke::bNodePreview *preview = nullptr;
+  {
+    std::scoped_lock lock(previews_mutex);
+    preview = bke::node_preview_verify(
+        root_tree->runtime->previews, node.instance_key(), preview_size.x, preview_size.y, true);
+  }
 
   if (context.use_gpu()) {
     compute_preview_gpu(context, input_result, preview);
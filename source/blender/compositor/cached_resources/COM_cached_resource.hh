@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include "BLI_mutex.hh"
+
 namespace blender::compositor {
 
 /* -------------------------------------------------------------------------------------------------
@@ -41,6 +43,12 @@ class CachedResource {
  *
  * See the existing cached resources for reference. */
 class CachedResourceContainer {
+ protected:
+  /* Guards the cached resources of the container, since the getter methods might be called
+   * concurrently when independent branches of the node tree are evaluated in parallel, so getters
+   * should lock it. */
+  Mutex mutex_;
+
  public:
   /* Reset the container by deleting the cached resources that are no longer needed because they
    * weren't used in the last evaluation and prepare the remaining cached resources to track their
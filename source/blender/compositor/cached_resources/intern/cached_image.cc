@@ -402,6 +402,8 @@ Result CachedImageContainer::get(Context &context,
                                  const ImageUser *image_user,
                                  const char *pass_name)
 {
+  std::scoped_lock lock(mutex_);
+
   if (!image || !image_user) {
     return Result(context);
   }
@@ -171,6 +171,8 @@ FogGlowKernel &FogGlowKernelContainer::get(int kernel_size,
                                            int2 spatial_size,
                                            math::AngleRadian field_of_view)
 {
+  std::scoped_lock lock(mutex_);
+
   const FogGlowKernelKey key(kernel_size, spatial_size, field_of_view);
 
   auto &kernel = *map_.lookup_or_add_cb(key, [&]() {
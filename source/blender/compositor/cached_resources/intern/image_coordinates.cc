@@ -136,6 +136,8 @@ Result &ImageCoordinatesContainer::get(Context &context,
                                        const int2 &size,
                                        const CoordinatesType type)
 {
+  std::scoped_lock lock(mutex_);
+
   const ImageCoordinatesKey key(size, type);
 
   auto &pixel_coordinates = *map_.lookup_or_add_cb(
@@ -105,6 +105,8 @@ void SymmetricSeparableBlurWeightsContainer::reset()
 
 Result &SymmetricSeparableBlurWeightsContainer::get(Context &context, int type, float radius)
 {
+  std::scoped_lock lock(mutex_);
+
   const SymmetricSeparableBlurWeightsKey key(type, radius);
 
   auto &weights = *map_.lookup_or_add_cb(key, [&]() {
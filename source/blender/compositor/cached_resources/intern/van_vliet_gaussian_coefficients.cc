@@ -544,6 +544,8 @@ void VanVlietGaussianCoefficientsContainer::reset()
 VanVlietGaussianCoefficients &VanVlietGaussianCoefficientsContainer::get(Context &context,
                                                                          float sigma)
 {
+  std::scoped_lock lock(mutex_);
+
   const VanVlietGaussianCoefficientsKey key(sigma);
 
   auto &deriche_gaussian_coefficients = *map_.lookup_or_add_cb(
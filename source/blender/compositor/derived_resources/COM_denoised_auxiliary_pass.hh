@@ -11,6 +11,7 @@
 #  include <string>
 
 #  include "BLI_map.hh"
+#  include "BLI_mutex.hh"
 
 #  include <OpenImageDenoise/oidn.hpp>
 
@@ -63,6 +64,8 @@ class DenoisedAuxiliaryPass {
 class DenoisedAuxiliaryPassContainer {
  private:
   Map<DenoisedAuxiliaryPassKey, std::unique_ptr<DenoisedAuxiliaryPass>> map_;
+  /* Guards the map, since multiple operations might denoise the same pass concurrently. */
+  Mutex mutex_;
 
  public:
   /* Check if there is an available DenoisedAuxiliaryPass derived resource with the given
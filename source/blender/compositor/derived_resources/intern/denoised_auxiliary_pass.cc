@@ -133,6 +133,8 @@ DenoisedAuxiliaryPass &DenoisedAuxiliaryPassContainer::get(Context &context,
                                                            const DenoisedAuxiliaryPassType type,
                                                            const oidn::Quality quality)
 {
+  std::scoped_lock lock(mutex_);
+
   const DenoisedAuxiliaryPassKey key(type, quality);
 
   return *map_.lookup_or_add_cb(key, [&]() {
@@ -3,7 +3,12 @@
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
 #include <limits>
+#include <optional>
+#include <string>
 
+#include "BLI_bounds.hh"
+#include "BLI_bounds_types.hh"
+#include "BLI_assert.h"
 #include "BLI_math_vector_types.hh"
 
 #include "DNA_node_types.h"
@@ -16,6 +21,7 @@
 #include "COM_input_descriptor.hh"
 #include "COM_node_operation.hh"
 #include "COM_pixel_operation.hh"
+#include "COM_region_of_interest.hh"
 #include "COM_result.hh"
 #include "COM_scheduler.hh"
 #include "COM_utilities.hh"
@@ -25,10 +31,25 @@ namespace blender::compositor {
 using namespace nodes::derived_node_tree_types;
 
 CompileState::CompileState(const Context &context, const Schedule &schedule)
-    : context_(context), schedule_(schedule)
+    : context_(context),
+      schedule_(schedule),
+      computed_regions_of_interest_(compute_regions_of_interest(context, schedule)),
+      regions_of_interest_(computed_regions_of_interest_)
 {
 }
 
+CompileState::CompileState(const Context &context,
+                           const Schedule &schedule,
+                           const RegionsOfInterest &regions_of_interest)
+    : context_(context), schedule_(schedule), regions_of_interest_(regions_of_interest)
+{
+}
+
+void CompileState::add_dependency(const CompileState &compile_state)
+{
+  dependencies_.append_non_duplicates(&compile_state);
+}
+
 const Schedule &CompileState::get_schedule()
 {
   return schedule_;
@@ -46,20 +67,40 @@ void CompileState::map_node_to_pixel_operation(DNode node, PixelOperation *opera
 
 Result &CompileState::get_result_from_output_socket(DOutputSocket output)
 {
+  const CompileState &compile_state = this->get_compile_state_of_node(output.node());
+
   /* The output belongs to a node that was compiled into a standard node operation, so return a
    * reference to the result from that operation using the output identifier. */
-  if (node_operations_.contains(output.node())) {
-    NodeOperation *operation = node_operations_.lookup(output.node());
+  if (compile_state.node_operations_.contains(output.node())) {
+    NodeOperation *operation = compile_state.node_operations_.lookup(output.node());
     return operation->get_result(output->identifier);
   }
 
   /* Otherwise, the output belongs to a node that was compiled into a pixel operation, so retrieve
    * the internal identifier of that output and return a reference to the result from that
    * operation using the retrieved identifier. */
-  PixelOperation *operation = pixel_operations_.lookup(output.node());
+  PixelOperation *operation = compile_state.pixel_operations_.lookup(output.node());
   return operation->get_result(operation->get_output_identifier_from_output_socket(output));
 }
 
+const CompileState &CompileState::get_compile_state_of_node(DNode node) const
+{
+  if (node_operations_.contains(node) || pixel_operations_.contains(node)) {
+    return *this;
+  }
+
+  for (const CompileState *dependency : dependencies_) {
+    if (dependency->node_operations_.contains(node) ||
+        dependency->pixel_operations_.contains(node))
+    {
+      return *dependency;
+    }
+  }
+
+  BLI_assert_unreachable();
+  return *this;
+}
+
 void CompileState::add_node_to_pixel_compile_unit(DNode node)
 {
   pixel_compile_unit_.add_new(node);
@@ -157,6 +198,24 @@ int CompileState::compute_pixel_node_operation_outputs_count(DNode node)
   return outputs_count;
 }
 
+std::optional<Bounds<int2>> CompileState::compute_pixel_operation_region_of_interest(
+    PixelOperation &operation)
+{
+  const Map<DOutputSocket, std::string> &outputs =
+      operation.get_output_sockets_to_output_identifiers_map();
+
+  std::optional<Bounds<int2>> region;
+  for (const DOutputSocket &output : outputs.keys()) {
+    const std::optional<Bounds<int2>> output_region = regions_of_interest_.lookup_try(output);
+    if (!output_region) {
+      return std::nullopt;
+    }
+    region = bounds::merge(region, output_region);
+  }
+
+  return region;
+}
+
 bool CompileState::is_pixel_node_single_value(DNode node)
 {
   /* The pixel node is single value when all of its inputs are single values. */
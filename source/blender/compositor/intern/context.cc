@@ -67,6 +67,21 @@ bool Context::is_canceled() const
   return this->get_node_tree().runtime->test_break(get_node_tree().runtime->tbh);
 }
 
+bool Context::use_node_result_cache() const
+{
+  return false;
+}
+
+bool Context::use_concurrent_evaluation() const
+{
+  return false;
+}
+
+int64_t Context::get_results_memory_budget() const
+{
+  return 0;
+}
+
 void Context::reset()
 {
   cache_manager_.reset();
@@ -136,4 +151,9 @@ StaticCacheManager &Context::cache_manager()
   return cache_manager_;
 }
 
+Mutex &Context::results_mutex()
+{
+  return results_mutex_;
+}
+
 }  // namespace blender::compositor
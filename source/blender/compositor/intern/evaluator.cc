@@ -2,8 +2,17 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include <memory>
+#include <optional>
+
+#include "BLI_map.hh"
 #include "BLI_memory_utils.hh"
+#include "BLI_mutex.hh"
+#include "BLI_span.hh"
 #include "BLI_string.h"
+#include "BLI_task.h"
+#include "BLI_task.hh"
+#include "BLI_vector.hh"
 
 #include "DNA_node_types.h"
 
@@ -16,8 +25,11 @@
 #include "COM_input_single_value_operation.hh"
 #include "COM_multi_function_procedure_operation.hh"
 #include "COM_node_operation.hh"
+#include "COM_node_result_cache.hh"
 #include "COM_operation.hh"
+#include "COM_region_of_interest.hh"
 #include "COM_result.hh"
+#include "COM_result_spill_manager.hh"
 #include "COM_scheduler.hh"
 #include "COM_shader_operation.hh"
 #include "COM_utilities.hh"
@@ -34,6 +46,10 @@ void Evaluator::evaluate()
 
   BLI_SCOPED_DEFER([&]() {
     if (context_.profiler()) {
+      if (context_.use_node_result_cache()) {
+        context_.profiler()->set_node_result_cache_memory_usage(
+            context_.cache_manager().node_results.memory_usage());
+      }
       context_.profiler()->finalize(context_.get_node_tree());
     }
   });
@@ -51,6 +67,16 @@ void Evaluator::evaluate()
 
   const Schedule schedule = compute_schedule(context_, *derived_node_tree_);
 
+  if (this->should_evaluate_concurrently()) {
+    this->evaluate_concurrently(schedule);
+    return;
+  }
+
+  const int64_t results_memory_budget = context_.get_results_memory_budget();
+  if (results_memory_budget > 0) {
+    result_spill_manager_ = std::make_unique<ResultSpillManager>(context_, results_memory_budget);
+  }
+
   CompileState compile_state(context_, schedule);
 
   for (const DNode &node : schedule) {
@@ -59,16 +85,7 @@ void Evaluator::evaluate()
       return;
     }
 
-    if (compile_state.should_compile_pixel_compile_unit(node)) {
-      this->evaluate_pixel_compile_unit(compile_state);
-    }
-
-    if (is_pixel_node(node)) {
-      compile_state.add_node_to_pixel_compile_unit(node);
-    }
-    else {
-      this->evaluate_node(node, compile_state);
-    }
+    this->evaluate_scheduled_node(node, compile_state);
   }
 }
 
@@ -104,6 +121,175 @@ bool Evaluator::validate_node_tree()
   return true;
 }
 
+bool Evaluator::should_evaluate_concurrently() const
+{
+  if (context_.use_gpu() || !context_.use_concurrent_evaluation()) {
+    return false;
+  }
+
+  /* Evaluating independent branches concurrently keeps more results alive at the same time, and
+   * the result spill manager assumes operations are evaluated one after the other. */
+  if (context_.get_results_memory_budget() > 0) {
+    return false;
+  }
+
+  /* The task graph runs the successors of a task as soon as it finishes when only a single thread
+   * is available, without waiting for their other dependencies, so it can't be used in that case,
+   * which is fine since there is nothing to gain from it anyways. */
+  return BLI_task_scheduler_num_threads() > 1;
+}
+
+struct Evaluator::EvaluationTask {
+  Evaluator *evaluator = nullptr;
+  /* The consecutive nodes of the schedule that the task evaluates. */
+  Span<DNode> nodes;
+  /* The indices of the tasks that evaluate the nodes linked to the inputs of the nodes of this
+   * task, which should be evaluated before this task. */
+  Vector<int> dependencies;
+  /* The compile state used to compile the nodes of this task. */
+  std::unique_ptr<CompileState> compile_state;
+};
+
+void Evaluator::evaluate_concurrently(const Schedule &schedule)
+{
+  /* The regions of interest are computed for the entire schedule once and shared by the compile
+   * states of all tasks. */
+  const RegionsOfInterest regions_of_interest = compute_regions_of_interest(context_, schedule);
+
+  Vector<std::unique_ptr<EvaluationTask>> tasks;
+  Map<DNode, int> node_tasks;
+  const Span<DNode> nodes = schedule.as_span();
+  for (int start = 0; start < nodes.size();) {
+    /* Consecutive pixel nodes are evaluated in the same task, such that they are compiled into the
+     * same pixel operations as they would have been in sequential evaluation. */
+    int end = start + 1;
+    if (is_pixel_node(nodes[start])) {
+      while (end < nodes.size() && is_pixel_node(nodes[end])) {
+        end++;
+      }
+    }
+
+    const int task_index = tasks.size();
+    std::unique_ptr<EvaluationTask> task = std::make_unique<EvaluationTask>();
+    task->evaluator = this;
+    task->nodes = nodes.slice(start, end - start);
+    task->compile_state = std::make_unique<CompileState>(context_, schedule, regions_of_interest);
+
+    for (const DNode &node : task->nodes) {
+      node_tasks.add_new(node, task_index);
+    }
+
+    for (const DNode &node : task->nodes) {
+      for (const bNodeSocket *input : node->input_sockets()) {
+        if (!is_socket_available(input)) {
+          continue;
+        }
+
+        const DSocket origin = get_input_origin_socket(DInputSocket{node.context(), input});
+        if (origin->is_input()) {
+          continue;
+        }
+
+        const std::optional<int> dependency = node_tasks.lookup_try(origin.node());
+        if (dependency && *dependency != task_index) {
+          task->dependencies.append_non_duplicates(*dependency);
+        }
+      }
+    }
+
+    tasks.append(std::move(task));
+    start = end;
+  }
+
+  TaskGraph *task_graph = BLI_task_graph_create();
+
+  Vector<TaskNode *> task_nodes;
+  for (std::unique_ptr<EvaluationTask> &task : tasks) {
+    task_nodes.append(BLI_task_graph_node_create(task_graph, evaluate_task, task.get(), nullptr));
+  }
+
+  for (const int i : tasks.index_range()) {
+    for (const int dependency : tasks[i]->dependencies) {
+      BLI_task_graph_edge_create(task_nodes[dependency], task_nodes[i]);
+      tasks[i]->compile_state->add_dependency(*tasks[dependency]->compile_state);
+    }
+  }
+
+  for (const int i : tasks.index_range()) {
+    if (tasks[i]->dependencies.is_empty()) {
+      BLI_task_graph_node_push_work(task_nodes[i]);
+    }
+  }
+
+  BLI_task_graph_work_and_wait(task_graph);
+  BLI_task_graph_free(task_graph);
+
+  if (is_canceled_) {
+    this->cancel_evaluation();
+  }
+}
+
+void Evaluator::evaluate_task(void *task_data)
+{
+  EvaluationTask &task = *static_cast<EvaluationTask *>(task_data);
+  Evaluator &evaluator = *task.evaluator;
+
+  /* Isolate the task, such that threads waiting for parallel work inside of it, possibly while
+   * holding a lock like those of the cached resources, don't start evaluating other tasks that
+   * might wait for the same lock. */
+  threading::isolate_task([&]() {
+    for (const DNode &node : task.nodes) {
+      /* Skip the rest of the tasks once canceled, since the results of the tasks they depend on
+       * might not have been computed. */
+      if (evaluator.is_canceled_ || evaluator.context_.is_canceled()) {
+        evaluator.is_canceled_ = true;
+        return;
+      }
+
+      evaluator.evaluate_scheduled_node(node, *task.compile_state);
+    }
+
+    /* In sequential evaluation, the pixel compile unit is compiled once the node following the
+     * pixel nodes is encountered, which belongs to another task, so compile it now. */
+    if (!task.compile_state->get_pixel_compile_unit().is_empty()) {
+      evaluator.evaluate_pixel_compile_unit(*task.compile_state);
+    }
+  });
+}
+
+void Evaluator::evaluate_scheduled_node(DNode node, CompileState &compile_state)
+{
+  if (compile_state.should_compile_pixel_compile_unit(node)) {
+    this->evaluate_pixel_compile_unit(compile_state);
+  }
+
+  if (is_pixel_node(node)) {
+    compile_state.add_node_to_pixel_compile_unit(node);
+    this->add_pixel_node_output_result_keys(node);
+  }
+  else {
+    this->evaluate_node(node, compile_state);
+  }
+}
+
+void Evaluator::add_operation(std::unique_ptr<Operation> operation)
+{
+  std::scoped_lock lock(mutex_);
+  operations_stream_.append(std::move(operation));
+}
+
+/* Returns true if the node has at least one available output. Nodes that have none, like output
+ * nodes, are evaluated for their side effects, so their evaluation should never be skipped. */
+static bool has_available_outputs(const DNode &node)
+{
+  for (const bNodeSocket *output : node->output_sockets()) {
+    if (is_socket_available(output)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void Evaluator::evaluate_node(DNode node, CompileState &compile_state)
 {
   NodeOperation *operation = node->typeinfo->get_compositor_operation(context_, node);
@@ -115,11 +301,30 @@ void Evaluator::evaluate_node(DNode node, CompileState &compile_state)
   /* This has to be done after input mapping because the method may add Input Single Value
    * Operations to the operations stream, which needs to be evaluated before the operation itself
    * is evaluated. */
-  operations_stream_.append(std::unique_ptr<Operation>(operation));
+  this->add_operation(std::unique_ptr<Operation>(operation));
 
   operation->compute_results_reference_counts(compile_state.get_schedule());
 
+  /* The key is computed before evaluation, such that the results of the operation can be retrieved
+   * from the node result cache instead of being computed if they were cached. */
+  const std::optional<NodeResultKey> node_key = this->compute_node_result_key(node);
+  if (node_key && is_node_result_deterministic(node) && has_available_outputs(node)) {
+    operation->set_result_cache_key(*node_key);
+  }
+
+  if (result_spill_manager_) {
+    result_spill_manager_->prepare_operation(*operation);
+  }
+
   operation->evaluate();
+
+  if (node_key) {
+    this->add_output_result_keys(node, *node_key, operation);
+  }
+
+  if (result_spill_manager_) {
+    result_spill_manager_->add_operation_results(*operation);
+  }
 }
 
 void Evaluator::map_node_operation_inputs_to_their_results(DNode node,
@@ -151,7 +356,7 @@ void Evaluator::map_node_operation_inputs_to_their_results(DNode node,
         context_, DInputSocket(dorigin));
     operation->map_input_to_result(input->identifier, &input_operation->get_result());
 
-    operations_stream_.append(std::unique_ptr<InputSingleValueOperation>(input_operation));
+    this->add_operation(std::unique_ptr<InputSingleValueOperation>(input_operation));
 
     input_operation->evaluate();
   }
@@ -221,12 +426,28 @@ void Evaluator::evaluate_pixel_compile_unit(CompileState &compile_state)
 
   map_pixel_operation_inputs_to_their_results(operation, compile_state);
 
-  operations_stream_.append(std::unique_ptr<Operation>(operation));
+  /* Only compute the region of the operation domain that is read by later operations. */
+  const std::optional<Bounds<int2>> region_of_interest =
+      compile_state.compute_pixel_operation_region_of_interest(*operation);
+  operation->set_region_of_interest(region_of_interest);
+  if (region_of_interest) {
+    this->add_pixel_operation_region_to_output_keys(*operation, *region_of_interest);
+  }
+
+  this->add_operation(std::unique_ptr<Operation>(operation));
 
   operation->compute_results_reference_counts(compile_state.get_schedule());
 
+  if (result_spill_manager_) {
+    result_spill_manager_->prepare_operation(*operation);
+  }
+
   operation->evaluate();
 
+  if (result_spill_manager_) {
+    result_spill_manager_->add_operation_results(*operation);
+  }
+
   compile_state.reset_pixel_compile_unit();
 }
 
@@ -248,12 +469,79 @@ void Evaluator::map_pixel_operation_inputs_to_their_results(PixelOperation *oper
     ImplicitInputOperation *input_operation = new ImplicitInputOperation(context_, item.key);
     operation->map_input_to_result(item.value, &input_operation->get_result());
 
-    operations_stream_.append(std::unique_ptr<ImplicitInputOperation>(input_operation));
+    this->add_operation(std::unique_ptr<ImplicitInputOperation>(input_operation));
 
     input_operation->evaluate();
   }
 }
 
+std::optional<NodeResultKey> Evaluator::compute_node_result_key(DNode node)
+{
+  if (!context_.use_node_result_cache()) {
+    return std::nullopt;
+  }
+
+  std::scoped_lock lock(mutex_);
+  return compositor::compute_node_result_key(context_, node, output_result_keys_);
+}
+
+void Evaluator::add_output_result_keys(DNode node,
+                                       const NodeResultKey &node_key,
+                                       NodeOperation *operation)
+{
+  const bool is_deterministic = is_node_result_deterministic(node);
+  for (const bNodeSocket *output : node->output_sockets()) {
+    if (!is_socket_available(output)) {
+      continue;
+    }
+
+    const DOutputSocket doutput{node.context(), output};
+    if (is_deterministic) {
+      const NodeResultKey key = compute_output_result_key(node_key, output->identifier);
+      std::scoped_lock lock(mutex_);
+      output_result_keys_.add_new(doutput, key);
+      continue;
+    }
+
+    /* The results of nodes that are not deterministic are identified by their content. Results
+     * that are not allocated are not used, so they need no key. */
+    const Result &result = operation->get_result(output->identifier);
+    if (!result.is_allocated()) {
+      continue;
+    }
+
+    const NodeResultKey key = compute_output_result_key(node_key, output->identifier, result);
+    std::scoped_lock lock(mutex_);
+    output_result_keys_.add_new(doutput, key);
+  }
+}
+
+void Evaluator::add_pixel_node_output_result_keys(DNode node)
+{
+  if (!is_node_result_deterministic(node)) {
+    return;
+  }
+
+  const std::optional<NodeResultKey> node_key = this->compute_node_result_key(node);
+  if (node_key) {
+    this->add_output_result_keys(node, *node_key, nullptr);
+  }
+}
+
+void Evaluator::add_pixel_operation_region_to_output_keys(PixelOperation &operation,
+                                                          const Bounds<int2> &region)
+{
+  std::scoped_lock lock(mutex_);
+  for (const DOutputSocket &output :
+       operation.get_output_sockets_to_output_identifiers_map().keys())
+  {
+    NodeResultKey *key = output_result_keys_.lookup_ptr(output);
+    if (key) {
+      *key = compute_region_result_key(*key, region);
+    }
+  }
+}
+
 void Evaluator::cancel_evaluation()
 {
   context_.cache_manager().skip_next_reset();
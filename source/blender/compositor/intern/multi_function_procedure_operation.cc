@@ -3,9 +3,12 @@
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
 #include <memory>
+#include <optional>
 #include <string>
 
 #include "BLI_assert.h"
+#include "BLI_bounds.hh"
+#include "BLI_bounds_types.hh"
 #include "BLI_color.hh"
 #include "BLI_cpp_type.hh"
 #include "BLI_generic_span.hh"
@@ -37,6 +40,7 @@
 #include "COM_input_descriptor.hh"
 #include "COM_multi_function_procedure_operation.hh"
 #include "COM_pixel_operation.hh"
+#include "COM_profiler.hh"
 #include "COM_result.hh"
 #include "COM_scheduler.hh"
 #include "COM_utilities.hh"
@@ -54,14 +58,55 @@ MultiFunctionProcedureOperation::MultiFunctionProcedureOperation(Context &contex
   procedure_executor_ = std::make_unique<mf::ProcedureExecutor>(procedure_);
 }
 
+/* Returns a mask of the pixels of the given domain that are inside the given region of interest,
+ * or of all pixels if there is no region of interest. */
+static IndexMask compute_region_of_interest_mask(const Domain &domain,
+                                                 const std::optional<Bounds<int2>> &region,
+                                                 IndexMaskMemory &memory)
+{
+  const int64_t size = int64_t(domain.size.x) * domain.size.y;
+  if (!region) {
+    return IndexMask(size);
+  }
+
+  /* The region might not intersect the domain, for instance, because the Crop node clamps its
+   * bounds to the image, which is not known when computing the region, so compute all pixels. */
+  const std::optional<Bounds<int2>> bounds = bounds::intersect(
+      *region, Bounds<int2>(int2(0), domain.size));
+  if (!bounds) {
+    return IndexMask(size);
+  }
+
+  const int2 bounds_size = bounds->size();
+  const int64_t start = int64_t(bounds->min.y) * domain.size.x + bounds->min.x;
+
+  /* The region spans entire rows, so it is contiguous in memory. */
+  if (bounds_size.x == domain.size.x) {
+    return IndexMask(IndexRange(start, int64_t(bounds_size.x) * bounds_size.y));
+  }
+
+  return IndexMask::from_repeating(
+      IndexMask(bounds_size.x), bounds_size.y, domain.size.x, start, memory);
+}
+
 void MultiFunctionProcedureOperation::execute()
 {
   const Domain domain = compute_domain();
-  const int64_t size = int64_t(domain.size.x) * domain.size.y;
-  const IndexMask mask = IndexMask(size);
+  const bool is_single_value = this->is_single_value_operation();
+
+  /* Only compute the pixels inside the region of interest, the rest are left uninitialized, since
+   * they are not read by any later operation. */
+  IndexMaskMemory memory;
+  const IndexMask mask = compute_region_of_interest_mask(
+      domain, is_single_value ? std::nullopt : region_of_interest_, memory);
   mf::ParamsBuilder parameter_builder{*procedure_executor_, &mask};
 
-  const bool is_single_value = this->is_single_value_operation();
+  if (!is_single_value && context().profiler()) {
+    const int64_t size = int64_t(domain.size.x) * domain.size.y;
+    for (const DNode &node : compile_unit_) {
+      context().profiler()->add_node_computed_pixels(node.instance_key(), mask.size(), size);
+    }
+  }
 
   /* For each of the parameters, either add an input or an output depending on its interface type,
    * allocating the outputs when needed. */
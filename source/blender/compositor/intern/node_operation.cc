@@ -5,6 +5,7 @@
 #include "BLI_assert.h"
 #include "BLI_string_ref.hh"
 #include "BLI_timeit.hh"
+#include "BLI_vector.hh"
 
 #include "DNA_node_types.h"
 
@@ -18,6 +19,7 @@
 #include "COM_context.hh"
 #include "COM_input_descriptor.hh"
 #include "COM_node_operation.hh"
+#include "COM_node_result_cache.hh"
 #include "COM_operation.hh"
 #include "COM_result.hh"
 #include "COM_scheduler.hh"
@@ -54,7 +56,10 @@ void NodeOperation::evaluate()
     GPU_debug_group_begin(node().bnode()->typeinfo->idname.c_str());
   }
   const timeit::TimePoint before_time = timeit::Clock::now();
-  Operation::evaluate();
+  if (!this->retrieve_cached_results()) {
+    Operation::evaluate();
+    this->add_results_to_cache();
+  }
   const timeit::TimePoint after_time = timeit::Clock::now();
   if (context().profiler()) {
     context().profiler()->set_node_evaluation_time(node_.instance_key(), after_time - before_time);
@@ -125,6 +130,82 @@ void NodeOperation::compute_results_reference_counts(const Schedule &schedule)
   }
 }
 
+void NodeOperation::set_result_cache_key(const NodeResultKey &key)
+{
+  result_cache_key_ = key;
+}
+
+bool NodeOperation::retrieve_cached_results()
+{
+  if (!result_cache_key_) {
+    return false;
+  }
+
+  /* Retrieve all needed outputs at once, since the operation will be evaluated if any of them is
+   * not cached. */
+  Vector<NodeResultKey> keys;
+  Vector<Result *> results;
+  for (const bNodeSocket *output : this->node()->output_sockets()) {
+    if (!is_socket_available(output) || !should_compute_output(output->identifier)) {
+      continue;
+    }
+
+    keys.append(compute_output_result_key(*result_cache_key_, output->identifier));
+    results.append(&get_result(output->identifier));
+  }
+
+  /* Nodes without needed outputs, like output nodes, are evaluated for their side effects, so they
+   * can't be skipped even though there is nothing to retrieve. */
+  if (keys.is_empty()) {
+    return false;
+  }
+
+  NodeResultCache &cache = context().cache_manager().node_results;
+  if (!cache.retrieve(keys, results)) {
+    if (context().profiler()) {
+      context().profiler()->add_node_result_cache_lookup(node_.instance_key(), false);
+    }
+    return false;
+  }
+
+  if (context().profiler()) {
+    context().profiler()->add_node_result_cache_lookup(node_.instance_key(), true);
+  }
+
+  this->compute_preview();
+  this->release_inputs();
+  context().evaluate_operation_post();
+  return true;
+}
+
+void NodeOperation::add_results_to_cache()
+{
+  if (!result_cache_key_) {
+    return;
+  }
+
+  /* Some operations stop executing when the evaluation is canceled, leaving their results
+   * incomplete, so they shouldn't be cached. */
+  if (context().is_canceled()) {
+    return;
+  }
+
+  NodeResultCache &cache = context().cache_manager().node_results;
+  for (const bNodeSocket *output : this->node()->output_sockets()) {
+    if (!is_socket_available(output)) {
+      continue;
+    }
+
+    const Result &result = get_result(output->identifier);
+    if (!result.is_allocated()) {
+      continue;
+    }
+
+    cache.add(
+        context(), compute_output_result_key(*result_cache_key_, output->identifier), result);
+  }
+}
+
 const DNode &NodeOperation::node() const
 {
   return node_;
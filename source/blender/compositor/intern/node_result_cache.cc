@@ -0,0 +1,482 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+
+#include <xxhash.h>
+
+#include "BLI_array.hh"
+#include "BLI_assert.h"
+#include "BLI_bounds_types.hh"
+#include "BLI_index_range.hh"
+#include "BLI_map.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_mutex.hh"
+#include "BLI_span.hh"
+#include "BLI_string_ref.hh"
+#include "BLI_system.h"
+#include "BLI_vector.hh"
+
+#include "DNA_color_types.h"
+#include "DNA_node_types.h"
+
+#include "BKE_node.hh"
+#include "BKE_node_runtime.hh"
+
+#include "RNA_access.hh"
+#include "RNA_prototypes.hh"
+
+#include "NOD_derived_node_tree.hh"
+
+#include "COM_context.hh"
+#include "COM_domain.hh"
+#include "COM_node_result_cache.hh"
+#include "COM_result.hh"
+#include "COM_utilities.hh"
+
+namespace blender::compositor {
+
+using namespace nodes::derived_node_tree_types;
+
+/* --------------------------------------------------------------------
+ * Node Result Key.
+ */
+
+/* Accumulates the bytes of the values that identify a result, which are then hashed into a key.
+ * Only the shallow bytes of the added values are used, so they should not contain any padding. */
+class KeyBuilder {
+ private:
+  Vector<uint8_t, 256> data_;
+
+ public:
+  template<typename T> void add(const T &value)
+  {
+    static_assert(std::is_trivially_copyable_v<T>);
+    this->add_bytes(&value, sizeof(T));
+  }
+
+  void add_bytes(const void *data, const int64_t size)
+  {
+    data_.extend(Span<uint8_t>(static_cast<const uint8_t *>(data), size));
+  }
+
+  void add_string(const StringRef string)
+  {
+    this->add(string.size());
+    this->add_bytes(string.data(), string.size());
+  }
+
+  void add_key(const NodeResultKey &key)
+  {
+    this->add(key.v1);
+    this->add(key.v2);
+  }
+
+  NodeResultKey build() const
+  {
+    const XXH128_hash_t hash = XXH3_128bits(data_.data(), data_.size());
+    return NodeResultKey{hash.low64, hash.high64};
+  }
+};
+
+bool is_node_result_deterministic(const DNode &node)
+{
+  return node->id == nullptr;
+}
+
+/* Adds the parameters of the context that nodes might depend on without having an input for
+ * them, like the frame number or the size of the compositing region. */
+static void add_context_parameters(KeyBuilder &builder, const Context &context)
+{
+  const Bounds<int2> compositing_region = context.get_compositing_region();
+  builder.add(compositing_region.min);
+  builder.add(compositing_region.max);
+  builder.add(context.get_frame_number());
+  builder.add(context.get_time());
+  builder.add(context.get_render_percentage());
+  builder.add(context.get_precision());
+  builder.add(context.get_denoise_quality());
+  builder.add_string(context.get_view_name());
+}
+
+/* Adds the values of the given curve mapping excluding its pointers, since those change every
+ * time the node tree is localized for evaluation. */
+static void add_curve_mapping(KeyBuilder &builder, const CurveMapping &curve_mapping)
+{
+  builder.add(curve_mapping.flag);
+  builder.add(curve_mapping.preset);
+  builder.add(curve_mapping.curr);
+  builder.add(curve_mapping.clipr);
+  builder.add(curve_mapping.black);
+  builder.add(curve_mapping.white);
+  builder.add(curve_mapping.tone);
+  for (const CurveMap &curve_map : curve_mapping.cm) {
+    builder.add(curve_map.totpoint);
+    builder.add(curve_map.ext_in);
+    builder.add(curve_map.ext_out);
+    for (const int i : IndexRange(curve_map.totpoint)) {
+      builder.add(curve_map.curve[i].x);
+      builder.add(curve_map.curve[i].y);
+      builder.add(curve_map.curve[i].flag);
+    }
+  }
+}
+
+/* Adds the values of the RNA properties of the given pointer, returning false if they can't be
+ * hashed. Pointers to IDs are added as is, since they are stable during the session, while other
+ * structures are added recursively by value, since their addresses change every time the node
+ * tree is localized for evaluation. Collections are not supported. */
+static bool add_rna_properties(KeyBuilder &builder, PointerRNA &ptr)
+{
+  bool is_hashable = true;
+  RNA_STRUCT_BEGIN_SKIP_RNA_TYPE (&ptr, prop) {
+    /* Skip the properties common to all nodes, like the location and label, since they don't
+     * affect evaluation, and the relevant ones are already added by add_node_properties. */
+    const char *identifier = RNA_property_identifier(prop);
+    if (RNA_struct_is_a(ptr.type, &RNA_Node) &&
+        RNA_struct_type_find_property(&RNA_Node, identifier))
+    {
+      continue;
+    }
+
+    builder.add_string(identifier);
+    const bool is_array = RNA_property_array_check(prop);
+    const int length = is_array ? RNA_property_array_length(&ptr, prop) : 0;
+    switch (RNA_property_type(prop)) {
+      case PROP_BOOLEAN: {
+        if (is_array) {
+          Array<bool, 16> values(length);
+          RNA_property_boolean_get_array(&ptr, prop, values.data());
+          builder.add_bytes(values.data(), values.as_span().size_in_bytes());
+        }
+        else {
+          builder.add(RNA_property_boolean_get(&ptr, prop));
+        }
+        break;
+      }
+      case PROP_INT: {
+        if (is_array) {
+          Array<int, 16> values(length);
+          RNA_property_int_get_array(&ptr, prop, values.data());
+          builder.add_bytes(values.data(), values.as_span().size_in_bytes());
+        }
+        else {
+          builder.add(RNA_property_int_get(&ptr, prop));
+        }
+        break;
+      }
+      case PROP_FLOAT: {
+        if (is_array) {
+          Array<float, 16> values(length);
+          RNA_property_float_get_array(&ptr, prop, values.data());
+          builder.add_bytes(values.data(), values.as_span().size_in_bytes());
+        }
+        else {
+          builder.add(RNA_property_float_get(&ptr, prop));
+        }
+        break;
+      }
+      case PROP_ENUM:
+        builder.add(RNA_property_enum_get(&ptr, prop));
+        break;
+      case PROP_STRING:
+        builder.add_string(RNA_property_string_get(&ptr, prop));
+        break;
+      case PROP_POINTER: {
+        PointerRNA child_ptr = RNA_property_pointer_get(&ptr, prop);
+        if (!child_ptr.data || RNA_struct_is_ID(child_ptr.type)) {
+          builder.add(child_ptr.data);
+        }
+        else if (RNA_struct_is_a(child_ptr.type, &RNA_CurveMapping)) {
+          add_curve_mapping(builder, *static_cast<const CurveMapping *>(child_ptr.data));
+        }
+        else if (!add_rna_properties(builder, child_ptr)) {
+          is_hashable = false;
+        }
+        break;
+      }
+      case PROP_COLLECTION:
+        is_hashable = false;
+        break;
+    }
+
+    if (!is_hashable) {
+      break;
+    }
+  }
+  RNA_STRUCT_END;
+
+  return is_hashable;
+}
+
+/* Adds the properties of the node, returning false if they can't be hashed. */
+static bool add_node_properties(KeyBuilder &builder, const DNode &node)
+{
+  builder.add_string(node->idname);
+  builder.add(node->custom1);
+  builder.add(node->custom2);
+  builder.add(node->custom3);
+  builder.add(node->custom4);
+  builder.add(node->id);
+
+  if (!node->storage) {
+    return true;
+  }
+
+  /* Storage that is not stored in DNA can't be hashed, and cryptomatte storage contains lists
+   * whose addresses change when the node tree is localized. */
+  const StringRef storage_name = node->typeinfo->storagename;
+  if (storage_name.is_empty() || storage_name == "NodeCryptomatte") {
+    return false;
+  }
+
+  /* The storage is hashed through the RNA properties of the node as opposed to its raw bytes,
+   * since the latter include padding as well as pointers that change every time the node tree is
+   * localized, like the scene of image users. */
+  bNode &bnode = const_cast<bNode &>(*node.bnode());
+  PointerRNA node_ptr = RNA_pointer_create_discrete(&bnode.owner_tree().id, &RNA_Node, &bnode);
+  return add_rna_properties(builder, node_ptr);
+}
+
+/* Adds the default value of the given unlinked input socket, returning false if its type is not
+ * supported. */
+static bool add_socket_value(KeyBuilder &builder, const bNodeSocket &socket)
+{
+  builder.add(socket.type);
+  switch (eNodeSocketDatatype(socket.type)) {
+    case SOCK_FLOAT:
+      builder.add(socket.default_value_typed<bNodeSocketValueFloat>()->value);
+      return true;
+    case SOCK_INT:
+      builder.add(socket.default_value_typed<bNodeSocketValueInt>()->value);
+      return true;
+    case SOCK_BOOLEAN:
+      builder.add(socket.default_value_typed<bNodeSocketValueBoolean>()->value);
+      return true;
+    case SOCK_VECTOR:
+      builder.add(socket.default_value_typed<bNodeSocketValueVector>()->value);
+      return true;
+    case SOCK_RGBA:
+      builder.add(socket.default_value_typed<bNodeSocketValueRGBA>()->value);
+      return true;
+    case SOCK_MENU:
+      builder.add(socket.default_value_typed<bNodeSocketValueMenu>()->value);
+      return true;
+    case SOCK_STRING:
+      builder.add_string(socket.default_value_typed<bNodeSocketValueString>()->value);
+      return true;
+    default:
+      return false;
+  }
+}
+
+std::optional<NodeResultKey> compute_node_result_key(
+    const Context &context,
+    const DNode &node,
+    const Map<DOutputSocket, NodeResultKey> &output_keys)
+{
+  KeyBuilder builder;
+  add_context_parameters(builder, context);
+
+  if (!add_node_properties(builder, node)) {
+    return std::nullopt;
+  }
+
+  for (const bNodeSocket *input : node->input_sockets()) {
+    if (!is_socket_available(input)) {
+      continue;
+    }
+
+    builder.add_string(input->identifier);
+
+    const DInputSocket dinput{node.context(), input};
+    const DSocket origin = get_input_origin_socket(dinput);
+    if (origin->is_input()) {
+      if (!add_socket_value(builder, *origin.bsocket())) {
+        return std::nullopt;
+      }
+      continue;
+    }
+
+    const std::optional<NodeResultKey> origin_key = output_keys.lookup_try(DOutputSocket(origin));
+    if (!origin_key) {
+      return std::nullopt;
+    }
+    builder.add_key(*origin_key);
+  }
+
+  return builder.build();
+}
+
+NodeResultKey compute_output_result_key(const NodeResultKey &node_key,
+                                        const StringRef output_identifier)
+{
+  KeyBuilder builder;
+  builder.add_key(node_key);
+  builder.add_string(output_identifier);
+  return builder.build();
+}
+
+NodeResultKey compute_output_result_key(const NodeResultKey &node_key,
+                                        const StringRef output_identifier,
+                                        const Result &result)
+{
+  KeyBuilder builder;
+  builder.add_key(node_key);
+  builder.add_string(output_identifier);
+  builder.add(result.type());
+  builder.add(result.is_single_value());
+  builder.add(result.domain().size);
+  builder.add(result.domain().transformation);
+  builder.add(result.domain().realization_options.interpolation);
+  builder.add(result.domain().realization_options.extension_x);
+  builder.add(result.domain().realization_options.extension_y);
+
+  const GSpan data = result.cpu_data();
+  const XXH128_hash_t data_hash = XXH3_128bits(data.data(), data.size_in_bytes());
+  builder.add(data_hash.low64);
+  builder.add(data_hash.high64);
+
+  return builder.build();
+}
+
+NodeResultKey compute_region_result_key(const NodeResultKey &output_key,
+                                        const Bounds<int2> &region)
+{
+  KeyBuilder builder;
+  builder.add_key(output_key);
+  builder.add(region.min);
+  builder.add(region.max);
+  return builder.build();
+}
+
+/* --------------------------------------------------------------------
+ * Node Result Cache.
+ */
+
+NodeResultCache::NodeResultCache()
+    : memory_budget_(int64_t(BLI_system_memory_max_in_megabytes()) * 1024 * 1024 / 8)
+{
+}
+
+NodeResultCache::~NodeResultCache()
+{
+  this->clear();
+}
+
+const Result *NodeResultCache::lookup(const NodeResultKey &key)
+{
+  std::scoped_lock lock(mutex_);
+  CachedResult *cached_result = cached_results_.lookup_ptr(key);
+  if (!cached_result) {
+    return nullptr;
+  }
+
+  cached_result->last_use = ++use_clock_;
+  return &cached_result->result;
+}
+
+bool NodeResultCache::contains(const NodeResultKey &key) const
+{
+  std::scoped_lock lock(mutex_);
+  return cached_results_.contains(key);
+}
+
+bool NodeResultCache::retrieve(const Span<NodeResultKey> keys, const Span<Result *> results)
+{
+  BLI_assert(keys.size() == results.size());
+
+  std::scoped_lock lock(mutex_);
+
+  for (const NodeResultKey &key : keys) {
+    if (!cached_results_.contains(key)) {
+      return false;
+    }
+  }
+
+  for (const int i : keys.index_range()) {
+    CachedResult &cached_result = cached_results_.lookup(keys[i]);
+    cached_result.last_use = ++use_clock_;
+    results[i]->share_data(cached_result.result);
+  }
+
+  return true;
+}
+
+void NodeResultCache::add(Context &context, const NodeResultKey &key, const Result &result)
+{
+  if (!result.is_allocated() || result.is_external() ||
+      result.storage_type() != ResultStorageType::CPU)
+  {
+    return;
+  }
+
+  std::scoped_lock lock(mutex_);
+
+  if (cached_results_.contains(key)) {
+    return;
+  }
+
+  const int64_t size = result.is_single_value() ? 0 : result.cpu_data().size_in_bytes();
+
+  /* The result alone is larger than the budget, so it would be evicted immediately. */
+  if (size > memory_budget_) {
+    return;
+  }
+
+  Result cached_result = Result(context, result.type(), result.precision());
+  cached_result.share_data(result);
+  cached_results_.add_new(key, CachedResult{cached_result, size, ++use_clock_});
+  memory_usage_ += size;
+
+  this->evict();
+}
+
+void NodeResultCache::set_memory_budget(const int64_t budget)
+{
+  std::scoped_lock lock(mutex_);
+  memory_budget_ = budget;
+  this->evict();
+}
+
+void NodeResultCache::clear()
+{
+  std::scoped_lock lock(mutex_);
+  for (CachedResult &cached_result : cached_results_.values()) {
+    cached_result.result.free();
+  }
+  cached_results_.clear();
+  memory_usage_ = 0;
+}
+
+int64_t NodeResultCache::memory_usage() const
+{
+  std::scoped_lock lock(mutex_);
+  return memory_usage_;
+}
+
+void NodeResultCache::evict()
+{
+  while (memory_usage_ > memory_budget_) {
+    /* The number of cached results is in the order of the number of nodes, so a linear search for
+     * the least recently used result is cheap compared to the evaluation of the nodes. */
+    const NodeResultKey *least_recently_used_key = nullptr;
+    uint64_t least_recent_use = UINT64_MAX;
+    for (const auto item : cached_results_.items()) {
+      if (item.value.last_use < least_recent_use) {
+        least_recent_use = item.value.last_use;
+        least_recently_used_key = &item.key;
+      }
+    }
+
+    const NodeResultKey key = *least_recently_used_key;
+    CachedResult cached_result = cached_results_.pop(key);
+    memory_usage_ -= cached_result.size;
+    cached_result.result.free();
+  }
+}
+
+}  // namespace blender::compositor
@@ -41,6 +41,16 @@ Result &Operation::get_result(StringRef identifier)
   return results_.lookup(identifier);
 }
 
+Map<std::string, Result> &Operation::get_results()
+{
+  return results_;
+}
+
+const Map<StringRef, Result *> &Operation::get_results_mapped_to_inputs() const
+{
+  return results_mapped_to_inputs_;
+}
+
 void Operation::map_input_to_result(StringRef identifier, Result *result)
 {
   results_mapped_to_inputs_.add_new(identifier, result);
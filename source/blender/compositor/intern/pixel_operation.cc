@@ -68,6 +68,16 @@ Map<ImplicitInput, std::string> &PixelOperation::get_implicit_inputs_to_input_id
   return implicit_inputs_to_input_identifiers_map_;
 }
 
+Map<DOutputSocket, std::string> &PixelOperation::get_output_sockets_to_output_identifiers_map()
+{
+  return output_sockets_to_output_identifiers_map_;
+}
+
+void PixelOperation::set_region_of_interest(const std::optional<Bounds<int2>> &region)
+{
+  region_of_interest_ = region;
+}
+
 int PixelOperation::get_internal_input_reference_count(const StringRef &identifier)
 {
   return inputs_to_reference_counts_map_.lookup(identifier);
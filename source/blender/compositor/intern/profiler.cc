@@ -2,6 +2,7 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include "BLI_mutex.hh"
 #include "BLI_timeit.hh"
 
 #include "DNA_node_types.h"
@@ -22,9 +23,81 @@ Map<bNodeInstanceKey, timeit::Nanoseconds> &Profiler::get_nodes_evaluation_times
 void Profiler::set_node_evaluation_time(bNodeInstanceKey node_instance_key,
                                         timeit::Nanoseconds time)
 {
+  std::scoped_lock lock(mutex_);
   nodes_evaluation_times_.lookup_or_add(node_instance_key, timeit::Nanoseconds::zero()) += time;
 }
 
+Map<bNodeInstanceKey, Profiler::ComputedPixels> &Profiler::get_nodes_computed_pixels()
+{
+  return nodes_computed_pixels_;
+}
+
+void Profiler::add_node_computed_pixels(bNodeInstanceKey node_instance_key,
+                                        int64_t computed_pixels,
+                                        int64_t domain_pixels)
+{
+  std::scoped_lock lock(mutex_);
+  ComputedPixels &pixels = nodes_computed_pixels_.lookup_or_add_default(node_instance_key);
+  pixels.computed += computed_pixels;
+  pixels.domain += domain_pixels;
+}
+
+Profiler::ComputedPixels Profiler::get_total_computed_pixels() const
+{
+  ComputedPixels total_pixels;
+  for (const ComputedPixels &pixels : nodes_computed_pixels_.values()) {
+    total_pixels.computed += pixels.computed;
+    total_pixels.domain += pixels.domain;
+  }
+  return total_pixels;
+}
+
+Map<bNodeInstanceKey, bool> &Profiler::get_nodes_result_cache_hits()
+{
+  return nodes_result_cache_hits_;
+}
+
+void Profiler::add_node_result_cache_lookup(bNodeInstanceKey node_instance_key, bool is_hit)
+{
+  std::scoped_lock lock(mutex_);
+  nodes_result_cache_hits_.add_overwrite(node_instance_key, is_hit);
+  if (is_hit) {
+    node_result_cache_statistics_.hits++;
+  }
+  else {
+    node_result_cache_statistics_.misses++;
+  }
+}
+
+void Profiler::set_node_result_cache_memory_usage(int64_t memory_usage)
+{
+  node_result_cache_statistics_.memory_usage = memory_usage;
+}
+
+const Profiler::NodeResultCacheStatistics &Profiler::get_node_result_cache_statistics() const
+{
+  return node_result_cache_statistics_;
+}
+
+void Profiler::add_spilled_tiles(int64_t tiles_count, int64_t size, int64_t compressed_size)
+{
+  std::scoped_lock lock(mutex_);
+  result_spill_statistics_.spilled_tiles += tiles_count;
+  result_spill_statistics_.spilled_size += size;
+  result_spill_statistics_.compressed_size += compressed_size;
+}
+
+void Profiler::add_restored_tiles(int64_t tiles_count)
+{
+  std::scoped_lock lock(mutex_);
+  result_spill_statistics_.restored_tiles += tiles_count;
+}
+
+const Profiler::ResultSpillStatistics &Profiler::get_result_spill_statistics() const
+{
+  return result_spill_statistics_;
+}
+
 timeit::Nanoseconds Profiler::accumulate_node_group_times(const bNodeTree &node_tree,
                                                           bNodeInstanceKey instance_key)
 {
@@ -0,0 +1,254 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <optional>
+
+#include "BLI_bounds.hh"
+#include "BLI_bounds_types.hh"
+#include "BLI_map.hh"
+#include "BLI_math_base.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_string_ref.hh"
+
+#include "DNA_node_types.h"
+
+#include "BKE_node_runtime.hh"
+
+#include "NOD_derived_node_tree.hh"
+
+#include "COM_context.hh"
+#include "COM_input_descriptor.hh"
+#include "COM_region_of_interest.hh"
+#include "COM_scheduler.hh"
+#include "COM_utilities.hh"
+
+namespace blender::compositor {
+
+using namespace nodes::derived_node_tree_types;
+
+/* A type representing the region of the result linked to each input socket that the node of the
+ * input reads. Inputs that read the entire result are not stored in the map. */
+using InputRegions = Map<DInputSocket, Bounds<int2>>;
+
+/* Computes the union of the regions read by the scheduled nodes linked to the given output.
+ * Returns nullopt if any of them reads the entire result or if the output is not used. */
+static std::optional<Bounds<int2>> compute_output_region(const DOutputSocket &output,
+                                                         const Schedule &schedule,
+                                                         const InputRegions &input_regions)
+{
+  bool is_used = false;
+  bool is_read_entirely = false;
+  std::optional<Bounds<int2>> region;
+
+  output.foreach_target_socket(
+      [&](DInputSocket target, const DOutputSocket::TargetSocketPathInfo & /*path_info*/) {
+        if (!schedule.contains(target.node())) {
+          return;
+        }
+
+        is_used = true;
+        const std::optional<Bounds<int2>> target_region = input_regions.lookup_try(target);
+        if (!target_region) {
+          is_read_entirely = true;
+          return;
+        }
+
+        region = bounds::merge(region, target_region);
+      });
+
+  if (!is_used || is_read_entirely) {
+    return std::nullopt;
+  }
+
+  return region;
+}
+
+/* Computes the union of the regions of interest of all used outputs of the given node. Returns
+ * nullopt if any of the outputs is read entirely. */
+static std::optional<Bounds<int2>> compute_node_outputs_region(
+    const DNode &node, const RegionsOfInterest &regions_of_interest)
+{
+  std::optional<Bounds<int2>> region;
+  bool is_any_output_used = false;
+
+  for (const bNodeSocket *output : node->output_sockets()) {
+    if (!is_socket_available(output)) {
+      continue;
+    }
+
+    if (!output->is_logically_linked()) {
+      continue;
+    }
+
+    const DOutputSocket doutput{node.context(), output};
+
+    const std::optional<Bounds<int2>> output_region = regions_of_interest.lookup_try(doutput);
+    if (!output_region) {
+      return std::nullopt;
+    }
+
+    is_any_output_used = true;
+    region = bounds::merge(region, output_region);
+  }
+
+  if (!is_any_output_used) {
+    return std::nullopt;
+  }
+
+  return region;
+}
+
+/* Returns the input of the given pixel node whose domain is the domain of the node, but only if it
+ * is the only input which can have a domain, because the pixels of such an input and the pixels of
+ * the outputs of the node map one to one. Otherwise, returns nullopt. */
+static std::optional<DInputSocket> get_pixel_node_sole_domain_input(const DNode &node)
+{
+  std::optional<DInputSocket> domain_input;
+
+  for (const bNodeSocket *input : node->input_sockets()) {
+    if (!is_socket_available(input)) {
+      continue;
+    }
+
+    const DInputSocket dinput{node.context(), input};
+    const DSocket origin = get_input_origin_socket(dinput);
+
+    /* Unlinked inputs are single values, unless they have an implicit input, which has the domain
+     * of the compositing region. */
+    if (origin->is_input()) {
+      const InputDescriptor origin_descriptor = input_descriptor_from_input_socket(
+          origin.bsocket());
+      if (origin_descriptor.implicit_input == ImplicitInput::None) {
+        continue;
+      }
+      return std::nullopt;
+    }
+
+    const InputDescriptor input_descriptor = input_descriptor_from_input_socket(input);
+    if (input_descriptor.expects_single_value) {
+      continue;
+    }
+
+    if (domain_input || input_descriptor.realization_mode != InputRealizationMode::OperationDomain)
+    {
+      return std::nullopt;
+    }
+
+    domain_input = dinput;
+  }
+
+  return domain_input;
+}
+
+/* Returns the value of the input of the given node identified by the given identifier if it is
+ * not linked, otherwise, returns nullopt. */
+template<typename T, typename SocketValueT>
+static std::optional<T> get_unlinked_input_value(const DNode &node, StringRef identifier)
+{
+  const DSocket origin = get_input_origin_socket(node.input_by_identifier(identifier));
+  if (!origin->is_input()) {
+    return std::nullopt;
+  }
+
+  return T(origin->default_value_typed<SocketValueT>()->value);
+}
+
+/* Computes the region of its image input that the Crop node reads given the region of interest of
+ * its output. Returns nullopt if the cropping bounds are not known before evaluation because its
+ * inputs are linked. */
+static std::optional<Bounds<int2>> compute_crop_node_input_region(
+    const DNode &node, const std::optional<Bounds<int2>> &output_region)
+{
+  const std::optional<int> x = get_unlinked_input_value<int, bNodeSocketValueInt>(node, "X");
+  const std::optional<int> y = get_unlinked_input_value<int, bNodeSocketValueInt>(node, "Y");
+  const std::optional<int> width = get_unlinked_input_value<int, bNodeSocketValueInt>(node,
+                                                                                      "Width");
+  const std::optional<int> height = get_unlinked_input_value<int, bNodeSocketValueInt>(node,
+                                                                                       "Height");
+  const std::optional<bool> is_alpha_crop = get_unlinked_input_value<bool, bNodeSocketValueBoolean>(
+      node, "Alpha Crop");
+  if (!x || !y || !width || !height || !is_alpha_crop) {
+    return std::nullopt;
+  }
+
+  /* Identical to the computation of the cropping bounds in the Crop node, except the clamping to
+   * the input size, which is not known yet. The clamping only changes the bounds if they lie
+   * entirely outside of the input, in which case the region doesn't intersect the domain of the
+   * input and the input is computed entirely, see MultiFunctionProcedureOperation::execute. */
+  const int2 lower_bound = math::max(int2(*x, *y), int2(0));
+  const int2 size = math::max(int2(*width, *height), int2(1));
+  const Bounds<int2> crop_bounds = Bounds<int2>(lower_bound, lower_bound + size);
+
+  if (!output_region) {
+    return crop_bounds;
+  }
+
+  /* The alpha crop has the same domain as its input, while the image crop output starts at the
+   * lower bound of the cropping bounds. */
+  const int2 offset = *is_alpha_crop ? int2(0) : crop_bounds.min;
+  const Bounds<int2> read_region = Bounds<int2>(output_region->min + offset,
+                                                output_region->max + offset);
+  return bounds::intersect(crop_bounds, read_region).value_or(crop_bounds);
+}
+
+/* Computes the regions of the results linked to the inputs of the given node which the node reads
+ * and adds them to the given input regions. Inputs that are read entirely are not added. */
+static void compute_node_input_regions(const DNode &node,
+                                       const RegionsOfInterest &regions_of_interest,
+                                       InputRegions &input_regions)
+{
+  const std::optional<Bounds<int2>> outputs_region = compute_node_outputs_region(
+      node, regions_of_interest);
+
+  if (node->typeinfo->idname == "CompositorNodeCrop") {
+    const std::optional<Bounds<int2>> region = compute_crop_node_input_region(node,
+                                                                              outputs_region);
+    if (region) {
+      input_regions.add_new(node.input_by_identifier("Image"), *region);
+    }
+    return;
+  }
+
+  if (is_pixel_node(node) && outputs_region) {
+    const std::optional<DInputSocket> domain_input = get_pixel_node_sole_domain_input(node);
+    if (domain_input) {
+      input_regions.add_new(*domain_input, *outputs_region);
+    }
+  }
+}
+
+RegionsOfInterest compute_regions_of_interest(const Context &context, const Schedule &schedule)
+{
+  RegionsOfInterest regions_of_interest;
+
+  if (context.use_gpu() || bool(context.needed_outputs() & OutputTypes::Previews)) {
+    return regions_of_interest;
+  }
+
+  /* Go over the schedule in reverse, such that the regions read by all nodes linked to the
+   * outputs of a node are known by the time the node is visited. */
+  InputRegions input_regions;
+  for (int i = schedule.size() - 1; i >= 0; i--) {
+    const DNode &node = schedule[i];
+
+    for (const bNodeSocket *output : node->output_sockets()) {
+      if (!is_socket_available(output)) {
+        continue;
+      }
+
+      const DOutputSocket doutput{node.context(), output};
+      const std::optional<Bounds<int2>> region = compute_output_region(
+          doutput, schedule, input_regions);
+      if (region) {
+        regions_of_interest.add_new(doutput, *region);
+      }
+    }
+
+    compute_node_input_regions(node, regions_of_interest, input_regions);
+  }
+
+  return regions_of_interest;
+}
+
+}  // namespace blender::compositor
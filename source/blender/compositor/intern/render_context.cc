@@ -10,6 +10,7 @@
 #include "BLI_map.hh"
 #include "BLI_math_vector.h"
 #include "BLI_math_vector_types.hh"
+#include "BLI_mutex.hh"
 #include "BLI_string.h"
 #include "BLI_string_utf8.h"
 #include "BLI_utildefines.h"
@@ -158,6 +159,7 @@ FileOutput &RenderContext::get_file_output(std::string path,
                                            int2 size,
                                            bool save_as_render)
 {
+  std::scoped_lock lock(mutex_);
   return *file_outputs_.lookup_or_add_cb(
       path, [&]() { return std::make_unique<FileOutput>(path, format, size, save_as_render); });
 }
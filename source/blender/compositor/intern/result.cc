@@ -14,6 +14,7 @@
 #include "BLI_generic_span.hh"
 #include "BLI_math_matrix_types.hh"
 #include "BLI_math_vector_types.hh"
+#include "BLI_mutex.hh"
 #include "BLI_utildefines.h"
 
 #include "GPU_shader.hh"
@@ -494,6 +495,8 @@ void Result::share_data(const Result &source)
   BLI_assert(type_ == source.type_);
   BLI_assert(!this->is_allocated() && source.is_allocated());
 
+  std::scoped_lock lock(context_->results_mutex());
+
   /* Overwrite everything except reference count. */
   const int reference_count = reference_count_;
   *this = source;
@@ -597,21 +600,26 @@ const RealizationOptions &Result::get_realization_options() const
 
 void Result::set_reference_count(int count)
 {
+  std::scoped_lock lock(context_->results_mutex());
   reference_count_ = count;
 }
 
 void Result::increment_reference_count(int count)
 {
+  std::scoped_lock lock(context_->results_mutex());
   reference_count_ += count;
 }
 
 void Result::decrement_reference_count(int count)
 {
+  std::scoped_lock lock(context_->results_mutex());
   reference_count_ -= count;
 }
 
 void Result::release()
 {
+  std::scoped_lock lock(context_->results_mutex());
+
   /* Decrement the reference count, and if it is not yet zero, return and do not free. */
   reference_count_--;
   BLI_assert(reference_count_ >= 0);
@@ -619,15 +627,33 @@ void Result::release()
     return;
   }
 
-  this->free();
+  this->free_data();
 }
 
 void Result::free()
+{
+  std::scoped_lock lock(context_->results_mutex());
+  this->free_data();
+}
+
+void Result::free_data()
 {
   if (is_external_) {
     return;
   }
 
+  /* The data itself was already freed when it was spilled. */
+  if (is_spilled_) {
+    delete data_reference_count_;
+    data_reference_count_ = nullptr;
+
+    delete derived_resources_;
+    derived_resources_ = nullptr;
+
+    is_spilled_ = false;
+    return;
+  }
+
   if (!this->is_allocated()) {
     return;
   }
@@ -683,6 +709,7 @@ bool Result::should_compute()
 
 DerivedResources &Result::derived_resources()
 {
+  std::scoped_lock lock(context_->results_mutex());
   if (!derived_resources_) {
     derived_resources_ = new DerivedResources();
   }
@@ -730,6 +757,49 @@ bool Result::is_allocated() const
   return false;
 }
 
+bool Result::is_data_shared() const
+{
+  std::scoped_lock lock(context_->results_mutex());
+  return !is_external_ && data_reference_count_ && *data_reference_count_ > 1;
+}
+
+bool Result::is_spilled() const
+{
+  return is_spilled_;
+}
+
+void Result::spill()
+{
+  BLI_assert(storage_type_ == ResultStorageType::CPU);
+  BLI_assert(this->is_allocated() && !is_single_value_ && !is_external_);
+  BLI_assert(!this->is_data_shared());
+
+  MEM_freeN(this->cpu_data().data());
+  cpu_data_ = GMutableSpan(this->get_cpp_type());
+  is_spilled_ = true;
+}
+
+void Result::unspill()
+{
+  BLI_assert(is_spilled_);
+
+  const CPPType &cpp_type = this->get_cpp_type();
+  const int64_t array_size = int64_t(domain_.size.x) * int64_t(domain_.size.y);
+  void *data = MEM_mallocN_aligned(array_size * cpp_type.size, cpp_type.alignment, AT);
+  cpu_data_ = GMutableSpan(cpp_type, data, array_size);
+  is_spilled_ = false;
+}
+
+bool Result::is_external() const
+{
+  return is_external_;
+}
+
+ResultStorageType Result::storage_type() const
+{
+  return storage_type_;
+}
+
 int Result::reference_count() const
 {
   return reference_count_;
@@ -0,0 +1,315 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include <zstd.h>
+
+#include "BLI_array.hh"
+#include "BLI_assert.h"
+#include "BLI_fileops.h"
+#include "BLI_index_range.hh"
+#include "BLI_map.hh"
+#include "BLI_math_base.h"
+#include "BLI_math_base.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_path_utils.hh"
+#include "BLI_string.h"
+#include "BLI_task.h"
+#include "BLI_task.hh"
+#include "BLI_vector.hh"
+
+#include "BKE_appdir.hh"
+
+#include "COM_context.hh"
+#include "COM_operation.hh"
+#include "COM_profiler.hh"
+#include "COM_result.hh"
+#include "COM_result_spill_manager.hh"
+
+namespace blender::compositor {
+
+/* The approximate uncompressed size of the tiles of spilled results. Tiles are large enough to
+ * amortize the cost of the file operations, but small enough for a typical image to be split into
+ * enough tiles to be compressed in parallel. */
+static constexpr int64_t tile_size = 4 * 1024 * 1024;
+
+/* A fast compression level, since spilling is limited by the compression speed rather than the
+ * speed of the disk for most of the data of the compositor. */
+static constexpr int compression_level = 1;
+
+ResultSpillManager::ResultSpillManager(Context &context, const int64_t memory_budget)
+    : context_(context), memory_budget_(memory_budget)
+{
+}
+
+ResultSpillManager::~ResultSpillManager()
+{
+  if (file_) {
+    fclose(file_);
+    BLI_delete(file_path_.c_str(), false, false);
+  }
+}
+
+void ResultSpillManager::prepare_operation(Operation &operation)
+{
+  this->remove_freed_results();
+
+  /* Mark the inputs as used, such that they are not spilled, and compute the size needed to
+   * restore the ones that are spilled. */
+  const uint64_t operation_use = ++use_clock_;
+  int64_t restore_size = 0;
+  for (Result *input : operation.get_results_mapped_to_inputs().values()) {
+    TrackedResult *tracked_result = tracked_results_.lookup_ptr(input);
+    if (!tracked_result) {
+      continue;
+    }
+
+    tracked_result->last_use = operation_use;
+    if (input->is_spilled()) {
+      restore_size += tracked_result->size;
+    }
+  }
+
+  /* Spill the least recently used results until the restored inputs fit in the budget. The
+   * number of tracked results is in the order of the number of nodes, so a linear search is cheap
+   * compared to the evaluation of the operation. */
+  while (memory_usage_ + restore_size > memory_budget_) {
+    Result *least_recently_used_result = nullptr;
+    uint64_t least_recent_use = operation_use;
+    for (const auto item : tracked_results_.items()) {
+      if (item.key->is_spilled() || item.value.last_use >= least_recent_use) {
+        continue;
+      }
+
+      /* Spilling shared data will not free any memory. */
+      if (item.key->is_data_shared()) {
+        continue;
+      }
+
+      least_recent_use = item.value.last_use;
+      least_recently_used_result = item.key;
+    }
+
+    /* Nothing left to spill, so the inputs of the operation will exceed the budget. */
+    if (!least_recently_used_result) {
+      break;
+    }
+
+    TrackedResult &tracked_result = tracked_results_.lookup(least_recently_used_result);
+    if (!this->spill(*least_recently_used_result, tracked_result)) {
+      break;
+    }
+  }
+
+  for (Result *input : operation.get_results_mapped_to_inputs().values()) {
+    TrackedResult *tracked_result = tracked_results_.lookup_ptr(input);
+    if (tracked_result && input->is_spilled()) {
+      this->restore(*input, *tracked_result);
+    }
+  }
+}
+
+void ResultSpillManager::add_operation_results(Operation &operation)
+{
+  for (Result &result : operation.get_results().values()) {
+    if (!result.is_allocated() || result.is_single_value() || result.is_external() ||
+        result.storage_type() != ResultStorageType::CPU)
+    {
+      continue;
+    }
+
+    const int64_t size = result.cpu_data().size_in_bytes();
+    if (tracked_results_.add(&result, TrackedResult{size, ++use_clock_, {}})) {
+      memory_usage_ += size;
+    }
+  }
+}
+
+void ResultSpillManager::remove_freed_results()
+{
+  tracked_results_.remove_if([&](const auto item) {
+    if (item.key->is_allocated() || item.key->is_spilled()) {
+      return false;
+    }
+
+    if (item.value.tiles.is_empty()) {
+      memory_usage_ -= item.value.size;
+    }
+    else {
+      spilled_results_count_--;
+    }
+    return true;
+  });
+
+  /* The tiles of freed results are never read again, so the file can be overwritten from its start
+   * once no results are spilled. */
+  if (spilled_results_count_ == 0) {
+    file_end_ = 0;
+  }
+}
+
+/* Calls the given function for consecutive batches of the given range, where the size of each
+ * batch is the number of threads, such that each batch can be processed in parallel while the
+ * temporary memory is limited to a tile per thread. */
+template<typename Function>
+static void foreach_tiles_batch(const IndexRange range, const Function &function)
+{
+  const int64_t batch_size = math::max(BLI_task_scheduler_num_threads(), 1);
+  for (int64_t start = range.start(); start < range.one_after_last(); start += batch_size) {
+    const int64_t end = math::min(start + batch_size, range.one_after_last());
+    function(IndexRange::from_begin_end(start, end));
+  }
+}
+
+bool ResultSpillManager::spill(Result &result, TrackedResult &tracked_result)
+{
+  if (!this->ensure_file()) {
+    return false;
+  }
+
+  const int2 size = result.domain().size;
+  const int64_t row_size = int64_t(size.x) * result.get_cpp_type().size;
+  const int64_t rows_per_tile = math::max(tile_size / row_size, int64_t(1));
+  const int64_t tiles_count = int64_t(divide_ceil_ul(size.y, rows_per_tile));
+  const uint8_t *data = static_cast<const uint8_t *>(result.cpu_data().data());
+
+  Vector<SpilledTile> tiles;
+  int64_t compressed_size = 0;
+  bool is_written = BLI_fseek(file_, file_end_, SEEK_SET) == 0;
+  foreach_tiles_batch(IndexRange(tiles_count), [&](const IndexRange batch) {
+    if (!is_written) {
+      return;
+    }
+
+    Array<Array<uint8_t>> compressed_tiles(batch.size());
+    Array<size_t> compressed_sizes(batch.size());
+    threading::parallel_for(batch.index_range(), 1, [&](const IndexRange sub_range) {
+      for (const int64_t i : sub_range) {
+        const int64_t start_row = batch[i] * rows_per_tile;
+        const int64_t rows = math::min(rows_per_tile, int64_t(size.y) - start_row);
+        const int64_t uncompressed_size = rows * row_size;
+        compressed_tiles[i].reinitialize(ZSTD_compressBound(uncompressed_size));
+        compressed_sizes[i] = ZSTD_compress(compressed_tiles[i].data(),
+                                            compressed_tiles[i].size(),
+                                            data + start_row * row_size,
+                                            uncompressed_size,
+                                            compression_level);
+      }
+    });
+
+    for (const int64_t i : batch.index_range()) {
+      if (ZSTD_isError(compressed_sizes[i]) ||
+          fwrite(compressed_tiles[i].data(), 1, compressed_sizes[i], file_) != compressed_sizes[i])
+      {
+        is_written = false;
+        return;
+      }
+
+      const int64_t start_row = batch[i] * rows_per_tile;
+      const int64_t rows = math::min(rows_per_tile, int64_t(size.y) - start_row);
+      tiles.append({file_end_ + compressed_size, int64_t(compressed_sizes[i]), rows * row_size});
+      compressed_size += compressed_sizes[i];
+    }
+  });
+
+  /* Keep the result in memory if writing failed, for instance, because the disk is full. The
+   * partially written data is overwritten by the next spilled result. */
+  if (!is_written) {
+    return false;
+  }
+
+  file_end_ += compressed_size;
+  spilled_results_count_++;
+  memory_usage_ -= tracked_result.size;
+  tracked_result.tiles = std::move(tiles);
+  result.spill();
+
+  if (Profiler *profiler = context_.profiler()) {
+    profiler->add_spilled_tiles(tiles_count, tracked_result.size, compressed_size);
+  }
+
+  return true;
+}
+
+void ResultSpillManager::restore(Result &result, TrackedResult &tracked_result)
+{
+  BLI_assert(result.is_spilled());
+
+  result.unspill();
+  uint8_t *data = static_cast<uint8_t *>(result.cpu_data().data());
+
+  const Span<SpilledTile> tiles = tracked_result.tiles;
+  Array<int64_t> tile_offsets(tiles.size());
+  int64_t offset = 0;
+  for (const int64_t i : tiles.index_range()) {
+    tile_offsets[i] = offset;
+    offset += tiles[i].size;
+  }
+
+  foreach_tiles_batch(tiles.index_range(), [&](const IndexRange batch) {
+    Array<Array<uint8_t>> compressed_tiles(batch.size());
+    Array<bool> is_read(batch.size());
+    for (const int64_t i : batch.index_range()) {
+      const SpilledTile &tile = tiles[batch[i]];
+      compressed_tiles[i].reinitialize(tile.compressed_size);
+      is_read[i] = BLI_fseek(file_, tile.offset, SEEK_SET) == 0 &&
+                   fread(compressed_tiles[i].data(), 1, tile.compressed_size, file_) ==
+                       size_t(tile.compressed_size);
+    }
+
+    threading::parallel_for(batch.index_range(), 1, [&](const IndexRange sub_range) {
+      for (const int64_t i : sub_range) {
+        const SpilledTile &tile = tiles[batch[i]];
+        uint8_t *tile_data = data + tile_offsets[batch[i]];
+        const size_t decompressed_size = is_read[i] ?
+                                             ZSTD_decompress(tile_data,
+                                                             tile.size,
+                                                             compressed_tiles[i].data(),
+                                                             tile.compressed_size) :
+                                             0;
+
+        /* The scratch file was modified or truncated externally, which should never happen, so
+         * just zero the tile to avoid reading uninitialized data. */
+        if (ZSTD_isError(decompressed_size) || decompressed_size != size_t(tile.size)) {
+          BLI_assert_unreachable();
+          std::memset(tile_data, 0, tile.size);
+        }
+      }
+    });
+  });
+
+  if (Profiler *profiler = context_.profiler()) {
+    profiler->add_restored_tiles(tiles.size());
+  }
+
+  tracked_result.tiles.clear();
+  spilled_results_count_--;
+  memory_usage_ += tracked_result.size;
+}
+
+bool ResultSpillManager::ensure_file()
+{
+  if (file_) {
+    return true;
+  }
+
+  char file_name[64];
+  SNPRINTF(file_name, "compositor_spill_%p.bin", this);
+  char file_path[FILE_MAX];
+  BLI_path_join(file_path, sizeof(file_path), BKE_tempdir_session(), file_name);
+
+  file_ = BLI_fopen(file_path, "w+b");
+  if (!file_) {
+    return false;
+  }
+
+  file_path_ = file_path;
+  return true;
+}
+
+}  // namespace blender::compositor
@@ -35,7 +35,7 @@ void DepsgraphDebug::begin_graph_evaluation()
   graph_evaluation_start_time_ = current_time;
 }
 
-void DepsgraphDebug::end_graph_evaluation()
+void DepsgraphDebug::end_graph_evaluation(const int drivers_num)
 {
   if (!do_time_debug()) {
     return;
@@ -45,10 +45,15 @@ void DepsgraphDebug::end_graph_evaluation()
   const double graph_eval_time = graph_eval_end_time - graph_evaluation_start_time_;
 
   if (name.empty()) {
-    printf("Depsgraph updated in %f seconds.\n", graph_eval_time);
+    printf("Depsgraph updated in %f seconds, %d drivers evaluated.\n",
+           graph_eval_time,
+           drivers_num);
   }
   else {
-    printf("Depsgraph [%s] updated in %f seconds.\n", name.c_str(), graph_eval_time);
+    printf("Depsgraph [%s] updated in %f seconds, %d drivers evaluated.\n",
+           name.c_str(),
+           graph_eval_time,
+           drivers_num);
   }
 }
 
@@ -21,7 +21,8 @@ class DepsgraphDebug {
   bool do_time_debug() const;
 
   void begin_graph_evaluation();
-  void end_graph_evaluation();
+  /** \param drivers_num: Number of drivers evaluated during this update. */
+  void end_graph_evaluation(int drivers_num);
 
   /* NOTE: Corresponds to G_DEBUG_DEPSGRAPH_* flags. */
   int flags;
@@ -82,6 +82,8 @@ struct DepsgraphEvalState {
   EvaluationStage stage;
   bool need_update_pending_parents = true;
   bool need_single_thread_pass = false;
+  /* Number of evaluated driver operations, only counted when gathering statistics. */
+  mutable std::atomic<int> drivers_num = 0;
 };
 
 void evaluate_node(const DepsgraphEvalState *state, OperationNode *operation_node)
@@ -95,6 +97,9 @@ void evaluate_node(const DepsgraphEvalState *state, OperationNode *operation_nod
     const double start_time = BLI_time_now_seconds();
     operation_node->evaluate(depsgraph);
     operation_node->stats.current_time += BLI_time_now_seconds() - start_time;
+    if (operation_node->opcode == OperationCode::DRIVER) {
+      state->drivers_num.fetch_add(1, std::memory_order_relaxed);
+    }
   }
   else {
     operation_node->evaluate(depsgraph);
@@ -473,7 +478,7 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   BPy_END_ALLOW_THREADS;
 #endif
 
-  graph->debug.end_graph_evaluation();
+  graph->debug.end_graph_evaluation(state.drivers_num);
 }
 
 }  // namespace blender::deg
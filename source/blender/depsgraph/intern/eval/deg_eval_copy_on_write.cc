@@ -23,6 +23,7 @@
 #include "BLI_listbase.h"
 #include "BLI_utildefines.h"
 
+#include "BKE_anim_rna_path_cache.hh"
 #include "BKE_curve.hh"
 #include "BKE_global.hh"
 #include "BKE_layer.hh"
@@ -986,6 +987,8 @@ void deg_free_eval_copy_datablock(ID *id_cow)
   BKE_libblock_free_data_py(id_cow);
   BKE_libblock_free_datablock(id_cow, 0);
   BKE_libblock_free_data(id_cow, false);
+  /* Animation paths resolved into the freed data are dangling now. */
+  BKE_anim_rna_path_cache_invalidate_all();
   /* Signal datablock as not being expanded. */
   id_cow->name[0] = '\0';
 }
@@ -61,6 +61,10 @@ bool ED_paint_proj_mesh_data_check(Scene &scene,
                                    bool *r_has_mat,
                                    bool *r_has_tex,
                                    bool *r_has_stencil);
+/**
+ * Free the face binning of previous strokes that is kept to speed up the start of new strokes.
+ */
+void ED_paint_proj_setup_cache_free();
 
 /* `image_undo.cc` */
 
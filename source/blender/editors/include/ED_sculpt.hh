@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 struct Depsgraph;
 struct Main;
 struct Mesh;
@@ -67,6 +69,17 @@ void geometry_begin(const Scene &scene, Object &ob, const wmOperator *op);
 void geometry_begin_ex(const Scene &scene, Object &ob, const char *name);
 void geometry_end(Object &ob);
 
+struct StorageUsage {
+  size_t memory = 0;
+  size_t disk = 0;
+};
+
+/**
+ * The memory and disk space used by the sculpt steps of the undo stack, in bytes. Steps that are
+ * still being compressed are counted with their uncompressed size.
+ */
+StorageUsage storage_usage_get();
+
 /**
  * Undo for changes happening on a base mesh for multires sculpting.
  * if there is no multi-res sculpt active regular undo is used.
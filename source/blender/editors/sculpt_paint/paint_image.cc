@@ -784,6 +784,7 @@ void ED_object_texture_paint_mode_exit_ex(Main &bmain, Scene &scene, Object &ob)
   }
   BKE_image_paint_set_mipmap(&bmain, true);
   toggle_paint_cursor(scene, false);
+  ED_paint_proj_setup_cache_free();
 
   Mesh *mesh = BKE_mesh_from_object(&ob);
   BLI_assert(mesh != nullptr);
@@ -12,6 +12,7 @@
 #include <climits>
 #include <cmath>
 #include <cstring>
+#include <memory>
 
 #include "MEM_guardedalloc.h"
 
@@ -19,6 +20,7 @@
 #  include "BLI_winstuff.h"
 #endif
 
+#include "BLI_bounds.hh"
 #include "BLI_linklist.h"
 #include "BLI_listbase.h"
 #include "BLI_math_base_safe.h"
@@ -31,8 +33,11 @@
 #include "BLI_string.h"
 #include "BLI_string_utf8.h"
 #include "BLI_task.h"
+#include "BLI_task.hh"
 #include "BLI_threads.h"
+#include "BLI_time.h"
 #include "BLI_utildefines.h"
+#include "BLI_vector.hh"
 
 #include "atomic_ops.h"
 
@@ -74,6 +79,7 @@
 #include "BKE_node_legacy_types.hh"
 #include "BKE_node_runtime.hh"
 #include "BKE_object.hh"
+#include "BKE_object_types.hh"
 #include "BKE_paint.hh"
 #include "BKE_paint_types.hh"
 #include "BKE_report.hh"
@@ -111,12 +117,16 @@
 
 #include "IMB_colormanagement.hh"
 
+#include "CLG_log.h"
+
 // #include "bmesh_tools.hh"
 
 #include "paint_intern.hh"
 
 using blender::int3;
 
+static CLG_LogRef LOG = {"paint.project"};
+
 static void partial_redraw_array_init(ImagePaintPartialRedraw *pr);
 
 /* Defines and Structs */
@@ -2005,7 +2015,7 @@ static ProjPixel *project_paint_uvpixel_init(const ProjPaintState *ps,
       sub_v2_v2v2(co, projPixel->projCoSS, ps->cloneOffset);
 
       /* no need to initialize the bucket, we're only checking buckets faces and for this
-       * the faces are already initialized in project_paint_delayed_face_init(...) */
+       * the faces are already initialized in project_paint_bin_faces(...) */
       if (ibuf->float_buffer.data) {
         if (!project_paint_PickColor(
                 ps, co, ((ProjPixelClone *)projPixel)->clonepx.f, nullptr, true))
@@ -3583,7 +3593,7 @@ static void project_bucket_init(const ProjPaintState *ps,
  * will have its pixels calculated when it might not be needed later, (at the moment at least)
  * obviously it shouldn't have bugs though. */
 
-static bool project_bucket_face_isect(ProjPaintState *ps,
+static bool project_bucket_face_isect(const ProjPaintState *ps,
                                       int bucket_x,
                                       int bucket_y,
                                       const int3 &tri)
@@ -3635,12 +3645,12 @@ static bool project_bucket_face_isect(ProjPaintState *ps,
   return false;
 }
 
-/* Add faces to the bucket but don't initialize its pixels
+/* Get the buckets a face is added to, without initializing their pixels.
  * TODO: when painting occluded, sort the faces on their min-Z
  * and only add faces that faces that are not occluded */
-static void project_paint_delayed_face_init(ProjPaintState *ps,
-                                            const int3 &corner_tri,
-                                            const int tri_index)
+static void project_paint_delayed_face_buckets(const ProjPaintState *ps,
+                                               const int3 &corner_tri,
+                                               blender::Vector<int> &r_buckets)
 {
   const int vert_tri[3] = {PS_CORNER_TRI_AS_VERT_INDEX_3(ps, corner_tri)};
   float min[2], max[2], *vCoSS;
@@ -3649,8 +3659,6 @@ static void project_paint_delayed_face_init(ProjPaintState *ps,
   int fidx, bucket_x, bucket_y;
   /* for early loop exit */
   int has_x_isect = -1, has_isect = 0;
-  /* just use the first thread arena since threading has not started yet */
-  MemArena *arena = ps->arena_mt[0];
 
   INIT_MINMAX2(min, max);
 
@@ -3666,12 +3674,7 @@ static void project_paint_delayed_face_init(ProjPaintState *ps,
     has_x_isect = 0;
     for (bucket_x = bucketMin[0]; bucket_x < bucketMax[0]; bucket_x++) {
       if (project_bucket_face_isect(ps, bucket_x, bucket_y, corner_tri)) {
-        int bucket_index = bucket_x + (bucket_y * ps->buckets_x);
-        BLI_linklist_prepend_arena(&ps->bucketFaces[bucket_index],
-                                   /* cast to a pointer to shut up the compiler */
-                                   POINTER_FROM_INT(tri_index),
-                                   arena);
-
+        r_buckets.append(bucket_x + (bucket_y * ps->buckets_x));
         has_x_isect = has_isect = 1;
       }
       else if (has_x_isect) {
@@ -3686,15 +3689,6 @@ static void project_paint_delayed_face_init(ProjPaintState *ps,
       break;
     }
   }
-
-#ifndef PROJ_DEBUG_NOSEAMBLEED
-  if (ps->seam_bleed_px > 0.0f) {
-    /* set as uninitialized */
-    ps->loopSeamData[corner_tri[0]].seam_uvs[0][0] = FLT_MAX;
-    ps->loopSeamData[corner_tri[1]].seam_uvs[0][0] = FLT_MAX;
-    ps->loopSeamData[corner_tri[2]].seam_uvs[0][0] = FLT_MAX;
-  }
-#endif
 }
 
 static void proj_paint_state_viewport_init(ProjPaintState *ps, const char symmetry_flag)
@@ -3813,52 +3807,72 @@ static void proj_paint_state_viewport_init(ProjPaintState *ps, const char symmet
 
 static void proj_paint_state_screen_coords_init(ProjPaintState *ps, const int diameter)
 {
-  float *projScreenCo;
+  using namespace blender;
   float projMargin;
-  int a;
-
-  INIT_MINMAX2(ps->screenMin, ps->screenMax);
 
   ps->screenCoords = static_cast<float(*)[4]>(
       MEM_mallocN(sizeof(float) * ps->totvert_eval * 4, "ProjectPaint ScreenVerts"));
-  projScreenCo = *ps->screenCoords;
 
+  const IndexRange verts(ps->totvert_eval);
   if (ps->is_ortho) {
-    for (a = 0; a < ps->totvert_eval; a++, projScreenCo += 4) {
-      mul_v3_m4v3(projScreenCo, ps->projectMat, ps->vert_positions_eval[a]);
-
-      /* screen space, not clamped */
-      projScreenCo[0] = float(ps->winx * 0.5f) + (ps->winx * 0.5f) * projScreenCo[0];
-      projScreenCo[1] = float(ps->winy * 0.5f) + (ps->winy * 0.5f) * projScreenCo[1];
-      minmax_v2v2_v2(ps->screenMin, ps->screenMax, projScreenCo);
-    }
-  }
-  else {
-    for (a = 0; a < ps->totvert_eval; a++, projScreenCo += 4) {
-      copy_v3_v3(projScreenCo, ps->vert_positions_eval[a]);
-      projScreenCo[3] = 1.0f;
+    threading::parallel_for(verts, 4096, [&](const IndexRange range) {
+      for (const int a : range) {
+        float *projScreenCo = ps->screenCoords[a];
+        mul_v3_m4v3(projScreenCo, ps->projectMat, ps->vert_positions_eval[a]);
 
-      mul_m4_v4(ps->projectMat, projScreenCo);
-
-      if (projScreenCo[3] > ps->clip_start) {
         /* screen space, not clamped */
-        projScreenCo[0] = float(ps->winx * 0.5f) +
-                          (ps->winx * 0.5f) * projScreenCo[0] / projScreenCo[3];
-        projScreenCo[1] = float(ps->winy * 0.5f) +
-                          (ps->winy * 0.5f) * projScreenCo[1] / projScreenCo[3];
-        /* Use the depth for bucket point occlusion */
-        projScreenCo[2] = projScreenCo[2] / projScreenCo[3];
-        minmax_v2v2_v2(ps->screenMin, ps->screenMax, projScreenCo);
-      }
-      else {
-        /* TODO: deal with cases where 1 side of a face goes behind the view ?
-         *
-         * After some research this is actually very tricky, only option is to
-         * clip the derived mesh before painting, which is a Pain */
-        projScreenCo[0] = FLT_MAX;
+        projScreenCo[0] = float(ps->winx * 0.5f) + (ps->winx * 0.5f) * projScreenCo[0];
+        projScreenCo[1] = float(ps->winy * 0.5f) + (ps->winy * 0.5f) * projScreenCo[1];
       }
-    }
+    });
   }
+  else {
+    threading::parallel_for(verts, 4096, [&](const IndexRange range) {
+      for (const int a : range) {
+        float *projScreenCo = ps->screenCoords[a];
+        copy_v3_v3(projScreenCo, ps->vert_positions_eval[a]);
+        projScreenCo[3] = 1.0f;
+
+        mul_m4_v4(ps->projectMat, projScreenCo);
+
+        if (projScreenCo[3] > ps->clip_start) {
+          /* screen space, not clamped */
+          projScreenCo[0] = float(ps->winx * 0.5f) +
+                            (ps->winx * 0.5f) * projScreenCo[0] / projScreenCo[3];
+          projScreenCo[1] = float(ps->winy * 0.5f) +
+                            (ps->winy * 0.5f) * projScreenCo[1] / projScreenCo[3];
+          /* Use the depth for bucket point occlusion */
+          projScreenCo[2] = projScreenCo[2] / projScreenCo[3];
+        }
+        else {
+          /* TODO: deal with cases where 1 side of a face goes behind the view ?
+           *
+           * After some research this is actually very tricky, only option is to
+           * clip the derived mesh before painting, which is a Pain */
+          projScreenCo[0] = FLT_MAX;
+        }
+      }
+    });
+  }
+
+  /* Bounds of the vertices that are in front of the view. */
+  const Bounds<float2> init_bounds(float2(FLT_MAX), float2(-FLT_MAX));
+  const Bounds<float2> screen_bounds = threading::parallel_reduce(
+      verts,
+      4096,
+      init_bounds,
+      [&](const IndexRange range, Bounds<float2> bounds) {
+        for (const int a : range) {
+          const float *projScreenCo = ps->screenCoords[a];
+          if (projScreenCo[0] != FLT_MAX) {
+            minmax_v2v2_v2(bounds.min, bounds.max, projScreenCo);
+          }
+        }
+        return bounds;
+      },
+      [](const Bounds<float2> &a, const Bounds<float2> &b) { return bounds::merge(a, b); });
+  copy_v2_v2(ps->screenMin, screen_bounds.min);
+  copy_v2_v2(ps->screenMax, screen_bounds.max);
 
   /* If this border is not added we get artifacts for faces that
    * have a parallel edge and at the bounds of the 2D projected verts eg
@@ -3974,36 +3988,37 @@ static void proj_paint_state_thread_init(ProjPaintState *ps, const bool reset_th
 static void proj_paint_state_vert_flags_init(ProjPaintState *ps)
 {
   if (ps->do_backfacecull && ps->do_mask_normal) {
-    float viewDirPersp[3];
-    float no[3];
-    int a;
-
     ps->vertFlags = MEM_calloc_arrayN<char>(ps->totvert_eval, "paint-vertFlags");
 
-    for (a = 0; a < ps->totvert_eval; a++) {
-      copy_v3_v3(no, ps->vert_normals[a]);
-      if (UNLIKELY(ps->is_flip_object)) {
-        negate_v3(no);
-      }
+    blender::threading::parallel_for(
+        blender::IndexRange(ps->totvert_eval), 4096, [&](const blender::IndexRange range) {
+          float viewDirPersp[3];
+          float no[3];
+          for (const int a : range) {
+            copy_v3_v3(no, ps->vert_normals[a]);
+            if (UNLIKELY(ps->is_flip_object)) {
+              negate_v3(no);
+            }
 
-      if (ps->is_ortho) {
-        if (dot_v3v3(ps->viewDir, no) <= ps->normal_angle__cos) {
-          /* 1 vert of this face is towards us */
-          ps->vertFlags[a] |= PROJ_VERT_CULL;
-        }
-      }
-      else {
-        sub_v3_v3v3(viewDirPersp, ps->viewPos, ps->vert_positions_eval[a]);
-        normalize_v3(viewDirPersp);
-        if (UNLIKELY(ps->is_flip_object)) {
-          negate_v3(viewDirPersp);
-        }
-        if (dot_v3v3(viewDirPersp, no) <= ps->normal_angle__cos) {
-          /* 1 vert of this face is towards us */
-          ps->vertFlags[a] |= PROJ_VERT_CULL;
-        }
-      }
-    }
+            if (ps->is_ortho) {
+              if (dot_v3v3(ps->viewDir, no) <= ps->normal_angle__cos) {
+                /* 1 vert of this face is towards us */
+                ps->vertFlags[a] |= PROJ_VERT_CULL;
+              }
+            }
+            else {
+              sub_v3_v3v3(viewDirPersp, ps->viewPos, ps->vert_positions_eval[a]);
+              normalize_v3(viewDirPersp);
+              if (UNLIKELY(ps->is_flip_object)) {
+                negate_v3(viewDirPersp);
+              }
+              if (dot_v3v3(viewDirPersp, no) <= ps->normal_angle__cos) {
+                /* 1 vert of this face is towards us */
+                ps->vertFlags[a] |= PROJ_VERT_CULL;
+              }
+            }
+          }
+        });
   }
   else {
     ps->vertFlags = nullptr;
@@ -4306,6 +4321,203 @@ static void project_paint_build_proj_ima(ProjPaintState *ps,
   }
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Face Binning
+ *
+ * Adding the faces to the screen space buckets is the most expensive part of the setup of a
+ * stroke on dense meshes. It only depends on the evaluated mesh, the projection and the bucket
+ * resolution, which usually don't change between strokes. So the result is kept for the next
+ * strokes until the mesh or the view changes.
+ * \{ */
+
+struct ProjPaintBinningKey {
+  uint32_t ob_session_uid;
+  const Mesh *mesh_eval;
+  uint64_t last_update_geometry;
+  float projectMat[4][4];
+  int winx, winy;
+  bool is_ortho;
+  float clip_start;
+  float screenMin[2], screenMax[2];
+  int buckets_x, buckets_y;
+
+  bool operator==(const ProjPaintBinningKey &other) const = default;
+
+  bool is_same_mesh(const ProjPaintBinningKey &other) const
+  {
+    return ob_session_uid == other.ob_session_uid && mesh_eval == other.mesh_eval &&
+           last_update_geometry == other.last_update_geometry;
+  }
+};
+
+struct ProjPaintBinning {
+  ProjPaintBinningKey key;
+  /** The binned triangles, in the order they were added. */
+  blender::Array<int> tris;
+  /** For every bucket, the triangles in the order they were added to the bucket. */
+  blender::Array<int> bucket_offsets;
+  blender::Array<int> bucket_tris;
+};
+
+/** One binning is kept for every view of the stroke, which can have all symmetry axes. */
+#define PROJ_BINNING_CACHE_MAX 8
+
+static blender::Vector<std::unique_ptr<ProjPaintBinning>> *proj_binning_cache = nullptr;
+
+void ED_paint_proj_setup_cache_free()
+{
+  MEM_delete(proj_binning_cache);
+  proj_binning_cache = nullptr;
+}
+
+static ProjPaintBinningKey project_paint_binning_key(const ProjPaintState *ps)
+{
+  const Object *ob_eval = DEG_get_evaluated(ps->depsgraph, ps->ob);
+
+  ProjPaintBinningKey key{};
+  key.ob_session_uid = ps->ob->id.session_uid;
+  key.mesh_eval = ps->mesh_eval;
+  key.last_update_geometry = ob_eval->runtime->last_update_geometry;
+  copy_m4_m4(key.projectMat, ps->projectMat);
+  key.winx = ps->winx;
+  key.winy = ps->winy;
+  key.is_ortho = ps->is_ortho;
+  key.clip_start = ps->clip_start;
+  copy_v2_v2(key.screenMin, ps->screenMin);
+  copy_v2_v2(key.screenMax, ps->screenMax);
+  key.buckets_x = ps->buckets_x;
+  key.buckets_y = ps->buckets_y;
+  return key;
+}
+
+static std::unique_ptr<ProjPaintBinning> project_paint_binning_calc(const ProjPaintState *ps,
+                                                                    const blender::Span<int> tris)
+{
+  using namespace blender;
+  std::unique_ptr<ProjPaintBinning> binning = std::make_unique<ProjPaintBinning>();
+  binning->tris = Array<int>(tris);
+
+  /* Find the buckets of the triangles in parallel, in chunks of a fixed size so that the order of
+   * the triangles in the buckets doesn't depend on threading. */
+  const int64_t chunk_size = 1024;
+  const int64_t chunks_num = (tris.size() + chunk_size - 1) / chunk_size;
+  struct Chunk {
+    Vector<int> tri_offsets;
+    Vector<int> buckets;
+  };
+  Array<Chunk> chunks(chunks_num);
+  threading::parallel_for(IndexRange(chunks_num), 1, [&](const IndexRange range) {
+    for (const int64_t chunk_i : range) {
+      Chunk &chunk = chunks[chunk_i];
+      const Span<int> chunk_tris = tris.slice(tris.index_range().drop_front(
+          chunk_i * chunk_size).take_front(chunk_size));
+      chunk.tri_offsets.reserve(chunk_tris.size() + 1);
+      for (const int tri_i : chunk_tris) {
+        chunk.tri_offsets.append(chunk.buckets.size());
+        project_paint_delayed_face_buckets(ps, ps->corner_tris_eval[tri_i], chunk.buckets);
+      }
+      chunk.tri_offsets.append(chunk.buckets.size());
+    }
+  });
+
+  const int buckets_num = ps->buckets_x * ps->buckets_y;
+  binning->bucket_offsets.reinitialize(buckets_num + 1);
+  binning->bucket_offsets.fill(0);
+  for (const Chunk &chunk : chunks) {
+    for (const int bucket : chunk.buckets) {
+      binning->bucket_offsets[bucket]++;
+    }
+  }
+  const OffsetIndices bucket_offsets = offset_indices::accumulate_counts_to_offsets(
+      binning->bucket_offsets);
+
+  binning->bucket_tris.reinitialize(bucket_offsets.total_size());
+  Array<int> bucket_fill(buckets_num, 0);
+  for (const int64_t chunk_i : chunks.index_range()) {
+    const Chunk &chunk = chunks[chunk_i];
+    for (const int i : chunk.tri_offsets.index_range().drop_back(1)) {
+      const int tri_i = tris[chunk_i * chunk_size + i];
+      for (const int bucket :
+           chunk.buckets.as_span().slice(chunk.tri_offsets[i],
+                                         chunk.tri_offsets[i + 1] - chunk.tri_offsets[i]))
+      {
+        binning->bucket_tris[bucket_offsets[bucket][bucket_fill[bucket]++]] = tri_i;
+      }
+    }
+  }
+
+  return binning;
+}
+
+/* Add faces to the buckets but don't initialize their pixels. */
+static void project_paint_bin_faces(ProjPaintState *ps, const blender::Span<int> tris)
+{
+  using namespace blender;
+  const double start_time = BLI_time_now_seconds();
+
+  if (proj_binning_cache == nullptr) {
+    proj_binning_cache = MEM_new<Vector<std::unique_ptr<ProjPaintBinning>>>(__func__);
+  }
+  Vector<std::unique_ptr<ProjPaintBinning>> &cache = *proj_binning_cache;
+
+  const ProjPaintBinningKey key = project_paint_binning_key(ps);
+  const ProjPaintBinning *binning = nullptr;
+  for (const std::unique_ptr<ProjPaintBinning> &cached : cache) {
+    if (cached->key == key && cached->tris.as_span() == tris) {
+      binning = cached.get();
+      break;
+    }
+  }
+
+  const bool is_cached = binning != nullptr;
+  if (!is_cached) {
+    /* The binning of other meshes or older versions of this mesh can't be used anymore. */
+    cache.remove_if([&](const std::unique_ptr<ProjPaintBinning> &cached) {
+      return !cached->key.is_same_mesh(key);
+    });
+    if (cache.size() >= PROJ_BINNING_CACHE_MAX) {
+      cache.remove(0);
+    }
+    std::unique_ptr<ProjPaintBinning> new_binning = project_paint_binning_calc(ps, tris);
+    new_binning->key = key;
+    binning = new_binning.get();
+    cache.append(std::move(new_binning));
+  }
+
+  /* just use the first thread arena since threading has not started yet */
+  MemArena *arena = ps->arena_mt[0];
+  const OffsetIndices<int> bucket_offsets = binning->bucket_offsets.as_span();
+  for (const int bucket_index : bucket_offsets.index_range()) {
+    for (const int tri_i : binning->bucket_tris.as_span().slice(bucket_offsets[bucket_index])) {
+      BLI_linklist_prepend_arena(&ps->bucketFaces[bucket_index],
+                                 /* cast to a pointer to shut up the compiler */
+                                 POINTER_FROM_INT(tri_i),
+                                 arena);
+    }
+  }
+
+#ifndef PROJ_DEBUG_NOSEAMBLEED
+  if (ps->seam_bleed_px > 0.0f) {
+    for (const int tri_i : tris) {
+      const int3 &corner_tri = ps->corner_tris_eval[tri_i];
+      /* set as uninitialized */
+      ps->loopSeamData[corner_tri[0]].seam_uvs[0][0] = FLT_MAX;
+      ps->loopSeamData[corner_tri[1]].seam_uvs[0][0] = FLT_MAX;
+      ps->loopSeamData[corner_tri[2]].seam_uvs[0][0] = FLT_MAX;
+    }
+  }
+#endif
+
+  CLOG_DEBUG(&LOG,
+             "Binned %d triangles into %d buckets in %.2f ms%s",
+             int(tris.size()),
+             int(bucket_offsets.size()),
+             (BLI_time_now_seconds() - start_time) * 1000.0,
+             is_cached ? " (cached)" : "");
+}
+
+/** \} */
+
 static void project_paint_prepare_all_faces(ProjPaintState *ps,
                                             MemArena *arena,
                                             const ProjPaintFaceLookup *face_lookup,
@@ -4324,6 +4536,7 @@ static void project_paint_prepare_all_faces(ProjPaintState *ps,
   int prev_poly = -1;
   const blender::Span<int3> corner_tris = ps->corner_tris_eval;
   const blender::Span<int> tri_faces = ps->corner_tri_faces_eval;
+  blender::Vector<int> binned_tris;
 
   BLI_assert(ps->image_tot == 0);
 
@@ -4475,11 +4688,26 @@ static void project_paint_prepare_all_faces(ProjPaintState *ps,
       if (image_index != -1) {
         /* Initialize the faces screen pixels */
         /* Add this to a list to initialize later */
-        project_paint_delayed_face_init(ps, corner_tris[tri_index], tri_index);
+        binned_tris.append(tri_index);
       }
     }
   }
 
+  project_paint_bin_faces(ps, binned_tris);
+
+#ifndef PROJ_DEBUG_NOSEAMBLEED
+  /* Detecting seams while painting needs the winding of the neighboring faces, which can be
+   * computed for all faces at once here instead of lazily by the painting threads. */
+  if (ps->seam_bleed_px > 0.0f && ps->is_shared_user == false) {
+    blender::threading::parallel_for(
+        corner_tris.index_range(), 4096, [&](const blender::IndexRange range) {
+          for (const int tri_i : range) {
+            project_face_winding_init(ps, tri_i);
+          }
+        });
+  }
+#endif
+
   /* Build an array of images we use. */
   if (ps->is_shared_user == false) {
     project_paint_build_proj_ima(ps, arena, &used_images);
@@ -4499,6 +4727,8 @@ static void project_paint_begin(const bContext *C,
   ProjPaintFaceLookup face_lookup;
   const float(*mloopuv_base)[2] = nullptr;
 
+  const double start_time = BLI_time_now_seconds();
+
   /* At the moment this is just ps->arena_mt[0], but use this to show were not multi-threading. */
   MemArena *arena;
 
@@ -4595,6 +4825,11 @@ static void project_paint_begin(const bContext *C,
 
   project_paint_prepare_all_faces(
       ps, arena, &face_lookup, &layer_clone, mloopuv_base, is_multi_view);
+
+  CLOG_DEBUG(&LOG,
+             "Stroke setup of %d triangles in %.2f ms",
+             int(ps->corner_tris_eval.size()),
+             (BLI_time_now_seconds() - start_time) * 1000.0);
 }
 
 static void paint_proj_begin_clone(ProjPaintState *ps, const float mouse[2])
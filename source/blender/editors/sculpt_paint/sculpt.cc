@@ -3026,6 +3026,10 @@ static void dynamic_topology_update(const Depsgraph &depsgraph,
     {
       mode |= PBVH_Collapse;
     }
+
+    if (sd.flags & SCULPT_DYNTOPO_PARALLEL) {
+      mode |= PBVH_Parallel;
+    }
   }
 
   if (brush.sculpt_brush_type == SCULPT_BRUSH_TYPE_MASK) {
@@ -1095,7 +1095,11 @@ static void fill_topology_automasking_factors_mesh(const Depsgraph &depsgraph,
   const int active_vert = std::get<int>(ss.active_vert());
   flood_fill::FillDataMesh flood = flood_fill::FillDataMesh(vert_positions.size());
 
-  flood.add_initial(find_symm_verts_mesh(depsgraph, ob, active_vert, radius));
+  const Vector<int> initial_verts = find_symm_verts_mesh(depsgraph, ob, active_vert, radius);
+  flood.add_initial(initial_verts);
+
+  /* Every other vertex the fill starts from is set when it is reached. */
+  factors.fill_indices(initial_verts.as_span(), 1.0f);
 
   const bool use_radius = ss.cache && is_constrained_by_radius(brush);
   const ePaintSymmetryFlags symm = SCULPT_mesh_symmetry_xyz_get(ob);
@@ -1103,16 +1107,14 @@ static void fill_topology_automasking_factors_mesh(const Depsgraph &depsgraph,
   float3 location = vert_positions[active_vert];
 
   if (use_radius) {
-    flood.execute(ob, vert_to_face_map, [&](int from_v, int to_v) {
-      factors[from_v] = 1.0f;
+    flood.execute_parallel(ob, vert_to_face_map, [&](int /*from_v*/, int to_v) {
       factors[to_v] = 1.0f;
       return SCULPT_is_vertex_inside_brush_radius_symm(
           vert_positions[to_v], location, radius, symm);
     });
   }
   else {
-    flood.execute(ob, vert_to_face_map, [&](int from_v, int to_v) {
-      factors[from_v] = 1.0f;
+    flood.execute_parallel(ob, vert_to_face_map, [&](int /*from_v*/, int to_v) {
       factors[to_v] = 1.0f;
       return true;
     });
@@ -12,6 +12,7 @@
 #include "BLI_math_geom.h"
 #include "BLI_math_rotation_legacy.hh"
 #include "BLI_math_vector.hh"
+#include "BLI_task.hh"
 
 #include "DNA_brush_types.h"
 #include "DNA_mesh_types.h"
@@ -169,29 +170,45 @@ static std::optional<int> get_closest_boundary_vert_mesh(Object &object,
   const float3 initial_vert_position = vert_positions[initial_vert];
   const float radius_sq = radius * radius;
 
-  std::optional<int> boundary_initial_vert;
-  int boundary_initial_vert_steps = std::numeric_limits<int>::max();
   Array<int> floodfill_steps(vert_positions.size(), 0);
 
-  flood_fill.execute(object, vert_to_face, [&](int from_v, int to_v) {
+  flood_fill.execute_parallel(object, vert_to_face, [&](int from_v, int to_v) {
     if (!hide_vert.is_empty() && hide_vert[from_v]) {
       return false;
     }
 
     floodfill_steps[to_v] = floodfill_steps[from_v] + 1;
 
-    if (boundary::vert_is_boundary(vert_to_face, hide_poly, boundary, to_v)) {
-      if (floodfill_steps[to_v] < boundary_initial_vert_steps) {
-        boundary_initial_vert_steps = floodfill_steps[to_v];
-        boundary_initial_vert = to_v;
-      }
-    }
-
     const float len_sq = math::distance_squared(initial_vert_position, vert_positions[to_v]);
     return len_sq < radius_sq;
   });
 
-  return boundary_initial_vert;
+  /* The boundary vertex reached in the fewest steps. The lowest index is used for vertices that
+   * are reached in the same number of steps, so that the result doesn't depend on threading. */
+  using StepsAndVert = std::pair<int, int>;
+  const StepsAndVert no_vert(std::numeric_limits<int>::max(), -1);
+  const StepsAndVert closest = threading::parallel_reduce(
+      floodfill_steps.index_range(),
+      4096,
+      no_vert,
+      [&](const IndexRange range, StepsAndVert closest) {
+        for (const int vert : range) {
+          const int steps = floodfill_steps[vert];
+          if (steps == 0 || steps >= closest.first) {
+            continue;
+          }
+          if (boundary::vert_is_boundary(vert_to_face, hide_poly, boundary, vert)) {
+            closest = {steps, vert};
+          }
+        }
+        return closest;
+      },
+      [](const StepsAndVert &a, const StepsAndVert &b) { return std::min(a, b); });
+
+  if (closest.second == -1) {
+    return std::nullopt;
+  }
+  return closest.second;
 }
 
 static std::optional<SubdivCCGCoord> get_closest_boundary_vert_grids(
@@ -135,6 +135,11 @@ static wmOperatorStatus sculpt_detail_flood_fill_exec(bContext *C, wmOperator *o
                              (sd->constant_detail * mat4_to_scale(ob.object_to_world().ptr()));
   const float min_edge_len = max_edge_len * detail_size::EDGE_LENGTH_MIN_FACTOR;
 
+  PBVHTopologyUpdateMode mode = PBVH_Collapse | PBVH_Subdivide;
+  if (sd->flags & SCULPT_DYNTOPO_PARALLEL) {
+    mode |= PBVH_Parallel;
+  }
+
   undo::push_begin(scene, ob, op);
   undo::push_node(depsgraph, ob, nullptr, undo::Type::Position);
 
@@ -143,7 +148,7 @@ static wmOperatorStatus sculpt_detail_flood_fill_exec(bContext *C, wmOperator *o
   while (bke::pbvh::bmesh_update_topology(*ss.bm,
                                           pbvh,
                                           *ss.bm_log,
-                                          PBVH_Collapse | PBVH_Subdivide,
+                                          mode,
                                           min_edge_len,
                                           max_edge_len,
                                           center,
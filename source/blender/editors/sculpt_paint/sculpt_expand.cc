@@ -746,7 +746,7 @@ static void calc_topology_falloff_from_verts(Object &ob,
     case bke::pbvh::Type::Mesh: {
       flood_fill::FillDataMesh flood(totvert);
       initial_verts.foreach_index([&](const int vert) { flood.add_and_skip_initial(vert); });
-      flood.execute(ob, vert_to_face_map, [&](const int from_vert, const int to_vert) {
+      flood.execute_parallel(ob, vert_to_face_map, [&](const int from_vert, const int to_vert) {
         distances[to_vert] = distances[from_vert] + 1.0f;
         return true;
       });
@@ -833,7 +833,7 @@ static Array<float> normals_falloff_create(const Depsgraph &depsgraph,
       const float3 orig_normal = vert_normals[vert];
       flood_fill::FillDataMesh flood(totvert);
       flood.add_initial(find_symm_verts(depsgraph, ob, vert));
-      flood.execute(ob, vert_to_face_map, [&](const int from_vert, const int to_vert) {
+      flood.execute_parallel(ob, vert_to_face_map, [&](const int from_vert, const int to_vert) {
         const float3 &from_normal = vert_normals[from_vert];
         const float3 &to_normal = vert_normals[to_vert];
         const float from_edge_factor = edge_factors[from_vert];
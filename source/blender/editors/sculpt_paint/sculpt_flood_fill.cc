@@ -4,6 +4,12 @@
 
 #include "sculpt_flood_fill.hh"
 
+#include <atomic>
+#include <limits>
+
+#include "BLI_array.hh"
+#include "BLI_task.hh"
+
 #include "BKE_attribute.hh"
 #include "BKE_mesh.hh"
 
@@ -116,6 +122,105 @@ void FillDataMesh::execute(Object &object,
   }
 }
 
+/* Number of vertices of a step that are processed together. It is fixed rather than depending on
+ * the scheduling, because the order of the next step depends on it. */
+static constexpr int64_t parallel_fill_chunk_size = 1024;
+
+void FillDataMesh::execute_parallel(Object &object,
+                                    const GroupedSpan<int> vert_to_face_map,
+                                    FunctionRef<bool(int from_v, int to_v)> func)
+{
+  Mesh &mesh = *static_cast<Mesh *>(object.data);
+  const OffsetIndices faces = mesh.faces();
+  const Span<int> corner_verts = mesh.corner_verts();
+  const bke::AttributeAccessor attributes = mesh.attributes();
+  const VArraySpan hide_poly = *attributes.lookup<bool>(".hide_poly", bke::AttrDomain::Face);
+  const VArraySpan hide_vert = *attributes.lookup<bool>(".hide_vert", bke::AttrDomain::Point);
+
+  /* For every vertex, the position in the current step of the first vertex that reaches it,
+   * which is the one that reaches it first when processing the queue serially. Visited vertices
+   * are marked with -1, which is smaller than all positions, so they are never claimed. */
+  constexpr int unclaimed = std::numeric_limits<int>::max();
+  constexpr int visited = -1;
+  Array<std::atomic<int>> claims(this->visited_verts.size());
+  threading::parallel_for(claims.index_range(), 4096, [&](const IndexRange range) {
+    for (const int vert : range) {
+      claims[vert].store(this->visited_verts[vert] ? visited : unclaimed,
+                         std::memory_order_relaxed);
+    }
+  });
+
+  const auto foreach_neighbor = [&](const int from_v, Vector<int> &neighbors, auto &&fn) {
+    vert_neighbors_get_mesh(faces, corner_verts, vert_to_face_map, hide_poly, from_v, neighbors);
+    if (!this->fake_neighbors.is_empty() && this->fake_neighbors[from_v] != FAKE_NEIGHBOR_NONE) {
+      neighbors.append(this->fake_neighbors[from_v]);
+    }
+    for (const int neighbor : neighbors) {
+      if (!hide_vert.is_empty() && hide_vert[neighbor]) {
+        continue;
+      }
+      fn(neighbor);
+    }
+  };
+
+  Vector<int> step;
+  while (!this->queue.empty()) {
+    step.append(this->queue.front());
+    this->queue.pop();
+  }
+
+  while (!step.is_empty()) {
+    /* Claim the unvisited neighbors for the first vertex of the step that reaches them. */
+    threading::parallel_for(step.index_range(), 256, [&](const IndexRange range) {
+      Vector<int> neighbors;
+      for (const int i : range) {
+        foreach_neighbor(step[i], neighbors, [&](const int neighbor) {
+          int claim = claims[neighbor].load(std::memory_order_relaxed);
+          while (i < claim && !claims[neighbor].compare_exchange_weak(
+                                  claim, i, std::memory_order_relaxed))
+          {
+          }
+        });
+      }
+    });
+
+    /* Visit the claimed neighbors, in the same order as the serial fill within each chunk. */
+    const int64_t chunks_num = (step.size() + parallel_fill_chunk_size - 1) /
+                               parallel_fill_chunk_size;
+    Array<Vector<int>> next_step_chunks(chunks_num);
+    threading::parallel_for(IndexRange(chunks_num), 1, [&](const IndexRange range) {
+      Vector<int> neighbors;
+      for (const int64_t chunk : range) {
+        const IndexRange chunk_range = step.index_range().drop_front(
+            chunk * parallel_fill_chunk_size).take_front(parallel_fill_chunk_size);
+        for (const int i : chunk_range) {
+          const int from_v = step[i];
+          foreach_neighbor(from_v, neighbors, [&](const int neighbor) {
+            if (claims[neighbor].load(std::memory_order_relaxed) != i) {
+              return;
+            }
+            claims[neighbor].store(visited, std::memory_order_relaxed);
+            if (func(from_v, neighbor)) {
+              next_step_chunks[chunk].append(neighbor);
+            }
+          });
+        }
+      }
+    });
+
+    step.clear();
+    for (const Span<int> chunk : next_step_chunks) {
+      step.extend(chunk);
+    }
+  }
+
+  for (const int vert : claims.index_range()) {
+    if (claims[vert].load(std::memory_order_relaxed) == visited) {
+      this->visited_verts[vert].set();
+    }
+  }
+}
+
 void FillDataGrids::execute(
     Object & /*object*/,
     const SubdivCCG &subdiv_ccg,
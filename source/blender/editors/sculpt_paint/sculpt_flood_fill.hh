@@ -41,6 +41,15 @@ struct FillDataMesh {
   void execute(Object &object,
                GroupedSpan<int> vert_to_face_map,
                FunctionRef<bool(int from_v, int to_v)> func);
+  /**
+   * Same as #execute, but processes the vertices of each step of the fill in parallel. Every
+   * vertex is reached from the same vertex as with #execute, but the function is called from
+   * multiple threads at the same time. It must only write to data of the `to_v` vertex, and only
+   * read data of other vertices that was written before the fill or by a previous step.
+   */
+  void execute_parallel(Object &object,
+                        GroupedSpan<int> vert_to_face_map,
+                        FunctionRef<bool(int from_v, int to_v)> func);
 };
 
 struct FillDataGrids {
@@ -6,43 +6,73 @@
  * \ingroup edsculpt
  */
 
+#include <algorithm>
+#include <atomic>
 #include <cstdlib>
+#include <optional>
 
-#include "BLI_bit_vector.hh"
-#include "BLI_linklist_stack.h"
+#include "BLI_enumerable_thread_specific.hh"
+#include "BLI_index_mask.hh"
 #include "BLI_math_geom.h"
 #include "BLI_math_vector.h"
+#include "BLI_task.hh"
 
 #include "DNA_mesh_types.h"
 
+#include "BKE_mesh.hh"
+
 #include "sculpt_geodesic.hh"
 
 #define SCULPT_GEODESIC_VERTEX_NONE -1
 
 namespace blender::ed::sculpt_paint::geodesic {
 
-/* Propagate distance from v1 and v2 to v0. */
-static bool sculpt_geodesic_mesh_test_dist_add(Span<float3> vert_positions,
-                                               const int v0,
-                                               const int v1,
-                                               const int v2,
-                                               MutableSpan<float> dists,
-                                               const Set<int> &initial_verts)
+/**
+ * The distances are propagated in waves of edges. Within a wave, all edges are processed in
+ * parallel: they read the distances of the previous wave and lower the new distances of the
+ * vertices they reach with an atomic minimum. Since the minimum doesn't depend on the order, the
+ * result doesn't depend on threading.
+ */
+enum VertUpdate : uint8_t {
+  VERT_UPDATE_NONE = 0,
+  /** The distance of the vertex is lowered in this wave. */
+  VERT_UPDATE_DIST = 1 << 0,
+  /** The distance was propagated across a triangle, so the edges of the vertex are added to the
+   * next wave. */
+  VERT_UPDATE_PROPAGATE = 1 << 1,
+};
+
+static void atomic_min_float(std::atomic<float> &value, const float new_value)
+{
+  float old_value = value.load(std::memory_order_relaxed);
+  while (new_value < old_value &&
+         !value.compare_exchange_weak(old_value, new_value, std::memory_order_relaxed))
+  {
+  }
+}
+
+/* Propagate distance from v1 and v2 to v0, returning the new distance if it is lower. */
+static std::optional<float> sculpt_geodesic_mesh_test_dist_add(Span<float3> vert_positions,
+                                                               const int v0,
+                                                               const int v1,
+                                                               const int v2,
+                                                               const Span<float> dists,
+                                                               const Set<int> &initial_verts)
 {
   if (initial_verts.contains(v0)) {
-    return false;
+    return std::nullopt;
   }
 
   BLI_assert(dists[v1] != FLT_MAX);
   if (dists[v0] <= dists[v1]) {
-    return false;
+    return std::nullopt;
   }
 
   float dist0;
   if (v2 != SCULPT_GEODESIC_VERTEX_NONE) {
     BLI_assert(dists[v2] != FLT_MAX);
     if (dists[v0] <= dists[v2]) {
-      return false;
+      return std::nullopt;
     }
     dist0 = geodesic_distance_propagate_across_triangle(
         vert_positions[v0], vert_positions[v1], vert_positions[v2], dists[v1], dists[v2]);
@@ -54,11 +84,10 @@ static bool sculpt_geodesic_mesh_test_dist_add(Span<float3> vert_positions,
   }
 
   if (dist0 < dists[v0]) {
-    dists[v0] = dist0;
-    return true;
+    return dist0;
   }
 
-  return false;
+  return std::nullopt;
 }
 
 Array<float> distances_create(const Span<float3> vert_positions,
@@ -74,27 +103,15 @@ Array<float> distances_create(const Span<float3> vert_positions,
   const float limit_radius_sq = limit_radius * limit_radius;
 
   Array<float> dists(vert_positions.size());
-  BitVector<> edge_tag(edges.size());
-
-  /* Both contain edge indices encoded as *void. */
-  BLI_LINKSTACK_DECLARE(queue, void *);
-  BLI_LINKSTACK_DECLARE(queue_next, void *);
-
-  BLI_LINKSTACK_INIT(queue);
-  BLI_LINKSTACK_INIT(queue_next);
-
-  for (const int i : vert_positions.index_range()) {
-    if (initial_verts.contains(i)) {
-      dists[i] = 0.0f;
-    }
-    else {
-      dists[i] = FLT_MAX;
+  threading::parallel_for(vert_positions.index_range(), 4096, [&](const IndexRange range) {
+    for (const int i : range) {
+      dists[i] = initial_verts.contains(i) ? 0.0f : FLT_MAX;
     }
-  }
+  });
 
   /* Masks vertices that are further than limit radius from an initial vertex. As there is no need
    * to define a distance to them the algorithm can stop earlier by skipping them. */
-  BitVector<> affected_vert(vert_positions.size());
+  Array<bool> affected_vert(vert_positions.size());
 
   if (limit_radius == FLT_MAX) {
     /* In this case, no need to loop through all initial vertices to check distances as they are
@@ -105,87 +122,146 @@ Array<float> distances_create(const Span<float3> vert_positions,
     /* This is an O(n^2) loop used to limit the geodesic distance calculation to a radius. When
      * this optimization is needed, it is expected for the tool to request the distance to a low
      * number of vertices (usually just 1 or 2). */
-    for (const int v : initial_verts) {
-      const float *v_co = vert_positions[v];
-      for (const int i : vert_positions.index_range()) {
-        if (len_squared_v3v3(v_co, vert_positions[i]) <= limit_radius_sq) {
-          affected_vert[i].set();
-        }
+    threading::parallel_for(vert_positions.index_range(), 4096, [&](const IndexRange range) {
+      for (const int i : range) {
+        affected_vert[i] = std::any_of(
+            initial_verts.begin(), initial_verts.end(), [&](const int v) {
+              return len_squared_v3v3(vert_positions[v], vert_positions[i]) <= limit_radius_sq;
+            });
       }
-    }
+    });
   }
 
   /* Add edges adjacent to an initial vertex to the queue. */
-  for (const int i : edges.index_range()) {
-    const int v1 = edges[i][0];
-    const int v2 = edges[i][1];
-    if (!affected_vert[v1] && !affected_vert[v2]) {
-      continue;
-    }
-    if (dists[v1] != FLT_MAX || dists[v2] != FLT_MAX) {
-      BLI_LINKSTACK_PUSH(queue, POINTER_FROM_INT(i));
-    }
+  Vector<int> queue;
+  {
+    IndexMaskMemory memory;
+    const IndexMask initial_edges = IndexMask::from_predicate(
+        edges.index_range(), GrainSize(4096), memory, [&](const int i) {
+          const int v1 = edges[i][0];
+          const int v2 = edges[i][1];
+          if (!affected_vert[v1] && !affected_vert[v2]) {
+            return false;
+          }
+          return dists[v1] != FLT_MAX || dists[v2] != FLT_MAX;
+        });
+    queue.resize(initial_edges.size());
+    initial_edges.to_indices(queue.as_mutable_span());
   }
 
-  do {
-    while (BLI_LINKSTACK_SIZE(queue)) {
-      const int e = POINTER_AS_INT(BLI_LINKSTACK_POP(queue));
-      int v1 = edges[e][0];
-      int v2 = edges[e][1];
+  Array<std::atomic<float>> new_dists(vert_positions.size());
+  threading::parallel_for(vert_positions.index_range(), 4096, [&](const IndexRange range) {
+    for (const int i : range) {
+      new_dists[i].store(dists[i], std::memory_order_relaxed);
+    }
+  });
+  /* Atomics are zero initialized, which is #VERT_UPDATE_NONE and untagged. */
+  Array<std::atomic<uint8_t>> vert_updates(vert_positions.size());
+  Array<std::atomic<bool>> edge_tag(edges.size());
 
-      if (dists[v1] == FLT_MAX || dists[v2] == FLT_MAX) {
-        if (dists[v1] > dists[v2]) {
-          std::swap(v1, v2);
-        }
-        sculpt_geodesic_mesh_test_dist_add(
-            vert_positions, v2, v1, SCULPT_GEODESIC_VERTEX_NONE, dists, initial_verts);
+  threading::EnumerableThreadSpecific<Vector<int>> all_updated_verts;
+  threading::EnumerableThreadSpecific<Vector<int>> all_next_edges;
+
+  while (!queue.is_empty()) {
+    const auto update_vert = [&](Vector<int> &updated_verts,
+                                 const int vert,
+                                 const float dist,
+                                 const uint8_t flag) {
+      atomic_min_float(new_dists[vert], dist);
+      const uint8_t prev = vert_updates[vert].fetch_or(flag, std::memory_order_relaxed);
+      if (prev == VERT_UPDATE_NONE) {
+        updated_verts.append(vert);
       }
+    };
 
-      for (const int face : edge_to_face_map[e]) {
-        if (!hide_poly.is_empty() && hide_poly[face]) {
-          continue;
+    threading::parallel_for(queue.index_range(), 256, [&](const IndexRange range) {
+      Vector<int> &updated_verts = all_updated_verts.local();
+      for (const int e : queue.as_span().slice(range)) {
+        int v1 = edges[e][0];
+        int v2 = edges[e][1];
+
+        if (dists[v1] == FLT_MAX || dists[v2] == FLT_MAX) {
+          if (dists[v1] > dists[v2]) {
+            std::swap(v1, v2);
+          }
+          if (const std::optional<float> dist = sculpt_geodesic_mesh_test_dist_add(
+                  vert_positions, v2, v1, SCULPT_GEODESIC_VERTEX_NONE, dists, initial_verts))
+          {
+            update_vert(updated_verts, v2, *dist, VERT_UPDATE_DIST);
+          }
         }
-        for (const int v_other : corner_verts.slice(faces[face])) {
-          if (ELEM(v_other, v1, v2)) {
+
+        for (const int face : edge_to_face_map[e]) {
+          if (!hide_poly.is_empty() && hide_poly[face]) {
             continue;
           }
-          if (sculpt_geodesic_mesh_test_dist_add(
-                  vert_positions, v_other, v1, v2, dists, initial_verts))
-          {
-            for (const int e_other : vert_to_edge_map[v_other]) {
-              int ev_other;
-              if (edges[e_other][0] == v_other) {
-                ev_other = edges[e_other][1];
-              }
-              else {
-                ev_other = edges[e_other][0];
-              }
-
-              if (e_other != e && !edge_tag[e_other] &&
-                  (edge_to_face_map[e_other].is_empty() || dists[ev_other] != FLT_MAX))
-              {
-                if (affected_vert[v_other] || affected_vert[ev_other]) {
-                  edge_tag[e_other].set();
-                  BLI_LINKSTACK_PUSH(queue_next, POINTER_FROM_INT(e_other));
-                }
-              }
+          for (const int v_other : corner_verts.slice(faces[face])) {
+            if (ELEM(v_other, v1, v2)) {
+              continue;
+            }
+            if (const std::optional<float> dist = sculpt_geodesic_mesh_test_dist_add(
+                    vert_positions, v_other, v1, v2, dists, initial_verts))
+            {
+              update_vert(
+                  updated_verts, v_other, *dist, VERT_UPDATE_DIST | VERT_UPDATE_PROPAGATE);
             }
           }
         }
       }
-    }
+    });
 
-    for (LinkNode *lnk = queue_next; lnk; lnk = lnk->next) {
-      const int e = POINTER_AS_INT(lnk->link);
-      edge_tag[e].reset();
+    Vector<int> updated_verts;
+    for (Vector<int> &verts : all_updated_verts) {
+      updated_verts.extend(verts);
+      verts.clear();
     }
 
-    BLI_LINKSTACK_SWAP(queue, queue_next);
+    threading::parallel_for(updated_verts.index_range(), 1024, [&](const IndexRange range) {
+      for (const int v : updated_verts.as_span().slice(range)) {
+        dists[v] = new_dists[v].load(std::memory_order_relaxed);
+      }
+    });
+
+    /* Add the edges of the vertices the distance was propagated to to the next wave. */
+    threading::parallel_for(updated_verts.index_range(), 256, [&](const IndexRange range) {
+      Vector<int> &next_edges = all_next_edges.local();
+      for (const int v_other : updated_verts.as_span().slice(range)) {
+        if (!(vert_updates[v_other].load(std::memory_order_relaxed) & VERT_UPDATE_PROPAGATE)) {
+          continue;
+        }
+        for (const int e_other : vert_to_edge_map[v_other]) {
+          const int ev_other = bke::mesh::edge_other_vert(edges[e_other], v_other);
+          if (!edge_to_face_map[e_other].is_empty() && dists[ev_other] == FLT_MAX) {
+            continue;
+          }
+          if (!affected_vert[v_other] && !affected_vert[ev_other]) {
+            continue;
+          }
+          if (!edge_tag[e_other].exchange(true, std::memory_order_relaxed)) {
+            next_edges.append(e_other);
+          }
+        }
+      }
+    });
+
+    threading::parallel_for(updated_verts.index_range(), 4096, [&](const IndexRange range) {
+      for (const int v : updated_verts.as_span().slice(range)) {
+        vert_updates[v].store(VERT_UPDATE_NONE, std::memory_order_relaxed);
+      }
+    });
 
-  } while (BLI_LINKSTACK_SIZE(queue));
+    queue.clear();
+    for (Vector<int> &next_edges : all_next_edges) {
+      queue.extend(next_edges);
+      next_edges.clear();
+    }
 
-  BLI_LINKSTACK_FREE(queue);
-  BLI_LINKSTACK_FREE(queue_next);
+    threading::parallel_for(queue.index_range(), 4096, [&](const IndexRange range) {
+      for (const int e : queue.as_span().slice(range)) {
+        edge_tag[e].store(false, std::memory_order_relaxed);
+      }
+    });
+  }
 
   return dists;
 }
@@ -759,7 +759,7 @@ static void mask_by_color_contiguous_mesh(const Depsgraph &depsgraph,
   flood_fill::FillDataMesh flood(mesh.verts_num);
   flood.add_initial(vert);
 
-  flood.execute(object, vert_to_face_map, [&](int /*from_v*/, int to_v) {
+  flood.execute_parallel(object, vert_to_face_map, [&](int /*from_v*/, int to_v) {
     const float4 current_color = float4(colors[to_v]);
 
     float new_vertex_mask = color_delta_get(
@@ -13,6 +13,7 @@
 #include "BLI_math_rotation.h"
 #include "BLI_math_vector.h"
 #include "BLI_math_vector.hh"
+#include "BLI_task.hh"
 
 #include "DNA_brush_types.h"
 #include "DNA_object_types.h"
@@ -681,36 +682,74 @@ static void calc_pose_origin_and_factor_mesh(const Depsgraph &depsgraph,
 
   const int symm = SCULPT_mesh_symmetry_xyz_get(object);
 
-  int tot_co = 0;
-  float3 pose_origin(0);
-  float3 fallback_floodfill_origin = initial_location;
-  flood.execute(object, vert_to_face_map, [&](int /*from_v*/, int to_v) {
+  enum class VertState : int8_t { Unvisited, Visited, Origin };
+  Array<VertState> vert_states(positions_eval.size(), VertState::Unvisited);
+  flood.execute_parallel(object, vert_to_face_map, [&](int /*from_v*/, int to_v) {
     r_pose_factor[to_v] = 1.0f;
 
     const float3 co = positions_eval[to_v];
-    if (math::distance_squared(initial_location, fallback_floodfill_origin) <
-        math::distance_squared(initial_location, co))
-    {
-      fallback_floodfill_origin = co;
-    }
-
     if (vert_inside_brush_radius(co, initial_location, radius, symm)) {
+      vert_states[to_v] = VertState::Visited;
       return true;
     }
 
-    if (SCULPT_check_vertex_pivot_symmetry(co, initial_location, symm)) {
-      pose_origin += co;
-      tot_co++;
-    }
-
+    const bool is_origin = SCULPT_check_vertex_pivot_symmetry(co, initial_location, symm);
+    vert_states[to_v] = is_origin ? VertState::Origin : VertState::Visited;
     return false;
   });
 
-  if (tot_co > 0) {
-    r_pose_origin = pose_origin / float(tot_co);
+  /* Accumulate the origin after the fill, so that it can be done in parallel. The vertices are
+   * split into chunks of a fixed size, which are then summed in order, so that the origin doesn't
+   * depend on threading. The furthest vertex with the lowest index is used as fallback. */
+  struct OriginData {
+    float3 pose_origin = float3(0);
+    int tot_co = 0;
+    float fallback_dist_sq = 0.0f;
+    int fallback_vert = -1;
+  };
+  constexpr int64_t chunk_size = 4096;
+  Array<OriginData> chunk_data((vert_states.size() + chunk_size - 1) / chunk_size);
+  threading::parallel_for(chunk_data.index_range(), 1, [&](const IndexRange chunks) {
+    for (const int64_t chunk : chunks) {
+      OriginData &data = chunk_data[chunk];
+      const IndexRange range =
+          vert_states.index_range().drop_front(chunk * chunk_size).take_front(chunk_size);
+      for (const int vert : range) {
+        if (vert_states[vert] == VertState::Unvisited) {
+          continue;
+        }
+        const float3 &co = positions_eval[vert];
+        const float dist_sq = math::distance_squared(initial_location, co);
+        if (dist_sq > data.fallback_dist_sq) {
+          data.fallback_dist_sq = dist_sq;
+          data.fallback_vert = vert;
+        }
+        if (vert_states[vert] == VertState::Origin) {
+          data.pose_origin += co;
+          data.tot_co++;
+        }
+      }
+    }
+  });
+
+  OriginData origin_data;
+  for (const OriginData &data : chunk_data) {
+    origin_data.pose_origin += data.pose_origin;
+    origin_data.tot_co += data.tot_co;
+    if (data.fallback_dist_sq > origin_data.fallback_dist_sq) {
+      origin_data.fallback_dist_sq = data.fallback_dist_sq;
+      origin_data.fallback_vert = data.fallback_vert;
+    }
+  }
+
+  if (origin_data.tot_co > 0) {
+    r_pose_origin = origin_data.pose_origin / float(origin_data.tot_co);
+  }
+  else if (origin_data.fallback_vert != -1) {
+    r_pose_origin = positions_eval[origin_data.fallback_vert];
   }
   else {
-    r_pose_origin = fallback_floodfill_origin;
+    r_pose_origin = initial_location;
   }
 }
 
@@ -1662,7 +1701,7 @@ static std::unique_ptr<IKChain> ik_chain_init_face_sets_fk_mesh(const Depsgraph
   flood_fill::FillDataMesh weight_floodfill(mesh.verts_num, ss.fake_neighbors.fake_neighbor_index);
   weight_floodfill.add_initial(find_symm_verts_mesh(depsgraph, object, active_vert, radius));
   MutableSpan<float> fk_weights = ik_chain->segments[0].weights;
-  weight_floodfill.execute(object, vert_to_face_map, [&](int /*from_v*/, int to_v) {
+  weight_floodfill.execute_parallel(object, vert_to_face_map, [&](int /*from_v*/, int to_v) {
     fk_weights[to_v] = 1.0f;
     return !face_set::vert_has_face_set(vert_to_face_map, face_sets, to_v, masked_face_set);
   });
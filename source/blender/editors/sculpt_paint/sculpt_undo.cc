@@ -24,15 +24,26 @@
  */
 #include "sculpt_undo.hh"
 
+#include <array>
+#include <atomic>
+#include <cstdio>
 #include <mutex>
 
+#include <zstd.h>
+
 #include "CLG_log.h"
 
 #include "BLI_array.hh"
 #include "BLI_bit_group_vector.hh"
+#include "BLI_fileops.h"
 #include "BLI_listbase.h"
 #include "BLI_map.hh"
+#include "BLI_path_utils.hh"
+#include "BLI_string.h"
 #include "BLI_string_utf8.h"
+#include "BLI_task.h"
+#include "BLI_task.hh"
+#include "BLI_time.h"
 #include "BLI_utildefines.h"
 #include "BLI_vector.hh"
 
@@ -40,7 +51,9 @@
 #include "DNA_object_types.h"
 #include "DNA_scene_types.h"
 #include "DNA_screen_types.h"
+#include "DNA_userdef_types.h"
 
+#include "BKE_appdir.hh"
 #include "BKE_attribute.hh"
 #include "BKE_attribute_legacy_convert.hh"
 #include "BKE_ccg.hh"
@@ -118,6 +131,23 @@ namespace blender::ed::sculpt_paint::undo {
 
 #define NO_ACTIVE_LAYER bke::AttrDomain::Auto
 
+/**
+ * Compressed storage of the arrays of a #Node whose size depends on the number of elements, see
+ * #foreach_packed_array. Those arrays are empty while the node is packed.
+ */
+struct PackedNodeData {
+  bool is_packed = false;
+  /** Number of elements of each packed array. */
+  std::array<int64_t, 8> sizes;
+  /** Size of all the packed arrays before compression. */
+  int64_t raw_size = 0;
+  int64_t compressed_size = 0;
+  /** The compressed arrays, empty while they are stored in the spill file of the step. */
+  Array<uint8_t, 0> data;
+  /** Position of the compressed arrays in the spill file of the step, or -1. */
+  int64_t file_offset = -1;
+};
+
 struct Node {
   Array<float3, 0> position;
   Array<float3, 0> orig_position;
@@ -150,6 +180,9 @@ struct Node {
   Array<int, 0> face_sets;
 
   Vector<int> face_indices;
+
+  /** Compressed arrays while the undo step is not being restored. */
+  PackedNodeData packed;
 };
 
 struct SculptAttrRef {
@@ -257,6 +290,22 @@ struct StepData {
 
   size_t undo_size;
 
+  /**
+   * Compresses the node data in the background once the step is finished, and writes it to the
+   * spill file when the sculpt undo memory limit is exceeded. Only one task runs at a time, and
+   * it must be finished before the nodes are accessed, see #unpack_step.
+   */
+  TaskPool *storage_task_pool = nullptr;
+  /** Whether the storage task finished, which makes the sizes below valid. */
+  std::atomic<bool> storage_is_done = false;
+  /** Size of the data of the step in memory, including the compressed node data. */
+  size_t memory_size = 0;
+  /** Size of the compressed node data in memory, which is what spilling frees. */
+  size_t packed_size = 0;
+  /** Size of the compressed node data in the spill file. */
+  size_t disk_size = 0;
+  std::string spill_filepath;
+
   /** Whether processing code needs to handle the current data as an undo step. */
   bool needs_undo() const
   {
@@ -1121,8 +1170,399 @@ static void restore_list(bContext *C, Depsgraph *depsgraph, StepData &step_data)
   }
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Compressed Storage
+ *
+ * Once an undo step is finished, the arrays of its nodes are compressed in a background task, and
+ * when the compressed steps exceed the sculpt undo memory limit preference, the oldest ones are
+ * written to a temporary file. Before a step is restored, its nodes are read back and
+ * decompressed, and they are compressed again afterwards, since restoring swaps the stored values
+ * with the current ones.
+ * \{ */
+
+/* A fast compression level, since steps are compressed after every stroke. */
+static constexpr int compression_level = 1;
+
+static size_t node_size_in_bytes(const Node &node)
+{
+  size_t size = sizeof(Node);
+  size += node.position.as_span().size_in_bytes();
+  size += node.orig_position.as_span().size_in_bytes();
+  size += node.normal.as_span().size_in_bytes();
+  size += node.col.as_span().size_in_bytes();
+  size += node.mask.as_span().size_in_bytes();
+  size += node.loop_col.as_span().size_in_bytes();
+  size += node.vert_indices.as_span().size_in_bytes();
+  size += node.corner_indices.as_span().size_in_bytes();
+  size += node.vert_hidden.size() / 8;
+  size += node.face_hidden.size() / 8;
+  size += node.grids.as_span().size_in_bytes();
+  size += node.grid_hidden.all_bits().size() / 8;
+  size += node.face_sets.as_span().size_in_bytes();
+  size += node.face_indices.as_span().size_in_bytes();
+  size += node.packed.data.as_span().size_in_bytes();
+  return size;
+}
+
+/**
+ * Call the function for the arrays of the node that are packed, which are the ones whose size
+ * depends on the number of elements of the node. Their elements all consist of 32-bit words.
+ */
+template<typename Fn> static void foreach_packed_array(Node &node, const Fn &fn)
+{
+  fn(node.position);
+  fn(node.orig_position);
+  fn(node.col);
+  fn(node.mask);
+  fn(node.loop_col);
+  fn(node.vert_indices);
+  fn(node.grids);
+  fn(node.face_sets);
+}
+
+template<typename T> static Span<uint32_t> words_of(const Span<T> values)
+{
+  static_assert(sizeof(T) % sizeof(uint32_t) == 0);
+  return Span(reinterpret_cast<const uint32_t *>(values.data()),
+              values.size() * (sizeof(T) / sizeof(uint32_t)));
+}
+
+template<typename T> static MutableSpan<uint32_t> words_of(const MutableSpan<T> values)
+{
+  static_assert(sizeof(T) % sizeof(uint32_t) == 0);
+  return MutableSpan(reinterpret_cast<uint32_t *>(values.data()),
+                     values.size() * (sizeof(T) / sizeof(uint32_t)));
+}
+
+/**
+ * Neighboring elements of a node have similar values, since they are close in space or in index.
+ * XOR-ing each word with the same word of the previous element clears the sign, exponent and high
+ * mantissa bits of similar floats and the high bits of similar integers, and grouping the bytes
+ * by significance puts those zeros next to each other, which makes the data compress much better.
+ * Unlike a delta against the state of the mesh, this is lossless and doesn't depend on the mesh
+ * being in the exact same state when the step is restored.
+ */
+static void encode_words(const Span<uint32_t> words,
+                         const int64_t stride,
+                         const MutableSpan<uint8_t> r_bytes)
+{
+  const int64_t num = words.size();
+  for (const int64_t i : words.index_range()) {
+    const uint32_t word = i < stride ? words[i] : words[i] ^ words[i - stride];
+    for (const int byte : IndexRange(4)) {
+      r_bytes[byte * num + i] = uint8_t(word >> (byte * 8));
+    }
+  }
+}
+
+static void decode_words(const Span<uint8_t> bytes,
+                         const int64_t stride,
+                         const MutableSpan<uint32_t> r_words)
+{
+  const int64_t num = r_words.size();
+  for (const int64_t i : r_words.index_range()) {
+    uint32_t word = 0;
+    for (const int byte : IndexRange(4)) {
+      word |= uint32_t(bytes[byte * num + i]) << (byte * 8);
+    }
+    r_words[i] = i < stride ? word : word ^ r_words[i - stride];
+  }
+}
+
+static void pack_node(Node &node)
+{
+  PackedNodeData &packed = node.packed;
+  if (packed.is_packed) {
+    return;
+  }
+
+  int64_t raw_size = 0;
+  foreach_packed_array(node, [&](const auto &array) {
+    raw_size += array.as_span().size_in_bytes();
+  });
+  if (raw_size == 0) {
+    return;
+  }
+
+  Array<uint8_t> raw(raw_size);
+  int64_t offset = 0;
+  int array_index = 0;
+  foreach_packed_array(node, [&](const auto &array) {
+    using T = typename std::decay_t<decltype(array)>::value_type;
+    const int64_t size = array.as_span().size_in_bytes();
+    encode_words(words_of(array.as_span()),
+                 sizeof(T) / sizeof(uint32_t),
+                 raw.as_mutable_span().slice(offset, size));
+    packed.sizes[array_index++] = array.size();
+    offset += size;
+  });
+
+  Array<uint8_t> compressed(ZSTD_compressBound(raw_size));
+  const size_t compressed_size = ZSTD_compress(
+      compressed.data(), compressed.size(), raw.data(), raw_size, compression_level);
+  if (ZSTD_isError(compressed_size)) {
+    return;
+  }
+
+  packed.data = Array<uint8_t, 0>(compressed.as_span().take_front(compressed_size));
+  packed.raw_size = raw_size;
+  packed.compressed_size = compressed_size;
+  packed.is_packed = true;
+  foreach_packed_array(node, [&](auto &array) { array = {}; });
+}
+
+static void unpack_node(Node &node)
+{
+  PackedNodeData &packed = node.packed;
+  if (!packed.is_packed) {
+    return;
+  }
+
+  Array<uint8_t> raw(packed.raw_size);
+  const size_t raw_size = ZSTD_decompress(
+      raw.data(), raw.size(), packed.data.data(), packed.data.size());
+
+  /* The spill file was modified or truncated externally, which should never happen. Zero the data
+   * rather than reading uninitialized memory, since the arrays still need their sizes. */
+  if (ZSTD_isError(raw_size) || raw_size != size_t(packed.raw_size)) {
+    BLI_assert_unreachable();
+    raw.fill(0);
+  }
+
+  int64_t offset = 0;
+  int array_index = 0;
+  foreach_packed_array(node, [&](auto &array) {
+    using T = typename std::decay_t<decltype(array)>::value_type;
+    array.reinitialize(packed.sizes[array_index++]);
+    const int64_t size = array.as_span().size_in_bytes();
+    decode_words(raw.as_span().slice(offset, size),
+                 sizeof(T) / sizeof(uint32_t),
+                 words_of(array.as_mutable_span()));
+    offset += size;
+  });
+
+  packed = {};
+}
+
+static void pack_step_task(TaskPool *__restrict pool, void * /*taskdata*/)
+{
+  StepData &step_data = *static_cast<StepData *>(BLI_task_pool_user_data(pool));
+  const double start_time = BLI_time_now_seconds();
+
+  threading::parallel_for(step_data.nodes.index_range(), 1, [&](const IndexRange range) {
+    for (const int i : range) {
+      pack_node(*step_data.nodes[i]);
+    }
+  });
+
+  size_t memory_size = 0;
+  size_t packed_size = 0;
+  for (const std::unique_ptr<Node> &node : step_data.nodes) {
+    memory_size += node_size_in_bytes(*node);
+    packed_size += node->packed.data.as_span().size_in_bytes();
+  }
+
+  CLOG_DEBUG(&LOG,
+             "Compressed %d nodes from %.1f MiB to %.1f MiB in %.1f ms",
+             int(step_data.nodes.size()),
+             double(step_data.undo_size) / (1024.0 * 1024.0),
+             double(memory_size) / (1024.0 * 1024.0),
+             (BLI_time_now_seconds() - start_time) * 1000.0);
+
+  step_data.memory_size = memory_size;
+  step_data.packed_size = packed_size;
+  step_data.disk_size = 0;
+  step_data.storage_is_done.store(true, std::memory_order_release);
+}
+
+static void spill_step_task(TaskPool *__restrict pool, void * /*taskdata*/)
+{
+  StepData &step_data = *static_cast<StepData *>(BLI_task_pool_user_data(pool));
+
+  FILE *file = BLI_fopen(step_data.spill_filepath.c_str(), "wb");
+  bool is_written = file != nullptr;
+  int64_t offset = 0;
+  for (std::unique_ptr<Node> &node : step_data.nodes) {
+    PackedNodeData &packed = node->packed;
+    if (!is_written || !packed.is_packed) {
+      continue;
+    }
+    is_written = fwrite(packed.data.data(), 1, packed.data.size(), file) ==
+                 size_t(packed.data.size());
+    packed.file_offset = offset;
+    offset += packed.data.size();
+  }
+  if (file != nullptr) {
+    is_written &= fclose(file) == 0;
+  }
+
+  /* Keep the data in memory if writing failed, for instance, because the disk is full. */
+  if (is_written) {
+    for (std::unique_ptr<Node> &node : step_data.nodes) {
+      if (node->packed.is_packed) {
+        node->packed.data = {};
+      }
+    }
+    step_data.memory_size -= step_data.packed_size;
+    step_data.packed_size = 0;
+    step_data.disk_size = offset;
+  }
+  else {
+    for (std::unique_ptr<Node> &node : step_data.nodes) {
+      node->packed.file_offset = -1;
+    }
+    BLI_delete(step_data.spill_filepath.c_str(), false, false);
+    step_data.spill_filepath.clear();
+  }
+
+  step_data.storage_is_done.store(true, std::memory_order_release);
+}
+
+static void storage_task_push(StepData &step_data, TaskRunFunction run)
+{
+  if (step_data.storage_task_pool == nullptr) {
+    step_data.storage_task_pool = BLI_task_pool_create_background(&step_data,
+                                                                  TASK_PRIORITY_LOW);
+  }
+  step_data.storage_is_done.store(false, std::memory_order_relaxed);
+  BLI_task_pool_push(step_data.storage_task_pool, run, nullptr, false, nullptr);
+}
+
+/** Compress the nodes of a finished step in the background. */
+static void pack_step_in_background(StepData &step_data)
+{
+  if (step_data.nodes.is_empty()) {
+    return;
+  }
+  storage_task_push(step_data, pack_step_task);
+}
+
+/** Wait for the storage task of the step and read back and decompress its nodes. */
+static void unpack_step(StepData &step_data)
+{
+  if (step_data.storage_task_pool == nullptr) {
+    return;
+  }
+  BLI_task_pool_work_and_wait(step_data.storage_task_pool);
+
+  if (!step_data.spill_filepath.empty()) {
+    FILE *file = BLI_fopen(step_data.spill_filepath.c_str(), "rb");
+    for (std::unique_ptr<Node> &node : step_data.nodes) {
+      PackedNodeData &packed = node->packed;
+      if (packed.file_offset == -1) {
+        continue;
+      }
+      packed.data.reinitialize(packed.compressed_size);
+      const bool is_read = file != nullptr &&
+                           BLI_fseek(file, packed.file_offset, SEEK_SET) == 0 &&
+                           fread(packed.data.data(), 1, packed.data.size(), file) ==
+                               size_t(packed.data.size());
+      if (!is_read) {
+        /* Handled like corrupted data when decompressing. */
+        packed.data.fill(0);
+      }
+      packed.file_offset = -1;
+    }
+    if (file != nullptr) {
+      fclose(file);
+    }
+    BLI_delete(step_data.spill_filepath.c_str(), false, false);
+    step_data.spill_filepath.clear();
+  }
+
+  threading::parallel_for(step_data.nodes.index_range(), 1, [&](const IndexRange range) {
+    for (const int i : range) {
+      unpack_node(*step_data.nodes[i]);
+    }
+  });
+  step_data.storage_is_done.store(false, std::memory_order_relaxed);
+}
+
+/**
+ * Use the compressed size for the steps that finished compressing, such that the undo memory
+ * limit applies to the memory that is actually used, and write the oldest steps to disk while the
+ * sculpt steps exceed the sculpt undo memory limit.
+ */
+static void storage_update(UndoStack &ustack)
+{
+  size_t memory_size = 0;
+  LISTBASE_FOREACH (UndoStep *, us, &ustack.steps) {
+    if (us->type != BKE_UNDOSYS_TYPE_SCULPT) {
+      continue;
+    }
+    const StepData &step_data = reinterpret_cast<SculptUndoStep *>(us)->data;
+    if (step_data.storage_is_done.load(std::memory_order_acquire)) {
+      us->data_size = step_data.memory_size;
+    }
+    memory_size += us->data_size;
+  }
+
+  if (U.sculpt_undo_memory == 0) {
+    return;
+  }
+
+  /* Steps are ordered from the oldest to the newest. */
+  const size_t memory_limit = size_t(U.sculpt_undo_memory) * 1024 * 1024;
+  LISTBASE_FOREACH (UndoStep *, us, &ustack.steps) {
+    if (memory_size <= memory_limit) {
+      break;
+    }
+    if (us->type != BKE_UNDOSYS_TYPE_SCULPT) {
+      continue;
+    }
+    StepData &step_data = reinterpret_cast<SculptUndoStep *>(us)->data;
+    if (!step_data.storage_is_done.load(std::memory_order_acquire) ||
+        step_data.packed_size == 0)
+    {
+      continue;
+    }
+
+    char filename[64];
+    SNPRINTF(filename, "sculpt_undo_%p.bin", &step_data);
+    char filepath[FILE_MAX];
+    BLI_path_join(filepath, sizeof(filepath), BKE_tempdir_session(), filename);
+    step_data.spill_filepath = filepath;
+
+    memory_size -= step_data.packed_size;
+    storage_task_push(step_data, spill_step_task);
+  }
+}
+
+StorageUsage storage_usage_get()
+{
+  StorageUsage usage;
+  const UndoStack *ustack = ED_undo_stack_get();
+  if (ustack == nullptr) {
+    return usage;
+  }
+
+  LISTBASE_FOREACH (const UndoStep *, us, &ustack->steps) {
+    if (us->type != BKE_UNDOSYS_TYPE_SCULPT) {
+      continue;
+    }
+    const StepData &step_data = reinterpret_cast<const SculptUndoStep *>(us)->data;
+    if (step_data.storage_is_done.load(std::memory_order_acquire)) {
+      usage.memory += step_data.memory_size;
+      usage.disk += step_data.disk_size;
+    }
+    else {
+      usage.memory += step_data.undo_size;
+    }
+  }
+  return usage;
+}
+
+/** \} */
+
 static void free_step_data(StepData &step_data)
 {
+  if (step_data.storage_task_pool) {
+    BLI_task_pool_cancel(step_data.storage_task_pool);
+    BLI_task_pool_free(step_data.storage_task_pool);
+  }
+  if (!step_data.spill_filepath.empty()) {
+    BLI_delete(step_data.spill_filepath.c_str(), false, false);
+  }
   geometry_free_data(&step_data.geometry_original);
   geometry_free_data(&step_data.geometry_modified);
   geometry_free_data(&step_data.bmesh.geometry_enter);
@@ -1769,26 +2209,6 @@ void push_enter_sculpt_mode(const Scene & /*scene*/, Object &ob, const wmOperato
   save_common_data(ob, us);
 }
 
-static size_t node_size_in_bytes(const Node &node)
-{
-  size_t size = sizeof(Node);
-  size += node.position.as_span().size_in_bytes();
-  size += node.orig_position.as_span().size_in_bytes();
-  size += node.normal.as_span().size_in_bytes();
-  size += node.col.as_span().size_in_bytes();
-  size += node.mask.as_span().size_in_bytes();
-  size += node.loop_col.as_span().size_in_bytes();
-  size += node.vert_indices.as_span().size_in_bytes();
-  size += node.corner_indices.as_span().size_in_bytes();
-  size += node.vert_hidden.size() / 8;
-  size += node.face_hidden.size() / 8;
-  size += node.grids.as_span().size_in_bytes();
-  size += node.grid_hidden.all_bits().size() / 8;
-  size += node.face_sets.as_span().size_in_bytes();
-  size += node.face_indices.as_span().size_in_bytes();
-  return size;
-}
-
 void push_end_ex(Object &ob, const bool use_nested_undo)
 {
   StepData *step_data = get_step_data();
@@ -1827,6 +2247,7 @@ void push_end_ex(Object &ob, const bool use_nested_undo)
     UndoStack *ustack = ED_undo_stack_get();
     BKE_undosys_step_push(ustack, nullptr, nullptr);
     if (wm->op_undo_depth == 0) {
+      storage_update(*ustack);
       BKE_undosys_stack_limit_steps_and_memory_defaults(ustack);
     }
     WM_file_tag_modified();
@@ -1914,6 +2335,7 @@ static bool step_encode(bContext * /*C*/, Main *bmain, UndoStep *us_p)
    * to the current 'SculptUndoStep' added by encode_init. */
   SculptUndoStep *us = reinterpret_cast<SculptUndoStep *>(us_p);
   us->step.data_size = us->data.undo_size;
+  pack_step_in_background(us->data);
 
   if (us->data.type == Type::DyntopoEnd) {
     us->step.use_memfile_step = true;
@@ -1932,7 +2354,9 @@ static void step_decode_undo_impl(bContext *C, Depsgraph *depsgraph, SculptUndoS
 {
   BLI_assert(us->step.is_applied == true);
 
+  unpack_step(us->data);
   restore_list(C, depsgraph, us->data);
+  pack_step_in_background(us->data);
   us->step.is_applied = false;
 }
 
@@ -1940,7 +2364,9 @@ static void step_decode_redo_impl(bContext *C, Depsgraph *depsgraph, SculptUndoS
 {
   BLI_assert(us->step.is_applied == false);
 
+  unpack_step(us->data);
   restore_list(C, depsgraph, us->data);
+  pack_step_in_background(us->data);
   us->step.is_applied = true;
 }
 
@@ -55,6 +55,7 @@
 #include "DEG_depsgraph_query.hh"
 
 #include "ED_info.hh"
+#include "ED_sculpt.hh"
 
 #include "WM_api.hh"
 
@@ -826,6 +827,7 @@ void ED_info_draw_stats(
     STROKES,
     POINTS,
     LIGHTS,
+    UNDO,
     MAX_LABELS_COUNT
   };
   char labels[MAX_LABELS_COUNT][64];
@@ -842,6 +844,7 @@ void ED_info_draw_stats(
   STRNCPY_UTF8(labels[STROKES], IFACE_("Strokes"));
   STRNCPY_UTF8(labels[POINTS], IFACE_("Points"));
   STRNCPY_UTF8(labels[LIGHTS], IFACE_("Lights"));
+  STRNCPY_UTF8(labels[UNDO], IFACE_("Undo"));
 
   int longest_label = 0;
   for (int i = 0; i < MAX_LABELS_COUNT; ++i) {
@@ -908,6 +911,21 @@ void ED_info_draw_stats(
       stats_row(col1, labels[VERTS], col2, stats_fmt.totvertsculpt, nullptr, y, height);
       stats_row(col1, labels[FACES], col2, stats_fmt.totfacesculpt, nullptr, y, height);
     }
+
+    const blender::ed::sculpt_paint::undo::StorageUsage undo_usage =
+        blender::ed::sculpt_paint::undo::storage_usage_get();
+    char undo_memory[BLI_STR_FORMAT_INT64_BYTE_UNIT_SIZE];
+    BLI_str_format_byte_unit(undo_memory, undo_usage.memory, false);
+    if (undo_usage.disk > 0) {
+      char undo_disk[BLI_STR_FORMAT_INT64_BYTE_UNIT_SIZE];
+      BLI_str_format_byte_unit(undo_disk, undo_usage.disk, false);
+      char undo_info[64];
+      SNPRINTF_UTF8(undo_info, IFACE_("%s (%s on disk)"), undo_memory, undo_disk);
+      stats_row(col1, labels[UNDO], col2, undo_info, nullptr, y, height);
+    }
+    else {
+      stats_row(col1, labels[UNDO], col2, undo_memory, nullptr, y, height);
+    }
   }
   else if (ob && (object_mode & OB_MODE_SCULPT_CURVES)) {
     stats_row(col1, labels[VERTS], col2, stats_fmt.totvertsculpt, nullptr, y, height);
@@ -28,6 +28,8 @@
 #include "DNA_space_types.h"
 #include "DNA_view2d_types.h"
 
+#include "BLT_translation.hh"
+
 #include "BKE_context.hh"
 #include "BKE_global.hh"
 #include "BKE_scene.hh"
@@ -1489,6 +1491,46 @@ static void draw_registered_callbacks(const bContext *C, ARegion &region)
   GPU_framebuffer_bind_no_srgb(overlay_fb);
 }
 
+/* Draw the timing of the stages of rendering the last frame below the frame-rate, which helps
+ * finding out whether playback is limited by decoding, transforming or blending strips. */
+static void draw_render_statistics(const Scene *scene, const int xoffset, int *yoffset)
+{
+  const seq::RenderStatistics statistics = seq::render_statistics_get(scene, false);
+  if (statistics.frame_time == 0.0) {
+    return;
+  }
+
+  const int line_height = int(UI_style_get()->widget.points * UI_SCALE_FAC * 1.6f);
+  char printable[128];
+
+  *yoffset -= line_height;
+  SNPRINTF_UTF8(printable,
+                IFACE_("Render: %.1f ms (%d parallel strips)"),
+                statistics.frame_time * 1000.0,
+                statistics.parallel_strips_num);
+  BLF_draw_default(xoffset, *yoffset, 0.0f, printable, sizeof(printable));
+
+  *yoffset -= line_height;
+  SNPRINTF_UTF8(printable,
+                IFACE_("Decode: %.1f ms, Transform: %.1f ms, Blend: %.1f ms"),
+                statistics.source_time * 1000.0,
+                statistics.preprocess_time * 1000.0,
+                statistics.blend_time * 1000.0);
+  BLF_draw_default(xoffset, *yoffset, 0.0f, printable, sizeof(printable));
+
+  const seq::RenderStatistics prefetch_statistics = seq::render_statistics_get(scene, true);
+  if (prefetch_statistics.frame_time == 0.0) {
+    return;
+  }
+
+  *yoffset -= line_height;
+  SNPRINTF_UTF8(printable,
+                IFACE_("Prefetch: %.1f ms (%.1f fps)"),
+                prefetch_statistics.frame_time * 1000.0,
+                1.0 / prefetch_statistics.frame_time);
+  BLF_draw_default(xoffset, *yoffset, 0.0f, printable, sizeof(printable));
+}
+
 /* Part of the sequencer preview region drawing which renders information overlays to the
  * viewport's overlay frame-buffer. */
 static void sequencer_preview_draw_overlays(const bContext *C,
@@ -1615,6 +1657,7 @@ static void sequencer_preview_draw_overlays(const bContext *C,
     BLF_shadow(font_id, FontShadowType::Outline, shadow_color);
 
     ED_scene_draw_fps(scene, xoffset, &yoffset);
+    draw_render_statistics(scene, xoffset, &yoffset);
 
     BLF_disable(font_id, BLF_SHADOW);
   }
@@ -111,23 +111,23 @@ static wmOperatorStatus sequencer_rebuild_proxy_exec(bContext *C, wmOperator * /
   }
 
   blender::Set<std::string> processed_paths;
+  ListBase queue = {nullptr, nullptr};
 
   LISTBASE_FOREACH (Strip *, strip, seq::active_seqbase_get(ed)) {
     if (strip->flag & SELECT) {
-      ListBase queue = {nullptr, nullptr};
-
       seq::proxy_rebuild_context(bmain, depsgraph, scene, strip, &processed_paths, &queue, false);
-
-      wmJobWorkerStatus worker_status = {};
-      LISTBASE_FOREACH (LinkData *, link, &queue) {
-        seq::IndexBuildContext *context = static_cast<seq::IndexBuildContext *>(link->data);
-        seq::proxy_rebuild(context, &worker_status);
-        seq::proxy_rebuild_finish(context, false);
-      }
-      seq::relations_free_imbuf(scene, &ed->seqbase, false);
     }
   }
 
+  /* Build the proxies of all selected strips at once, so movies are processed concurrently. */
+  wmJobWorkerStatus worker_status = {};
+  seq::proxy_rebuild_queue(&queue, &worker_status);
+  LISTBASE_FOREACH (LinkData *, link, &queue) {
+    seq::proxy_rebuild_finish(static_cast<seq::IndexBuildContext *>(link->data), false);
+  }
+  BLI_freelistN(&queue);
+  seq::relations_free_imbuf(scene, &ed->seqbase, false);
+
   return OPERATOR_FINISHED;
 }
 
@@ -54,6 +54,15 @@ ImBuf *IMB_load_image_from_filepath(const char *filepath,
                                     const int flags,
                                     char r_colorspace[IM_MAX_SPACE] = nullptr);
 
+/**
+ * Load a single layer OpenEXR file that is already open for reading, see #IMB_exr_begin_read.
+ * Returns null for multi-layer and multi-view files, which are read through the handle.
+ */
+ImBuf *IMB_load_image_from_exr_handle(void *exrhandle,
+                                      const char *filepath,
+                                      const int flags,
+                                      char r_colorspace[IM_MAX_SPACE] = nullptr);
+
 /**
  * Save image.
  */
@@ -18,6 +18,7 @@
 /** Number of supported channels per pass (easy to change). */
 #define EXR_PASS_MAXCHAN 24
 
+struct ImBuf;
 struct StampData;
 
 void *IMB_exr_get_handle();
@@ -66,9 +67,35 @@ bool IMB_exr_set_channel(void *handle,
                          int ystride,
                          float *rect);
 
+/**
+ * Read the channels of the file. For handles with parsed channels, this reads all passes that
+ * were not read with #IMB_exr_read_pass yet.
+ */
 void IMB_exr_read_channels(void *handle);
+/**
+ * Read a single pass of a handle with parsed channels on first access. Only the memory for this
+ * pass is allocated and only the parts of the file that contain its channels are decoded, which
+ * is much faster than reading all channels when few of many passes are needed.
+ *
+ * \param passname: The name of the pass, followed by `.` and the view for multi-view files.
+ * \return The pixels of the pass, which the caller takes ownership of, or null if the pass
+ * doesn't exist or was already read.
+ */
+float *IMB_exr_read_pass(void *handle, const char *layname, const char *passname, int *r_totchan);
+/**
+ * Check whether the file of a handle opened with #IMB_exr_begin_read was modified or removed
+ * since it was opened, in which case passes that were not read yet can't be read from it.
+ */
+bool IMB_exr_file_changed(void *handle);
 void IMB_exr_write_channels(void *handle);
 
+/**
+ * Pass the views, layers and passes of a handle with parsed channels on to the callbacks, along
+ * with the ownership of the pixels of the passes.
+ *
+ * \param read_passes: Read the passes that were not read yet. Otherwise the pixels of those
+ * passes are null, and can be read later with #IMB_exr_read_pass while the handle is open.
+ */
 void IMB_exr_multilayer_convert(void *handle,
                                 void *base,
                                 void *(*addview)(void *base, const char *str),
@@ -79,7 +106,8 @@ void IMB_exr_multilayer_convert(void *handle,
                                                 float *rect,
                                                 int totchan,
                                                 const char *chan_id,
-                                                const char *view));
+                                                const char *view),
+                                bool read_passes = true);
 
 void IMB_exr_close(void *handle);
 
@@ -88,3 +116,6 @@ void IMB_exr_add_view(void *handle, const char *name);
 bool IMB_exr_has_multilayer(void *handle);
 
 bool IMB_exr_get_ppm(void *handle, double ppm[2]);
+
+/** Add the string attributes of the header of a file opened for reading to the metadata. */
+void IMB_exr_read_metadata(void *handle, ImBuf *ibuf);
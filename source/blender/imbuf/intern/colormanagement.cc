@@ -9,8 +9,10 @@
 #include "IMB_colormanagement.hh"
 #include "IMB_colormanagement_intern.hh"
 
+#include <algorithm>
 #include <cmath>
 #include <cstring>
+#include <string>
 
 #include "DNA_color_types.h"
 #include "DNA_image_types.h"
@@ -34,11 +36,14 @@
 #include "BLI_math_matrix.hh"
 #include "BLI_math_matrix_types.hh"
 #include "BLI_math_vector_types.hh"
+#include "BLI_mutex.hh"
 #include "BLI_path_utils.hh"
 #include "BLI_rect.h"
+#include "BLI_string.h"
 #include "BLI_string_utf8.h"
 #include "BLI_task.hh"
 #include "BLI_threads.h"
+#include "BLI_vector.hh"
 #include "BLI_vector_set.hh"
 
 #include "BKE_appdir.hh"
@@ -137,6 +142,13 @@ static struct GlobalColorPickingState {
   bool failed = false;
 } global_color_picking_state;
 
+static struct GlobalBakedProcessorState {
+  /* Display processors baked into 3D lookup tables, most recently used first, along with the
+   * settings they were created for. */
+  blender::Mutex mutex;
+  blender::Vector<std::pair<std::string, std::shared_ptr<const ocio::CPUProcessor>>> processors;
+} global_baked_processor_state;
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -630,6 +642,7 @@ void colormanagement_exit()
 {
   global_gpu_state = GlobalGPUState();
   global_color_picking_state = GlobalColorPickingState();
+  global_baked_processor_state.processors.clear_and_shrink();
 
   colormanage_free_config();
 }
@@ -1641,15 +1654,85 @@ ColormanageProcessor *IMB_colormanagement_display_processor_for_imbuf(
   return IMB_colormanagement_display_processor_new(view_settings, display_settings);
 }
 
+/* Number of most recently used baked display processors that are kept in memory. */
+#define BAKED_PROCESSOR_CACHE_SIZE 4
+
+/* Float images with fewer pixels than this are displayed with the exact processor, since baking
+ * the table of a processor costs about as much as applying it on a quarter of such image. */
+#define BAKED_PROCESSOR_MIN_PIXELS (1024 * 1024)
+
+/**
+ * Replace the OCIO processor of the given display processor with one baked into a 3D lookup
+ * table, which is much faster to apply for complex view transforms like Filmic and AgX. The
+ * result differs by less than one 8-bit level, so it is only used for display buffers when
+ * enabled in the view settings, and never for images that are saved. Baked processors are
+ * cached, since the processors of views are created again for every update of a display buffer.
+ */
+static void display_processor_use_baked(ColormanageProcessor *cm_processor,
+                                        const ColorManagedViewSettings *view_settings,
+                                        const ColorManagedDisplaySettings *display_settings)
+{
+  if (!cm_processor->cpu_processor || cm_processor->cpu_processor->is_noop()) {
+    return;
+  }
+
+  char key[4 * MAX_COLORSPACE_NAME + 128];
+  SNPRINTF(key,
+           "%s|%s|%s|%s|%.9g|%.9g|%.9g|%.9g|%d",
+           view_settings->look,
+           view_settings->view_transform,
+           display_settings->display_device,
+           global_role_scene_linear,
+           view_settings->exposure,
+           view_settings->gamma,
+           view_settings->temperature,
+           view_settings->tint,
+           (view_settings->flag & COLORMANAGE_VIEW_USE_WHITE_BALANCE) != 0);
+
+  GlobalBakedProcessorState &state = global_baked_processor_state;
+  std::lock_guard lock(state.mutex);
+
+  for (const int i : state.processors.index_range()) {
+    if (state.processors[i].first == key) {
+      cm_processor->cpu_processor = state.processors[i].second;
+      /* Keep the most recently used processors first. */
+      std::rotate(state.processors.begin(),
+                  state.processors.begin() + i,
+                  state.processors.begin() + i + 1);
+      return;
+    }
+  }
+
+  /* Baking is multi-threaded, so isolate it to avoid running other tasks that would lock the
+   * mutex on this thread. */
+  std::shared_ptr<const ocio::CPUProcessor> baked_processor;
+  blender::threading::isolate_task(
+      [&]() { baked_processor = ocio::create_baked_cpu_processor(cm_processor->cpu_processor); });
+
+  state.processors.insert(0, std::make_pair(std::string(key), baked_processor));
+  if (state.processors.size() > BAKED_PROCESSOR_CACHE_SIZE) {
+    state.processors.remove_last();
+  }
+  cm_processor->cpu_processor = std::move(baked_processor);
+}
+
 static void colormanage_display_buffer_process_ex(
     ImBuf *ibuf,
     float *display_buffer,
     uchar *display_buffer_byte,
     const ColorManagedViewSettings *view_settings,
-    const ColorManagedDisplaySettings *display_settings)
+    const ColorManagedDisplaySettings *display_settings,
+    const bool use_baked_processor)
 {
   ColormanageProcessor *cm_processor = IMB_colormanagement_display_processor_for_imbuf(
       ibuf, view_settings, display_settings);
+
+  if (cm_processor && use_baked_processor &&
+      (view_settings->flag & COLORMANAGE_VIEW_USE_BAKED_DISPLAY) && ibuf->float_buffer.data &&
+      size_t(ibuf->x) * size_t(ibuf->y) >= BAKED_PROCESSOR_MIN_PIXELS)
+  {
+    display_processor_use_baked(cm_processor, view_settings, display_settings);
+  }
   display_buffer_apply_threaded(ibuf,
                                 ibuf->float_buffer.data,
                                 ibuf->byte_buffer.data,
@@ -1668,7 +1751,7 @@ static void colormanage_display_buffer_process(ImBuf *ibuf,
                                                const ColorManagedDisplaySettings *display_settings)
 {
   colormanage_display_buffer_process_ex(
-      ibuf, nullptr, display_buffer, view_settings, display_settings);
+      ibuf, nullptr, display_buffer, view_settings, display_settings, true);
 }
 
 /** \} */
@@ -2267,8 +2350,12 @@ static void colormanagement_imbuf_make_display_space(
     IMB_alloc_byte_pixels(ibuf);
   }
 
-  colormanage_display_buffer_process_ex(
-      ibuf, ibuf->float_buffer.data, ibuf->byte_buffer.data, view_settings, display_settings);
+  colormanage_display_buffer_process_ex(ibuf,
+                                        ibuf->float_buffer.data,
+                                        ibuf->byte_buffer.data,
+                                        view_settings,
+                                        display_settings,
+                                        false);
 }
 
 void IMB_colormanagement_imbuf_make_display_space(
@@ -7,7 +7,10 @@
  * \ingroup imbuf
  */
 
+#include <cstring>
+
 #include "BLI_rect.h"
+#include "BLI_simd.hh"
 #include "BLI_task.hh"
 
 #include "IMB_filter.hh"
@@ -62,6 +65,98 @@ MINLINE void float_to_byte_dither_v4(uchar b[4], const float f[4], float dither,
   b[3] = unit_float_to_uchar_clamp(f[3]);
 }
 
+#if BLI_HAVE_SSE2
+
+/* Vectorized versions of the conversions above, for the loops of #IMB_buffer_byte_from_float
+ * without color space conversion, which is the final step of every display transform. They give
+ * the exact same result as the scalar functions. */
+
+/** Same as #unit_float_to_uchar_clamp, for all four channels of a pixel. */
+MALWAYS_INLINE void float_to_byte_v4_simd(uchar b[4], const __m128 f)
+{
+  const __m128 clamped = _mm_min_ps(_mm_max_ps(f, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+  const __m128i i = _mm_cvttps_epi32(
+      _mm_add_ps(_mm_mul_ps(clamped, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f)));
+  const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(i, i), _mm_setzero_si128());
+  const int32_t value = _mm_cvtsi128_si32(packed);
+  memcpy(b, &value, sizeof(value));
+}
+
+/** Same as #premul_to_straight_v4_v4. */
+MALWAYS_INLINE __m128 premul_to_straight_v4_simd(const __m128 premul)
+{
+  const __m128 alpha = _mm_shuffle_ps(premul, premul, _MM_SHUFFLE(3, 3, 3, 3));
+  const __m128 straight = _mm_mul_ps(premul, _mm_div_ps(_mm_set1_ps(1.0f), alpha));
+  /* Keep the alpha channel, and the whole pixel if alpha is zero or one. */
+  const __m128 keep = _mm_or_ps(
+      _mm_or_ps(_mm_cmpeq_ps(alpha, _mm_setzero_ps()), _mm_cmpeq_ps(alpha, _mm_set1_ps(1.0f))),
+      _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0)));
+  return _mm_or_ps(_mm_and_ps(keep, premul), _mm_andnot_ps(keep, straight));
+}
+
+/** Same as #dither_random_value, for the four pixels starting at the given one. */
+MALWAYS_INLINE void dither_random_values_simd(float r_values[4], const int x, const int y)
+{
+#  if BLI_HAVE_SSE4
+  const __m128i xs = _mm_add_epi32(_mm_set1_epi32(x), _mm_set_epi32(3, 2, 1, 0));
+  const __m128i ys = _mm_set1_epi32(y);
+  const __m128i mul = _mm_set1_epi32(1103515245);
+  const __m128i qx = _mm_mullo_epi32(mul, _mm_xor_si128(_mm_srli_epi32(xs, 1), ys));
+  const __m128i qy = _mm_mullo_epi32(mul, _mm_xor_si128(_mm_srli_epi32(ys, 1), xs));
+  const __m128i n = _mm_mullo_epi32(mul, _mm_xor_si128(qx, _mm_srli_epi32(qy, 3)));
+
+  /* Convert the unsigned hash to float in two exact halves, such that the sum is rounded once,
+   * like the scalar conversion. */
+  const __m128 n_high = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(n, 16)), _mm_set1_ps(65536.0f));
+  const __m128 n_low = _mm_cvtepi32_ps(_mm_and_si128(n, _mm_set1_epi32(0xffff)));
+  __m128 v = _mm_mul_ps(_mm_add_ps(n_high, n_low), _mm_set1_ps(1.0f / float(0xffffffffu)));
+
+  /* Convert uniform distribution into triangle-shaped distribution. */
+  v = _mm_sub_ps(_mm_mul_ps(v, _mm_set1_ps(2.0f)), _mm_set1_ps(1.0f));
+  const __m128 sign_mask = _mm_set1_ps(-0.0f);
+  const __m128 magnitude = _mm_sub_ps(
+      _mm_set1_ps(1.0f), _mm_sqrt_ps(_mm_sub_ps(_mm_set1_ps(1.0f), _mm_andnot_ps(sign_mask, v))));
+  _mm_storeu_ps(r_values, _mm_or_ps(magnitude, _mm_and_ps(v, sign_mask)));
+#  else
+  for (int i = 0; i < 4; i++) {
+    r_values[i] = dither_random_value(x + i, y);
+  }
+#  endif
+}
+
+static void rgba_float_to_byte_row_simd(uchar *to,
+                                        const float *from,
+                                        const int width,
+                                        const float dither,
+                                        const bool predivide,
+                                        const int y)
+{
+  float dither_values[4];
+  for (int x = 0; x < width; x++, from += 4, to += 4) {
+    __m128 pixel = _mm_loadu_ps(from);
+    if (predivide) {
+      pixel = premul_to_straight_v4_simd(pixel);
+    }
+    if (dither) {
+      if ((x & 3) == 0) {
+        dither_random_values_simd(dither_values, x, y);
+      }
+      const float dither_value = dither_values[x & 3] * 0.0033f * dither;
+      pixel = _mm_add_ps(pixel, _mm_set_ps(0.0f, dither_value, dither_value, dither_value));
+    }
+    float_to_byte_v4_simd(to, pixel);
+  }
+}
+
+static void rgb_float_to_byte_row_simd(uchar *to, const float *from, const int width)
+{
+  for (int x = 0; x < width; x++, from += 3, to += 4) {
+    float_to_byte_v4_simd(to, _mm_set_ps(1.0f, from[2], from[1], from[0]));
+  }
+}
+
+#endif /* BLI_HAVE_SSE2 */
+
 bool IMB_alpha_affects_rgb(const ImBuf *ibuf)
 {
   return ibuf && (ibuf->flags & IB_alphamode_channel_packed) == 0;
@@ -104,10 +199,14 @@ void IMB_buffer_byte_from_float(uchar *rect_to,
 
       if (profile_to == profile_from) {
         /* no color space conversion */
+#if BLI_HAVE_SSE2
+        rgb_float_to_byte_row_simd(to, from, width);
+#else
         for (x = 0; x < width; x++, from += 3, to += 4) {
           rgb_float_to_uchar(to, from);
           to[3] = 255;
         }
+#endif
       }
       else if (profile_to == IB_PROFILE_SRGB) {
         /* convert from linear to sRGB */
@@ -133,6 +232,9 @@ void IMB_buffer_byte_from_float(uchar *rect_to,
 
       if (profile_to == profile_from) {
         /* no color space conversion */
+#if BLI_HAVE_SSE2
+        rgba_float_to_byte_row_simd(to, from, width, dither, predivide, y + start_y);
+#else
         if (dither && predivide) {
           float straight[4];
           for (x = 0; x < width; x++, from += 4, to += 4) {
@@ -155,6 +257,7 @@ void IMB_buffer_byte_from_float(uchar *rect_to,
             rgba_float_to_uchar(to, from);
           }
         }
+#endif
       }
       else if (profile_to == IB_PROFILE_SRGB) {
         /* convert from linear to sRGB */
@@ -78,6 +78,8 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "CLG_log.h"
+
 #include "BLI_fileops.h"
 #include "BLI_listbase.h"
 #include "BLI_math_base.hh"
@@ -86,7 +88,10 @@
 #include "BLI_path_utils.hh"
 #include "BLI_string.h"
 #include "BLI_string_utf8.h"
+#include "BLI_task.hh"
 #include "BLI_threads.h"
+#include "BLI_time.h"
+#include "BLI_vector.hh"
 
 #include "BKE_idprop.hh"
 #include "BKE_image.hh"
@@ -101,6 +106,8 @@
 using namespace Imf;
 using namespace Imath;
 
+static CLG_LogRef LOG = {"image.openexr"};
+
 /* prototype */
 static struct ExrPass *imb_exr_get_pass(ListBase *lb, const char *passname);
 static bool exr_has_multiview(MultiPartInputFile &file);
@@ -747,6 +754,11 @@ struct ExrHandle {
 
   IStream *ifile_stream;
   MultiPartInputFile *ifile;
+  /** Path, size and modification time of the file opened for reading, to detect it being
+   * overwritten while passes are read from it on first access. */
+  char ifile_path[FILE_MAX];
+  int64_t ifile_size;
+  int64_t ifile_mtime;
 
   OFileStream *ofile_stream;
   MultiPartOutputFile *mpofile;
@@ -794,6 +806,8 @@ struct ExrPass {
   char internal_name[EXR_PASS_MAXNAME]; /* name with no view */
   char view[EXR_VIEW_MAXNAME];
   int view_id;
+  /** Pixels are only read when the pass is first accessed, see #imb_exr_read_passes. */
+  bool is_loaded;
 };
 
 struct ExrLayer {
@@ -803,6 +817,7 @@ struct ExrLayer {
 };
 
 static bool imb_exr_multilayer_parse_channels_from_file(ExrHandle *data);
+static void imb_exr_pass_alloc_buffer(ExrHandle *data, ExrPass *pass);
 
 /* ********************** */
 
@@ -1057,6 +1072,13 @@ bool IMB_exr_begin_read(
     return false;
   }
 
+  BLI_stat_t st;
+  if (BLI_stat(filepath, &st) == 0) {
+    STRNCPY(data->ifile_path, filepath);
+    data->ifile_size = st.st_size;
+    data->ifile_mtime = st.st_mtime;
+  }
+
   Box2i dw = data->ifile->header(0).dataWindow();
   data->width = *width = dw.max.x - dw.min.x + 1;
   data->height = *height = dw.max.y - dw.min.y + 1;
@@ -1178,17 +1200,82 @@ void IMB_exr_write_channels(void *handle)
   }
 }
 
-void IMB_exr_read_channels(void *handle)
+/* Read one part of the file into the buffers of those channels that are in the part. */
+static void imb_exr_read_part(ExrHandle *data,
+                              const int part,
+                              const blender::Span<ExrChannel *> channels,
+                              const bool flip)
 {
-  ExrHandle *data = (ExrHandle *)handle;
-  int numparts = data->ifile->parts();
+  try {
+    /* Read part header. */
+    InputPart in(*data->ifile, part);
+    const Box2i dw = in.header().dataWindow();
+
+    /* Insert all matching channel into frame-buffer. */
+    FrameBuffer frameBuffer;
+
+    for (ExrChannel *echan : channels) {
+      if (echan->m->part_number != part) {
+        continue;
+      }
+
+      exr_printf("%d %-6s %-22s \"%s\"\n",
+                 echan->m->part_number,
+                 echan->m->view.c_str(),
+                 echan->m->name.c_str(),
+                 echan->m->internal_name.c_str());
+
+      float *rect = echan->rect;
+      size_t xstride = echan->xstride * sizeof(float);
+      size_t ystride = echan->ystride * sizeof(float);
+
+      if (!flip) {
+        /* Inverse correct first pixel for data-window coordinates. */
+        rect -= echan->xstride * (dw.min.x - dw.min.y * data->width);
+        /* Move to last scan-line to flip to Blender convention. */
+        rect += echan->xstride * (data->height - 1) * data->width;
+        ystride = -ystride;
+      }
+      else {
+        /* Inverse correct first pixel for data-window coordinates. */
+        rect -= echan->xstride * (dw.min.x + dw.min.y * data->width);
+      }
+
+      frameBuffer.insert(echan->m->internal_name,
+                         Slice(Imf::FLOAT, (char *)rect, xstride, ystride));
+    }
+
+    /* Read pixels. */
+    in.setFrameBuffer(frameBuffer);
+    exr_printf("readPixels:readPixels[%d]: min.y: %d, max.y: %d\n", part, dw.min.y, dw.max.y);
+    in.readPixels(dw.min.y, dw.max.y);
+  }
+  catch (const std::exception &exc) {
+    std::cerr << "OpenEXR-readPixels: ERROR: " << exc.what() << std::endl;
+  }
+  catch (...) { /* Catch-all for edge cases or compiler bugs. */
+    std::cerr << "OpenEXR-readPixels: UNKNOWN ERROR: " << std::endl;
+  }
+}
+
+/**
+ * Read the given channels, which must have a buffer assigned. Only the parts that contain any of
+ * the channels are decoded. Parts are decoded in parallel, while the chunks of each part are
+ * decoded by the thread pool of OpenEXR.
+ */
+static void imb_exr_read_channels_from_parts(ExrHandle *data,
+                                             const blender::Span<ExrChannel *> channels)
+{
+  if (channels.is_empty()) {
+    return;
+  }
 
   /* Check if EXR was saved with previous versions of blender which flipped images. */
   const StringAttribute *ta = data->ifile->header(0).findTypedAttribute<StringAttribute>(
       "BlenderMultiChannel");
 
   /* 'previous multilayer attribute, flipped. */
-  short flip = (ta && STRPREFIX(ta->value().c_str(), "Blender V2.43"));
+  const bool flip = (ta && STRPREFIX(ta->value().c_str(), "Blender V2.43"));
 
   exr_printf(
       "\nIMB_exr_read_channels\n%s %-6s %-22s "
@@ -1198,63 +1285,116 @@ void IMB_exr_read_channels(void *handle)
       "name",
       "internal_name");
 
-  for (int i = 0; i < numparts; i++) {
-    /* Read part header. */
-    InputPart in(*data->ifile, i);
-    Header header = in.header();
-    Box2i dw = header.dataWindow();
+  blender::Vector<int> parts;
+  for (const ExrChannel *echan : channels) {
+    parts.append_non_duplicates(echan->m->part_number);
+  }
 
-    /* Insert all matching channel into frame-buffer. */
-    FrameBuffer frameBuffer;
+  const double start_time = BLI_time_now_seconds();
 
-    LISTBASE_FOREACH (ExrChannel *, echan, &data->channels) {
-      if (echan->m->part_number != i) {
-        continue;
-      }
-
-      exr_printf("%d %-6s %-22s \"%s\"\n",
-                 echan->m->part_number,
-                 echan->m->view.c_str(),
-                 echan->m->name.c_str(),
-                 echan->m->internal_name.c_str());
+  blender::threading::parallel_for(parts.index_range(), 1, [&](const blender::IndexRange range) {
+    for (const int part : parts.as_span().slice(range)) {
+      imb_exr_read_part(data, part, channels, flip);
+    }
+  });
 
-      if (echan->rect) {
-        float *rect = echan->rect;
-        size_t xstride = echan->xstride * sizeof(float);
-        size_t ystride = echan->ystride * sizeof(float);
-
-        if (!flip) {
-          /* Inverse correct first pixel for data-window coordinates. */
-          rect -= echan->xstride * (dw.min.x - dw.min.y * data->width);
-          /* Move to last scan-line to flip to Blender convention. */
-          rect += echan->xstride * (data->height - 1) * data->width;
-          ystride = -ystride;
-        }
-        else {
-          /* Inverse correct first pixel for data-window coordinates. */
-          rect -= echan->xstride * (dw.min.x + dw.min.y * data->width);
-        }
+  CLOG_DEBUG(&LOG,
+             "Read %d of %d channels (%.1f MiB) from %d of %d parts in %.2f ms",
+             int(channels.size()),
+             BLI_listbase_count(&data->channels),
+             double(channels.size()) * data->width * data->height * sizeof(float) /
+                 (1024.0 * 1024.0),
+             int(parts.size()),
+             data->ifile->parts(),
+             (BLI_time_now_seconds() - start_time) * 1000.0);
+}
 
-        frameBuffer.insert(echan->m->internal_name,
-                           Slice(Imf::FLOAT, (char *)rect, xstride, ystride));
-      }
+/* Allocate the buffers of the passes that were not loaded yet and read their channels. */
+static void imb_exr_read_passes(ExrHandle *data, const blender::Span<ExrPass *> passes)
+{
+  blender::Vector<ExrChannel *> channels;
+  for (ExrPass *pass : passes) {
+    if (pass->is_loaded) {
+      continue;
     }
-
-    /* Read pixels. */
-    try {
-      in.setFrameBuffer(frameBuffer);
-      exr_printf("readPixels:readPixels[%d]: min.y: %d, max.y: %d\n", i, dw.min.y, dw.max.y);
-      in.readPixels(dw.min.y, dw.max.y);
+    pass->is_loaded = true;
+    if (pass->totchan) {
+      imb_exr_pass_alloc_buffer(data, pass);
+      channels.extend(blender::Span<ExrChannel *>(pass->chan, pass->totchan));
     }
-    catch (const std::exception &exc) {
-      std::cerr << "OpenEXR-readPixels: ERROR: " << exc.what() << std::endl;
-      break;
+  }
+
+  imb_exr_read_channels_from_parts(data, channels);
+}
+
+static blender::Vector<ExrPass *> imb_exr_get_all_passes(ExrHandle *data)
+{
+  blender::Vector<ExrPass *> passes;
+  LISTBASE_FOREACH (ExrLayer *, lay, &data->layers) {
+    LISTBASE_FOREACH (ExrPass *, pass, &lay->passes) {
+      passes.append(pass);
     }
-    catch (...) { /* Catch-all for edge cases or compiler bugs. */
-      std::cerr << "OpenEXR-readPixels: UNKNOWN ERROR: " << std::endl;
-      break;
+  }
+  return passes;
+}
+
+void IMB_exr_read_channels(void *handle)
+{
+  ExrHandle *data = (ExrHandle *)handle;
+
+  if (!BLI_listbase_is_empty(&data->layers)) {
+    /* Channels were parsed into passes, read all passes that were not accessed yet. */
+    imb_exr_read_passes(data, imb_exr_get_all_passes(data));
+    return;
+  }
+
+  /* Read the channels that were assigned a buffer with #IMB_exr_set_channel. */
+  blender::Vector<ExrChannel *> channels;
+  LISTBASE_FOREACH (ExrChannel *, echan, &data->channels) {
+    if (echan->rect) {
+      channels.append(echan);
     }
   }
+  imb_exr_read_channels_from_parts(data, channels);
+}
+
+float *IMB_exr_read_pass(void *handle, const char *layname, const char *passname, int *r_totchan)
+{
+  ExrHandle *data = (ExrHandle *)handle;
+
+  ExrLayer *lay = (ExrLayer *)BLI_findstring(&data->layers, layname, offsetof(ExrLayer, name));
+  if (lay == nullptr) {
+    return nullptr;
+  }
+  ExrPass *pass = (ExrPass *)BLI_findstring(&lay->passes, passname, offsetof(ExrPass, name));
+  if (pass == nullptr) {
+    return nullptr;
+  }
+
+  if (!pass->is_loaded) {
+    imb_exr_read_passes(data, {pass});
+  }
+
+  if (r_totchan) {
+    *r_totchan = pass->totchan;
+  }
+  float *rect = pass->rect;
+  pass->rect = nullptr;
+  return rect;
+}
+
+bool IMB_exr_file_changed(void *handle)
+{
+  ExrHandle *data = (ExrHandle *)handle;
+  if (data->ifile == nullptr || data->ifile_path[0] == '\0') {
+    return false;
+  }
+
+  BLI_stat_t st;
+  if (BLI_stat(data->ifile_path, &st) != 0) {
+    return true;
+  }
+  return st.st_size != data->ifile_size || int64_t(st.st_mtime) != data->ifile_mtime;
 }
 
 void IMB_exr_multilayer_convert(void *handle,
@@ -1267,7 +1407,8 @@ void IMB_exr_multilayer_convert(void *handle,
                                                 float *rect,
                                                 int totchan,
                                                 const char *chan_id,
-                                                const char *view))
+                                                const char *view),
+                                const bool read_passes)
 {
   ExrHandle *data = (ExrHandle *)handle;
 
@@ -1287,6 +1428,12 @@ void IMB_exr_multilayer_convert(void *handle,
     return;
   }
 
+  if (read_passes) {
+    /* Passes that were not accessed yet are read now, since the ownership of all of them is
+     * passed on. */
+    imb_exr_read_passes(data, imb_exr_get_all_passes(data));
+  }
+
   LISTBASE_FOREACH (ExrLayer *, lay, &data->layers) {
     void *laybase = addlayer(base, lay->name);
     if (laybase) {
@@ -1605,6 +1752,67 @@ static std::vector<MultiViewChannelName> exr_channels_in_multi_part_file(
   return channels;
 }
 
+/* Allocate the buffer of a pass and assign the channels to it, with some heuristics to merge the
+ * channels in buffers. */
+static void imb_exr_pass_alloc_buffer(ExrHandle *data, ExrPass *pass)
+{
+  pass->rect = MEM_calloc_arrayN<float>(
+      size_t(data->width) * size_t(data->height) * size_t(pass->totchan), "pass rect");
+  if (pass->totchan == 1) {
+    ExrChannel *echan = pass->chan[0];
+    echan->rect = pass->rect;
+    echan->xstride = 1;
+    echan->ystride = data->width;
+    pass->chan_id[0] = echan->chan_id;
+  }
+  else {
+    char lookup[256];
+
+    memset(lookup, 0, sizeof(lookup));
+
+    /* we can have RGB(A), XYZ(W), UVA */
+    if (ELEM(pass->totchan, 3, 4)) {
+      if (pass->chan[0]->chan_id == 'B' || pass->chan[1]->chan_id == 'B' ||
+          pass->chan[2]->chan_id == 'B')
+      {
+        lookup[uint('R')] = 0;
+        lookup[uint('G')] = 1;
+        lookup[uint('B')] = 2;
+        lookup[uint('A')] = 3;
+      }
+      else if (pass->chan[0]->chan_id == 'Y' || pass->chan[1]->chan_id == 'Y' ||
+               pass->chan[2]->chan_id == 'Y')
+      {
+        lookup[uint('X')] = 0;
+        lookup[uint('Y')] = 1;
+        lookup[uint('Z')] = 2;
+        lookup[uint('W')] = 3;
+      }
+      else {
+        lookup[uint('U')] = 0;
+        lookup[uint('V')] = 1;
+        lookup[uint('A')] = 2;
+      }
+      for (int a = 0; a < pass->totchan; a++) {
+        ExrChannel *echan = pass->chan[a];
+        echan->rect = pass->rect + lookup[uint(echan->chan_id)];
+        echan->xstride = pass->totchan;
+        echan->ystride = data->width * pass->totchan;
+        pass->chan_id[uint(lookup[uint(echan->chan_id)])] = echan->chan_id;
+      }
+    }
+    else { /* unknown */
+      for (int a = 0; a < pass->totchan; a++) {
+        ExrChannel *echan = pass->chan[a];
+        echan->rect = pass->rect + a;
+        echan->xstride = pass->totchan;
+        echan->ystride = data->width * pass->totchan;
+        pass->chan_id[a] = echan->chan_id;
+      }
+    }
+  }
+}
+
 static bool imb_exr_multilayer_parse_channels_from_file(ExrHandle *data)
 {
   std::vector<MultiViewChannelName> channels = exr_channels_in_multi_part_file(*data->ifile);
@@ -1660,73 +1868,10 @@ static bool imb_exr_multilayer_parse_channels_from_file(ExrHandle *data)
     return false;
   }
 
-  /* with some heuristics, try to merge the channels in buffers */
-  LISTBASE_FOREACH (ExrLayer *, lay, &data->layers) {
-    LISTBASE_FOREACH (ExrPass *, pass, &lay->passes) {
-      if (pass->totchan) {
-        pass->rect = MEM_calloc_arrayN<float>(
-            size_t(data->width) * size_t(data->height) * size_t(pass->totchan), "pass rect");
-        if (pass->totchan == 1) {
-          ExrChannel *echan = pass->chan[0];
-          echan->rect = pass->rect;
-          echan->xstride = 1;
-          echan->ystride = data->width;
-          pass->chan_id[0] = echan->chan_id;
-        }
-        else {
-          char lookup[256];
-
-          memset(lookup, 0, sizeof(lookup));
-
-          /* we can have RGB(A), XYZ(W), UVA */
-          if (ELEM(pass->totchan, 3, 4)) {
-            if (pass->chan[0]->chan_id == 'B' || pass->chan[1]->chan_id == 'B' ||
-                pass->chan[2]->chan_id == 'B')
-            {
-              lookup[uint('R')] = 0;
-              lookup[uint('G')] = 1;
-              lookup[uint('B')] = 2;
-              lookup[uint('A')] = 3;
-            }
-            else if (pass->chan[0]->chan_id == 'Y' || pass->chan[1]->chan_id == 'Y' ||
-                     pass->chan[2]->chan_id == 'Y')
-            {
-              lookup[uint('X')] = 0;
-              lookup[uint('Y')] = 1;
-              lookup[uint('Z')] = 2;
-              lookup[uint('W')] = 3;
-            }
-            else {
-              lookup[uint('U')] = 0;
-              lookup[uint('V')] = 1;
-              lookup[uint('A')] = 2;
-            }
-            for (int a = 0; a < pass->totchan; a++) {
-              echan = pass->chan[a];
-              echan->rect = pass->rect + lookup[uint(echan->chan_id)];
-              echan->xstride = pass->totchan;
-              echan->ystride = data->width * pass->totchan;
-              pass->chan_id[uint(lookup[uint(echan->chan_id)])] = echan->chan_id;
-            }
-          }
-          else { /* unknown */
-            for (int a = 0; a < pass->totchan; a++) {
-              ExrChannel *echan = pass->chan[a];
-              echan->rect = pass->rect + a;
-              echan->xstride = pass->totchan;
-              echan->ystride = data->width * pass->totchan;
-              pass->chan_id[a] = echan->chan_id;
-            }
-          }
-        }
-      }
-    }
-  }
-
   return true;
 }
 
-/* creates channels, makes a hierarchy and assigns memory to channels */
+/* creates channels and makes a hierarchy, memory is assigned to channels when reading them */
 static ExrHandle *imb_exr_begin_read_mem(IStream &file_stream,
                                          MultiPartInputFile &file,
                                          int width,
@@ -2061,6 +2206,140 @@ bool IMB_exr_get_ppm(void *handle, double ppm[2])
   return exr_get_ppm(*data->ifile, ppm);
 }
 
+static void exr_read_metadata(const Header &header, ImBuf *ibuf)
+{
+  IMB_metadata_ensure(&ibuf->metadata);
+  for (Header::ConstIterator iter = header.begin(); iter != header.end(); iter++) {
+    const StringAttribute *attr = header.findTypedAttribute<StringAttribute>(iter.name());
+
+    /* not all attributes are string attributes so we might get some NULLs here */
+    if (attr) {
+      IMB_metadata_set_field(ibuf->metadata, iter.name(), attr->value().c_str());
+      ibuf->flags |= IB_metadata;
+    }
+  }
+}
+
+void IMB_exr_read_metadata(void *handle, ImBuf *ibuf)
+{
+  ExrHandle *data = (ExrHandle *)handle;
+  exr_read_metadata(data->ifile->header(0), ibuf);
+}
+
+/* Create an image without pixels with the size and properties of the first part of a file. */
+static ImBuf *exr_alloc_imbuf(MultiPartInputFile &file, ImFileColorSpace &r_colorspace)
+{
+  const Header &file_header = file.header(0);
+  const Box2i dw = file_header.dataWindow();
+  const size_t width = dw.max.x - dw.min.x + 1;
+  const size_t height = dw.max.y - dw.min.y + 1;
+  const bool is_alpha = exr_has_alpha(file);
+
+  ImBuf *ibuf = IMB_allocImBuf(width, height, is_alpha ? 32 : 24, 0);
+  ibuf->foptions.flag |= exr_is_half_float(file) ? OPENEXR_HALF : 0;
+  ibuf->foptions.flag |= openexr_header_get_compression(file_header);
+
+  exr_get_ppm(file, ibuf->ppm);
+
+  imb_exr_set_known_colorspace(file_header, r_colorspace);
+
+  ibuf->ftype = IMB_FTYPE_OPENEXR;
+  return ibuf;
+}
+
+/* Read the RGBA pixels of a single layer file into the float buffer of the image. */
+static void exr_read_rgba_pixels(MultiPartInputFile &file, ImBuf *ibuf)
+{
+  const Box2i dw = file.header(0).dataWindow();
+  const size_t width = dw.max.x - dw.min.x + 1;
+  const size_t height = dw.max.y - dw.min.y + 1;
+
+  const char *rgb_channels[3];
+  const int num_rgb_channels = exr_has_rgb(file, rgb_channels);
+  const bool has_luma = exr_has_luma(file);
+  const bool has_xyz = exr_has_xyz(file);
+  FrameBuffer frameBuffer;
+  float *first;
+  size_t xstride = sizeof(float[4]);
+  size_t ystride = -xstride * width;
+
+  /* No need to clear image memory, it will be fully written below. */
+  IMB_alloc_float_pixels(ibuf, 4, false);
+
+  /* Inverse correct first pixel for data-window
+   * coordinates (- dw.min.y because of y flip). */
+  first = ibuf->float_buffer.data - 4 * (dw.min.x - dw.min.y * width);
+  /* But, since we read y-flipped (negative y stride) we move to last scan-line. */
+  first += 4 * (height - 1) * width;
+
+  if (num_rgb_channels > 0) {
+    for (int i = 0; i < num_rgb_channels; i++) {
+      frameBuffer.insert(exr_rgba_channelname(file, rgb_channels[i]),
+                         Slice(Imf::FLOAT, (char *)(first + i), xstride, ystride));
+    }
+  }
+  else if (has_xyz) {
+    frameBuffer.insert(exr_rgba_channelname(file, "X"),
+                       Slice(Imf::FLOAT, (char *)first, xstride, ystride));
+    frameBuffer.insert(exr_rgba_channelname(file, "Y"),
+                       Slice(Imf::FLOAT, (char *)(first + 1), xstride, ystride));
+    frameBuffer.insert(exr_rgba_channelname(file, "Z"),
+                       Slice(Imf::FLOAT, (char *)(first + 2), xstride, ystride));
+  }
+  else if (has_luma) {
+    frameBuffer.insert(exr_rgba_channelname(file, "Y"),
+                       Slice(Imf::FLOAT, (char *)first, xstride, ystride));
+    frameBuffer.insert(
+        exr_rgba_channelname(file, "BY"),
+        Slice(Imf::FLOAT, (char *)(first + 1), xstride, ystride, 1, 1, 0.5f));
+    frameBuffer.insert(
+        exr_rgba_channelname(file, "RY"),
+        Slice(Imf::FLOAT, (char *)(first + 2), xstride, ystride, 1, 1, 0.5f));
+  }
+
+  /* 1.0 is fill value, this still needs to be assigned even when (is_alpha == 0) */
+  frameBuffer.insert(exr_rgba_channelname(file, "A"),
+                     Slice(Imf::FLOAT, (char *)(first + 3), xstride, ystride, 1, 1, 1.0f));
+
+  InputPart in(file, 0);
+  in.setFrameBuffer(frameBuffer);
+  in.readPixels(dw.min.y, dw.max.y);
+
+  /* XXX, ImBuf has no nice way to deal with this.
+   * ideally IM_rect would be used when the caller wants a rect BUT
+   * at the moment all functions use IM_rect.
+   * Disabling this is ok because all functions should check
+   * if a rect exists and create one on demand.
+   *
+   * Disabling this because the sequencer frees immediate. */
+#if 0
+  if (flag & IM_rect) {
+    IMB_byte_from_float(ibuf);
+  }
+#endif
+
+  if (num_rgb_channels == 0 && has_luma && exr_has_chroma(file)) {
+    for (size_t a = 0; a < size_t(ibuf->x) * ibuf->y; a++) {
+      float *color = ibuf->float_buffer.data + a * 4;
+      ycc_to_rgb(color[0] * 255.0f,
+                 color[1] * 255.0f,
+                 color[2] * 255.0f,
+                 &color[0],
+                 &color[1],
+                 &color[2],
+                 BLI_YCC_ITU_BT709);
+    }
+  }
+  else if (!has_xyz && num_rgb_channels <= 1) {
+    /* Convert 1 to 3 channels. */
+    for (size_t a = 0; a < size_t(ibuf->x) * ibuf->y; a++) {
+      float *color = ibuf->float_buffer.data + a * 4;
+      color[1] = color[0];
+      color[2] = color[0];
+    }
+  }
+}
+
 ImBuf *imb_load_openexr(const uchar *mem, size_t size, int flags, ImFileColorSpace &r_colorspace)
 {
   ImBuf *ibuf = nullptr;
@@ -2096,34 +2375,12 @@ ImBuf *imb_load_openexr(const uchar *mem, size_t size, int flags, ImFileColorSpa
       printf("Error: can't process EXR multilayer file\n");
     }
     else {
-      const bool is_alpha = exr_has_alpha(*file);
-
-      ibuf = IMB_allocImBuf(width, height, is_alpha ? 32 : 24, 0);
-      ibuf->foptions.flag |= exr_is_half_float(*file) ? OPENEXR_HALF : 0;
-      ibuf->foptions.flag |= openexr_header_get_compression(file_header);
-
-      exr_get_ppm(*file, ibuf->ppm);
-
-      imb_exr_set_known_colorspace(file_header, r_colorspace);
-
-      ibuf->ftype = IMB_FTYPE_OPENEXR;
+      ibuf = exr_alloc_imbuf(*file, r_colorspace);
 
       if (!(flags & IB_test)) {
 
         if (flags & IB_metadata) {
-          Header::ConstIterator iter;
-
-          IMB_metadata_ensure(&ibuf->metadata);
-          for (iter = file_header.begin(); iter != file_header.end(); iter++) {
-            const StringAttribute *attr = file_header.findTypedAttribute<StringAttribute>(
-                iter.name());
-
-            /* not all attributes are string attributes so we might get some NULLs here */
-            if (attr) {
-              IMB_metadata_set_field(ibuf->metadata, iter.name(), attr->value().c_str());
-              ibuf->flags |= IB_metadata;
-            }
-          }
+          exr_read_metadata(file_header, ibuf);
         }
 
         /* Only enters with IB_multilayer flag set. */
@@ -2136,90 +2393,7 @@ ImBuf *imb_load_openexr(const uchar *mem, size_t size, int flags, ImFileColorSpa
           }
         }
         else {
-          const char *rgb_channels[3];
-          const int num_rgb_channels = exr_has_rgb(*file, rgb_channels);
-          const bool has_luma = exr_has_luma(*file);
-          const bool has_xyz = exr_has_xyz(*file);
-          FrameBuffer frameBuffer;
-          float *first;
-          size_t xstride = sizeof(float[4]);
-          size_t ystride = -xstride * width;
-
-          /* No need to clear image memory, it will be fully written below. */
-          IMB_alloc_float_pixels(ibuf, 4, false);
-
-          /* Inverse correct first pixel for data-window
-           * coordinates (- dw.min.y because of y flip). */
-          first = ibuf->float_buffer.data - 4 * (dw.min.x - dw.min.y * width);
-          /* But, since we read y-flipped (negative y stride) we move to last scan-line. */
-          first += 4 * (height - 1) * width;
-
-          if (num_rgb_channels > 0) {
-            for (int i = 0; i < num_rgb_channels; i++) {
-              frameBuffer.insert(exr_rgba_channelname(*file, rgb_channels[i]),
-                                 Slice(Imf::FLOAT, (char *)(first + i), xstride, ystride));
-            }
-          }
-          else if (has_xyz) {
-            frameBuffer.insert(exr_rgba_channelname(*file, "X"),
-                               Slice(Imf::FLOAT, (char *)first, xstride, ystride));
-            frameBuffer.insert(exr_rgba_channelname(*file, "Y"),
-                               Slice(Imf::FLOAT, (char *)(first + 1), xstride, ystride));
-            frameBuffer.insert(exr_rgba_channelname(*file, "Z"),
-                               Slice(Imf::FLOAT, (char *)(first + 2), xstride, ystride));
-          }
-          else if (has_luma) {
-            frameBuffer.insert(exr_rgba_channelname(*file, "Y"),
-                               Slice(Imf::FLOAT, (char *)first, xstride, ystride));
-            frameBuffer.insert(
-                exr_rgba_channelname(*file, "BY"),
-                Slice(Imf::FLOAT, (char *)(first + 1), xstride, ystride, 1, 1, 0.5f));
-            frameBuffer.insert(
-                exr_rgba_channelname(*file, "RY"),
-                Slice(Imf::FLOAT, (char *)(first + 2), xstride, ystride, 1, 1, 0.5f));
-          }
-
-          /* 1.0 is fill value, this still needs to be assigned even when (is_alpha == 0) */
-          frameBuffer.insert(exr_rgba_channelname(*file, "A"),
-                             Slice(Imf::FLOAT, (char *)(first + 3), xstride, ystride, 1, 1, 1.0f));
-
-          InputPart in(*file, 0);
-          in.setFrameBuffer(frameBuffer);
-          in.readPixels(dw.min.y, dw.max.y);
-
-          /* XXX, ImBuf has no nice way to deal with this.
-           * ideally IM_rect would be used when the caller wants a rect BUT
-           * at the moment all functions use IM_rect.
-           * Disabling this is ok because all functions should check
-           * if a rect exists and create one on demand.
-           *
-           * Disabling this because the sequencer frees immediate. */
-#if 0
-          if (flag & IM_rect) {
-            IMB_byte_from_float(ibuf);
-          }
-#endif
-
-          if (num_rgb_channels == 0 && has_luma && exr_has_chroma(*file)) {
-            for (size_t a = 0; a < size_t(ibuf->x) * ibuf->y; a++) {
-              float *color = ibuf->float_buffer.data + a * 4;
-              ycc_to_rgb(color[0] * 255.0f,
-                         color[1] * 255.0f,
-                         color[2] * 255.0f,
-                         &color[0],
-                         &color[1],
-                         &color[2],
-                         BLI_YCC_ITU_BT709);
-            }
-          }
-          else if (!has_xyz && num_rgb_channels <= 1) {
-            /* Convert 1 to 3 channels. */
-            for (size_t a = 0; a < size_t(ibuf->x) * ibuf->y; a++) {
-              float *color = ibuf->float_buffer.data + a * 4;
-              color[1] = color[0];
-              color[2] = color[0];
-            }
-          }
+          exr_read_rgba_pixels(*file, ibuf);
 
           /* file is no longer needed */
           delete membuf;
@@ -2259,6 +2433,43 @@ ImBuf *imb_load_openexr(const uchar *mem, size_t size, int flags, ImFileColorSpa
   }
 }
 
+ImBuf *imb_load_openexr_from_handle(void *handle, int flags, ImFileColorSpace &r_colorspace)
+{
+  ExrHandle *data = (ExrHandle *)handle;
+  if (data->ifile == nullptr || imb_exr_is_multi(*data->ifile)) {
+    return nullptr;
+  }
+
+  ImBuf *ibuf = nullptr;
+  try {
+    ibuf = exr_alloc_imbuf(*data->ifile, r_colorspace);
+    if (!(flags & IB_test)) {
+      if (flags & IB_metadata) {
+        exr_read_metadata(data->ifile->header(0), ibuf);
+      }
+      exr_read_rgba_pixels(*data->ifile, ibuf);
+      if (flags & IB_alphamode_detect) {
+        ibuf->flags |= IB_alphamode_premul;
+      }
+    }
+    return ibuf;
+  }
+  catch (const std::exception &exc) {
+    std::cerr << exc.what() << std::endl;
+    if (ibuf) {
+      IMB_freeImBuf(ibuf);
+    }
+    return nullptr;
+  }
+  catch (...) { /* Catch-all for edge cases or compiler bugs. */
+    std::cerr << "OpenEXR-Load: UNKNOWN ERROR" << std::endl;
+    if (ibuf) {
+      IMB_freeImBuf(ibuf);
+    }
+    return nullptr;
+  }
+}
+
 ImBuf *imb_load_filepath_thumbnail_openexr(const char *filepath,
                                            const int /*flags*/,
                                            const size_t max_thumb_size,
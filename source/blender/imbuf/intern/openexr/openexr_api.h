@@ -28,6 +28,14 @@ struct ImBuf *imb_load_openexr(const unsigned char *mem,
                                int flags,
                                ImFileColorSpace &r_colorspace);
 
+/**
+ * Load a single layer file from a handle opened with #IMB_exr_begin_read, so the file doesn't
+ * have to be opened again after testing it for layers. Returns null for multi-layer files.
+ */
+struct ImBuf *imb_load_openexr_from_handle(void *handle,
+                                           int flags,
+                                           ImFileColorSpace &r_colorspace);
+
 struct ImBuf *imb_load_filepath_thumbnail_openexr(const char *filepath,
                                                   int flags,
                                                   size_t max_thumb_size,
@@ -58,6 +58,13 @@ bool IMB_exr_set_channel(void * /*handle*/,
 }
 
 void IMB_exr_read_channels(void * /*handle*/) {}
+float *IMB_exr_read_pass(void * /*handle*/,
+                         const char * /*layname*/,
+                         const char * /*passname*/,
+                         int * /*r_totchan*/)
+{
+  return nullptr;
+}
 void IMB_exr_write_channels(void * /*handle*/) {}
 
 void IMB_exr_multilayer_convert(void * /*handle*/,
@@ -70,13 +77,19 @@ void IMB_exr_multilayer_convert(void * /*handle*/,
                                                      float *rect,
                                                      int totchan,
                                                      const char *chan_id,
-                                                     const char *view))
+                                                     const char *view),
+                                bool /*read_passes*/)
 {
 }
 
 void IMB_exr_close(void * /*handle*/) {}
 
 void IMB_exr_add_view(void * /*handle*/, const char * /*name*/) {}
+bool IMB_exr_file_changed(void * /*handle*/)
+{
+  return false;
+}
+
 bool IMB_exr_has_multilayer(void * /*handle*/)
 {
   return false;
@@ -86,3 +99,5 @@ bool IMB_exr_get_ppm(void * /*handle*/, double /*ppm*/[2])
 {
   return false;
 }
+
+void IMB_exr_read_metadata(void * /*handle*/, ImBuf * /*ibuf*/) {}
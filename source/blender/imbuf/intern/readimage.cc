@@ -19,6 +19,7 @@
 #include "BLI_path_utils.hh" /* For assertions. */
 #include "BLI_string.h"
 #include "BLI_string_utf8.h"
+#include "BLI_utildefines.h"
 
 #include <cstdlib>
 
@@ -33,6 +34,10 @@
 #include "IMB_colormanagement.hh"
 #include "IMB_colormanagement_intern.hh"
 
+#ifdef WITH_IMAGE_OPENEXR
+#  include "openexr/openexr_api.h"
+#endif
+
 static void imb_handle_colorspace_and_alpha(ImBuf *ibuf,
                                             const int flags,
                                             const char *filepath,
@@ -229,6 +234,25 @@ ImBuf *IMB_load_image_from_filepath(const char *filepath,
   return ibuf;
 }
 
+ImBuf *IMB_load_image_from_exr_handle(void *exrhandle,
+                                      const char *filepath,
+                                      const int flags,
+                                      char r_colorspace[IM_MAX_SPACE])
+{
+#ifdef WITH_IMAGE_OPENEXR
+  ImFileColorSpace file_colorspace;
+  ImBuf *ibuf = imb_load_openexr_from_handle(exrhandle, flags, file_colorspace);
+  if (ibuf) {
+    imb_handle_colorspace_and_alpha(ibuf, flags, filepath, file_colorspace, r_colorspace);
+    STRNCPY(ibuf->filepath, filepath);
+  }
+  return ibuf;
+#else
+  UNUSED_VARS(exrhandle, filepath, flags, r_colorspace);
+  return nullptr;
+#endif
+}
+
 ImBuf *IMB_thumb_load_image(const char *filepath,
                             const size_t max_thumb_size,
                             char r_colorspace[IM_MAX_SPACE],
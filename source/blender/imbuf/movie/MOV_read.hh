@@ -16,6 +16,8 @@
 
 #include "BLI_set.hh"
 
+#include <atomic>
+#include <cstdint>
 #include <string>
 
 struct IDProperty;
@@ -130,6 +132,37 @@ void MOV_get_filename(const MovieReader *anim, char *filename, int filename_maxn
  */
 IDProperty *MOV_load_metadata(MovieReader *anim);
 
+/**
+ * Build an index of the key frames of the movie in the background once it is initialized, or
+ * load it if it was built before. Once ready, it is used to seek directly to the key frame that
+ * starts the GOP of a requested frame, and to decode forward instead of seeking when the requested
+ * frame is further in the GOP that is being decoded.
+ */
+void MOV_use_keyframe_index(MovieReader *anim);
+
+/** Counters of the work done to decode the requested frames of a movie. */
+struct MovieDecodeStatistics {
+  /** Number of requested frames, excluding the ones read from proxies. */
+  int64_t requested_frames = 0;
+  /** Number of requested frames that were found in the pool of recently decoded frames. */
+  int64_t pool_hits = 0;
+  /** Number of seeks to a key frame. */
+  int64_t seeks = 0;
+  /** Number of seeks that were avoided by decoding forward within the current GOP. */
+  int64_t avoided_seeks = 0;
+  /** Number of decoded frames, including those decoded to reach a requested frame. */
+  int64_t decoded_frames = 0;
+  /** Number of frames that were decoded after seeks until the requested frames were reached. */
+  int64_t seek_decoded_frames = 0;
+  /** Total time in seconds spent seeking and decoding until the requested frames were reached. */
+  double seek_time = 0.0;
+};
+
+/**
+ * Get the decoding statistics of the movie since it was opened, to measure the cost of seeking.
+ */
+MovieDecodeStatistics MOV_get_decode_statistics(const MovieReader *anim);
+
 /*-------------------------------------------------------------------- */
 /*
  * Movie proxy / timecode index related functionality.
@@ -191,6 +224,18 @@ void MOV_proxy_builder_process(MovieProxyBuilder *context,
                                bool *stop,
                                bool *do_update,
                                float *progress);
+/**
+ * Same as above, for when the progress is read by another thread while the proxies are built.
+ */
+void MOV_proxy_builder_process(MovieProxyBuilder *context,
+                               bool *stop,
+                               bool *do_update,
+                               std::atomic<float> *progress);
+
+/**
+ * Get the number of frames that were decoded and encoded into proxies so far.
+ */
+int MOV_proxy_builder_get_frames_num(const MovieProxyBuilder *context);
 
 /**
  * Finish building proxies / time-codes indices, and delete the builder.
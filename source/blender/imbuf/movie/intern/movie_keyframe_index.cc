@@ -0,0 +1,306 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup imbuf
+ */
+
+#ifdef WITH_FFMPEG
+
+#  include <algorithm>
+#  include <cinttypes>
+#  include <cstdio>
+#  include <cstring>
+#  include <mutex>
+#  include <string>
+
+#  include <xxhash.h>
+
+#  include "MEM_guardedalloc.h"
+
+#  include "BLI_assert.h"
+#  include "BLI_fileops.h"
+#  include "BLI_map.hh"
+#  include "BLI_mutex.hh"
+#  include "BLI_path_utils.hh"
+#  include "BLI_string.h"
+#  include "BLI_task.h"
+#  include "BLI_time.h"
+
+#  include "BKE_appdir.hh"
+
+#  include "movie_keyframe_index.hh"
+#  include "movie_read.hh"
+
+extern "C" {
+#  include "ffmpeg_compat.h"
+#  include <libavformat/avformat.h>
+}
+
+static const char keyframe_index_header_str[] = "BlenMKey";
+
+/* Increment when the content of the index changes, so that old files are not used. */
+#  define KEYFRAME_INDEX_FILE_VERSION 1
+
+struct KeyframeIndexFileHeader {
+  char header_str[8];
+  int32_t version;
+  int32_t video_stream;
+  int64_t keyframes_num;
+};
+
+/* The indices of all files that were opened, by file path, video stream, size and modification
+ * time. Indices are small and kept until exit, so that a file is only indexed once per session,
+ * even if building failed. */
+static blender::Mutex keyframe_indices_lock;
+static blender::Map<std::string, MovieKeyframeIndex *> *keyframe_indices = nullptr;
+/* Builds the indices in the background, independently of the movie readers. */
+static TaskPool *keyframe_indices_task_pool = nullptr;
+
+int64_t MovieKeyframeIndex::gop_start_pts(const int64_t pts) const
+{
+  BLI_assert(this->is_ready);
+
+  /* The first key frame that is after the timestamp, such that the previous one starts its GOP.
+   * Timestamps before the first key frame belong to the first GOP. */
+  const int64_t *next_keyframe = std::upper_bound(
+      this->keyframe_pts.begin(), this->keyframe_pts.end(), pts);
+  if (next_keyframe == this->keyframe_pts.begin()) {
+    return this->keyframe_pts.first();
+  }
+  return *(next_keyframe - 1);
+}
+
+/* The file name of the index is a hash of the path of the movie and its modification time and
+ * size, such that modified files get a new index, and the index of a file is shared by all blend
+ * files that use it. */
+static bool keyframe_index_filepath_get(const MovieKeyframeIndex *index, char *r_filepath)
+{
+  BLI_stat_t status;
+  if (BLI_stat(index->filepath, &status) != 0) {
+    return false;
+  }
+
+  char caches_dir[FILE_MAX];
+  if (!BKE_appdir_folder_caches(caches_dir, sizeof(caches_dir))) {
+    return false;
+  }
+
+  XXH3_state_t *state = XXH3_createState();
+  XXH3_64bits_reset(state);
+  XXH3_64bits_update(state, index->filepath, strlen(index->filepath));
+  const int64_t size = status.st_size;
+  const int64_t modification_time = status.st_mtime;
+  XXH3_64bits_update(state, &size, sizeof(size));
+  XXH3_64bits_update(state, &modification_time, sizeof(modification_time));
+  const uint64_t hash = XXH3_64bits_digest(state);
+  XXH3_freeState(state);
+
+  char filename[64];
+  SNPRINTF(filename, "%016" PRIx64 ".blen_kfi", hash);
+  BLI_path_join(r_filepath, FILE_MAX, caches_dir, "movie_keyframes", filename);
+  return true;
+}
+
+static bool keyframe_index_read(MovieKeyframeIndex *index, const char *filepath)
+{
+  FILE *file = BLI_fopen(filepath, "rb");
+  if (file == nullptr) {
+    return false;
+  }
+
+  KeyframeIndexFileHeader header;
+  bool is_read = fread(&header, sizeof(header), 1, file) == 1 &&
+                 memcmp(header.header_str, keyframe_index_header_str, 8) == 0 &&
+                 header.version == KEYFRAME_INDEX_FILE_VERSION &&
+                 header.video_stream == index->video_stream && header.keyframes_num > 0;
+  if (is_read) {
+    index->keyframe_pts.resize(header.keyframes_num);
+    is_read = fread(index->keyframe_pts.data(), sizeof(int64_t), header.keyframes_num, file) ==
+              size_t(header.keyframes_num);
+  }
+
+  fclose(file);
+  return is_read;
+}
+
+static void keyframe_index_write(const MovieKeyframeIndex *index, const char *filepath)
+{
+  if (!BLI_file_ensure_parent_dir_exists(filepath)) {
+    return;
+  }
+
+  /* Write to a temporary file that is then renamed, such that partially written files are never
+   * read, even by other instances of Blender. */
+  char filepath_temp[FILE_MAX];
+  SNPRINTF(filepath_temp, "%s.%p_part", filepath, index);
+
+  FILE *file = BLI_fopen(filepath_temp, "wb");
+  if (file == nullptr) {
+    return;
+  }
+
+  KeyframeIndexFileHeader header;
+  memcpy(header.header_str, keyframe_index_header_str, 8);
+  header.version = KEYFRAME_INDEX_FILE_VERSION;
+  header.video_stream = index->video_stream;
+  header.keyframes_num = index->keyframe_pts.size();
+
+  const bool is_written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                          fwrite(index->keyframe_pts.data(),
+                                 sizeof(int64_t),
+                                 index->keyframe_pts.size(),
+                                 file) == size_t(index->keyframe_pts.size());
+  const bool is_closed = fclose(file) == 0;
+
+  if (!is_written || !is_closed || BLI_rename_overwrite(filepath_temp, filepath) != 0) {
+    BLI_delete(filepath_temp, false, false);
+  }
+}
+
+/* Read all packets of the video stream without decoding them, collecting the timestamps of the
+ * key frames. Returns false if the file couldn't be read or building was canceled. */
+static bool keyframe_index_build(TaskPool *pool, MovieKeyframeIndex *index)
+{
+  AVFormatContext *format_ctx = nullptr;
+  if (avformat_open_input(&format_ctx, index->filepath, nullptr, nullptr) != 0) {
+    return false;
+  }
+  if (avformat_find_stream_info(format_ctx, nullptr) < 0 ||
+      index->video_stream >= int(format_ctx->nb_streams))
+  {
+    avformat_close_input(&format_ctx);
+    return false;
+  }
+
+  /* Let the demuxer skip the packets of the other streams where possible. */
+  for (int i = 0; i < format_ctx->nb_streams; i++) {
+    if (i != index->video_stream) {
+      format_ctx->streams[i]->discard = AVDISCARD_ALL;
+    }
+  }
+
+  const double start_time = BLI_time_now_seconds();
+
+  bool is_canceled = false;
+  AVPacket *packet = av_packet_alloc();
+  while (av_read_frame(format_ctx, packet) >= 0) {
+    if (packet->stream_index == index->video_stream && (packet->flags & AV_PKT_FLAG_KEY)) {
+      const int64_t pts = timestamp_from_pts_or_dts(packet->pts, packet->dts);
+      if (pts != AV_NOPTS_VALUE) {
+        index->keyframe_pts.append(pts);
+      }
+    }
+    av_packet_unref(packet);
+
+    if (BLI_task_pool_current_canceled(pool)) {
+      is_canceled = true;
+      break;
+    }
+  }
+  av_packet_free(&packet);
+
+  av_log(format_ctx,
+         AV_LOG_DEBUG,
+         "KEYFRAME INDEX: found %d key frames in %.2f seconds\n",
+         int(index->keyframe_pts.size()),
+         BLI_time_now_seconds() - start_time);
+
+  avformat_close_input(&format_ctx);
+
+  if (is_canceled || index->keyframe_pts.is_empty()) {
+    index->keyframe_pts.clear();
+    return false;
+  }
+
+  /* Packets are read in decoding order, which for some containers differs from the order of the
+   * timestamps of the key frames. */
+  std::sort(index->keyframe_pts.begin(), index->keyframe_pts.end());
+  const int64_t *unique_end = std::unique(index->keyframe_pts.begin(),
+                                          index->keyframe_pts.end());
+  index->keyframe_pts.resize(unique_end - index->keyframe_pts.begin());
+  return true;
+}
+
+static void keyframe_index_task_run(TaskPool *__restrict pool, void *taskdata)
+{
+  MovieKeyframeIndex *index = static_cast<MovieKeyframeIndex *>(taskdata);
+
+  char filepath[FILE_MAX];
+  const bool has_filepath = keyframe_index_filepath_get(index, filepath);
+  if (has_filepath && keyframe_index_read(index, filepath)) {
+    index->is_ready = true;
+    return;
+  }
+
+  index->keyframe_pts.clear();
+  if (!keyframe_index_build(pool, index)) {
+    return;
+  }
+
+  if (has_filepath) {
+    keyframe_index_write(index, filepath);
+  }
+  index->is_ready = true;
+}
+
+const MovieKeyframeIndex *movie_keyframe_index_ensure(const MovieReader *anim)
+{
+  BLI_assert(anim->pFormatCtx != nullptr);
+
+  BLI_stat_t status;
+  if (BLI_stat(anim->filepath, &status) != 0) {
+    return nullptr;
+  }
+  /* Modified files get a new index. */
+  char key[FILE_MAX + 64];
+  SNPRINTF(key,
+           "%s:%d:%" PRId64 ":%" PRId64,
+           anim->filepath,
+           anim->videoStream,
+           int64_t(status.st_size),
+           int64_t(status.st_mtime));
+
+  std::lock_guard lock(keyframe_indices_lock);
+  if (keyframe_indices == nullptr) {
+    keyframe_indices = new blender::Map<std::string, MovieKeyframeIndex *>();
+    keyframe_indices_task_pool = BLI_task_pool_create_background(nullptr, TASK_PRIORITY_LOW);
+  }
+
+  return keyframe_indices->lookup_or_add_cb(key, [&]() {
+    MovieKeyframeIndex *index = MEM_new<MovieKeyframeIndex>("MovieKeyframeIndex");
+    STRNCPY(index->filepath, anim->filepath);
+    index->video_stream = anim->videoStream;
+    BLI_task_pool_push(keyframe_indices_task_pool, keyframe_index_task_run, index, false, nullptr);
+    return index;
+  });
+}
+
+const MovieKeyframeIndex *movie_keyframe_index_get_ready(const MovieReader *anim)
+{
+  if (anim->keyframe_index == nullptr || !anim->keyframe_index->is_ready) {
+    return nullptr;
+  }
+  return anim->keyframe_index;
+}
+
+void movie_keyframe_index_exit()
+{
+  std::lock_guard lock(keyframe_indices_lock);
+  if (keyframe_indices == nullptr) {
+    return;
+  }
+
+  BLI_task_pool_cancel(keyframe_indices_task_pool);
+  BLI_task_pool_free(keyframe_indices_task_pool);
+  keyframe_indices_task_pool = nullptr;
+
+  for (MovieKeyframeIndex *index : keyframe_indices->values()) {
+    MEM_delete(index);
+  }
+  delete keyframe_indices;
+  keyframe_indices = nullptr;
+}
+
+#endif /* WITH_FFMPEG */
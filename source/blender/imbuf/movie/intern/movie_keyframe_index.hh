@@ -0,0 +1,63 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup imbuf
+ *
+ * Index of the key frames of the video stream of a movie. It allows seeking directly to the key
+ * frame that starts the GOP of a requested frame, and knowing whether a requested frame belongs
+ * to the GOP that is currently being decoded, in which case it can be reached by decoding forward
+ * without seeking at all.
+ *
+ * Unlike the time-code indices, which are built explicitly together with proxies, this index is
+ * built in the background as soon as the movie is opened for playback, by reading the packets of
+ * the video stream without decoding them. It is stored in the cache directory of the user, such
+ * that it is only built once per file.
+ *
+ * There is a single index per file that is shared by all movie readers of the file, and which
+ * outlives them. Readers are freed and recreated often, for example by the sequencer when strips
+ * go out of view, which must not restart building the index.
+ */
+
+#pragma once
+
+#ifdef WITH_FFMPEG
+
+#  include <atomic>
+#  include <cstdint>
+
+#  include "BLI_vector.hh"
+
+struct MovieReader;
+
+struct MovieKeyframeIndex {
+  char filepath[1024];
+  int video_stream;
+
+  /** Sorted timestamps of the key frames, in the time base of the video stream. */
+  blender::Vector<int64_t> keyframe_pts;
+  /** Set once #keyframe_pts is built or loaded, after which it is never modified. */
+  std::atomic<bool> is_ready = false;
+
+  /**
+   * Return the timestamp of the key frame that starts the GOP which contains the given timestamp.
+   * Only valid once the index is ready.
+   */
+  int64_t gop_start_pts(int64_t pts) const;
+};
+
+/**
+ * Get the key frame index of the file of the given initialized movie. The first time the file is
+ * requested, the index starts loading from the cache, or building if it is not cached yet. Both
+ * happen in the background, so this returns immediately. The index is owned by the module.
+ */
+const MovieKeyframeIndex *movie_keyframe_index_ensure(const MovieReader *anim);
+
+/** Return the key frame index of the movie if it is ready to be used, otherwise null. */
+const MovieKeyframeIndex *movie_keyframe_index_get_ready(const MovieReader *anim);
+
+/** Cancel building indices that are still in progress, and free all indices. */
+void movie_keyframe_index_exit();
+
+#endif /* WITH_FFMPEG */
@@ -19,6 +19,7 @@
 #include "BLI_path_utils.hh"
 #include "BLI_string.h"
 #include "BLI_string_utils.hh"
+#include "BLI_task.hh"
 #include "BLI_threads.h"
 #include "BLI_time.h"
 #include "BLI_utildefines.h"
@@ -861,9 +862,14 @@ static void index_rebuild_ffmpeg_proc_decoded_frame(MovieProxyBuilder *context,
   uint64_t s_dts = context->seek_pos_dts;
   uint64_t pts = av_get_pts_from_frame(in_frame);
 
-  for (i = 0; i < context->num_proxy_sizes; i++) {
-    add_to_proxy_output_ffmpeg(context->proxy_ctx[i], in_frame);
-  }
+  /* Each proxy size has its own scaler, encoder and output file, so the decoded frame is scaled
+   * and encoded for all sizes in parallel. */
+  blender::threading::parallel_for(
+      blender::IndexRange(context->num_proxy_sizes), 1, [&](const blender::IndexRange range) {
+        for (const int64_t proxy_index : range) {
+          add_to_proxy_output_ffmpeg(context->proxy_ctx[proxy_index], in_frame);
+        }
+      });
 
   if (!context->start_pts_set) {
     context->start_pts = pts;
@@ -899,10 +905,11 @@ static void index_rebuild_ffmpeg_proc_decoded_frame(MovieProxyBuilder *context,
   context->frameno_gapless++;
 }
 
+template<typename ProgressT>
 static int index_rebuild_ffmpeg(MovieProxyBuilder *context,
                                 const bool *stop,
                                 bool *do_update,
-                                float *progress)
+                                ProgressT *progress)
 {
   AVFrame *in_frame = av_frame_alloc();
   AVPacket *next_packet = av_packet_alloc();
@@ -1174,6 +1181,22 @@ MovieProxyBuilder *MOV_proxy_builder_start(MovieReader *anim,
   UNUSED_VARS(tcs_in_use, proxy_sizes_in_use, quality);
 }
 
+template<typename ProgressT>
+static void proxy_builder_process(MovieProxyBuilder *context,
+                                  bool *stop,
+                                  bool *do_update,
+                                  ProgressT *progress)
+{
+#ifdef WITH_FFMPEG
+  if (context != nullptr) {
+    if (indexer_need_to_build_proxy(context)) {
+      index_rebuild_ffmpeg(context, stop, do_update, progress);
+    }
+  }
+#endif
+  UNUSED_VARS(context, stop, do_update, progress);
+}
+
 void MOV_proxy_builder_process(MovieProxyBuilder *context,
                                /* NOLINTNEXTLINE: readability-non-const-parameter. */
                                bool *stop,
@@ -1181,15 +1204,29 @@ void MOV_proxy_builder_process(MovieProxyBuilder *context,
                                bool *do_update,
                                /* NOLINTNEXTLINE: readability-non-const-parameter. */
                                float *progress)
+{
+  proxy_builder_process(context, stop, do_update, progress);
+}
+
+void MOV_proxy_builder_process(MovieProxyBuilder *context,
+                               /* NOLINTNEXTLINE: readability-non-const-parameter. */
+                               bool *stop,
+                               /* NOLINTNEXTLINE: readability-non-const-parameter. */
+                               bool *do_update,
+                               std::atomic<float> *progress)
+{
+  proxy_builder_process(context, stop, do_update, progress);
+}
+
+int MOV_proxy_builder_get_frames_num(const MovieProxyBuilder *context)
 {
 #ifdef WITH_FFMPEG
   if (context != nullptr) {
-    if (indexer_need_to_build_proxy(context)) {
-      index_rebuild_ffmpeg(context, stop, do_update, progress);
-    }
+    return context->frameno_gapless;
   }
 #endif
-  UNUSED_VARS(context, stop, do_update, progress);
+  UNUSED_VARS(context);
+  return 0;
 }
 
 void MOV_proxy_builder_finish(MovieProxyBuilder *context, const bool stop)
@@ -21,6 +21,7 @@
 #include "BLI_string_utf8.h"
 #include "BLI_task.hh"
 #include "BLI_threads.h"
+#include "BLI_time.h"
 #include "BLI_utildefines.h"
 
 #include "DNA_scene_types.h"
@@ -39,6 +40,7 @@
 
 #ifdef WITH_FFMPEG
 #  include "ffmpeg_swscale.hh"
+#  include "movie_keyframe_index.hh"
 #  include "movie_util.hh"
 
 extern "C" {
@@ -199,6 +201,23 @@ void MOV_set_multiview_suffix(MovieReader *anim, const char *suffix)
   STRNCPY(anim->suffix, suffix);
 }
 
+void MOV_use_keyframe_index(MovieReader *anim)
+{
+  anim->use_keyframe_index = true;
+
+#ifdef WITH_FFMPEG
+  /* Otherwise the index is created once the movie is initialized. */
+  if (anim->state == MovieReader::State::Valid && anim->keyframe_index == nullptr) {
+    anim->keyframe_index = movie_keyframe_index_ensure(anim);
+  }
+#endif
+}
+
+MovieDecodeStatistics MOV_get_decode_statistics(const MovieReader *anim)
+{
+  return anim->decode_statistics;
+}
+
 #ifdef WITH_FFMPEG
 
 static double ffmpeg_stream_start_time_get(const AVStream *stream)
@@ -376,6 +395,22 @@ static AVFormatContext *init_format_context_vpx_workarounds(const char *filepath
   return format_ctx;
 }
 
+/* The approximate maximum size of the decoded frames kept in the pool of a movie, and the maximum
+ * number of frames, which limits the cost of searching the pool for small frames. */
+static constexpr int64_t decoded_frames_pool_budget = 64 * 1024 * 1024;
+static constexpr int decoded_frames_pool_max_size = 16;
+
+static int ffmpeg_decoded_frames_pool_capacity_get(const AVCodecContext *codec_ctx)
+{
+  const int frame_size = av_image_get_buffer_size(
+      codec_ctx->pix_fmt, codec_ctx->width, codec_ctx->height, 1);
+  if (frame_size <= 0) {
+    return 0;
+  }
+  return int(std::clamp<int64_t>(
+      decoded_frames_pool_budget / frame_size, 2, decoded_frames_pool_max_size));
+}
+
 static int startffmpeg(MovieReader *anim)
 {
   if (anim == nullptr) {
@@ -468,6 +503,8 @@ static int startffmpeg(MovieReader *anim)
   anim->cur_packet = av_packet_alloc();
   anim->cur_packet->stream_index = -1;
 
+  anim->decoded_frames_pool_capacity = ffmpeg_decoded_frames_pool_capacity_get(pCodecCtx);
+
   anim->pFrame = av_frame_alloc();
   anim->pFrame_backup = av_frame_alloc();
   anim->pFrame_backup_complete = false;
@@ -602,6 +639,33 @@ static AVFrame *ffmpeg_double_buffer_frame_fallback_get(MovieReader *anim)
   return nullptr;
 }
 
+/* Add the recently decoded frame to the pool, removing the oldest frame if the pool is full. */
+static void ffmpeg_decoded_frames_pool_add(MovieReader *anim)
+{
+  if (anim->decoded_frames_pool_capacity == 0) {
+    return;
+  }
+
+  if (anim->decoded_frames_pool.size() >= anim->decoded_frames_pool_capacity) {
+    av_frame_free(&anim->decoded_frames_pool.first());
+    anim->decoded_frames_pool.remove(0);
+  }
+
+  /* Only a reference to the frame data is added, so this doesn't copy the frame. */
+  AVFrame *frame = av_frame_clone(anim->pFrame);
+  if (frame != nullptr) {
+    anim->decoded_frames_pool.append(frame);
+  }
+}
+
+static void ffmpeg_decoded_frames_pool_clear(MovieReader *anim)
+{
+  for (AVFrame *&frame : anim->decoded_frames_pool) {
+    av_frame_free(&frame);
+  }
+  anim->decoded_frames_pool.clear();
+}
+
 /* Convert from ffmpeg planar GBRA layout to ImBuf interleaved RGBA, applying
  * video rotation in the same go if needed. */
 static void float_planar_to_interleaved(const AVFrame *frame, const int rotation, ImBuf *ibuf)
@@ -856,9 +920,30 @@ static AVFrame *ffmpeg_frame_by_pts_get(MovieReader *anim, int64_t pts_to_search
   return best_frame;
 }
 
+/* Return frame from the pool of decoded frames that matches `pts_to_search`, nullptr if it is not
+ * in the pool. The most recent frame in the pool is the current frame of the decoder, which is
+ * already handled by #ffmpeg_frame_by_pts_get, so it is skipped. */
+static AVFrame *ffmpeg_decoded_frames_pool_lookup(MovieReader *anim, int64_t pts_to_search)
+{
+  const blender::Span<AVFrame *> pool = anim->decoded_frames_pool;
+  for (int64_t i = 0; i < pool.size() - 1; i++) {
+    /* Frames in the pool are consecutive, so use the PTS of the next frame as the end of each
+     * frame, since frame durations are not always reliable. */
+    const int64_t frame_start = av_get_pts_from_frame(pool[i]);
+    const int64_t frame_end = av_get_pts_from_frame(pool[i + 1]);
+    if (ffmpeg_pts_isect(frame_start, frame_end, pts_to_search)) {
+      final_frame_log(anim, frame_start, frame_end, "Pool");
+      return pool[i];
+    }
+  }
+  return nullptr;
+}
+
 static void ffmpeg_decode_store_frame_pts(MovieReader *anim)
 {
   anim->cur_pts = av_get_pts_from_frame(anim->pFrame);
+  anim->decode_statistics.decoded_frames++;
+  ffmpeg_decoded_frames_pool_add(anim);
 
 #  ifdef FFMPEG_OLD_KEY_FRAME_QUERY_METHOD
   if (anim->pFrame->key_frame)
@@ -1160,6 +1245,12 @@ static int ffmpeg_seek_to_key_frame(MovieReader *anim,
   int64_t seek_pos;
   int ret;
 
+  /* Seeking by timestamp is not reliable for formats with timestamp discontinuities, for which the
+   * generic seek workaround is used instead. */
+  const MovieKeyframeIndex *keyframe_index = movie_keyframe_index_get_ready(anim);
+  const bool use_keyframe_index = keyframe_index != nullptr &&
+                                  !(anim->pFormatCtx->iformat->flags & AVFMT_TS_DISCONT);
+
   if (tc_index) {
     /* We can use timestamps generated from our indexer to seek. */
     int new_frame_index = tc_index->get_frame_index(position);
@@ -1175,6 +1266,15 @@ static int ffmpeg_seek_to_key_frame(MovieReader *anim,
     av_log(anim->pFormatCtx, AV_LOG_DEBUG, "Using PTS from timecode as seek_pos\n");
     ret = av_seek_frame(anim->pFormatCtx, anim->videoStream, pts, AVSEEK_FLAG_BACKWARD);
   }
+  else if (use_keyframe_index) {
+    /* Seek directly to the key frame that starts the GOP of the requested frame, instead of
+     * guessing how far before the requested frame it is. */
+    seek_pos = keyframe_index->gop_start_pts(pts_to_search);
+    anim->cur_key_frame_pts = seek_pos;
+
+    av_log(anim->pFormatCtx, AV_LOG_DEBUG, "KEYFRAME INDEX seek pts = %" PRId64 "\n", seek_pos);
+    ret = av_seek_frame(anim->pFormatCtx, anim->videoStream, seek_pos, AVSEEK_FLAG_BACKWARD);
+  }
   else {
     /* We have to manually seek with ffmpeg to get to the key frame we want to start decoding from.
      */
@@ -1218,6 +1318,7 @@ static int ffmpeg_seek_to_key_frame(MovieReader *anim,
    * errors. */
   avcodec_flush_buffers(anim->pCodecCtx);
   ffmpeg_double_buffer_backup_frame_clear(anim);
+  ffmpeg_decoded_frames_pool_clear(anim);
 
   anim->cur_pts = -1;
 
@@ -1234,9 +1335,26 @@ static bool ffmpeg_must_decode(MovieReader *anim, int position)
   return !anim->pFrame_complete || anim->cur_position != position;
 }
 
-static bool ffmpeg_must_seek(MovieReader *anim, int position)
+static bool ffmpeg_must_seek(MovieReader *anim, int position, int64_t pts_to_search)
 {
-  bool must_seek = position != anim->cur_position + 1 || ffmpeg_is_first_frame_decode(anim);
+  if (ffmpeg_is_first_frame_decode(anim)) {
+    anim->seek_before_decode = true;
+    return true;
+  }
+
+  bool must_seek = position != anim->cur_position + 1;
+
+  /* Decoding forward is cheaper than seeking back to the start of the GOP when the requested frame
+   * is further in the GOP that is currently being decoded, which is common when scrubbing. */
+  const MovieKeyframeIndex *keyframe_index = movie_keyframe_index_get_ready(anim);
+  if (must_seek && keyframe_index != nullptr && anim->cur_pts < pts_to_search &&
+      anim->cur_pts >= keyframe_index->gop_start_pts(pts_to_search))
+  {
+    av_log(anim->pFormatCtx, AV_LOG_DEBUG, "FETCH: requested frame is in current GOP\n");
+    anim->decode_statistics.avoided_seeks++;
+    must_seek = false;
+  }
+
   anim->seek_before_decode = must_seek;
   return must_seek;
 }
@@ -1248,6 +1366,7 @@ static ImBuf *ffmpeg_fetchibuf(MovieReader *anim, int position, IMB_Timecode_Typ
   }
 
   av_log(anim->pFormatCtx, AV_LOG_DEBUG, "FETCH: seek_pos=%d\n", position);
+  anim->decode_statistics.requested_frames++;
 
   const MovieIndex *tc_index = movie_open_index(anim, tc);
   int64_t pts_to_search = ffmpeg_get_pts_to_search(anim, tc_index, position);
@@ -1256,6 +1375,10 @@ static ImBuf *ffmpeg_fetchibuf(MovieReader *anim, int position, IMB_Timecode_Typ
   double pts_time_base = av_q2d(v_st->time_base);
   int64_t start_pts = v_st->start_time;
 
+  /* A previously decoded frame that matches the requested one, in which case the state of the
+   * decoder is kept as is, such that sequential decoding can continue from where it stopped. */
+  AVFrame *pool_frame = nullptr;
+
   if (anim->never_seek_decode_one_frame) {
     /* If we must only ever decode one frame, and never seek, do so here. */
     if (!anim->pFrame_complete) {
@@ -1274,11 +1397,37 @@ static ImBuf *ffmpeg_fetchibuf(MovieReader *anim, int position, IMB_Timecode_Typ
            start_pts);
 
     if (ffmpeg_must_decode(anim, position)) {
-      if (ffmpeg_must_seek(anim, position)) {
+      pool_frame = ffmpeg_decoded_frames_pool_lookup(anim, pts_to_search);
+      if (pool_frame != nullptr) {
+        anim->decode_statistics.pool_hits++;
+      }
+    }
+
+    if (pool_frame == nullptr && ffmpeg_must_decode(anim, position)) {
+      const bool must_seek = ffmpeg_must_seek(anim, position, pts_to_search);
+      const double seek_start_time = BLI_time_now_seconds();
+      const int64_t decoded_frames_before_seek = anim->decode_statistics.decoded_frames;
+
+      if (must_seek) {
         ffmpeg_seek_to_key_frame(anim, position, tc_index, pts_to_search);
       }
 
       ffmpeg_decode_video_frame_scan(anim, pts_to_search);
+
+      if (must_seek) {
+        MovieDecodeStatistics &statistics = anim->decode_statistics;
+        const double seek_time = BLI_time_now_seconds() - seek_start_time;
+        const int64_t seek_decoded_frames = statistics.decoded_frames -
+                                            decoded_frames_before_seek;
+        statistics.seeks++;
+        statistics.seek_time += seek_time;
+        statistics.seek_decoded_frames += seek_decoded_frames;
+        av_log(anim->pFormatCtx,
+               AV_LOG_DEBUG,
+               "SEEK COST: decoded %" PRId64 " frames in %.2f ms\n",
+               seek_decoded_frames,
+               seek_time * 1000.0);
+      }
     }
   }
 
@@ -1307,7 +1456,7 @@ static ImBuf *ffmpeg_fetchibuf(MovieReader *anim, int position, IMB_Timecode_Typ
     IMB_assign_byte_buffer(cur_frame_final, buffer_data, IB_TAKE_OWNERSHIP);
   }
 
-  AVFrame *final_frame = ffmpeg_frame_by_pts_get(anim, pts_to_search);
+  AVFrame *final_frame = pool_frame ? pool_frame : ffmpeg_frame_by_pts_get(anim, pts_to_search);
   if (final_frame == nullptr) {
     /* No valid frame was decoded for requested PTS, fall back on most recent decoded frame, even
      * if it is incorrect. */
@@ -1344,7 +1493,9 @@ static ImBuf *ffmpeg_fetchibuf(MovieReader *anim, int position, IMB_Timecode_Typ
     cur_frame_final->byte_buffer.colorspace = colormanage_colorspace_get_named(anim->colorspace);
   }
 
-  anim->cur_position = position;
+  if (pool_frame == nullptr) {
+    anim->cur_position = position;
+  }
 
   return cur_frame_final;
 }
@@ -1368,7 +1519,9 @@ static void free_anim_ffmpeg(MovieReader *anim)
     }
     av_frame_free(&anim->pFrameDeinterlaced);
     ffmpeg_sws_release_context(anim->img_convert_ctx);
+    ffmpeg_decoded_frames_pool_clear(anim);
   }
+  anim->keyframe_index = nullptr;
   anim->duration_in_frames = 0;
 }
 
@@ -1395,6 +1548,12 @@ static bool anim_getnew(MovieReader *anim)
   }
 #endif
   anim->state = MovieReader::State::Valid;
+
+#ifdef WITH_FFMPEG
+  if (anim->use_keyframe_index) {
+    anim->keyframe_index = movie_keyframe_index_ensure(anim);
+  }
+#endif
   return true;
 }
 
@@ -1473,15 +1632,12 @@ ImBuf *MOV_decode_frame(MovieReader *anim,
 #ifdef WITH_FFMPEG
   if (anim->state == MovieReader::State::Valid) {
     ibuf = ffmpeg_fetchibuf(anim, position, tc);
-    if (ibuf) {
-      anim->cur_position = position;
-    }
   }
 #endif
 
   if (ibuf) {
     STRNCPY(ibuf->filepath, anim->filepath);
-    ibuf->fileframe = anim->cur_position + 1;
+    ibuf->fileframe = position + 1;
   }
   return ibuf;
 }
@@ -11,8 +11,12 @@
 
 #include <cstdint>
 
+#include "BLI_vector.hh"
+
 #include "IMB_imbuf_enums.h"
 
+#include "MOV_read.hh"
+
 #ifdef WITH_FFMPEG
 
 extern "C" {
@@ -25,6 +29,7 @@ struct AVCodec;
 struct AVFrame;
 struct AVPacket;
 struct SwsContext;
+struct MovieKeyframeIndex;
 #endif
 
 struct IDProperty;
@@ -79,8 +84,20 @@ struct MovieReader {
    * ffmpeg crashes/aborts when trying to seek within them
    * (https://trac.ffmpeg.org/ticket/10755). */
   bool never_seek_decode_one_frame = false;
+
+  /* Recently decoded frames in presentation order, which are reused when a frame that was
+   * decoded shortly before is requested again, like when stepping backwards. Cleared on seek, such
+   * that the frames are always consecutive. */
+  blender::Vector<AVFrame *> decoded_frames_pool;
+  int decoded_frames_pool_capacity = 0;
+
+  /* Shared by all readers of the file, see #movie_keyframe_index_ensure. */
+  const MovieKeyframeIndex *keyframe_index = nullptr;
 #endif
 
+  bool use_keyframe_index = false;
+  MovieDecodeStatistics decode_statistics;
+
   char index_dir[768] = {};
 
   int proxies_tried = 0;
@@ -15,6 +15,7 @@
 #include "MOV_util.hh"
 
 #include "ffmpeg_swscale.hh"
+#include "movie_keyframe_index.hh"
 #include "movie_util.hh"
 
 #ifdef WITH_FFMPEG
@@ -527,6 +528,7 @@ void MOV_exit()
 {
 #ifdef WITH_FFMPEG
   ffmpeg_sws_exit();
+  movie_keyframe_index_exit();
 #endif
 }
 
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <memory>
+
 namespace blender::ocio {
 
 class PackedImage;
@@ -46,4 +48,13 @@ class CPUProcessor {
   virtual void apply_predivide(const PackedImage &image) const = 0;
 };
 
+/**
+ * Create a processor which approximates the given one with a baked 3D lookup table. Applying it is
+ * fast regardless of the complexity of the given processor, but it is only accurate enough for
+ * 8-bit display output of scene linear colors. The given processor is kept for the values and
+ * images that the table does not cover.
+ */
+std::unique_ptr<CPUProcessor> create_baked_cpu_processor(
+    std::shared_ptr<const CPUProcessor> processor);
+
 }  // namespace blender::ocio
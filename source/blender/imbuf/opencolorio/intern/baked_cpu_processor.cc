@@ -0,0 +1,259 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "baked_cpu_processor.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "BLI_assert.h"
+#include "BLI_index_range.hh"
+#include "BLI_task.hh"
+#include "BLI_utildefines.h"
+
+#include "OCIO_packed_image.hh"
+
+namespace blender::ocio {
+
+/* -------------------------------------------------------------------- */
+/** \name Shaper
+ *
+ * The bit pattern of a positive float is a piecewise linear approximation of its logarithm, which
+ * is cheap to compute and exactly invertible. The first node of the table is zero, and the other
+ * nodes are evenly spaced in bit patterns between the minimum and maximum exponents.
+ * \{ */
+
+static constexpr int size = BakedCPUProcessor::size;
+static constexpr int32_t min_bits = (127 + BakedCPUProcessor::min_exponent) << 23;
+static constexpr int32_t max_bits = (127 + BakedCPUProcessor::max_exponent) << 23;
+/* Largest value covered by the table, which has the bit pattern of the last node. */
+static constexpr float max_value = float(1 << BakedCPUProcessor::max_exponent);
+
+static constexpr int octaves = BakedCPUProcessor::max_exponent -
+                               BakedCPUProcessor::min_exponent;
+static_assert((size - 2) % octaves == 0, "Octave boundaries must fall on nodes");
+
+static float int_as_float(const int32_t value)
+{
+  float result;
+  memcpy(&result, &value, sizeof(value));
+  return result;
+}
+
+static int32_t float_as_int(const float value)
+{
+  int32_t result;
+  memcpy(&result, &value, sizeof(value));
+  return result;
+}
+
+static float shaper_node_value(const int node)
+{
+  if (node == 0) {
+    return 0.0f;
+  }
+  const double bits = double(node - 1) * double(max_bits - min_bits) / double(size - 2);
+  return int_as_float(min_bits + int32_t(std::lround(bits)));
+}
+
+/* Position of the given value in the table, in units of nodes. The value must not be negative. */
+static float shaper_position(const float value)
+{
+  if (value == 0.0f) {
+    return 0.0f;
+  }
+
+  const int32_t bits = float_as_int(value);
+  if (bits < min_bits) {
+    return value / int_as_float(min_bits);
+  }
+
+  const float nodes_per_bit = float(size - 2) / float(max_bits - min_bits);
+  return std::min(1.0f + float(bits - min_bits) * nodes_per_bit, float(size - 1));
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Baked CPU Processor
+ * \{ */
+
+BakedCPUProcessor::BakedCPUProcessor(std::shared_ptr<const CPUProcessor> processor)
+    : processor_(std::move(processor)),
+      table_(size * size * size),
+      is_noop_(processor_->is_noop())
+{
+  float node_values[size];
+  for (const int i : IndexRange(size)) {
+    node_values[i] = shaper_node_value(i);
+  }
+
+  /* Apply the processor on one slice of the table at a time, where red changes fastest. */
+  threading::parallel_for(IndexRange(size), 1, [&](const IndexRange range) {
+    for (const int b : range) {
+      float3 *slice = table_.data() + int64_t(b) * size * size;
+      for (const int g : IndexRange(size)) {
+        for (const int r : IndexRange(size)) {
+          slice[g * size + r] = float3(node_values[r], node_values[g], node_values[b]);
+        }
+      }
+
+      const PackedImage image(slice,
+                              size,
+                              size,
+                              3,
+                              BitDepth::BIT_DEPTH_F32,
+                              sizeof(float),
+                              sizeof(float3),
+                              sizeof(float3) * size);
+      processor_->apply(image);
+    }
+  });
+}
+
+bool BakedCPUProcessor::is_noop() const
+{
+  return is_noop_;
+}
+
+/* Tetrahedral interpolation of the table, which only needs four of the eight corners of the cell
+ * and preserves the neutral axis better than trilinear interpolation. */
+float3 BakedCPUProcessor::lookup(const float3 &color) const
+{
+  const float3 position(
+      shaper_position(color.x), shaper_position(color.y), shaper_position(color.z));
+
+  const int r = std::min(int(position.x), size - 2);
+  const int g = std::min(int(position.y), size - 2);
+  const int b = std::min(int(position.z), size - 2);
+  const float fr = position.x - float(r);
+  const float fg = position.y - float(g);
+  const float fb = position.z - float(b);
+
+  const float3 *cell = table_.data() + (int64_t(b) * size + g) * size + r;
+  const int64_t stride_r = 1;
+  const int64_t stride_g = size;
+  const int64_t stride_b = int64_t(size) * size;
+
+  const float3 &c000 = cell[0];
+  const float3 &c111 = cell[stride_r + stride_g + stride_b];
+
+  if (fr > fg) {
+    if (fg > fb) {
+      return (1.0f - fr) * c000 + (fr - fg) * cell[stride_r] +
+             (fg - fb) * cell[stride_r + stride_g] + fb * c111;
+    }
+    if (fr > fb) {
+      return (1.0f - fr) * c000 + (fr - fb) * cell[stride_r] +
+             (fb - fg) * cell[stride_r + stride_b] + fg * c111;
+    }
+    return (1.0f - fb) * c000 + (fb - fr) * cell[stride_b] +
+           (fr - fg) * cell[stride_r + stride_b] + fg * c111;
+  }
+
+  if (fb > fg) {
+    return (1.0f - fb) * c000 + (fb - fg) * cell[stride_b] +
+           (fg - fr) * cell[stride_g + stride_b] + fr * c111;
+  }
+  if (fb > fr) {
+    return (1.0f - fg) * c000 + (fg - fb) * cell[stride_g] +
+           (fb - fr) * cell[stride_g + stride_b] + fr * c111;
+  }
+  return (1.0f - fg) * c000 + (fg - fr) * cell[stride_g] + (fr - fb) * cell[stride_r + stride_g] +
+         fb * c111;
+}
+
+void BakedCPUProcessor::apply_rgb(float rgb[3]) const
+{
+  /* Negative, NaN and too large values are outside of the table. */
+  if (!(rgb[0] >= 0.0f && rgb[1] >= 0.0f && rgb[2] >= 0.0f && rgb[0] <= max_value &&
+        rgb[1] <= max_value && rgb[2] <= max_value))
+  {
+    processor_->apply_rgb(rgb);
+    return;
+  }
+
+  const float3 result = this->lookup(float3(rgb));
+  rgb[0] = result.x;
+  rgb[1] = result.y;
+  rgb[2] = result.z;
+}
+
+void BakedCPUProcessor::apply_rgba(float rgba[4]) const
+{
+  this->apply_rgb(rgba);
+}
+
+void BakedCPUProcessor::apply_rgba_predivide(float rgba[4]) const
+{
+  if (ELEM(rgba[3], 1.0f, 0.0f)) {
+    this->apply_rgb(rgba);
+    return;
+  }
+
+  const float alpha = rgba[3];
+  const float inv_alpha = 1.0f / alpha;
+
+  rgba[0] *= inv_alpha;
+  rgba[1] *= inv_alpha;
+  rgba[2] *= inv_alpha;
+
+  this->apply_rgb(rgba);
+
+  rgba[0] *= alpha;
+  rgba[1] *= alpha;
+  rgba[2] *= alpha;
+}
+
+template<typename Function>
+static void foreach_pixel(const PackedImage &image, const Function &function)
+{
+  BLI_assert(image.get_chan_stride_in_bytes() == sizeof(float));
+
+  uint8_t *data = static_cast<uint8_t *>(image.get_data());
+  const size_t x_stride = image.get_x_stride_in_bytes();
+  const size_t y_stride = image.get_y_stride_in_bytes();
+  for (size_t y = 0; y < image.get_height(); y++) {
+    for (size_t x = 0; x < image.get_width(); x++) {
+      function(reinterpret_cast<float *>(data + y * y_stride + x * x_stride));
+    }
+  }
+}
+
+void BakedCPUProcessor::apply(const PackedImage &image) const
+{
+  if (image.get_bit_depth() != BitDepth::BIT_DEPTH_F32 || image.get_num_channels() < 3) {
+    processor_->apply(image);
+    return;
+  }
+
+  foreach_pixel(image, [&](float *pixel) { this->apply_rgb(pixel); });
+}
+
+void BakedCPUProcessor::apply_predivide(const PackedImage &image) const
+{
+  if (image.get_num_channels() < 4) {
+    this->apply(image);
+    return;
+  }
+
+  if (image.get_bit_depth() != BitDepth::BIT_DEPTH_F32) {
+    processor_->apply_predivide(image);
+    return;
+  }
+
+  foreach_pixel(image, [&](float *pixel) { this->apply_rgba_predivide(pixel); });
+}
+
+/** \} */
+
+std::unique_ptr<CPUProcessor> create_baked_cpu_processor(
+    std::shared_ptr<const CPUProcessor> processor)
+{
+  return std::make_unique<BakedCPUProcessor>(std::move(processor));
+}
+
+}  // namespace blender::ocio
@@ -0,0 +1,72 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include <memory>
+
+#include "BLI_array.hh"
+#include "BLI_math_vector_types.hh"
+
+#include "MEM_guardedalloc.h"
+
+#include "OCIO_cpu_processor.hh"
+
+namespace blender::ocio {
+
+/**
+ * CPU processor which approximates another processor with a 3D lookup table, sampled once on
+ * construction and applied with tetrahedral interpolation. The cost of applying it does not
+ * depend on the complexity of the original processor, which makes it much faster for view
+ * transforms like Filmic and AgX, at the cost of a small error.
+ *
+ * The table covers scene linear values in a logarithmic-like shaper space, which is the bit
+ * pattern of the floating point value. Values below the range of the shaper are interpolated
+ * linearly towards zero. For typical display transforms, the result differs from the original
+ * processor by less than one 8-bit level.
+ *
+ * Pixels with negative, NaN or values above the range of the table, which some view transforms
+ * like AgX map to visible colors, and images that are not 32-bit float are processed by the
+ * original processor instead.
+ *
+ * The alpha channel is passed through unchanged, which matches display and color space
+ * transforms.
+ */
+class BakedCPUProcessor : public CPUProcessor {
+ public:
+  /** Number of nodes along each axis of the table. */
+  static constexpr int size = 65;
+
+  /**
+   * Range of values of the shaper in powers of two, which is the range of the table. There is a
+   * whole number of nodes per octave, such that the boundaries of octaves, where the shaper is
+   * not smooth, fall on nodes.
+   */
+  static constexpr int min_exponent = -12;
+  static constexpr int max_exponent = 9;
+
+ private:
+  std::shared_ptr<const CPUProcessor> processor_;
+  Array<float3> table_;
+  bool is_noop_;
+
+  float3 lookup(const float3 &color) const;
+
+ public:
+  explicit BakedCPUProcessor(std::shared_ptr<const CPUProcessor> processor);
+
+  bool is_noop() const override;
+
+  void apply_rgb(float rgb[3]) const override;
+  void apply_rgba(float rgba[4]) const override;
+
+  void apply_rgba_predivide(float rgba[4]) const override;
+
+  void apply(const PackedImage &image) const override;
+  void apply_predivide(const PackedImage &image) const override;
+
+  MEM_CXX_CLASS_ALLOC_FUNCS("BakedCPUProcessor");
+};
+
+}  // namespace blender::ocio
@@ -0,0 +1,105 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <memory>
+
+#include "baked_cpu_processor.hh"
+
+#include "BLI_array.hh"
+#include "BLI_math_base.hh"
+#include "BLI_math_vector_types.hh"
+
+#include "OCIO_packed_image.hh"
+
+#include "fallback/fallback_cpu_processor.hh"
+
+#include "testing/testing.h"
+
+namespace blender::ocio {
+
+/* The error of the table is less than one 8-bit level in display space. */
+static constexpr float display_epsilon = 1.0f / 255.0f;
+
+static float3 clamp_display(const float3 &color)
+{
+  return math::clamp(color, float3(0.0f), float3(1.0f));
+}
+
+TEST(ocio_baked_cpu_processor, linear_to_srgb)
+{
+  const auto processor_ptr = std::make_shared<FallbackLinearRGBToSRGBCPUProcessor>();
+  const FallbackLinearRGBToSRGBCPUProcessor &processor = *processor_ptr;
+  const BakedCPUProcessor baked_processor(processor_ptr);
+
+  EXPECT_FALSE(baked_processor.is_noop());
+
+  /* Combinations of values spanning the whole range of the table, including values that are not
+   * on the nodes of the table, and the same values for all channels. */
+  const float values[] = {0.0f, 1e-5f, 0.002f, 0.01f, 0.05f, 0.18f, 0.3f, 0.6f, 0.97f, 1.0f, 4.0f};
+  for (const float r : values) {
+    for (const float g : values) {
+      for (const float b : values) {
+        float3 expected(r, g, b);
+        processor.apply_rgb(expected);
+        float3 result(r, g, b);
+        baked_processor.apply_rgb(result);
+        EXPECT_V3_NEAR(clamp_display(result), clamp_display(expected), display_epsilon);
+      }
+    }
+  }
+}
+
+TEST(ocio_baked_cpu_processor, out_of_range)
+{
+  const auto processor_ptr = std::make_shared<FallbackLinearRGBToSRGBCPUProcessor>();
+  const FallbackLinearRGBToSRGBCPUProcessor &processor = *processor_ptr;
+  const BakedCPUProcessor baked_processor(processor_ptr);
+
+  /* Negative values are processed exactly, view transforms may map them to visible colors. */
+  float3 negative(-1.0f, -0.5f, 0.25f);
+  float3 expected_negative = negative;
+  processor.apply_rgb(expected_negative);
+  baked_processor.apply_rgb(negative);
+  EXPECT_V3_NEAR(negative, expected_negative, 1e-6f);
+
+  /* Values above the range of the table are processed exactly, instead of being clamped. */
+  float3 large(1e6f, 1000.0f, 0.5f);
+  float3 expected_large = large;
+  processor.apply_rgb(expected_large);
+  baked_processor.apply_rgb(large);
+  EXPECT_V3_NEAR(large, expected_large, 1e-6f);
+}
+
+TEST(ocio_baked_cpu_processor, apply_image_predivide)
+{
+  const auto processor_ptr = std::make_shared<FallbackLinearRGBToSRGBCPUProcessor>();
+  const FallbackLinearRGBToSRGBCPUProcessor &processor = *processor_ptr;
+  const BakedCPUProcessor baked_processor(processor_ptr);
+
+  Array<float4> pixels = {float4(0.25f, 0.1f, 0.05f, 0.5f),
+                          float4(0.18f, 0.18f, 0.18f, 1.0f),
+                          float4(0.0f, 0.0f, 0.0f, 0.0f)};
+  Array<float4> expected = pixels;
+  for (float4 &pixel : expected) {
+    processor.apply_rgba_predivide(pixel);
+  }
+
+  const PackedImage image(pixels.data(),
+                          pixels.size(),
+                          1,
+                          4,
+                          BitDepth::BIT_DEPTH_F32,
+                          sizeof(float),
+                          sizeof(float4),
+                          sizeof(float4) * pixels.size());
+  baked_processor.apply_predivide(image);
+
+  for (const int i : pixels.index_range()) {
+    EXPECT_V4_NEAR(pixels[i], expected[i], display_epsilon);
+    /* Alpha is passed through. */
+    EXPECT_EQ(pixels[i].w, expected[i].w);
+  }
+}
+
+}  // namespace blender::ocio
@@ -0,0 +1,189 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BLI_array.hh"
+#include "BLI_math_color.h"
+#include "BLI_math_vector.h"
+#include "BLI_rand.hh"
+#include "BLI_timeit.hh"
+
+#include "IMB_imbuf.hh"
+#include "IMB_imbuf_types.hh"
+
+namespace blender::imbuf::tests {
+
+/* Odd size, such that rows don't end on a multiple of the number of pixels that are processed
+ * together by the vectorized code. */
+static constexpr int width = 67;
+static constexpr int height = 5;
+
+static Array<float> create_test_pixels(const int channels)
+{
+  RandomNumberGenerator rng(42);
+  Array<float> pixels(channels * width * height);
+  for (float &value : pixels) {
+    /* Include values outside of the displayable range. */
+    value = rng.get_float() * 1.5f - 0.2f;
+  }
+
+  /* Include the special cases of alpha. */
+  if (channels == 4) {
+    for (int i = 0; i < width * height; i += 3) {
+      pixels[i * 4 + 3] = (i % 2) ? 0.0f : 1.0f;
+    }
+  }
+  return pixels;
+}
+
+/* Per pixel conversion with the scalar functions, which the vectorized code must match. */
+static void reference_byte_from_float(uchar *to,
+                                      const float *from,
+                                      const int channels,
+                                      const float dither,
+                                      const bool predivide,
+                                      const int start_y)
+{
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++, from += channels, to += 4) {
+      float pixel[4] = {from[0], from[1], from[2], 1.0f};
+      if (channels == 4) {
+        if (predivide) {
+          premul_to_straight_v4_v4(pixel, from);
+        }
+        else {
+          copy_v4_v4(pixel, from);
+        }
+      }
+
+      if (dither != 0.0f) {
+        const float dither_value = dither_random_value(x, y + start_y) * 0.0033f * dither;
+        pixel[0] += dither_value;
+        pixel[1] += dither_value;
+        pixel[2] += dither_value;
+      }
+
+      rgba_float_to_uchar(to, pixel);
+    }
+  }
+}
+
+static void test_byte_from_float(const int channels, const float dither, const bool predivide)
+{
+  const int start_y = 11;
+  const Array<float> pixels = create_test_pixels(channels);
+
+  Array<uchar> result(4 * width * height);
+  IMB_buffer_byte_from_float(result.data(),
+                             pixels.data(),
+                             channels,
+                             dither,
+                             IB_PROFILE_SRGB,
+                             IB_PROFILE_SRGB,
+                             predivide,
+                             width,
+                             height,
+                             width,
+                             width,
+                             start_y);
+
+  Array<uchar> expected(4 * width * height);
+  reference_byte_from_float(expected.data(), pixels.data(), channels, dither, predivide, start_y);
+
+  for (const int i : result.index_range()) {
+    EXPECT_EQ(result[i], expected[i]) << "at pixel " << i / 4 << ", channel " << i % 4;
+  }
+}
+
+TEST(imbuf_conversion, byte_from_float_rgba)
+{
+  test_byte_from_float(4, 0.0f, false);
+}
+
+TEST(imbuf_conversion, byte_from_float_rgba_predivide)
+{
+  test_byte_from_float(4, 0.0f, true);
+}
+
+TEST(imbuf_conversion, byte_from_float_rgba_dither)
+{
+  test_byte_from_float(4, 1.0f, false);
+}
+
+TEST(imbuf_conversion, byte_from_float_rgba_dither_predivide)
+{
+  test_byte_from_float(4, 0.5f, true);
+}
+
+TEST(imbuf_conversion, byte_from_float_rgb)
+{
+  test_byte_from_float(3, 0.0f, false);
+}
+
+/**
+ * Set this to 1 to compare the performance of the conversion to the scalar functions, for an 8K
+ * image. It is disabled by default, because it prints a lot and takes a while.
+ */
+#if 0
+TEST(imbuf_conversion, byte_from_float_benchmark)
+{
+  const int benchmark_width = 7680;
+  const int benchmark_height = 4320;
+  const size_t pixels_num = size_t(benchmark_width) * benchmark_height;
+
+  RandomNumberGenerator rng(42);
+  Array<float> pixels(pixels_num * 4);
+  for (float &value : pixels) {
+    value = rng.get_float();
+  }
+  Array<uchar> result(pixels_num * 4);
+
+  for (const float dither : {0.0f, 1.0f}) {
+    for (const bool predivide : {false, true}) {
+      const std::string name = std::string("dither ") + (dither ? "on" : "off") + ", predivide " +
+                               (predivide ? "on" : "off");
+      {
+        SCOPED_TIMER("Scalar, " + name);
+        const float *from = pixels.data();
+        uchar *to = result.data();
+        for (int y = 0; y < benchmark_height; y++) {
+          for (int x = 0; x < benchmark_width; x++, from += 4, to += 4) {
+            float pixel[4];
+            if (predivide) {
+              premul_to_straight_v4_v4(pixel, from);
+            }
+            else {
+              copy_v4_v4(pixel, from);
+            }
+            if (dither != 0.0f) {
+              const float dither_value = dither_random_value(x, y) * 0.0033f * dither;
+              pixel[0] += dither_value;
+              pixel[1] += dither_value;
+              pixel[2] += dither_value;
+            }
+            rgba_float_to_uchar(to, pixel);
+          }
+        }
+      }
+      {
+        SCOPED_TIMER("IMB_buffer_byte_from_float, " + name);
+        IMB_buffer_byte_from_float(result.data(),
+                                   pixels.data(),
+                                   4,
+                                   dither,
+                                   IB_PROFILE_SRGB,
+                                   IB_PROFILE_SRGB,
+                                   predivide,
+                                   benchmark_width,
+                                   benchmark_height,
+                                   benchmark_width,
+                                   benchmark_width);
+      }
+    }
+  }
+}
+#endif
+
+}  // namespace blender::imbuf::tests
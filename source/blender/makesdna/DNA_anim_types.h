@@ -22,6 +22,15 @@
 #  include <type_traits>
 #endif
 
+#ifdef __cplusplus
+namespace blender::bke {
+struct AnimRNAPathCache;
+}
+using AnimRNAPathCacheHandle = blender::bke::AnimRNAPathCache;
+#else
+typedef struct AnimRNAPathCacheHandle AnimRNAPathCacheHandle;
+#endif
+
 /* ************************************************ */
 /* F-Curve DataTypes */
 
@@ -296,6 +305,9 @@ typedef struct ChannelDriver {
   /** Compiled simple arithmetic expression. */
   struct ExprPyLike_Parsed *expr_simple;
 
+  /** Runtime cache of the resolved target paths, only used on evaluated copies. */
+  AnimRNAPathCacheHandle *rna_path_cache;
+
   /** Result of previous evaluation. */
   float curval;
   /* XXX to be implemented... this is like the constraint influence setting. */
@@ -713,6 +725,8 @@ typedef struct AnimData {
 
   /** Runtime data, for depsgraph evaluation. */
   FCurve **driver_array;
+  /** Runtime cache of the paths resolved by the active action, only used on evaluated copies. */
+  AnimRNAPathCacheHandle *rna_path_cache;
 
   /* settings for animation evaluation */
   /** User-defined settings. */
@@ -18,6 +18,15 @@
 struct AnimData;
 struct Ipo;
 
+#ifdef __cplusplus
+namespace blender::bke {
+struct KeyRuntime;
+}  // namespace blender::bke
+using KeyRuntimeHandle = blender::bke::KeyRuntime;
+#else
+typedef struct KeyRuntimeHandle KeyRuntimeHandle;
+#endif
+
 /**
  * The struct that holds the data for an individual Shape Key. Depending on which object owns the
  * `Key`, the contained data type can vary (see `void *data;`).
@@ -112,6 +121,10 @@ typedef struct Key {
    * current free UID for key-blocks.
    */
   int uidgen;
+
+  /** Runtime data, allocated for every key. Its evaluation caches are only built for evaluated
+   * copies. */
+  KeyRuntimeHandle *runtime;
 } Key;
 
 /* **************** KEY ********************* */
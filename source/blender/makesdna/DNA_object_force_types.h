@@ -334,6 +334,11 @@ enum {
   PFIELD_CLOTH_USE_CULLING = 1 << 19,
   /** Replace collision direction with collider normal. */
   PFIELD_CLOTH_USE_NORMAL = 1 << 20,
+  /**
+   * Draw the noise of all points from one random sequence, which depends on the order of
+   * evaluation. Set for files from before the noise was seeded per point.
+   */
+  PFIELD_LEGACY_NOISE = 1 << 21,
 };
 
 /** #PartDeflect::falloff */
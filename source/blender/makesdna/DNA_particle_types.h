@@ -510,6 +510,11 @@ enum {
   // PART_BRANCHING = 1 << 20,
   // PART_ANIM_BRANCHING = 1 << 21,
   PART_SELF_EFFECT = 1 << 22,
+  /**
+   * Integrate particles and boids serially with one random sequence, and search neighbors with
+   * trees. Set for files from before parallel dynamics, to keep their results.
+   */
+  PART_LEGACY_DYNAMICS = 1 << 23,
 
   PART_GRID_HEXAGONAL = 1 << 24,
   PART_GRID_INVERT = 1 << 26,
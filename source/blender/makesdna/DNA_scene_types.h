@@ -940,7 +940,8 @@ typedef struct RenderData {
   int compositor_denoise_preview_quality; /* eCompositorDenoiseQaulity */
   int compositor_denoise_final_quality;   /* eCompositorDenoiseQaulity */
 
-  char _pad6[4];
+  /** Maximum memory in megabytes used by the results of the CPU compositor, zero for no limit. */
+  int compositor_memory_limit;
 } RenderData;
 
 /** #RenderData::quality_flag */
@@ -2697,6 +2698,11 @@ typedef enum eSculptFlags {
   SCULPT_DYNTOPO_DETAIL_BRUSH = (1 << 14),
   /* unused = (1 << 15), */
   SCULPT_DYNTOPO_DETAIL_MANUAL = (1 << 16),
+  /**
+   * If set, dynamic-topology refinement processes separate parts of the mesh on multiple threads.
+   * The resulting topology can differ between otherwise identical strokes.
+   */
+  SCULPT_DYNTOPO_PARALLEL = (1 << 17),
 } eSculptFlags;
 
 /** #Sculpt::transform_mode */
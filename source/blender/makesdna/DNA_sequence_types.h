@@ -28,30 +28,36 @@ struct bSound;
 
 #ifdef __cplusplus
 namespace blender::seq {
+struct DiskImageCache;
 struct FinalImageCache;
 struct IntraFrameCache;
 struct MediaPresence;
 struct ThumbnailCache;
 struct TextVarsRuntime;
 struct PrefetchJob;
+struct RenderStatisticsStorage;
 struct SourceImageCache;
 struct StripLookup;
 }  // namespace blender::seq
+using DiskImageCache = blender::seq::DiskImageCache;
 using FinalImageCache = blender::seq::FinalImageCache;
 using IntraFrameCache = blender::seq::IntraFrameCache;
 using MediaPresence = blender::seq::MediaPresence;
 using ThumbnailCache = blender::seq::ThumbnailCache;
 using TextVarsRuntime = blender::seq::TextVarsRuntime;
 using PrefetchJob = blender::seq::PrefetchJob;
+using RenderStatisticsStorage = blender::seq::RenderStatisticsStorage;
 using SourceImageCache = blender::seq::SourceImageCache;
 using StripLookup = blender::seq::StripLookup;
 #else
+typedef struct DiskImageCache DiskImageCache;
 typedef struct FinalImageCache FinalImageCache;
 typedef struct IntraFrameCache IntraFrameCache;
 typedef struct MediaPresence MediaPresence;
 typedef struct ThumbnailCache ThumbnailCache;
 typedef struct TextVarsRuntime TextVarsRuntime;
 typedef struct PrefetchJob PrefetchJob;
+typedef struct RenderStatisticsStorage RenderStatisticsStorage;
 typedef struct SourceImageCache SourceImageCache;
 typedef struct StripLookup StripLookup;
 #endif
@@ -330,6 +336,8 @@ typedef struct EditingRuntime {
   IntraFrameCache *intra_frame_cache;
   SourceImageCache *source_image_cache;
   FinalImageCache *final_image_cache;
+  DiskImageCache *disk_image_cache;
+  RenderStatisticsStorage *render_statistics;
 } EditingRuntime;
 
 typedef struct Editing {
@@ -353,6 +361,8 @@ typedef struct Editing {
 
   int show_missing_media_flag; /* eEditingShowMissingMediaFlag */
   int cache_flag;              /* eEditingCacheFlag */
+  int render_flag;             /* eEditingRenderFlag */
+  char _pad1[4];
 
   PrefetchJob *prefetch_job;
 
@@ -899,8 +909,16 @@ typedef enum eEditingCacheFlag {
 
   SEQ_CACHE_PREFETCH_ENABLE = (1 << 10),
   SEQ_CACHE_UNUSED_11 = (1 << 11), /* Was SEQ_CACHE_DISK_CACHE_ENABLE */
+  /** Store raw and final images on disk too, see #UserDef.sequencer_disk_cache_dir. */
+  SEQ_CACHE_USE_DISK = (1 << 12),
 } eEditingCacheFlag;
 
+/** #Editing.render_flag */
+typedef enum eEditingRenderFlag {
+  /** Render the images of independent strips of a frame in parallel before blending them. */
+  SEQ_RENDER_PARALLEL_STRIPS = (1 << 0),
+} eEditingRenderFlag;
+
 /** #Strip.color_tag. */
 typedef enum StripColorTag {
   STRIP_COLOR_NONE = -1,
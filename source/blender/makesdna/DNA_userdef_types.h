@@ -291,6 +291,8 @@ typedef struct UserDef {
   char renderdir[/*FILE_MAX*/ 1024];
   /* EXR cache path */
   char render_cachedir[/*FILE_MAXDIR*/ 768];
+  /** Sequencer disk cache path, the user cache directory is used when empty. */
+  char sequencer_disk_cache_dir[/*FILE_MAXDIR*/ 768];
   char textudir[/*FILE_MAXDIR*/ 768];
   /* Deprecated, use #UserDef.script_directories instead. */
   char pythondir_legacy[/*FILE_MAXDIR*/ 768] DNA_DEPRECATED;
@@ -438,7 +440,11 @@ typedef struct UserDef {
   short gp_manhattandist, gp_euclideandist, gp_eraser;
   /** #eGP_UserdefSettings. */
   short gp_settings;
-  char _pad13[4];
+  /**
+   * Memory used by sculpt undo steps in megabytes, above which the oldest steps are written to a
+   * temporary file, zero to keep them in memory.
+   */
+  int sculpt_undo_memory;
   struct SolidLight light_param[4];
   float light_ambient[3];
   char gizmo_flag;
@@ -599,7 +605,8 @@ typedef struct UserDef {
   char filebrowser_display_type; /* eUserpref_TempSpaceDisplayType */
 
   short sequencer_proxy_setup; /* eUserpref_SeqProxySetup */
-  short _pad1;
+  /** Size limit of the sequencer disk cache in gigabytes, zero for no limit. */
+  short sequencer_disk_cache_size_limit;
 
   float collection_instance_empty_size;
   char text_flag;
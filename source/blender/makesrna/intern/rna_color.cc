@@ -1380,6 +1380,15 @@ static void rna_def_colormanage(BlenderRNA *brna)
                            "(automatically converted to/from temperature and tint)");
   RNA_def_property_update(prop, NC_WINDOW, "rna_ColorManagement_update");
 
+  prop = RNA_def_property(srna, "use_baked_display_transform", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, nullptr, "flag", COLORMANAGE_VIEW_USE_BAKED_DISPLAY);
+  RNA_def_property_ui_text(prop,
+                           "Approximate Display Transform",
+                           "Display large float images with the view transform baked into a "
+                           "lookup table, which is much faster for complex view transforms like "
+                           "'AgX', at the cost of a small error. Saved images are not affected");
+  RNA_def_property_update(prop, NC_WINDOW, "rna_ColorManagement_update");
+
   prop = RNA_def_property(srna, "use_hdr_view", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, nullptr, "flag", COLORMANAGE_VIEW_USE_HDR);
   RNA_def_property_ui_text(
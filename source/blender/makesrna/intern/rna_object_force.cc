@@ -1667,6 +1667,15 @@ static void rna_def_field(BlenderRNA *brna)
   RNA_def_property_ui_text(prop, "Seed", "Seed of the noise");
   RNA_def_property_update(prop, 0, "rna_FieldSettings_update");
 
+  prop = RNA_def_property(srna, "use_legacy_noise", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, nullptr, "flag", PFIELD_LEGACY_NOISE);
+  RNA_def_property_ui_text(
+      prop,
+      "Legacy Noise",
+      "Draw the noise of all affected points from a single random sequence, to keep the results "
+      "of files created before the noise was generated per point");
+  RNA_def_property_update(prop, 0, "rna_FieldSettings_update");
+
   /* Boolean */
 
   prop = RNA_def_property(srna, "use_min_distance", PROP_BOOLEAN, PROP_NONE);
@@ -2638,6 +2638,15 @@ static void rna_def_particle_settings(BlenderRNA *brna)
   RNA_def_property_ui_text(prop, "Self Effect", "Particle effectors affect themselves");
   RNA_def_property_update(prop, 0, "rna_Particle_reset");
 
+  prop = RNA_def_property(srna, "use_legacy_dynamics", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, nullptr, "flag", PART_LEGACY_DYNAMICS);
+  RNA_def_property_ui_text(
+      prop,
+      "Legacy Dynamics",
+      "Simulate particles one after the other with a single random sequence, to keep the results "
+      "of files created before the simulation was multi-threaded");
+  RNA_def_property_update(prop, 0, "rna_Particle_reset");
+
   prop = RNA_def_property(srna, "type", PROP_ENUM, PROP_NONE);
   RNA_def_property_enum_items(prop, part_type_items);
   RNA_def_property_clear_flag(prop, PROP_ANIMATABLE);
@@ -1176,6 +1176,15 @@ static void rna_def_sculpt(BlenderRNA *brna)
       prop, "Detail Refine Method", "In dynamic-topology mode, how to add or remove mesh detail");
   RNA_def_property_update(prop, NC_SCENE | ND_TOOLSETTINGS, nullptr);
 
+  prop = RNA_def_property(srna, "use_parallel_refine", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, nullptr, "flags", SCULPT_DYNTOPO_PARALLEL);
+  RNA_def_property_ui_text(prop,
+                           "Parallel Refine",
+                           "Add and remove mesh detail in separate parts of the mesh on multiple "
+                           "threads. Faster with high detail, but the resulting topology can "
+                           "differ between strokes");
+  RNA_def_property_update(prop, NC_SCENE | ND_TOOLSETTINGS, nullptr);
+
   prop = RNA_def_property(srna, "detail_type_method", PROP_ENUM, PROP_NONE);
   RNA_def_property_enum_bitflag_sdna(prop, nullptr, "flags");
   RNA_def_property_enum_items(prop, detail_type_items);
@@ -2569,6 +2569,14 @@ static void rna_def_editor(BlenderRNA *brna)
   RNA_def_property_update(
       prop, NC_SPACE | ND_SPACE_SEQUENCER, "rna_SequenceEditor_cache_settings_changed");
 
+  prop = RNA_def_property(srna, "use_cache_disk", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, nullptr, "cache_flag", SEQ_CACHE_USE_DISK);
+  RNA_def_property_ui_text(prop,
+                           "Disk Cache",
+                           "Also store cached raw and final images on disk, such that they are "
+                           "reused after reloading the file, see the Video Sequencer preferences");
+  RNA_def_property_update(prop, NC_SPACE | ND_SPACE_SEQUENCER, nullptr);
+
   prop = RNA_def_property(srna, "use_prefetch", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, nullptr, "cache_flag", SEQ_CACHE_PREFETCH_ENABLE);
   RNA_def_property_ui_text(
@@ -2577,6 +2585,14 @@ static void rna_def_editor(BlenderRNA *brna)
       "Render frames ahead of current frame in the background for faster playback");
   RNA_def_property_update(prop, NC_SCENE | ND_SEQUENCER, nullptr);
 
+  prop = RNA_def_property(srna, "use_parallel_strip_render", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, nullptr, "render_flag", SEQ_RENDER_PARALLEL_STRIPS);
+  RNA_def_property_ui_text(prop,
+                           "Parallel Strip Rendering",
+                           "Decode and transform the images of stacked strips in parallel, for "
+                           "faster playback of frames with many strips");
+  RNA_def_property_update(prop, NC_SCENE | ND_SEQUENCER, nullptr);
+
   prop = RNA_def_property(srna, "cache_raw_size", PROP_INT, PROP_NONE);
   RNA_def_property_clear_flag(prop, PROP_EDITABLE | PROP_ANIMATABLE);
   RNA_def_property_int_funcs(prop, "rna_SequenceEditor_get_cache_raw_size", nullptr, nullptr);
@@ -153,6 +153,13 @@ struct RenderResult {
   struct StampData *stamp_data;
 
   bool passes_allocated;
+
+  /* Handle of the multi-layer EXR file the passes are read from the first time they are
+   * accessed, see #RE_RenderPassEnsureLoaded. Null when all passes were read on creation. */
+  void *exrhandle;
+  /* Color-space of the color passes in the file, and whether to pre-divide them on reading. */
+  char exr_colorspace[64];
+  bool exr_predivide;
 };
 
 struct RenderStats {
@@ -415,8 +422,19 @@ void RE_PreviewRender(struct Render *re, struct Main *bmain, struct Scene *scene
  */
 bool RE_ReadRenderResult(struct Scene *scene, struct Scene *scenode);
 
-struct RenderResult *RE_MultilayerConvert(
-    void *exrhandle, const char *colorspace, bool predivide, int rectx, int recty);
+/**
+ * Convert a multi-layer EXR handle to a render result.
+ *
+ * \param read_passes: Read the pixels of all passes, after which the handle can be closed.
+ * Otherwise the render result takes ownership of the handle, and every pass is read the first
+ * time it is accessed through #RE_RenderPassEnsureLoaded.
+ */
+struct RenderResult *RE_MultilayerConvert(void *exrhandle,
+                                          const char *colorspace,
+                                          bool predivide,
+                                          int rectx,
+                                          int recty,
+                                          bool read_passes);
 
 /* Display and event callbacks. */
 
@@ -530,6 +548,14 @@ struct RenderView *RE_RenderViewGetByName(struct RenderResult *rr, const char *v
 RenderResult *RE_DuplicateRenderResult(RenderResult *rr);
 
 struct ImBuf *RE_RenderPassEnsureImBuf(RenderPass *render_pass);
+
+/**
+ * Read the pixels of a pass of a render result that was converted from a multi-layer EXR file
+ * without reading its passes. Does nothing for passes that already have their pixels.
+ */
+void RE_RenderPassEnsureLoaded(RenderResult *render_result, RenderPass *render_pass);
+/** Read the pixels of all passes that were not accessed yet, see #RE_RenderPassEnsureLoaded. */
+void RE_RenderResultEnsurePassesLoaded(RenderResult *render_result);
 struct ImBuf *RE_RenderViewEnsureImBuf(const RenderResult *render_result, RenderView *render_view);
 
 /* Returns true if the pass is a color (as opposite of data) and needs to be color managed. */
@@ -7,11 +7,14 @@
 
 #include "BLI_listbase.h"
 #include "BLI_math_vector_types.hh"
+#include "BLI_mutex.hh"
 #include "BLI_threads.h"
 #include "BLI_vector.hh"
 
 #include "MEM_guardedalloc.h"
 
+#include "CLG_log.h"
+
 #include "BKE_cryptomatte.hh"
 #include "BKE_global.hh"
 #include "BKE_image.hh"
@@ -26,6 +29,7 @@
 #include "COM_context.hh"
 #include "COM_domain.hh"
 #include "COM_evaluator.hh"
+#include "COM_profiler.hh"
 #include "COM_render_context.hh"
 
 #include "RE_compositor.hh"
@@ -39,6 +43,8 @@
 
 #include "render_types.h"
 
+static CLG_LogRef LOG = {"compositor"};
+
 namespace blender::render {
 
 /**
@@ -94,6 +100,10 @@ class Context : public compositor::Context {
   Vector<blender::gpu::Texture *> cached_gpu_passes_;
   Vector<ImBuf *> cached_cpu_passes_;
 
+  /* Guards the output results and the cached passes above, since inputs and outputs might be
+   * requested concurrently by nodes in independent branches, see use_concurrent_evaluation. */
+  Mutex mutex_;
+
  public:
   Context(const ContextInputData &input_data)
       : compositor::Context(),
@@ -172,6 +182,8 @@ class Context : public compositor::Context {
 
   compositor::Result get_output() override
   {
+    std::scoped_lock lock(mutex_);
+
     const int2 render_size = get_render_size();
     if (output_result_.is_allocated()) {
       /* If the allocated result have the same size as the render size, return it as is. */
@@ -192,6 +204,8 @@ class Context : public compositor::Context {
                                        const bool is_data,
                                        compositor::ResultPrecision precision) override
   {
+    std::scoped_lock lock(mutex_);
+
     viewer_output_result_.set_transformation(domain.transformation);
     viewer_output_result_.meta_data.is_non_color_data = is_data;
 
@@ -264,6 +278,8 @@ class Context : public compositor::Context {
     compositor::Result pass = compositor::Result(
         *this, this->result_type_from_pass(render_pass), compositor::ResultPrecision::Full);
 
+    std::scoped_lock lock(mutex_);
+
     if (this->use_gpu()) {
       blender::gpu::Texture *pass_texture = RE_pass_ensure_gpu_texture_cache(render, render_pass);
       /* Don't assume render will keep pass data stored, add our own reference. */
@@ -531,6 +547,26 @@ class Context : public compositor::Context {
       GPU_finish();
     }
   }
+
+  bool use_node_result_cache() const override
+  {
+    /* Only interactive evaluations benefit from caching node results, since final renders evaluate
+     * the node tree once per frame and the frame number is part of the key of the results. */
+    return !this->use_gpu() && !this->render_context();
+  }
+
+  bool use_concurrent_evaluation() const override
+  {
+    return !this->use_gpu();
+  }
+
+  int64_t get_results_memory_budget() const override
+  {
+    if (this->use_gpu()) {
+      return 0;
+    }
+    return int64_t(this->get_render_data().compositor_memory_limit) * 1024 * 1024;
+  }
 };
 
 /* Render Compositor */
@@ -618,6 +654,8 @@ class Compositor {
       evaluator.evaluate();
     }
 
+    this->log_profiler_statistics();
+
     context_->output_to_render_result();
     context_->viewer_output_to_viewer_image();
 
@@ -637,6 +675,37 @@ class Compositor {
     }
   }
 
+  /* Log the statistics of the node result cache and the spilling of results of the last
+   * evaluation, which are only gathered when profiling. */
+  void log_profiler_statistics()
+  {
+    const compositor::Profiler *profiler = context_->profiler();
+    if (profiler == nullptr) {
+      return;
+    }
+
+    const compositor::Profiler::NodeResultCacheStatistics &cache_statistics =
+        profiler->get_node_result_cache_statistics();
+    if (cache_statistics.hits != 0 || cache_statistics.misses != 0) {
+      CLOG_DEBUG(&LOG,
+                 "Node result cache: %d hits, %d misses, %.1f MiB used",
+                 int(cache_statistics.hits),
+                 int(cache_statistics.misses),
+                 double(cache_statistics.memory_usage) / (1024.0 * 1024.0));
+    }
+
+    const compositor::Profiler::ResultSpillStatistics &spill_statistics =
+        profiler->get_result_spill_statistics();
+    if (spill_statistics.spilled_tiles != 0) {
+      CLOG_DEBUG(&LOG,
+                 "Spilled %d result tiles (%.1f MiB, %.1f MiB compressed), restored %d tiles",
+                 int(spill_statistics.spilled_tiles),
+                 double(spill_statistics.spilled_size) / (1024.0 * 1024.0),
+                 double(spill_statistics.compressed_size) / (1024.0 * 1024.0),
+                 int(spill_statistics.restored_tiles));
+    }
+  }
+
   /* Returns true if the compositor should be freed and reconstructed, which is needed when the
    * compositor execution device or precision changed, because we either need to update all cached
    * and pooled resources for the new execution device and precision, or we simply recreate the
@@ -32,6 +32,7 @@
 #include "BLI_rect.h"
 #include "BLI_set.hh"
 #include "BLI_string_utf8.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 #include "BLI_time.h"
 #include "BLI_timecode.h"
@@ -261,10 +262,14 @@ bool RE_HasSingleLayer(Render *re)
   return (re->r.scemode & R_SINGLE_LAYER);
 }
 
-RenderResult *RE_MultilayerConvert(
-    void *exrhandle, const char *colorspace, bool predivide, int rectx, int recty)
+RenderResult *RE_MultilayerConvert(void *exrhandle,
+                                   const char *colorspace,
+                                   bool predivide,
+                                   int rectx,
+                                   int recty,
+                                   bool read_passes)
 {
-  return render_result_new_from_exr(exrhandle, colorspace, predivide, rectx, recty);
+  return render_result_new_from_exr(exrhandle, colorspace, predivide, rectx, recty, read_passes);
 }
 
 RenderLayer *render_get_single_layer(Render *re, RenderResult *rr)
@@ -2285,6 +2290,34 @@ bool RE_WriteRenderViewsMovie(ReportList *reports,
   return ok;
 }
 
+/* Get file path the rendered frame is to be written to. */
+static bool render_output_filepath_get(Render *re,
+                                       Main *bmain,
+                                       Scene *scene,
+                                       char filepath[FILE_MAX])
+{
+  const char *relbase = BKE_main_blendfile_path(bmain);
+  path_templates::VariableMap template_variables;
+  BKE_add_template_variables_general(template_variables, &scene->id);
+  BKE_add_template_variables_for_render_path(template_variables, *scene);
+
+  const blender::Vector<path_templates::Error> errors = BKE_image_path_from_imformat(
+      filepath,
+      scene->r.pic,
+      relbase,
+      &template_variables,
+      scene->r.cfra,
+      &scene->r.im_format,
+      (scene->r.scemode & R_EXTENSION) != 0,
+      true,
+      nullptr);
+  if (!errors.is_empty()) {
+    BKE_report_path_template_errors(re->reports, RPT_ERROR, scene->r.pic, errors);
+    return false;
+  }
+  return true;
+}
+
 static bool do_write_image_or_movie(
     Render *re, Main *bmain, Scene *scene, const int totvideos, const char *filepath_override)
 {
@@ -2311,25 +2344,7 @@ static bool do_write_image_or_movie(
         STRNCPY(filepath, filepath_override);
       }
       else {
-        const char *relbase = BKE_main_blendfile_path(bmain);
-        path_templates::VariableMap template_variables;
-        BKE_add_template_variables_general(template_variables, &scene->id);
-        BKE_add_template_variables_for_render_path(template_variables, *scene);
-
-        const blender::Vector<path_templates::Error> errors = BKE_image_path_from_imformat(
-            filepath,
-            scene->r.pic,
-            relbase,
-            &template_variables,
-            scene->r.cfra,
-            &scene->r.im_format,
-            (scene->r.scemode & R_EXTENSION) != 0,
-            true,
-            nullptr);
-        if (!errors.is_empty()) {
-          BKE_report_path_template_errors(re->reports, RPT_ERROR, scene->r.pic, errors);
-          ok = false;
-        }
+        ok = render_output_filepath_get(re, bmain, scene, filepath);
       }
 
       /* write images as individual images or stereo */
@@ -2403,6 +2418,117 @@ static void re_movie_free_all(Render *re)
   re->movie_writers.clear_and_shrink();
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Pipelined Animation Writing
+ *
+ * When rendering an image sequence, saving a frame is done from a background thread while the
+ * next frame renders. The render result and the output settings of the scene are copied, so that
+ * the animation of the next frame does not affect the frame being written. Only one frame is
+ * written at a time.
+ * \{ */
+
+struct RenderAnimWrite {
+  /** Output settings of the scene for the rendered frame, see #render_anim_write_scene_copy. */
+  Scene *scene = nullptr;
+  RenderResult *result = nullptr;
+  ReportList *reports = nullptr;
+  char filepath[FILE_MAX] = "";
+  double write_time = 0.0;
+  bool ok = false;
+};
+
+/**
+ * Copy the settings of the scene that are used to write a frame: the output format with its color
+ * management, the views and the stamp flags. All other settings are left empty, so the writer
+ * shares no data with the scene, which is updated for the next frame while the frame is written.
+ */
+static Scene *render_anim_write_scene_copy(const Scene *scene)
+{
+  Scene *scene_copy = MEM_callocN<Scene>(__func__);
+  STRNCPY(scene_copy->id.name, scene->id.name);
+  scene_copy->r.stamp = scene->r.stamp;
+  scene_copy->r.dither_intensity = scene->r.dither_intensity;
+  BKE_image_format_copy(&scene_copy->r.im_format, &scene->r.im_format);
+  BLI_duplicatelist(&scene_copy->r.views, &scene->r.views);
+  BKE_color_managed_display_settings_copy(&scene_copy->display_settings,
+                                          &scene->display_settings);
+  BKE_color_managed_view_settings_copy(&scene_copy->view_settings, &scene->view_settings);
+  return scene_copy;
+}
+
+static void render_anim_write_scene_free(Scene *scene)
+{
+  BKE_image_format_free(&scene->r.im_format);
+  BLI_freelistN(&scene->r.views);
+  BKE_color_managed_view_settings_free(&scene->view_settings);
+  MEM_freeN(scene);
+}
+
+static void render_anim_write_task(TaskPool *__restrict /*pool*/, void *taskdata)
+{
+  RenderAnimWrite *write = static_cast<RenderAnimWrite *>(taskdata);
+  const double start_time = BLI_time_now_seconds();
+  write->ok = BKE_image_render_write(
+      write->reports, write->result, write->scene, true, write->filepath);
+  write->write_time = BLI_time_now_seconds() - start_time;
+}
+
+static RenderAnimWrite *render_anim_write_begin(Render *re,
+                                                Main *bmain,
+                                                Scene *scene,
+                                                TaskPool *pool)
+{
+  char filepath[FILE_MAX];
+  if (!render_output_filepath_get(re, bmain, scene, filepath)) {
+    return nullptr;
+  }
+
+  RenderAnimWrite *write = MEM_new<RenderAnimWrite>(__func__);
+  write->scene = render_anim_write_scene_copy(scene);
+  write->reports = re->reports;
+  STRNCPY(write->filepath, filepath);
+
+  RenderResult rres;
+  RE_AcquireResultImageViews(re, &rres);
+  write->result = RE_DuplicateRenderResult(&rres);
+  RE_ReleaseResultImageViews(re, &rres);
+
+  BLI_task_pool_push(pool, render_anim_write_task, write, false, nullptr);
+
+  re->i.lastframetime = BLI_time_now_seconds() - re->i.starttime;
+
+  char time_str[32];
+  BLI_timecode_string_from_time_simple(time_str, sizeof(time_str), re->i.lastframetime);
+  const std::string message = fmt::format("Time: {} (Saving in background)", time_str);
+  CLOG_STR_INFO(&LOG, message.c_str());
+  render_callback_exec_string(re, G_MAIN, BKE_CB_EVT_RENDER_STATS, message.c_str());
+
+  return write;
+}
+
+/* Wait for the frame to be written, returns false if writing failed. */
+static bool render_anim_write_end(TaskPool *pool, RenderAnimWrite *write)
+{
+  BLI_task_pool_work_and_wait(pool);
+
+  /* The file path is already logged as "Saved: '...'" by the writer, like for frames that are
+   * not written in the background. */
+  const bool ok = write->ok;
+  if (ok) {
+    char time_str[32];
+    BLI_timecode_string_from_time_simple(time_str, sizeof(time_str), write->write_time);
+    CLOG_INFO(&LOG, "Saving: %s (in background)", time_str);
+  }
+
+  RE_FreeRenderResult(write->result);
+  render_anim_write_scene_free(write->scene);
+  MEM_delete(write);
+
+  return ok;
+}
+
+/** \} */
+
 void RE_RenderAnim(Render *re,
                    Main *bmain,
                    Scene *scene,
@@ -2446,6 +2572,13 @@ void RE_RenderAnim(Render *re,
 
   render_init_depsgraph(re);
 
+  /* Write frames in the background while the next frame renders. */
+  TaskPool *write_pool = nullptr;
+  RenderAnimWrite *pending_write = nullptr;
+  if ((G.f & G_FLAG_RENDER_PIPELINE) && !is_movie && do_write_file) {
+    write_pool = BLI_task_pool_create_background(nullptr, TASK_PRIORITY_HIGH);
+  }
+
   if (is_movie && do_write_file) {
     size_t width, height;
     get_videos_dimensions(re, &rd, &width, &height);
@@ -2476,6 +2609,8 @@ void RE_RenderAnim(Render *re,
     }
   }
 
+  const double anim_start_time = BLI_time_now_seconds();
+
   /* Ugly global still... is to prevent renderwin events and signal subdivision-surface etc
    * to make full resolution is also set by caller renderwin.c */
   G.is_rendering = true;
@@ -2617,10 +2752,27 @@ void RE_RenderAnim(Render *re,
     do_render_full_pipeline(re);
     totrendered++;
 
+    /* The previous frame was written while this one rendered. */
+    if (pending_write) {
+      if (render_anim_write_end(write_pool, pending_write)) {
+        render_callback_exec_id(re, re->main, &scene->id, BKE_CB_EVT_RENDER_WRITE);
+      }
+      else {
+        G.is_break = true;
+      }
+      pending_write = nullptr;
+    }
+
     const bool should_write = !(re->flag & R_SKIP_WRITE);
     if (re->test_break_cb(re->tbh) == 0) {
       if (!G.is_break && should_write) {
-        if (!do_write_image_or_movie(re, bmain, scene, totvideos, nullptr)) {
+        if (write_pool) {
+          pending_write = render_anim_write_begin(re, bmain, scene, write_pool);
+          if (pending_write == nullptr) {
+            G.is_break = true;
+          }
+        }
+        else if (!do_write_image_or_movie(re, bmain, scene, totvideos, nullptr)) {
           G.is_break = true;
         }
       }
@@ -2664,12 +2816,38 @@ void RE_RenderAnim(Render *re,
     if (G.is_break == false) {
       /* keep after file save */
       render_callback_exec_id(re, re->main, &scene->id, BKE_CB_EVT_RENDER_POST);
-      if (should_write) {
+      /* With pipelined writing this is done when the frame is written. */
+      if (should_write && pending_write == nullptr) {
         render_callback_exec_id(re, re->main, &scene->id, BKE_CB_EVT_RENDER_WRITE);
       }
     }
   }
 
+  if (write_pool) {
+    if (pending_write) {
+      if (render_anim_write_end(write_pool, pending_write)) {
+        if (G.is_break == false) {
+          render_callback_exec_id(re, re->main, &scene->id, BKE_CB_EVT_RENDER_WRITE);
+        }
+      }
+      else {
+        G.is_break = true;
+      }
+    }
+    BLI_task_pool_free(write_pool);
+  }
+
+  if (totrendered > 1) {
+    const double anim_time = BLI_time_now_seconds() - anim_start_time;
+    char time_str[32];
+    BLI_timecode_string_from_time_simple(time_str, sizeof(time_str), anim_time);
+    CLOG_INFO(&LOG,
+              "Rendered %d frames in %s (%.1f frames/hour)",
+              totrendered,
+              time_str,
+              (anim_time > 0.0) ? totrendered * 3600.0 / anim_time : 0.0);
+  }
+
   /* end movie */
   if (is_movie && do_write_file) {
     re_movie_free_all(re);
@@ -13,8 +13,11 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "CLG_log.h"
+
 #include "BLI_hash_md5.hh"
 #include "BLI_listbase.h"
+#include "BLI_mutex.hh"
 #include "BLI_path_utils.hh"
 #include "BLI_rect.h"
 #include "BLI_string_utf8.h"
@@ -41,6 +44,8 @@
 #include "render_result.h"
 #include "render_types.h"
 
+static CLG_LogRef LOG = {"render"};
+
 /* -------------------------------------------------------------------- */
 /** \name Free
  * \{ */
@@ -92,6 +97,10 @@ void render_result_free(RenderResult *rr)
 
   IMB_freeImBuf(rr->ibuf);
 
+  if (rr->exrhandle) {
+    IMB_exr_close(rr->exrhandle);
+  }
+
   if (rr->text) {
     MEM_freeN(rr->text);
   }
@@ -608,7 +617,10 @@ static void ml_addpass_cb(void *base,
   /* channel id chars */
   STRNCPY(rpass->chan_id, chan_id);
 
-  RE_pass_set_buffer_data(rpass, rect);
+  /* The pixels of passes that are read on first access are not available yet. */
+  if (rect) {
+    RE_pass_set_buffer_data(rpass, rect);
+  }
 
   STRNCPY(rpass->name, name);
   STRNCPY(rpass->view, view);
@@ -709,20 +721,53 @@ static int order_render_passes(const void *a, const void *b)
   return (rpa->view_id < rpb->view_id);
 }
 
-RenderResult *render_result_new_from_exr(
-    void *exrhandle, const char *colorspace, bool predivide, int rectx, int recty)
+/* Convert the pixels of a pass read from an EXR file to the color-space used for rendering. */
+static void render_result_exr_pass_init(const RenderResult *rr,
+                                        RenderPass *rpass,
+                                        const char *colorspace,
+                                        const bool predivide)
+{
+  copy_v2_v2_db(rpass->ibuf->ppm, rr->ppm);
+
+  if (RE_RenderPassIsColor(rpass)) {
+    const char *to_colorspace = IMB_colormanagement_role_colorspace_name_get(
+        COLOR_ROLE_SCENE_LINEAR);
+    IMB_colormanagement_transform_float(rpass->ibuf->float_buffer.data,
+                                        rpass->rectx,
+                                        rpass->recty,
+                                        rpass->channels,
+                                        colorspace,
+                                        to_colorspace,
+                                        predivide);
+  }
+  else {
+    const char *data_colorspace = IMB_colormanagement_role_colorspace_name_get(COLOR_ROLE_DATA);
+    IMB_colormanagement_assign_float_colorspace(rpass->ibuf, data_colorspace);
+  }
+}
+
+RenderResult *render_result_new_from_exr(void *exrhandle,
+                                         const char *colorspace,
+                                         bool predivide,
+                                         int rectx,
+                                         int recty,
+                                         bool read_passes)
 {
   RenderResult *rr = MEM_callocN<RenderResult>(__func__);
-  const char *to_colorspace = IMB_colormanagement_role_colorspace_name_get(
-      COLOR_ROLE_SCENE_LINEAR);
-  const char *data_colorspace = IMB_colormanagement_role_colorspace_name_get(COLOR_ROLE_DATA);
 
   rr->rectx = rectx;
   rr->recty = recty;
 
   IMB_exr_get_ppm(exrhandle, rr->ppm);
 
-  IMB_exr_multilayer_convert(exrhandle, rr, ml_addview_cb, ml_addlayer_cb, ml_addpass_cb);
+  IMB_exr_multilayer_convert(
+      exrhandle, rr, ml_addview_cb, ml_addlayer_cb, ml_addpass_cb, read_passes);
+
+  if (!read_passes) {
+    rr->exrhandle = exrhandle;
+    STRNCPY(rr->exr_colorspace, colorspace);
+    rr->exr_predivide = predivide;
+  }
 
   LISTBASE_FOREACH (RenderLayer *, rl, &rr->layers) {
     rl->rectx = rectx;
@@ -734,19 +779,8 @@ RenderResult *render_result_new_from_exr(
       rpass->rectx = rectx;
       rpass->recty = recty;
 
-      copy_v2_v2_db(rpass->ibuf->ppm, rr->ppm);
-
-      if (RE_RenderPassIsColor(rpass)) {
-        IMB_colormanagement_transform_float(rpass->ibuf->float_buffer.data,
-                                            rpass->rectx,
-                                            rpass->recty,
-                                            rpass->channels,
-                                            colorspace,
-                                            to_colorspace,
-                                            predivide);
-      }
-      else {
-        IMB_colormanagement_assign_float_colorspace(rpass->ibuf, data_colorspace);
+      if (rpass->ibuf) {
+        render_result_exr_pass_init(rr, rpass, colorspace, predivide);
       }
     }
   }
@@ -754,6 +788,87 @@ RenderResult *render_result_new_from_exr(
   return rr;
 }
 
+/* Passes of render results of different images can be read at the same time, but the access to
+ * the EXR handle of a render result is not thread safe. */
+static blender::Mutex exr_pass_read_mutex;
+
+/* The file can be overwritten while the image is open, for example by rendering to it again.
+ * Passes can't be read from it anymore then, since the channel layout of the handle is outdated,
+ * so the handle is closed and the passes that were not read yet stay empty until the image is
+ * reloaded. */
+static bool render_result_exr_handle_ensure_valid(RenderResult *rr)
+{
+  if (rr->exrhandle == nullptr) {
+    return false;
+  }
+  if (!IMB_exr_file_changed(rr->exrhandle)) {
+    return true;
+  }
+
+  CLOG_WARN(&LOG, "Multi-layer EXR file changed on disk, reload the image to read its passes");
+  IMB_exr_close(rr->exrhandle);
+  rr->exrhandle = nullptr;
+  return false;
+}
+
+static void render_result_exr_pass_read(RenderResult *rr, RenderLayer *rl, RenderPass *rpass)
+{
+  char passname[EXR_PASS_MAXNAME];
+  if (rpass->view[0] != '\0') {
+    SNPRINTF(passname, "%s.%s", rpass->name, rpass->view);
+  }
+  else {
+    STRNCPY(passname, rpass->name);
+  }
+
+  float *rect = IMB_exr_read_pass(rr->exrhandle, rl->name, passname, nullptr);
+  if (rect == nullptr) {
+    return;
+  }
+
+  RE_pass_set_buffer_data(rpass, rect);
+  render_result_exr_pass_init(rr, rpass, rr->exr_colorspace, rr->exr_predivide);
+}
+
+void RE_RenderPassEnsureLoaded(RenderResult *render_result, RenderPass *render_pass)
+{
+  if (render_result->exrhandle == nullptr) {
+    return;
+  }
+
+  std::scoped_lock lock(exr_pass_read_mutex);
+  if (render_pass->ibuf || !render_result_exr_handle_ensure_valid(render_result)) {
+    return;
+  }
+
+  LISTBASE_FOREACH (RenderLayer *, rl, &render_result->layers) {
+    if (BLI_findindex(&rl->passes, render_pass) != -1) {
+      render_result_exr_pass_read(render_result, rl, render_pass);
+      return;
+    }
+  }
+}
+
+void RE_RenderResultEnsurePassesLoaded(RenderResult *render_result)
+{
+  if (render_result->exrhandle == nullptr) {
+    return;
+  }
+
+  std::scoped_lock lock(exr_pass_read_mutex);
+  if (!render_result_exr_handle_ensure_valid(render_result)) {
+    return;
+  }
+
+  LISTBASE_FOREACH (RenderLayer *, rl, &render_result->layers) {
+    LISTBASE_FOREACH (RenderPass *, rpass, &rl->passes) {
+      if (rpass->ibuf == nullptr) {
+        render_result_exr_pass_read(render_result, rl, rpass);
+      }
+    }
+  }
+}
+
 void render_result_view_new(RenderResult *rr, const char *viewname)
 {
   RenderView *rv = MEM_callocN<RenderView>("new render view");
@@ -1344,8 +1459,12 @@ static RenderView *duplicate_render_view(RenderView *rview)
 
 RenderResult *RE_DuplicateRenderResult(RenderResult *rr)
 {
+  /* The copy doesn't share the EXR handle, so it gets the pixels of all passes. */
+  RE_RenderResultEnsurePassesLoaded(rr);
+
   RenderResult *new_rr = MEM_dupallocN<RenderResult>("new duplicated render result", *rr);
   new_rr->next = new_rr->prev = nullptr;
+  new_rr->exrhandle = nullptr;
   new_rr->layers.first = new_rr->layers.last = nullptr;
   new_rr->views.first = new_rr->views.last = nullptr;
   LISTBASE_FOREACH (RenderLayer *, rl, &rr->layers) {
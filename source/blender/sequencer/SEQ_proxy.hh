@@ -37,6 +37,11 @@ bool proxy_rebuild_context(Main *bmain,
                            ListBase *queue,
                            bool build_only_on_bad_performance);
 void proxy_rebuild(IndexBuildContext *context, wmJobWorkerStatus *worker_status);
+/**
+ * Build the proxies of all contexts of the queue. The proxies of movie strips are built
+ * concurrently, reporting the overall throughput once done.
+ */
+void proxy_rebuild_queue(ListBase *queue, wmJobWorkerStatus *worker_status);
 void proxy_rebuild_finish(IndexBuildContext *context, bool stop);
 void proxy_set(Strip *strip, bool value);
 bool can_use_proxy(const RenderData *context, const Strip *strip, IMB_Proxy_Size psize);
@@ -87,4 +87,28 @@ bool render_is_muted(const ListBase *channels, const Strip *strip);
 float get_render_scale_factor(eSpaceSeq_Proxy_RenderSize render_size, short scene_render_scale);
 float get_render_scale_factor(const RenderData &context);
 
+/** Timing of the stages of rendering a frame, see #render_statistics_get. */
+struct RenderStatistics {
+  /** Time to render the whole frame in seconds, zero if no frame was rendered yet. */
+  double frame_time = 0.0;
+  /**
+   * Time spent loading and decoding the images of strips in seconds. Summed over all strips, so
+   * it can exceed the frame time when strips are rendered in parallel.
+   */
+  double source_time = 0.0;
+  /** Time spent transforming, cropping and applying modifiers to the images of strips. */
+  double preprocess_time = 0.0;
+  /** Time spent blending the images of the strips of the stack. */
+  double blend_time = 0.0;
+  /** Number of strips whose images were rendered in parallel. */
+  int parallel_strips_num = 0;
+};
+
+/**
+ * Get the statistics of the last frame rendered for display, or of the last frame rendered in
+ * the background by the prefetch job if \a prefetch is true. Frames that are retrieved from the
+ * final image cache are not counted.
+ */
+RenderStatistics render_statistics_get(const Scene *scene, bool prefetch);
+
 }  // namespace blender::seq
@@ -0,0 +1,808 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup sequencer
+ */
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
+#include <xxhash.h>
+#include <zstd.h>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_array.hh"
+#include "BLI_fileops.h"
+#include "BLI_fileops_types.h"
+#include "BLI_index_range.hh"
+#include "BLI_listbase.h"
+#include "BLI_math_base.hh"
+#include "BLI_mutex.hh"
+#include "BLI_path_utils.hh"
+#include "BLI_set.hh"
+#include "BLI_span.hh"
+#include "BLI_string.h"
+#include "BLI_string_ref.hh"
+#include "BLI_task.h"
+#include "BLI_vector.hh"
+
+#include "DNA_color_types.h"
+#include "DNA_scene_types.h"
+#include "DNA_sequence_types.h"
+#include "DNA_userdef_types.h"
+#include "DNA_vfont_types.h"
+
+#include "BKE_appdir.hh"
+#include "BKE_library.hh"
+#include "BKE_main.hh"
+
+#include "IMB_colormanagement.hh"
+#include "IMB_imbuf.hh"
+#include "IMB_imbuf_types.hh"
+
+#include "SEQ_render.hh"
+#include "SEQ_time.hh"
+
+#include "disk_image_cache.hh"
+#include "prefetch.hh"
+
+namespace blender::seq {
+
+/* Identifies the cache files and the version of their format. The version should be bumped
+ * whenever the format or the computation of the keys changes, such that old files are ignored. */
+static constexpr char file_magic[4] = {'V', 'S', 'E', 'C'};
+static constexpr int32_t file_version = 1;
+static constexpr const char *file_extension = ".vseimg";
+
+/* A fast compression level, since images are written while playing back. */
+static constexpr int compression_level = 1;
+
+/* The maximum total size of the images that are waiting to be written. Images that are put in the
+ * cache while the limit is reached are not written, which happens when frames are rendered faster
+ * than they can be written, like during playback of cached frames. */
+static constexpr int64_t max_pending_writes_size = int64_t(512) * 1024 * 1024;
+
+/* The directory is scanned to enforce its size limit every time this fraction of the limit is
+ * written, and files are removed until this fraction of the limit is free again. */
+static constexpr int64_t size_limit_scan_divisor = 16;
+
+static Mutex disk_image_cache_mutex;
+
+struct DiskImageCache {
+  /* Writes the images in the background, see disk_image_cache_put. */
+  TaskPool *write_pool = nullptr;
+  /* The keys of the images that are waiting to be written, to avoid writing an image twice. */
+  Set<DiskImageKey> pending_writes;
+  /* The total size of the images that are waiting to be written. */
+  int64_t pending_writes_size = 0;
+};
+
+static DiskImageCache *ensure_disk_image_cache(Scene *scene)
+{
+  DiskImageCache **cache = &scene->ed->runtime.disk_image_cache;
+  if (*cache == nullptr) {
+    *cache = MEM_new<DiskImageCache>(__func__);
+  }
+  return *cache;
+}
+
+/* -------------------------------------------------------------------- */
+/** \name Image Keys
+ * \{ */
+
+/**
+ * Accumulates the bytes of the values that an image depends on, which are then hashed into a key.
+ * Only the shallow bytes of the added values are used, so they should not contain pointers.
+ */
+class KeyBuilder {
+ private:
+  Vector<uint8_t, 1024> data_;
+
+ public:
+  template<typename T> void add(const T &value)
+  {
+    static_assert(std::is_trivially_copyable_v<T>);
+    this->add_bytes(&value, sizeof(T));
+  }
+
+  void add_bytes(const void *data, const int64_t size)
+  {
+    data_.extend(Span<uint8_t>(static_cast<const uint8_t *>(data), size));
+  }
+
+  void add_string(const StringRef string)
+  {
+    this->add(string.size());
+    this->add_bytes(string.data(), string.size());
+  }
+
+  DiskImageKey build() const
+  {
+    const XXH128_hash_t hash = XXH3_128bits(data_.data(), data_.size());
+    return DiskImageKey{hash.low64, hash.high64};
+  }
+};
+
+static bool is_disk_cache_enabled(const RenderData *context, const int cache_flag)
+{
+  if (context->skip_cache || context->is_proxy_render) {
+    return false;
+  }
+  const Scene *scene = prefetch_get_original_scene(context);
+  if (scene == nullptr || scene->ed == nullptr) {
+    return false;
+  }
+  return (scene->ed->cache_flag & SEQ_CACHE_USE_DISK) && (scene->ed->cache_flag & cache_flag);
+}
+
+/* Adds the settings of the render context that all images depend on. */
+static void add_render_context(KeyBuilder &builder, const RenderData *context)
+{
+  builder.add(context->preview_render_size);
+  builder.add(context->use_proxies);
+  builder.add(context->view_id);
+  builder.add_string(context->scene->sequencer_colorspace_settings.name);
+}
+
+/* Adds the path and the modification time of the file, returning false if it doesn't exist. */
+static bool add_file(KeyBuilder &builder,
+                     const Scene *scene,
+                     const char *dirpath,
+                     const char *filename)
+{
+  char filepath[FILE_MAX];
+  BLI_path_join(filepath, sizeof(filepath), dirpath, filename);
+  BLI_path_abs(filepath, ID_BLEND_PATH_FROM_GLOBAL(&scene->id));
+
+  BLI_stat_t status;
+  if (BLI_stat(filepath, &status) != 0) {
+    return false;
+  }
+
+  builder.add_string(filepath);
+  builder.add(int64_t(status.st_size));
+  builder.add(int64_t(status.st_mtime));
+  return true;
+}
+
+/* Adds the file and the settings that the raw image of an image or movie strip depends on. */
+static bool add_media(KeyBuilder &builder,
+                      const Scene *scene,
+                      const Strip *strip,
+                      const float timeline_frame)
+{
+  const StripElem *elem = render_give_stripelem(scene, strip, int(timeline_frame));
+  if (elem == nullptr || !add_file(builder, scene, strip->data->dirpath, elem->filename)) {
+    return false;
+  }
+
+  builder.add(strip->type);
+  builder.add(strip->flag & (SEQ_FILTERY | SEQ_MAKE_FLOAT | SEQ_USE_VIEWS));
+  builder.add(strip->streamindex);
+  builder.add(strip->anim_startofs);
+  builder.add(strip->alpha_mode);
+  builder.add(strip->views_format);
+  if (strip->stereo3d_format) {
+    builder.add(*strip->stereo3d_format);
+  }
+  builder.add(strip->data->proxy ? strip->data->proxy->tc : short(0));
+  builder.add_string(strip->data->colorspace_settings.name);
+  builder.add(std::trunc(give_frame_index(scene, strip, timeline_frame)));
+  return true;
+}
+
+/* Adds the values of the given curve mapping excluding its pointers. */
+static void add_curve_mapping(KeyBuilder &builder, const CurveMapping &curve_mapping)
+{
+  builder.add(curve_mapping.flag);
+  builder.add(curve_mapping.preset);
+  builder.add(curve_mapping.curr);
+  builder.add(curve_mapping.clipr);
+  builder.add(curve_mapping.black);
+  builder.add(curve_mapping.white);
+  builder.add(curve_mapping.tone);
+  for (const CurveMap &curve_map : curve_mapping.cm) {
+    builder.add(curve_map.totpoint);
+    builder.add(curve_map.ext_in);
+    builder.add(curve_map.ext_out);
+    for (const int i : IndexRange(curve_map.totpoint)) {
+      builder.add(curve_map.curve[i].x);
+      builder.add(curve_map.curve[i].y);
+      builder.add(curve_map.curve[i].flag);
+    }
+  }
+}
+
+/* Adds the modifiers of the strip, returning false if any of them uses a mask, since masks can
+ * change without any change to the strip. */
+static bool add_modifiers(KeyBuilder &builder, const Strip *strip)
+{
+  LISTBASE_FOREACH (const StripModifierData *, smd, &strip->modifiers) {
+    if (smd->mask_strip != nullptr || smd->mask_id != nullptr) {
+      return false;
+    }
+
+    builder.add(smd->type);
+    builder.add(smd->flag & STRIP_MODIFIER_FLAG_MUTE);
+
+    switch (smd->type) {
+      case seqModifierType_Curves:
+        add_curve_mapping(builder,
+                          reinterpret_cast<const CurvesModifierData *>(smd)->curve_mapping);
+        break;
+      case seqModifierType_HueCorrect:
+        add_curve_mapping(builder,
+                          reinterpret_cast<const HueCorrectModifierData *>(smd)->curve_mapping);
+        break;
+      case seqModifierType_SoundEqualizer:
+        break;
+      default: {
+        /* The settings of the rest of the modifiers don't contain pointers, so hash the bytes
+         * following the common modifier data directly. */
+        const uint8_t *data = reinterpret_cast<const uint8_t *>(smd);
+        builder.add_bytes(data + sizeof(StripModifierData),
+                          int64_t(MEM_allocN_len(smd)) - int64_t(sizeof(StripModifierData)));
+        break;
+      }
+    }
+  }
+  return true;
+}
+
+static void add_effect_data(KeyBuilder &builder, const Strip *strip)
+{
+  switch (strip->type) {
+    case STRIP_TYPE_TEXT: {
+      TextVars data = *static_cast<const TextVars *>(strip->effectdata);
+      const VFont *font = data.text_font;
+      builder.add_string(data.text_ptr ? data.text_ptr : "");
+      if (font) {
+        builder.add_string(font->filepath);
+      }
+      data.text_ptr = nullptr;
+      data.text_font = nullptr;
+      data.runtime = nullptr;
+      builder.add(data);
+      break;
+    }
+    case STRIP_TYPE_SPEED: {
+      SpeedControlVars data = *static_cast<const SpeedControlVars *>(strip->effectdata);
+      data.frameMap = nullptr;
+      builder.add(data);
+      break;
+    }
+    default:
+      /* The settings of the rest of the effects don't contain pointers. */
+      builder.add_bytes(strip->effectdata, MEM_allocN_len(strip->effectdata));
+      break;
+  }
+}
+
+static void add_channels(KeyBuilder &builder, const ListBase *channels)
+{
+  LISTBASE_FOREACH (const SeqTimelineChannel *, channel, channels) {
+    builder.add(channel->index);
+    builder.add(channel->flag);
+  }
+}
+
+/* Adds the state of the strip and the strips it renders, returning false if the strip depends on
+ * data that can't be identified by a key. */
+static bool add_strip(KeyBuilder &builder,
+                      const Scene *scene,
+                      const Strip *strip,
+                      const float timeline_frame)
+{
+  /* Scenes, movie clips, and masks can change without any change to the strip. */
+  if (ELEM(strip->type, STRIP_TYPE_SCENE, STRIP_TYPE_MOVIECLIP, STRIP_TYPE_MASK)) {
+    return false;
+  }
+
+  builder.add(strip->type);
+  builder.add(strip->flag & ~STRIP_ALLSEL);
+  builder.add(strip->channel);
+  builder.add(strip->len);
+  builder.add(strip->start);
+  builder.add(strip->startofs);
+  builder.add(strip->endofs);
+  builder.add(strip->anim_startofs);
+  builder.add(strip->anim_endofs);
+  builder.add(strip->sat);
+  builder.add(strip->mul);
+  builder.add(strip->multicam_source);
+  builder.add(strip->effect_fader);
+  builder.add(strip->blend_mode);
+  builder.add(strip->blend_opacity);
+  builder.add(strip->media_playback_rate);
+  builder.add(strip->speed_factor);
+  builder.add(give_frame_index(scene, strip, timeline_frame));
+  builder.add_bytes(strip->retiming_keys, sizeof(SeqRetimingKey) * strip->retiming_keys_num);
+  if (strip->data && strip->data->transform) {
+    builder.add(*strip->data->transform);
+  }
+  if (strip->data && strip->data->crop) {
+    builder.add(*strip->data->crop);
+  }
+
+  if (!add_modifiers(builder, strip)) {
+    return false;
+  }
+
+  if (ELEM(strip->type, STRIP_TYPE_IMAGE, STRIP_TYPE_MOVIE) &&
+      !add_media(builder, scene, strip, timeline_frame))
+  {
+    return false;
+  }
+
+  if (strip->effectdata) {
+    add_effect_data(builder, strip);
+  }
+
+  /* The frames of the strips of meta strips are remapped, so add all of them. */
+  if (strip->type == STRIP_TYPE_META) {
+    add_channels(builder, &strip->channels);
+    LISTBASE_FOREACH (const Strip *, child, &strip->seqbase) {
+      if (!add_strip(builder, scene, child, timeline_frame)) {
+        return false;
+      }
+    }
+  }
+
+  for (const Strip *input : {strip->input1, strip->input2}) {
+    if (input && !add_strip(builder, scene, input, timeline_frame)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+std::optional<DiskImageKey> disk_image_cache_source_key(const RenderData *context,
+                                                        const Strip *strip,
+                                                        float timeline_frame)
+{
+  if (!ELEM(strip->type, STRIP_TYPE_IMAGE, STRIP_TYPE_MOVIE) ||
+      !is_disk_cache_enabled(context, SEQ_CACHE_STORE_RAW))
+  {
+    return std::nullopt;
+  }
+
+  timeline_frame = math::round(timeline_frame);
+
+  KeyBuilder builder;
+  builder.add_string("source");
+  add_render_context(builder, context);
+  if (!add_media(builder, context->scene, strip, timeline_frame)) {
+    return std::nullopt;
+  }
+  return builder.build();
+}
+
+std::optional<DiskImageKey> disk_image_cache_final_key(const RenderData *context,
+                                                       const ListBase *channels,
+                                                       const ListBase *seqbasep,
+                                                       float timeline_frame,
+                                                       const int display_channel)
+{
+  if (!is_disk_cache_enabled(context, SEQ_CACHE_STORE_FINAL_OUT)) {
+    return std::nullopt;
+  }
+
+  timeline_frame = math::round(timeline_frame);
+  const Scene *scene = context->scene;
+
+  KeyBuilder builder;
+  builder.add_string("final");
+  add_render_context(builder, context);
+  builder.add(context->rectx);
+  builder.add(context->recty);
+  builder.add(scene->r.seq_flag);
+  builder.add(timeline_frame);
+  builder.add(display_channel);
+  add_channels(builder, channels);
+
+  /* Add all strips at the frame rather than only the rendered ones, since effect and adjustment
+   * strips render strips that are not rendered directly. */
+  LISTBASE_FOREACH (const Strip *, strip, seqbasep) {
+    if (!time_strip_intersects_frame(scene, strip, int(timeline_frame))) {
+      continue;
+    }
+    if (!add_strip(builder, scene, strip, timeline_frame)) {
+      return std::nullopt;
+    }
+  }
+
+  return builder.build();
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Image Files
+ * \{ */
+
+struct FileHeader {
+  char magic[4];
+  int32_t version;
+  int32_t width;
+  int32_t height;
+  int32_t planes;
+  int32_t channels;
+  /* The sizes of the compressed byte and float buffers that follow the header, which are zero if
+   * the image doesn't have the buffer. */
+  int64_t byte_buffer_size;
+  int64_t float_buffer_size;
+  char byte_colorspace[64];
+  char float_colorspace[64];
+};
+
+static bool get_directory(char *r_directory, const size_t directory_maxncpy)
+{
+  char root[FILE_MAX];
+  if (U.sequencer_disk_cache_dir[0] != '\0') {
+    STRNCPY(root, U.sequencer_disk_cache_dir);
+  }
+  else if (!BKE_appdir_folder_caches(root, sizeof(root))) {
+    return false;
+  }
+  BLI_path_join(r_directory, directory_maxncpy, root, "sequencer-images");
+  return true;
+}
+
+static void get_file_path(const char *directory, const DiskImageKey &key, char *r_filepath)
+{
+  char filename[64];
+  SNPRINTF(filename, "%016" PRIx64 "%016" PRIx64 "%s", key.v1, key.v2, file_extension);
+  BLI_path_join(r_filepath, FILE_MAX, directory, filename);
+}
+
+static const char *get_colorspace_name(const ColorSpace *colorspace)
+{
+  return colorspace ? IMB_colormanagement_colorspace_get_name(colorspace) : "";
+}
+
+/* Compresses and writes the given buffer, returning its compressed size, or -1 on failure. */
+static int64_t write_buffer(FILE *file, const void *data, const size_t size)
+{
+  Array<uint8_t> compressed_data(ZSTD_compressBound(size));
+  const size_t compressed_size = ZSTD_compress(
+      compressed_data.data(), compressed_data.size(), data, size, compression_level);
+  if (ZSTD_isError(compressed_size) ||
+      fwrite(compressed_data.data(), 1, compressed_size, file) != compressed_size)
+  {
+    return -1;
+  }
+  return int64_t(compressed_size);
+}
+
+static bool read_buffer(FILE *file, void *data, const size_t size, const int64_t compressed_size)
+{
+  Array<uint8_t> compressed_data(compressed_size);
+  if (fread(compressed_data.data(), 1, compressed_size, file) != size_t(compressed_size)) {
+    return false;
+  }
+  const size_t decompressed_size = ZSTD_decompress(
+      data, size, compressed_data.data(), compressed_size);
+  return !ZSTD_isError(decompressed_size) && decompressed_size == size;
+}
+
+static size_t get_byte_buffer_size(const ImBuf *image)
+{
+  return size_t(image->x) * size_t(image->y) * 4;
+}
+
+static size_t get_float_buffer_size(const ImBuf *image)
+{
+  return size_t(image->x) * size_t(image->y) * size_t(image->channels) * sizeof(float);
+}
+
+static bool write_image(FILE *file, const ImBuf *image)
+{
+  FileHeader header = {};
+  memcpy(header.magic, file_magic, sizeof(file_magic));
+  header.version = file_version;
+  header.width = image->x;
+  header.height = image->y;
+  header.planes = image->planes;
+  header.channels = image->channels;
+  STRNCPY(header.byte_colorspace, get_colorspace_name(image->byte_buffer.colorspace));
+  STRNCPY(header.float_colorspace, get_colorspace_name(image->float_buffer.colorspace));
+
+  /* Reserve the header, which is written once the sizes of the buffers are known. */
+  if (fwrite(&header, sizeof(header), 1, file) != 1) {
+    return false;
+  }
+
+  if (image->byte_buffer.data) {
+    header.byte_buffer_size = write_buffer(
+        file, image->byte_buffer.data, get_byte_buffer_size(image));
+    if (header.byte_buffer_size < 0) {
+      return false;
+    }
+  }
+
+  if (image->float_buffer.data) {
+    header.float_buffer_size = write_buffer(
+        file, image->float_buffer.data, get_float_buffer_size(image));
+    if (header.float_buffer_size < 0) {
+      return false;
+    }
+  }
+
+  return BLI_fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+}
+
+static ImBuf *read_image(FILE *file)
+{
+  FileHeader header;
+  if (fread(&header, sizeof(header), 1, file) != 1 ||
+      memcmp(header.magic, file_magic, sizeof(file_magic)) != 0 ||
+      header.version != file_version || header.width <= 0 || header.height <= 0 ||
+      header.channels <= 0 || header.channels > 4)
+  {
+    return nullptr;
+  }
+
+  ImBuf *image = IMB_allocImBuf(header.width, header.height, header.planes, 0);
+  image->channels = header.channels;
+
+  if (header.byte_buffer_size > 0) {
+    const size_t size = get_byte_buffer_size(image);
+    uint8_t *data = MEM_malloc_arrayN<uint8_t>(size, __func__);
+    IMB_assign_byte_buffer(image, data, IB_TAKE_OWNERSHIP);
+    if (!read_buffer(file, data, size, header.byte_buffer_size)) {
+      IMB_freeImBuf(image);
+      return nullptr;
+    }
+    if (header.byte_colorspace[0] != '\0') {
+      IMB_colormanagement_assign_byte_colorspace(image, header.byte_colorspace);
+    }
+  }
+
+  if (header.float_buffer_size > 0) {
+    const size_t size = get_float_buffer_size(image);
+    float *data = MEM_malloc_arrayN<float>(size / sizeof(float), __func__);
+    IMB_assign_float_buffer(image, data, IB_TAKE_OWNERSHIP);
+    if (!read_buffer(file, data, size, header.float_buffer_size)) {
+      IMB_freeImBuf(image);
+      return nullptr;
+    }
+    if (header.float_colorspace[0] != '\0') {
+      IMB_colormanagement_assign_float_colorspace(image, header.float_colorspace);
+    }
+  }
+
+  return image;
+}
+
+/* Removes the least recently used files of the directory if its size exceeds the limit. Since
+ * the directory is shared between all blend files and possibly other instances of Blender, it is
+ * scanned rather than tracking the files that are written. */
+static void limit_directory_size(const char *directory, const int64_t written_size)
+{
+  const int64_t size_limit = int64_t(U.sequencer_disk_cache_size_limit) * 1024 * 1024 * 1024;
+  if (size_limit <= 0) {
+    return;
+  }
+
+  static Mutex mutex;
+  static bool is_scanned = false;
+  static int64_t written_size_since_scan = 0;
+
+  std::lock_guard lock(mutex);
+  written_size_since_scan += written_size;
+  if (is_scanned && written_size_since_scan < size_limit / size_limit_scan_divisor) {
+    return;
+  }
+  is_scanned = true;
+  written_size_since_scan = 0;
+
+  struct CacheFile {
+    const char *path;
+    int64_t size;
+    int64_t modification_time;
+  };
+
+  direntry *entries = nullptr;
+  const uint entries_num = BLI_filelist_dir_contents(directory, &entries);
+
+  Vector<CacheFile> files;
+  int64_t total_size = 0;
+  for (const int i : IndexRange(entries_num)) {
+    const direntry &entry = entries[i];
+    if (!S_ISREG(entry.s.st_mode) || !BLI_path_extension_check(entry.relname, file_extension)) {
+      continue;
+    }
+    files.append({entry.path, int64_t(entry.s.st_size), int64_t(entry.s.st_mtime)});
+    total_size += int64_t(entry.s.st_size);
+  }
+
+  if (total_size > size_limit) {
+    std::sort(files.begin(), files.end(), [](const CacheFile &a, const CacheFile &b) {
+      return a.modification_time < b.modification_time;
+    });
+
+    const int64_t target_size = size_limit - size_limit / size_limit_scan_divisor;
+    for (const CacheFile &file : files) {
+      if (total_size <= target_size) {
+        break;
+      }
+      if (BLI_delete(file.path, false, false) == 0) {
+        total_size -= file.size;
+      }
+    }
+  }
+
+  BLI_filelist_free(entries, entries_num);
+}
+
+static void write_file(const DiskImageKey &key, const ImBuf *image)
+{
+  char directory[FILE_MAX];
+  if (!get_directory(directory, sizeof(directory)) || !BLI_dir_create_recursive(directory)) {
+    return;
+  }
+
+  char filepath[FILE_MAX];
+  get_file_path(directory, key, filepath);
+  if (BLI_exists(filepath)) {
+    return;
+  }
+
+  /* Write to a temporary file that is then renamed, such that partially written files are never
+   * read, even by other instances of Blender. */
+  char temp_filepath[FILE_MAX];
+  SNPRINTF(temp_filepath, "%s.%p.tmp", filepath, image);
+
+  FILE *file = BLI_fopen(temp_filepath, "wb");
+  if (file == nullptr) {
+    return;
+  }
+  const bool is_written = write_image(file, image);
+  const bool is_closed = fclose(file) == 0;
+
+  if (!is_written || !is_closed || BLI_rename_overwrite(temp_filepath, filepath) != 0) {
+    BLI_delete(temp_filepath, false, false);
+    return;
+  }
+
+  limit_directory_size(directory, int64_t(BLI_file_size(filepath)));
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Disk Image Cache
+ * \{ */
+
+struct WriteTask {
+  DiskImageKey key;
+  ImBuf *image;
+  int64_t size;
+};
+
+static void write_task_run(TaskPool *__restrict /*pool*/, void *taskdata)
+{
+  const WriteTask *task = static_cast<const WriteTask *>(taskdata);
+  write_file(task->key, task->image);
+}
+
+static void write_task_free(TaskPool *__restrict pool, void *taskdata)
+{
+  WriteTask *task = static_cast<WriteTask *>(taskdata);
+  DiskImageCache *cache = static_cast<DiskImageCache *>(BLI_task_pool_user_data(pool));
+  {
+    std::lock_guard lock(disk_image_cache_mutex);
+    cache->pending_writes.remove(task->key);
+    cache->pending_writes_size -= task->size;
+  }
+  IMB_freeImBuf(task->image);
+  MEM_delete(task);
+}
+
+ImBuf *disk_image_cache_get(const DiskImageKey &key)
+{
+  char directory[FILE_MAX];
+  if (!get_directory(directory, sizeof(directory))) {
+    return nullptr;
+  }
+
+  char filepath[FILE_MAX];
+  get_file_path(directory, key, filepath);
+  FILE *file = BLI_fopen(filepath, "rb");
+  if (file == nullptr) {
+    return nullptr;
+  }
+  ImBuf *image = read_image(file);
+  fclose(file);
+
+  /* Mark the file as recently used, see limit_directory_size. */
+  if (image) {
+    BLI_file_touch(filepath);
+  }
+  return image;
+}
+
+void disk_image_cache_put(const RenderData *context, const DiskImageKey &key, ImBuf *image)
+{
+  if (image == nullptr || (!image->byte_buffer.data && !image->float_buffer.data)) {
+    return;
+  }
+
+  const int64_t size = int64_t(IMB_get_size_in_memory(image));
+  Scene *scene = prefetch_get_original_scene(context);
+
+  DiskImageCache *cache = nullptr;
+  {
+    std::lock_guard lock(disk_image_cache_mutex);
+    cache = ensure_disk_image_cache(scene);
+    if (cache->pending_writes_size + size > max_pending_writes_size ||
+        cache->pending_writes.contains(key))
+    {
+      return;
+    }
+    /* Reserve the write before copying the image outside of the lock. */
+    cache->pending_writes.add_new(key);
+    cache->pending_writes_size += size;
+  }
+
+  /* Write a copy of the image, since images in the memory caches can still get new buffers, for
+   * instance, when they are displayed. */
+  ImBuf *image_copy = IMB_dupImBuf(image);
+
+  std::lock_guard lock(disk_image_cache_mutex);
+  /* The cache might have been destroyed while the image was copied. */
+  if (scene->ed == nullptr || scene->ed->runtime.disk_image_cache != cache ||
+      !cache->pending_writes.contains(key))
+  {
+    IMB_freeImBuf(image_copy);
+    return;
+  }
+  if (image_copy == nullptr) {
+    cache->pending_writes.remove(key);
+    cache->pending_writes_size -= size;
+    return;
+  }
+
+  if (cache->write_pool == nullptr) {
+    cache->write_pool = BLI_task_pool_create_background(cache, TASK_PRIORITY_LOW);
+  }
+
+  WriteTask *task = MEM_new<WriteTask>(__func__, WriteTask{key, image_copy, size});
+  BLI_task_pool_push(cache->write_pool, write_task_run, task, false, write_task_free);
+}
+
+void disk_image_cache_destroy(Scene *scene)
+{
+  DiskImageCache *cache = nullptr;
+  {
+    std::lock_guard lock(disk_image_cache_mutex);
+    if (scene == nullptr || scene->ed == nullptr) {
+      return;
+    }
+    cache = scene->ed->runtime.disk_image_cache;
+    scene->ed->runtime.disk_image_cache = nullptr;
+  }
+
+  if (cache == nullptr) {
+    return;
+  }
+
+  /* Finish the pending writes outside of the lock, since the tasks lock it when they finish. */
+  if (cache->write_pool) {
+    BLI_task_pool_work_and_wait(cache->write_pool);
+    BLI_task_pool_free(cache->write_pool);
+  }
+  MEM_delete(cache);
+}
+
+/** \} */
+
+}  // namespace blender::seq
@@ -0,0 +1,81 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup sequencer
+ *
+ * Disk tier of the source and final image caches, which persists across sessions.
+ * - Keyed by a hash of everything the image depends on, so files are only reused when the
+ *   image would be rendered identically, and are never invalidated explicitly.
+ * - Images are zstd compressed and written in the background.
+ * - Files of all blend files share one directory, whose size is limited by removing the least
+ *   recently used files.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+#include "BLI_struct_equality_utils.hh"
+
+struct ImBuf;
+struct ListBase;
+struct Scene;
+struct Strip;
+
+namespace blender::seq {
+
+struct RenderData;
+
+/** A hash of the state that a cached image depends on, which identifies its file on disk. */
+struct DiskImageKey {
+  uint64_t v1 = 0;
+  uint64_t v2 = 0;
+
+  uint64_t hash() const
+  {
+    return v1;
+  }
+
+  BLI_STRUCT_EQUALITY_OPERATORS_2(DiskImageKey, v1, v2)
+};
+
+/**
+ * Compute the key of the raw image of the strip at the given frame. Returns nullopt if the disk
+ * cache or the source image cache are disabled, or if the image of the strip can't be identified
+ * by a key, which is the case for all strips that don't read images or movies from files.
+ */
+std::optional<DiskImageKey> disk_image_cache_source_key(const RenderData *context,
+                                                        const Strip *strip,
+                                                        float timeline_frame);
+
+/**
+ * Compute the key of the final image of the given strips stack at the given frame. Returns
+ * nullopt if the disk cache or the final image cache are disabled, or if any strip at the frame
+ * depends on data that can't be identified by a key, like scene, movie clip, and mask strips.
+ */
+std::optional<DiskImageKey> disk_image_cache_final_key(const RenderData *context,
+                                                       const ListBase *channels,
+                                                       const ListBase *seqbasep,
+                                                       float timeline_frame,
+                                                       int display_channel);
+
+/**
+ * Read the image identified by the given key from disk, or return null if it is not cached.
+ *
+ * \note The returned #ImBuf has its reference increased, free after usage!
+ */
+ImBuf *disk_image_cache_get(const DiskImageKey &key);
+
+/**
+ * Schedule writing the given image to disk. The image is compressed and written in the
+ * background, so this returns immediately. The image reference is increased until it is written.
+ */
+void disk_image_cache_put(const RenderData *context, const DiskImageKey &key, ImBuf *image);
+
+/** Wait for the pending writes of the scene and free its disk cache runtime data. */
+void disk_image_cache_destroy(Scene *scene);
+
+}  // namespace blender::seq
@@ -8,16 +8,24 @@
  * \ingroup bke
  */
 
+#include <algorithm>
+#include <atomic>
+
 #include "MEM_guardedalloc.h"
 
 #include "DNA_scene_types.h"
 #include "DNA_sequence_types.h"
 #include "DNA_space_types.h"
 
+#include "BLI_array.hh"
 #include "BLI_fileops.h"
 #include "BLI_listbase.h"
 #include "BLI_path_utils.hh"
 #include "BLI_string.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
+#include "BLI_time.h"
+#include "BLI_vector.hh"
 
 #ifdef WIN32
 #  include "BLI_winstuff.h"
@@ -28,6 +36,7 @@
 #include "BKE_global.hh"
 #include "BKE_image.hh"
 #include "BKE_main.hh"
+#include "BKE_report.hh"
 #include "BKE_scene.hh"
 
 #include "WM_types.hh"
@@ -511,7 +520,13 @@ bool proxy_rebuild_context(Main *bmain,
   return true;
 }
 
-void proxy_rebuild(IndexBuildContext *context, wmJobWorkerStatus *worker_status)
+/* Build the proxies of a strip that is not a movie from its rendered images. The progress of the
+ * strip is reported in the range starting at `progress_start`, so that strips which are built one
+ * after the other each fill their own part of the job progress. */
+static void proxy_rebuild_rendered(IndexBuildContext *context,
+                                   wmJobWorkerStatus *worker_status,
+                                   const float progress_start,
+                                   const float progress_range)
 {
   const bool overwrite = context->overwrite;
   RenderData render_context;
@@ -520,17 +535,6 @@ void proxy_rebuild(IndexBuildContext *context, wmJobWorkerStatus *worker_status)
   Main *bmain = context->bmain;
   int timeline_frame;
 
-  if (strip->type == STRIP_TYPE_MOVIE) {
-    if (context->proxy_builder) {
-      MOV_proxy_builder_process(context->proxy_builder,
-                                &worker_status->stop,
-                                &worker_status->do_update,
-                                &worker_status->progress);
-    }
-
-    return;
-  }
-
   if (!(strip->flag & SEQ_USE_PROXY)) {
     return;
   }
@@ -576,9 +580,10 @@ void proxy_rebuild(IndexBuildContext *context, wmJobWorkerStatus *worker_status)
       seq_proxy_build_frame(&render_context, &state, strip, timeline_frame, 100, overwrite);
     }
 
-    worker_status->progress = float(timeline_frame - time_left_handle_frame_get(scene, strip)) /
-                              (time_right_handle_frame_get(scene, strip) -
-                               time_left_handle_frame_get(scene, strip));
+    const int frame_start = time_left_handle_frame_get(scene, strip);
+    const int frame_end = time_right_handle_frame_get(scene, strip);
+    const float strip_progress = float(timeline_frame - frame_start) / (frame_end - frame_start);
+    worker_status->progress = progress_start + strip_progress * progress_range;
     worker_status->do_update = true;
 
     if (worker_status->stop || G.is_break) {
@@ -587,6 +592,135 @@ void proxy_rebuild(IndexBuildContext *context, wmJobWorkerStatus *worker_status)
   }
 }
 
+void proxy_rebuild(IndexBuildContext *context, wmJobWorkerStatus *worker_status)
+{
+  if (context->strip->type == STRIP_TYPE_MOVIE) {
+    if (context->proxy_builder) {
+      MOV_proxy_builder_process(context->proxy_builder,
+                                &worker_status->stop,
+                                &worker_status->do_update,
+                                &worker_status->progress);
+    }
+
+    return;
+  }
+
+  proxy_rebuild_rendered(context, worker_status, 0.0f, 1.0f);
+}
+
+/* Movie proxies are built by independent builders, which decode their movie and encode all proxy
+ * sizes using threads of their own. So only a few builders run at once, which is enough to keep
+ * the CPU busy during the parts of decoding and muxing that are single threaded. */
+static int movie_proxy_builders_num_max()
+{
+  return std::clamp(BLI_system_thread_count() / 8, 1, 4);
+}
+
+struct MovieProxyBuildTasks {
+  Span<IndexBuildContext *> contexts;
+  /* The progress of each context, written by the builders and read by the job thread. */
+  Array<std::atomic<float>> progress;
+  std::atomic<int64_t> next_context = 0;
+  std::atomic<int> running_builders = 0;
+  bool *stop;
+
+  MovieProxyBuildTasks(Span<IndexBuildContext *> contexts, bool *stop)
+      : contexts(contexts), progress(contexts.size()), stop(stop)
+  {
+  }
+};
+
+/* Build the proxies of the contexts that were not taken by other builders yet, one at a time. */
+static void movie_proxy_build_task_run(TaskPool *__restrict pool, void * /*taskdata*/)
+{
+  MovieProxyBuildTasks *tasks = static_cast<MovieProxyBuildTasks *>(BLI_task_pool_user_data(pool));
+  while (!*tasks->stop) {
+    const int64_t i = tasks->next_context.fetch_add(1);
+    if (i >= tasks->contexts.size()) {
+      break;
+    }
+
+    bool do_update = false;
+    MOV_proxy_builder_process(
+        tasks->contexts[i]->proxy_builder, tasks->stop, &do_update, &tasks->progress[i]);
+    tasks->progress[i] = 1.0f;
+  }
+  tasks->running_builders--;
+}
+
+void proxy_rebuild_queue(ListBase *queue, wmJobWorkerStatus *worker_status)
+{
+  Vector<IndexBuildContext *> movie_contexts;
+  Vector<IndexBuildContext *> other_contexts;
+  LISTBASE_FOREACH (LinkData *, link, queue) {
+    IndexBuildContext *context = static_cast<IndexBuildContext *>(link->data);
+    if (context->strip->type != STRIP_TYPE_MOVIE) {
+      other_contexts.append(context);
+    }
+    else if (context->proxy_builder) {
+      movie_contexts.append(context);
+    }
+  }
+
+  const int64_t contexts_num = movie_contexts.size() + other_contexts.size();
+  if (contexts_num == 0) {
+    return;
+  }
+
+  if (!movie_contexts.is_empty()) {
+    const double start_time = BLI_time_now_seconds();
+
+    MovieProxyBuildTasks tasks(movie_contexts, &worker_status->stop);
+
+    const int builders_num = int(
+        std::min<int64_t>(movie_contexts.size(), movie_proxy_builders_num_max()));
+    tasks.running_builders = builders_num;
+
+    TaskPool *task_pool = BLI_task_pool_create_background(&tasks, TASK_PRIORITY_HIGH);
+    for (int i = 0; i < builders_num; i++) {
+      BLI_task_pool_push(task_pool, movie_proxy_build_task_run, nullptr, false, nullptr);
+    }
+
+    /* Report the overall progress while the builders run. */
+    while (tasks.running_builders > 0) {
+      BLI_time_sleep_ms(100);
+      float progress = 0.0f;
+      for (const std::atomic<float> &context_progress : tasks.progress) {
+        progress += context_progress;
+      }
+      worker_status->progress = progress / contexts_num;
+      worker_status->do_update = true;
+    }
+
+    BLI_task_pool_work_and_wait(task_pool);
+    BLI_task_pool_free(task_pool);
+
+    if (!worker_status->stop) {
+      int64_t frames_num = 0;
+      for (const IndexBuildContext *context : movie_contexts) {
+        frames_num += MOV_proxy_builder_get_frames_num(context->proxy_builder);
+      }
+      const double time = std::max(BLI_time_now_seconds() - start_time, 1e-6);
+      BKE_reportf(worker_status->reports,
+                  RPT_INFO,
+                  "Built proxies of %d movies in %.1f seconds (%.1f frames per second)",
+                  int(movie_contexts.size()),
+                  time,
+                  frames_num / time);
+    }
+  }
+
+  /* The proxies of other strips are built from rendered images, one strip after the other. Each
+   * strip reports its progress in its own part of the overall progress, after the movies. */
+  for (const int64_t i : other_contexts.index_range()) {
+    if (worker_status->stop) {
+      break;
+    }
+    const float progress_start = float(movie_contexts.size() + i) / contexts_num;
+    proxy_rebuild_rendered(other_contexts[i], worker_status, progress_start, 1.0f / contexts_num);
+  }
+}
+
 void proxy_rebuild_finish(IndexBuildContext *context, bool stop)
 {
   if (context->proxy_builder) {
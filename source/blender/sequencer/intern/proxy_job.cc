@@ -40,16 +40,11 @@ static void proxy_startjob(void *pjv, wmJobWorkerStatus *worker_status)
 {
   ProxyJob *pj = static_cast<ProxyJob *>(pjv);
 
-  LISTBASE_FOREACH (LinkData *, link, &pj->queue) {
-    IndexBuildContext *context = static_cast<IndexBuildContext *>(link->data);
-
-    proxy_rebuild(context, worker_status);
+  proxy_rebuild_queue(&pj->queue, worker_status);
 
-    if (worker_status->stop) {
-      pj->stop = true;
-      fprintf(stderr, "Canceling proxy rebuild on users request...\n");
-      break;
-    }
+  if (worker_status->stop) {
+    pj->stop = true;
+    fprintf(stderr, "Canceling proxy rebuild on users request...\n");
   }
 }
 
@@ -9,6 +9,7 @@
  */
 
 #include <ctime>
+#include <optional>
 
 #include "MEM_guardedalloc.h"
 
@@ -22,9 +23,11 @@
 #include "BLI_listbase.h"
 #include "BLI_math_geom.h"
 #include "BLI_math_matrix.hh"
+#include "BLI_mutex.hh"
 #include "BLI_path_utils.hh"
 #include "BLI_rect.h"
 #include "BLI_task.hh"
+#include "BLI_timeit.hh"
 
 #include "BKE_anim_data.hh"
 #include "BKE_animsys.h"
@@ -67,6 +70,7 @@
 #include "SEQ_transform.hh"
 #include "SEQ_utils.hh"
 
+#include "cache/disk_image_cache.hh"
 #include "cache/final_image_cache.hh"
 #include "cache/intra_frame_cache.hh"
 #include "cache/source_image_cache.hh"
@@ -1646,6 +1650,72 @@ static ImBuf *do_render_strip_seqbase(const RenderData *context,
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Render Statistics
+ * \{ */
+
+struct RenderStatisticsStorage {
+  RenderStatistics frame;
+  RenderStatistics prefetch_frame;
+};
+
+/* Statistics are written by the prefetch thread and read when drawing. */
+static Mutex render_statistics_mutex;
+
+static double nanoseconds_to_seconds(const int64_t nanoseconds)
+{
+  return double(nanoseconds) * 1e-9;
+}
+
+static void render_statistics_store(Scene *scene,
+                                    const SeqRenderState &state,
+                                    const timeit::Nanoseconds frame_time,
+                                    const bool is_prefetch)
+{
+  if (scene == nullptr || scene->ed == nullptr) {
+    return;
+  }
+
+  std::lock_guard lock(render_statistics_mutex);
+  RenderStatisticsStorage *&storage = scene->ed->runtime.render_statistics;
+  if (storage == nullptr) {
+    storage = MEM_new<RenderStatisticsStorage>(__func__);
+  }
+
+  RenderStatistics &statistics = is_prefetch ? storage->prefetch_frame : storage->frame;
+  statistics.frame_time = nanoseconds_to_seconds(frame_time.count());
+  statistics.source_time = nanoseconds_to_seconds(state.source_time);
+  statistics.preprocess_time = nanoseconds_to_seconds(state.preprocess_time);
+  statistics.blend_time = nanoseconds_to_seconds(state.blend_time);
+  statistics.parallel_strips_num = state.parallel_strips_num;
+}
+
+RenderStatistics render_statistics_get(const Scene *scene, const bool prefetch)
+{
+  if (scene == nullptr || scene->ed == nullptr) {
+    return {};
+  }
+
+  std::lock_guard lock(render_statistics_mutex);
+  const RenderStatisticsStorage *storage = scene->ed->runtime.render_statistics;
+  if (storage == nullptr) {
+    return {};
+  }
+  return prefetch ? storage->prefetch_frame : storage->frame;
+}
+
+void render_statistics_free(Scene *scene)
+{
+  if (scene == nullptr || scene->ed == nullptr) {
+    return;
+  }
+
+  std::lock_guard lock(render_statistics_mutex);
+  MEM_SAFE_DELETE(scene->ed->runtime.render_statistics);
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Strip Stack Rendering Functions
  * \{ */
@@ -1759,19 +1829,41 @@ ImBuf *seq_render_strip(const RenderData *context,
   }
 
   /* Proxies are not stored in cache. */
+  std::optional<DiskImageKey> disk_key;
   if (!can_use_proxy(context, strip, rendersize_to_proxysize(context->preview_render_size))) {
     ibuf = seq::source_image_cache_get(context, strip, timeline_frame);
+    if (ibuf == nullptr) {
+      disk_key = disk_image_cache_source_key(context, strip, timeline_frame);
+      ibuf = disk_key ? disk_image_cache_get(*disk_key) : nullptr;
+      /* Keep the image in memory once it is read, to avoid decompressing it on every access. It
+       * is added later on when storing raw images is enabled, see seq_render_preprocess_ibuf. */
+      if (ibuf && !(prefetch_get_original_scene(context)->ed->cache_flag & SEQ_CACHE_STORE_RAW))
+      {
+        source_image_cache_put(context, strip, timeline_frame, ibuf);
+      }
+    }
   }
 
   if (ibuf == nullptr) {
+    const timeit::TimePoint start = timeit::Clock::now();
     ibuf = do_render_strip_uncached(context, state, strip, timeline_frame, &is_proxy_image);
+    if (ibuf && disk_key && !is_proxy_image) {
+      disk_image_cache_put(context, *disk_key, ibuf);
+    }
+
+    /* Effect and meta strips render other strips, whose time is already counted. */
+    if (!(strip->type & STRIP_TYPE_EFFECT) && strip->type != STRIP_TYPE_META) {
+      state->source_time += timeit::Nanoseconds(timeit::Clock::now() - start).count();
+    }
   }
 
   if (ibuf) {
+    const timeit::TimePoint start = timeit::Clock::now();
     use_preprocess = seq_input_have_to_preprocess(context, strip, timeline_frame);
     ibuf = seq_render_preprocess_ibuf(
         context, strip, ibuf, timeline_frame, use_preprocess, is_proxy_image);
     intra_frame_cache_put_preprocessed(context->scene, strip, ibuf);
+    state->preprocess_time += timeit::Nanoseconds(timeit::Clock::now() - start).count();
   }
 
   if (ibuf == nullptr) {
@@ -1808,9 +1900,14 @@ static StripEarlyOut strip_get_early_out_for_blend_mode(Strip *strip)
   return early_out;
 }
 
-static ImBuf *seq_render_strip_stack_apply_effect(
-    const RenderData *context, Strip *strip, float timeline_frame, ImBuf *ibuf1, ImBuf *ibuf2)
+static ImBuf *seq_render_strip_stack_apply_effect(const RenderData *context,
+                                                  SeqRenderState *state,
+                                                  Strip *strip,
+                                                  float timeline_frame,
+                                                  ImBuf *ibuf1,
+                                                  ImBuf *ibuf2)
 {
+  const timeit::TimePoint start = timeit::Clock::now();
   ImBuf *out;
   EffectHandle sh = strip_effect_get_sequence_blend(strip);
   BLI_assert(sh.execute != nullptr);
@@ -1824,6 +1921,7 @@ static ImBuf *seq_render_strip_stack_apply_effect(
     out = sh.execute(context, strip, timeline_frame, fac, ibuf1, ibuf2);
   }
 
+  state->blend_time += timeit::Nanoseconds(timeit::Clock::now() - start).count();
   return out;
 }
 
@@ -1847,6 +1945,76 @@ static bool is_opaque_alpha_over(const Strip *strip)
   return true;
 }
 
+/* Returns true if the image of the strip can be rendered on any thread independently of the rest
+ * of the stack. Effect, meta and scene strips render other strips or scenes, which is not thread
+ * safe, and so do modifiers that use other strips or masks as their mask input. */
+static bool strip_can_render_in_parallel(const Strip *strip)
+{
+  if (!ELEM(strip->type, STRIP_TYPE_IMAGE, STRIP_TYPE_MOVIE)) {
+    return false;
+  }
+
+  LISTBASE_FOREACH (StripModifierData *, smd, &strip->modifiers) {
+    if (smd->mask_strip != nullptr || smd->mask_id != nullptr) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/* Render the images of the strips of the stack that can be rendered independently in parallel.
+ * The images are stored in the intra frame cache, so compositing the stack afterwards only blends
+ * them. Loading, decoding and transforming the images of stacked strips dominates the render time
+ * of frames with many strips, while it is mostly single threaded for each strip. */
+static void seq_render_strips_in_parallel(const RenderData *context,
+                                          SeqRenderState *state,
+                                          Span<Strip *> strips,
+                                          float timeline_frame)
+{
+  const Editing *ed = editing_get(context->scene);
+  if (ed == nullptr || (ed->render_flag & SEQ_RENDER_PARALLEL_STRIPS) == 0) {
+    return;
+  }
+
+  /* The whole stack is already composited. */
+  ImBuf *composite = intra_frame_cache_get_composite(context->scene, strips.last());
+  if (composite != nullptr) {
+    IMB_freeImBuf(composite);
+    return;
+  }
+
+  /* Go down the stack until a strip that replaces the strips below it, which are not rendered,
+   * skipping strips that are fully transparent. Occlusion by opaque strips is only known after
+   * their images are rendered, so occluded strips might be rendered needlessly. */
+  Vector<Strip *> parallel_strips;
+  for (int64_t i = strips.size() - 1; i >= 0; i--) {
+    Strip *strip = strips[i];
+    if (strip_can_render_in_parallel(strip) &&
+        strip_get_early_out_for_blend_mode(strip) != StripEarlyOut::UseInput1)
+    {
+      parallel_strips.append(strip);
+    }
+    if (strip->blend_mode == SEQ_BLEND_REPLACE) {
+      break;
+    }
+  }
+
+  if (parallel_strips.size() < 2) {
+    return;
+  }
+
+  threading::parallel_for(parallel_strips.index_range(), 1, [&](const IndexRange range) {
+    for (const int64_t i : range) {
+      /* Free the image. It is stored in the intra frame cache where the stack compositing finds
+       * it, so this doesn't affect performance. */
+      IMB_freeImBuf(seq_render_strip(context, state, parallel_strips[i], timeline_frame));
+    }
+  });
+
+  state->parallel_strips_num += int(parallel_strips.size());
+}
+
 static ImBuf *seq_render_strip_stack(const RenderData *context,
                                      SeqRenderState *state,
                                      ListBase *channels,
@@ -1860,6 +2028,8 @@ static ImBuf *seq_render_strip_stack(const RenderData *context,
     return nullptr;
   }
 
+  seq_render_strips_in_parallel(context, state, strips, timeline_frame);
+
   OpaqueQuadTracker opaques;
 
   int64_t i;
@@ -1931,7 +2101,8 @@ static ImBuf *seq_render_strip_stack(const RenderData *context,
               context->rectx, context->recty, 32, use_float ? IB_float_data : IB_byte_data);
           seq_imbuf_assign_spaces(context->scene, ibuf1);
 
-          out = seq_render_strip_stack_apply_effect(context, strip, timeline_frame, ibuf1, ibuf2);
+          out = seq_render_strip_stack_apply_effect(
+              context, state, strip, timeline_frame, ibuf1, ibuf2);
           IMB_metadata_copy(out, ibuf2);
 
           intra_frame_cache_put_composite(context->scene, strip, out);
@@ -1959,7 +2130,8 @@ static ImBuf *seq_render_strip_stack(const RenderData *context,
       ImBuf *ibuf1 = out;
       ImBuf *ibuf2 = seq_render_strip(context, state, strip, timeline_frame);
 
-      out = seq_render_strip_stack_apply_effect(context, strip, timeline_frame, ibuf1, ibuf2);
+      out = seq_render_strip_stack_apply_effect(
+          context, state, strip, timeline_frame, ibuf1, ibuf2);
 
       IMB_freeImBuf(ibuf1);
       IMB_freeImBuf(ibuf2);
@@ -2009,6 +2181,19 @@ ImBuf *render_give_ibuf(const RenderData *context, float timeline_frame, int cha
   /* Make sure we only keep the `anim` data for strips that are in view. */
   relations_free_all_anim_ibufs(context->scene, timeline_frame);
 
+  /* Fall back to the disk cache, and keep the image in memory once it is read. */
+  std::optional<DiskImageKey> disk_key;
+  if (!strips.is_empty() && !out) {
+    disk_key = disk_image_cache_final_key(context, channels, seqbasep, timeline_frame, chanshown);
+    out = disk_key ? disk_image_cache_get(*disk_key) : nullptr;
+    if (out) {
+      std::scoped_lock lock(seq_render_mutex);
+      evict_caches_if_full(orig_scene);
+      final_image_cache_put(
+          orig_scene, seqbasep, timeline_frame, context->view_id, chanshown, out);
+    }
+  }
+
   SeqRenderState state;
 
   if (!strips.is_empty() && !out) {
@@ -2017,7 +2202,10 @@ ImBuf *render_give_ibuf(const RenderData *context, float timeline_frame, int cha
      * If we do this after we have added the new cache, we risk removing what we just added. */
     evict_caches_if_full(orig_scene);
 
+    const timeit::TimePoint start = timeit::Clock::now();
     out = seq_render_strip_stack(context, &state, channels, seqbasep, timeline_frame, chanshown);
+    render_statistics_store(
+        orig_scene, state, timeit::Clock::now() - start, context->is_prefetch_render);
 
     if (out && (orig_scene->ed->cache_flag & SEQ_CACHE_STORE_FINAL_OUT) && !context->skip_cache &&
         !context->is_proxy_render)
@@ -2025,6 +2213,9 @@ ImBuf *render_give_ibuf(const RenderData *context, float timeline_frame, int cha
       final_image_cache_put(
           orig_scene, seqbasep, timeline_frame, context->view_id, chanshown, out);
     }
+    if (out && disk_key) {
+      disk_image_cache_put(context, *disk_key, out);
+    }
   }
 
   seq_prefetch_start(context, timeline_frame);
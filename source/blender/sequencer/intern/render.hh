@@ -8,6 +8,9 @@
  * \ingroup sequencer
  */
 
+#include <atomic>
+#include <cstdint>
+
 #include "BLI_math_vector_types.hh"
 #include "BLI_vector.hh"
 
@@ -24,6 +27,13 @@ namespace blender::seq {
 /* Mutable state while rendering one sequencer frame. */
 struct SeqRenderState {
   LinkNode *scene_parents = nullptr;
+
+  /* Time spent in the stages of rendering the frame in nanoseconds, see #RenderStatistics.
+   * Atomic because the images of strips might be rendered in parallel. */
+  std::atomic<int64_t> source_time = 0;
+  std::atomic<int64_t> preprocess_time = 0;
+  std::atomic<int64_t> blend_time = 0;
+  std::atomic<int> parallel_strips_num = 0;
 };
 
 /* Strip corner coordinates in screen pixel space. Note that they might not be
@@ -57,4 +67,6 @@ void seq_imbuf_assign_spaces(const Scene *scene, ImBuf *ibuf);
 
 StripScreenQuad get_strip_screen_quad(const RenderData *context, const Strip *strip);
 
+void render_statistics_free(Scene *scene);
+
 }  // namespace blender::seq
@@ -56,11 +56,13 @@
 
 #include "BLO_read_write.hh"
 
+#include "cache/disk_image_cache.hh"
 #include "cache/final_image_cache.hh"
 #include "cache/intra_frame_cache.hh"
 #include "cache/source_image_cache.hh"
 #include "modifier.hh"
 #include "prefetch.hh"
+#include "render.hh"
 #include "sequencer.hh"
 #include "utils.hh"
 
@@ -285,6 +287,7 @@ Editing *editing_ensure(Scene *scene)
     ed->seqbasep = &ed->seqbase;
     ed->cache_flag = (SEQ_CACHE_PREFETCH_ENABLE | SEQ_CACHE_STORE_FINAL_OUT | SEQ_CACHE_STORE_RAW);
     ed->show_missing_media_flag = SEQ_EDIT_SHOW_MISSING_MEDIA;
+    ed->render_flag = SEQ_RENDER_PARALLEL_STRIPS;
     ed->displayed_channels = &ed->channels;
     channels_ensure(ed->displayed_channels);
   }
@@ -314,6 +317,8 @@ void editing_free(Scene *scene, const bool do_id_user)
   blender::seq::intra_frame_cache_destroy(scene);
   blender::seq::source_image_cache_destroy(scene);
   blender::seq::final_image_cache_destroy(scene);
+  blender::seq::disk_image_cache_destroy(scene);
+  blender::seq::render_statistics_free(scene);
   channels_free(&ed->channels);
 
   MEM_freeN(ed);
@@ -481,6 +481,8 @@ Strip *add_movie_strip(Main *bmain, Scene *scene, ListBase *seqbase, LoadData *l
       StripAnim *sanim = MEM_mallocN<StripAnim>("Strip Anim");
       BLI_addtail(&strip->anims, sanim);
       sanim->anim = anim_arr[i];
+      /* Start indexing the key frames right away, so the index is ready before scrubbing. */
+      MOV_use_keyframe_index(sanim->anim);
     }
     else {
       break;
@@ -225,6 +225,11 @@ static void open_anim_filepath(Strip *strip, StripAnim *sanim, const char *filep
                                   true,
                                   strip->data->colorspace_settings.name);
   }
+
+  /* Strips are often scrubbed, which benefits from knowing where the key frames are. */
+  if (sanim->anim) {
+    MOV_use_keyframe_index(sanim->anim);
+  }
 }
 
 static bool use_proxy(Editing *ed, Strip *strip)
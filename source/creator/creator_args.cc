@@ -652,6 +652,7 @@ static void print_help(bArgs *ba, bool all)
   BLI_args_print_arg_doc(ba, "--frame-end");
   BLI_args_print_arg_doc(ba, "--frame-jump");
   BLI_args_print_arg_doc(ba, "--render-output");
+  BLI_args_print_arg_doc(ba, "--render-pipeline");
   BLI_args_print_arg_doc(ba, "--engine");
   BLI_args_print_arg_doc(ba, "--threads");
 
@@ -1976,6 +1977,18 @@ static int arg_handle_output_set(int argc, const char **argv, void *data)
   return 0;
 }
 
+static const char arg_handle_render_pipeline_set_doc[] =
+    "\n\t"
+    "Save rendered frames in the background while the next frame renders.\n"
+    "\tThis improves the throughput of animation renders which write image files.\n"
+    "\tThe 'render_write' handlers of a frame are called after the next frame has rendered.\n"
+    "\tMust come before '-a / --render-anim'.";
+static int arg_handle_render_pipeline_set(int /*argc*/, const char ** /*argv*/, void * /*data*/)
+{
+  G.f |= G_FLAG_RENDER_PIPELINE;
+  return 0;
+}
+
 static const char arg_handle_engine_set_doc[] =
     "<engine>\n"
     "\tSpecify the render engine.\n"
@@ -2969,6 +2982,7 @@ void main_args_setup(bContext *C, bArgs *ba, bool all)
   BLI_args_add(ba, nullptr, "--addons", CB(arg_handle_addons_set), C);
 
   BLI_args_add(ba, "-o", "--render-output", CB(arg_handle_output_set), C);
+  BLI_args_add(ba, nullptr, "--render-pipeline", CB(arg_handle_render_pipeline_set), nullptr);
   BLI_args_add(ba, "-E", "--engine", CB(arg_handle_engine_set), C);
 
   BLI_args_add(ba, "-F", "--render-format", CB(arg_handle_image_type_set), C);
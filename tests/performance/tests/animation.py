@@ -5,8 +5,16 @@
 import api
 
 
-def _run(args):
+def _clear_scene():
     import bpy
+
+    bpy.ops.object.select_all(action='SELECT')
+    bpy.ops.object.delete(use_global=False)
+
+
+def _playback_time(scene, frame_callback=None):
+    # Play back the scene for at least 10 seconds, and return the average time per frame. The
+    # optional callback is called after every frame change.
     import time
 
     start_time = time.time()
@@ -14,16 +22,163 @@ def _run(args):
     num_frames = 0
 
     while elapsed_time < 10.0:
-        scene = bpy.context.scene
         for i in range(scene.frame_start, scene.frame_end + 1):
             scene.frame_set(i)
+            if frame_callback:
+                frame_callback()
 
         num_frames += scene.frame_end + 1 - scene.frame_start
         elapsed_time = time.time() - start_time
 
-    time_per_frame = elapsed_time / num_frames
+    return elapsed_time / num_frames
+
 
-    result = {'time': time_per_frame}
+def _run(args):
+    import bpy
+
+    result = {'time': _playback_time(bpy.context.scene)}
+    return result
+
+
+def _run_shape_keys(args):
+    import bpy
+    import numpy as np
+
+    # Replace the scene contents with a dense grid, similar to a facial rig with many corrective
+    # shape keys that each only move a small region.
+    _clear_scene()
+    bpy.ops.mesh.primitive_grid_add(
+        x_subdivisions=args['grid_size'], y_subdivisions=args['grid_size'], size=2.0)
+    ob = bpy.context.object
+    mesh = ob.data
+
+    ob.shape_key_add(name="Basis")
+    basis = np.empty(len(mesh.vertices) * 3, dtype=np.float32)
+    mesh.vertices.foreach_get("co", basis)
+    basis = basis.reshape(-1, 3)
+
+    scene = bpy.context.scene
+    scene.frame_start = 1
+    scene.frame_end = 50
+
+    rng = np.random.default_rng(0)
+    for i in range(args['shape_keys_num']):
+        shape_key = ob.shape_key_add(name=f"Corrective {i}", from_mix=False)
+        center = rng.uniform(-1.0, 1.0, 2)
+        distance = np.linalg.norm(basis[:, :2] - center, axis=1)
+        influence = np.clip(1.0 - distance / args['region_radius'], 0.0, 1.0)
+        co = basis.copy()
+        co[:, 2] += influence * 0.1
+        shape_key.data.foreach_set("co", co.ravel())
+
+        shape_key.value = 0.0
+        shape_key.keyframe_insert("value", frame=scene.frame_start + i % 10)
+        shape_key.value = 1.0
+        shape_key.keyframe_insert("value", frame=scene.frame_end - i % 10)
+
+    result = {'time': _playback_time(scene)}
+    return result
+
+
+def _run_crowd(args):
+    import bpy
+
+    # Replace the scene contents with many armatures sharing one action that animates the location,
+    # rotation and scale of every bone, like a crowd of characters playing the same cycle.
+    _clear_scene()
+
+    armature = bpy.data.armatures.new("Crowd")
+    rig = bpy.data.objects.new("Crowd", armature)
+    scene = bpy.context.scene
+    scene.collection.objects.link(rig)
+    bpy.context.view_layer.objects.active = rig
+
+    bpy.ops.object.mode_set(mode='EDIT')
+    for i in range(args['bones_num']):
+        bone = armature.edit_bones.new(f"Bone {i}")
+        bone.head = (0.0, 0.0, i * 0.1)
+        bone.tail = (0.0, 0.0, i * 0.1 + 0.1)
+    bpy.ops.object.mode_set(mode='OBJECT')
+
+    scene.frame_start = 1
+    scene.frame_end = 50
+    for frame in (scene.frame_start, scene.frame_end // 2, scene.frame_end):
+        for i, pose_bone in enumerate(rig.pose.bones):
+            pose_bone.location = (0.0, frame * 0.01, i * 0.001)
+            pose_bone.rotation_quaternion = (1.0, frame * 0.01, 0.0, 0.0)
+            pose_bone.scale = (1.0, 1.0 + frame * 0.01, 1.0)
+            for data_path in ("location", "rotation_quaternion", "scale"):
+                pose_bone.keyframe_insert(data_path, frame=frame)
+
+    for i in range(1, args['armatures_num']):
+        copy = rig.copy()
+        copy.location.x = i
+        scene.collection.objects.link(copy)
+
+    result = {'time': _playback_time(scene)}
+    return result
+
+
+def _run_skinning(args):
+    import bpy
+    import numpy as np
+
+    # Replace the scene contents with a dense grid skinned to a chain of animated bones, where every
+    # vertex is influenced by the four closest bones like a typical character mesh.
+    _clear_scene()
+    bpy.ops.mesh.primitive_grid_add(
+        x_subdivisions=args['grid_size'], y_subdivisions=args['grid_size'], size=2.0)
+    ob = bpy.context.object
+    mesh = ob.data
+
+    armature = bpy.data.armatures.new("Skeleton")
+    rig = bpy.data.objects.new("Skeleton", armature)
+    scene = bpy.context.scene
+    scene.collection.objects.link(rig)
+    bpy.context.view_layer.objects.active = rig
+
+    bones_num = args['bones_num']
+    bone_heads = np.linspace(-1.0, 1.0, bones_num, endpoint=False)
+    bone_length = 2.0 / bones_num
+    bpy.ops.object.mode_set(mode='EDIT')
+    for i, head in enumerate(bone_heads):
+        bone = armature.edit_bones.new(f"Bone {i}")
+        bone.head = (head, 0.0, 0.0)
+        bone.tail = (head + bone_length, 0.0, 0.0)
+    bpy.ops.object.mode_set(mode='OBJECT')
+
+    co = np.empty(len(mesh.vertices) * 3, dtype=np.float32)
+    mesh.vertices.foreach_get("co", co)
+    distance = np.abs(co.reshape(-1, 3)[:, :1] - (bone_heads + bone_length / 2.0))
+    closest = np.argsort(distance, axis=1)[:, :4]
+    # Quantize the weights, to assign them with few calls.
+    for i in range(bones_num):
+        group = ob.vertex_groups.new(name=f"Bone {i}")
+        vertices = np.nonzero((closest == i).any(axis=1))[0]
+        levels = np.clip(np.rint(4.0 - distance[vertices, i] / bone_length), 1, 4)
+        for level in np.unique(levels):
+            group.add(vertices[levels == level].tolist(), level / 10.0, 'REPLACE')
+
+    modifier = ob.modifiers.new("Armature", 'ARMATURE')
+    modifier.object = rig
+    modifier.use_deform_preserve_volume = args['use_dual_quaternion']
+
+    scene.frame_start = 1
+    scene.frame_end = 50
+    for frame in (scene.frame_start, scene.frame_end // 2, scene.frame_end):
+        for i, pose_bone in enumerate(rig.pose.bones):
+            pose_bone.rotation_quaternion = (1.0, 0.0, frame * 0.002 * (i % 5), 0.0)
+            pose_bone.keyframe_insert("rotation_quaternion", frame=frame)
+
+    depsgraph = bpy.context.evaluated_depsgraph_get()
+    deform_times = []
+
+    def store_deform_time():
+        deform_times.append(ob.evaluated_get(depsgraph).modifiers["Armature"].execution_time)
+
+    time_per_frame = _playback_time(scene, store_deform_time)
+
+    result = {'time': time_per_frame, 'deform_time': sum(deform_times) / len(deform_times)}
     return result
 
 
@@ -43,6 +198,75 @@ class AnimationTest(api.Test):
         return result
 
 
+class ShapeKeysTest(api.Test):
+    """
+    Playback of a generated mesh with 500k vertices and 300 animated shape keys, which each move
+    about 1% of the vertices.
+    """
+
+    def name(self):
+        return "shape_keys_500k_300"
+
+    def category(self):
+        return "animation"
+
+    def run(self, env, device_id):
+        args = {
+            'grid_size': 708,
+            'shape_keys_num': 300,
+            'region_radius': 0.11,
+        }
+        result, _ = env.run_in_blender(_run_shape_keys, args)
+        return result
+
+
+class CrowdTest(api.Test):
+    """
+    Playback of 100 generated armatures with 100 bones each, sharing an action with 1000 F-Curves.
+    """
+
+    def name(self):
+        return "crowd_100_armatures"
+
+    def category(self):
+        return "animation"
+
+    def run(self, env, device_id):
+        args = {
+            'armatures_num': 100,
+            'bones_num': 100,
+        }
+        result, _ = env.run_in_blender(_run_crowd, args)
+        return result
+
+
+class SkinningTest(api.Test):
+    """
+    Playback of a generated mesh with 250k vertices deformed by 100 animated bones, with up to four
+    bones per vertex. The time of the armature modifier is reported separately.
+    """
+
+    def __init__(self, use_dual_quaternion):
+        self.use_dual_quaternion = use_dual_quaternion
+
+    def name(self):
+        return "skinning_250k_dual_quaternion" if self.use_dual_quaternion else "skinning_250k"
+
+    def category(self):
+        return "animation"
+
+    def run(self, env, device_id):
+        args = {
+            'grid_size': 500,
+            'bones_num': 100,
+            'use_dual_quaternion': self.use_dual_quaternion,
+        }
+        result, _ = env.run_in_blender(_run_skinning, args)
+        return result
+
+
 def generate(env):
     filepaths = env.find_blend_files('animation/*')
-    return [AnimationTest(filepath) for filepath in filepaths]
+    tests = [AnimationTest(filepath) for filepath in filepaths]
+    tests += [ShapeKeysTest(), CrowdTest(), SkinningTest(False), SkinningTest(True)]
+    return tests
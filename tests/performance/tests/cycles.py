@@ -5,6 +5,50 @@
 import api
 
 
+def _prepare_shader_heavy_scene(num_layers):
+    """
+    Replace the materials of the startup scene with a procedural material which has a deep node
+    graph of textures and math nodes, so that the render time is dominated by shader evaluation.
+    """
+    import bpy
+
+    material = bpy.data.materials.new("ShaderHeavy")
+    material.use_nodes = True
+    nodes = material.node_tree.nodes
+    links = material.node_tree.links
+
+    bsdf = nodes["Principled BSDF"]
+    texcoord = nodes.new('ShaderNodeTexCoord')
+
+    value = None
+    for i in range(num_layers):
+        noise = nodes.new('ShaderNodeTexNoise')
+        noise.inputs["Scale"].default_value = 2.0 + i
+        links.new(texcoord.outputs["Object"], noise.inputs["Vector"])
+
+        # Chains of math nodes with constant operands are common in production materials.
+        for operation, operand in (('MULTIPLY', 1.5), ('ADD', 0.1), ('POWER', 1.2), ('MINIMUM', 0.9)):
+            math = nodes.new('ShaderNodeMath')
+            math.operation = operation
+            math.inputs[1].default_value = operand
+            links.new(noise.outputs["Fac"] if value is None else value, math.inputs[0])
+            value = math.outputs["Value"]
+
+        mix = nodes.new('ShaderNodeMix')
+        mix.data_type = 'FLOAT'
+        links.new(value, mix.inputs["Factor"])
+        links.new(noise.outputs["Fac"], mix.inputs["B"])
+        value = mix.outputs["Result"]
+
+    links.new(value, bsdf.inputs["Roughness"])
+    links.new(value, bsdf.inputs["Base Color"])
+
+    for ob in bpy.context.scene.objects:
+        if ob.type == 'MESH':
+            ob.data.materials.clear()
+            ob.data.materials.append(material)
+
+
 def _run(args):
     import bpy
 
@@ -21,6 +65,9 @@ def _run(args):
 
     device_index = args['device_index']
 
+    if 'shader_heavy_layers' in args:
+        _prepare_shader_heavy_scene(args['shader_heavy_layers'])
+
     scene = bpy.context.scene
     scene.render.engine = 'CYCLES'
     scene.render.filepath = args['render_filepath']
@@ -83,48 +130,76 @@ class CyclesTest(api.Test):
         return True
 
     def run(self, env, device_id):
-        tokens = device_id.split('_')
-        device_type = tokens[0]
-        device_index = int(tokens[1]) if len(tokens) > 1 else 0
-        args = {'device_type': device_type,
-                'device_index': device_index,
-                'render_filepath': str(env.log_file.parent / (env.log_file.stem + '.png'))}
-
-        _, lines = env.run_in_blender(_run, args, ['--debug-cycles', '--verbose', '2', self.filepath])
-
-        # Parse render time from output
-        prefix_time = "Render time (without synchronization): "
-        prefix_memory = "Peak: "
-        prefix_time_per_sample = "Average time per sample: "
-        time = None
-        time_per_sample = None
-        memory = None
-        for line in lines:
-            line = line.strip()
-            offset = line.find(prefix_time)
-            if offset != -1:
-                time = line[offset + len(prefix_time):]
-                time = float(time)
-            offset = line.find(prefix_time_per_sample)
-            if offset != -1:
-                time_per_sample = line[offset + len(prefix_time_per_sample):]
-                time_per_sample = time_per_sample.split()[0]
-                time_per_sample = float(time_per_sample)
-            offset = line.find(prefix_memory)
-            if offset != -1:
-                memory = line[offset + len(prefix_memory):]
-                memory = memory.split()[0].replace(',', '')
-                memory = float(memory)
-
-        if time_per_sample:
-            time = time_per_sample
-
-        if not (time and memory):
-            raise Exception("Error parsing render time output")
-
-        return {'time': time, 'peak_memory': memory}
+        return _run_cycles_test(env, device_id, {}, [self.filepath])
+
+
+class CyclesShaderHeavyTest(api.Test):
+    """
+    Render of the startup scene with a procedural material which has a deep node graph, measuring
+    time per sample which is dominated by the shader evaluation.
+    """
+
+    def __init__(self, num_layers):
+        self.num_layers = num_layers
+
+    def name(self):
+        return "shader_heavy_{}_layers".format(self.num_layers)
+
+    def category(self):
+        return "cycles"
+
+    def use_device(self):
+        return True
+
+    def run(self, env, device_id):
+        return _run_cycles_test(env, device_id, {'shader_heavy_layers': self.num_layers}, [])
+
+
+def _run_cycles_test(env, device_id, extra_args, blender_args):
+    tokens = device_id.split('_')
+    device_type = tokens[0]
+    device_index = int(tokens[1]) if len(tokens) > 1 else 0
+    args = {'device_type': device_type,
+            'device_index': device_index,
+            'render_filepath': str(env.log_file.parent / (env.log_file.stem + '.png'))}
+    args.update(extra_args)
+
+    _, lines = env.run_in_blender(_run, args, ['--debug-cycles', '--verbose', '2'] + blender_args)
+
+    # Parse render time from output
+    prefix_time = "Render time (without synchronization): "
+    prefix_memory = "Peak: "
+    prefix_time_per_sample = "Average time per sample: "
+    time = None
+    time_per_sample = None
+    memory = None
+    for line in lines:
+        line = line.strip()
+        offset = line.find(prefix_time)
+        if offset != -1:
+            time = line[offset + len(prefix_time):]
+            time = float(time)
+        offset = line.find(prefix_time_per_sample)
+        if offset != -1:
+            time_per_sample = line[offset + len(prefix_time_per_sample):]
+            time_per_sample = time_per_sample.split()[0]
+            time_per_sample = float(time_per_sample)
+        offset = line.find(prefix_memory)
+        if offset != -1:
+            memory = line[offset + len(prefix_memory):]
+            memory = memory.split()[0].replace(',', '')
+            memory = float(memory)
+
+    if time_per_sample:
+        time = time_per_sample
+
+    if not (time and memory):
+        raise Exception("Error parsing render time output")
+
+    return {'time': time, 'peak_memory': memory}
 
 
 def generate(env):
     filepaths = env.find_blend_files('cycles/*')
-    return [CyclesTest(filepath) for filepath in filepaths]
+    shader_tests = [CyclesShaderHeavyTest(num_layers) for num_layers in (8, 32)]
+    return [CyclesTest(filepath) for filepath in filepaths] + shader_tests
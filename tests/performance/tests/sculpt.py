@@ -19,6 +19,12 @@ class BrushType(enum.Enum):
     SMOOTH = "Smooth"
 
 
+class FloodFillBrushType(enum.Enum):
+    """Brushes that flood fill the mesh from the active vertex at the start of the stroke"""
+    POSE = "Pose"
+    BOUNDARY = "Boundary"
+
+
 def set_view3d_context_override(context_override):
     """
     Set context override to become the first viewport in the active workspace
@@ -40,7 +46,7 @@ def set_view3d_context_override(context_override):
                 context_override["region"] = region
 
 
-def prepare_sculpt_scene(context: any, mode: SculptMode, subdivision_level=3):
+def prepare_sculpt_scene(context: any, mode: SculptMode, subdivision_level=3, grid_size=None):
     """
     Prepare a clean state of the scene suitable for benchmarking
 
@@ -50,6 +56,8 @@ def prepare_sculpt_scene(context: any, mode: SculptMode, subdivision_level=3):
     For multires sculpting, we create a grid with 22k vertices - with a multires
     modifier set to level 3, this results in an equivalent number of 2.2M vertices
     inside sculpt mode.
+
+    The number of vertices along each side of the grid can be overridden with ``grid_size``.
     """
     import bpy
 
@@ -76,6 +84,9 @@ def prepare_sculpt_scene(context: any, mode: SculptMode, subdivision_level=3):
     else:
         raise NotImplementedError
 
+    if grid_size is not None:
+        size = grid_size
+
     grid_node = group.nodes.new('GeometryNodeMeshGrid')
     grid_node.inputs["Size X"].default_value = 2.0
     grid_node.inputs["Size Y"].default_value = 2.0
@@ -102,7 +113,7 @@ def prepare_sculpt_scene(context: any, mode: SculptMode, subdivision_level=3):
         bpy.ops.sculpt.dynamic_topology_toggle()
 
 
-def prepare_brush(context: any, brush_type: BrushType):
+def prepare_brush(context: any, brush_type: BrushType | FloodFillBrushType):
     """Activates and sets common brush settings"""
     import bpy
     bpy.ops.brush.asset_activate(
@@ -172,7 +183,15 @@ def _run_brush_test(args: dict):
 
     measurements = []
     while True:
-        prepare_sculpt_scene(context, args['mode'])
+        prepare_sculpt_scene(context, args['mode'], grid_size=args.get('grid_size'))
+        if 'detail_resolution' in args:
+            # Use a constant detail that is finer than the grid, such that every step of the stroke
+            # subdivides and collapses the edges under the brush.
+            sculpt = context.tool_settings.sculpt
+            sculpt.detail_type_method = 'CONSTANT'
+            sculpt.detail_refine_method = 'SUBDIVIDE_COLLAPSE'
+            sculpt.constant_detail_resolution = args['detail_resolution']
+            sculpt.use_parallel_refine = args['use_parallel_refine']
         context_override = context.copy()
         set_view3d_context_override(context_override)
         with context.temp_override(**context_override):
@@ -304,6 +323,56 @@ class SculptBrushAfterSpatialReorderingTest(api.Test):
         return {'time': result}
 
 
+class SculptDyntopoHighDetailTest(api.Test):
+    def __init__(self, filepath: pathlib.Path, brush_type: BrushType, use_parallel_refine: bool):
+        self.filepath = filepath
+        self.brush_type = brush_type
+        self.use_parallel_refine = use_parallel_refine
+
+    def name(self):
+        suffix = "_parallel" if self.use_parallel_refine else ""
+        return "dyntopo_{}_high_detail{}".format(self.brush_type.name.lower(), suffix)
+
+    def category(self):
+        return "sculpt"
+
+    def run(self, env, _device_id):
+        args = {
+            'mode': SculptMode.DYNTOPO,
+            'brush_type': self.brush_type,
+            'detail_resolution': 400.0,
+            'use_parallel_refine': self.use_parallel_refine,
+        }
+
+        result, _ = env.run_in_blender(_run_brush_test, args, [self.filepath])
+
+        return {'time': result}
+
+
+class SculptFloodFillBrushTest(api.Test):
+    def __init__(self, filepath: pathlib.Path, brush_type: FloodFillBrushType):
+        self.filepath = filepath
+        self.brush_type = brush_type
+
+    def name(self):
+        return "mesh_{}_10m".format(self.brush_type.name.lower())
+
+    def category(self):
+        return "sculpt"
+
+    def run(self, env, _device_id):
+        args = {
+            'mode': SculptMode.MESH,
+            'brush_type': self.brush_type,
+            # A grid with 10M vertices, where the flood fills at the start of the stroke dominate.
+            'grid_size': 3163,
+        }
+
+        result, _ = env.run_in_blender(_run_brush_test, args, [self.filepath])
+
+        return {'time': result}
+
+
 class SculptRebuildBVHTest(api.Test):
     def __init__(self, filepath: pathlib.Path, mode: SculptMode):
         self.filepath = filepath
@@ -375,7 +444,11 @@ def generate(env):
             filepaths[0],
             SculptMode.MESH,
             brush_type)for brush_type in BrushType]
+    dyntopo_detail_tests = [SculptDyntopoHighDetailTest(filepaths[0], brush_type, use_parallel_refine)
+                            for brush_type in BrushType for use_parallel_refine in (False, True)]
+    flood_fill_tests = [SculptFloodFillBrushTest(filepaths[0], brush_type) for brush_type in FloodFillBrushType]
     bvh_tests = [SculptRebuildBVHTest(filepaths[0], mode) for mode in SculptMode]
     spatial_bvh_tests = [SculptRebuildSpatialBVHTest(filepaths[0], SculptMode.MESH)]
     subdivision_tests = [SculptMultiresSubdivideTest(filepaths[0])]
-    return brush_tests + brush_tests_after_reordering + bvh_tests + spatial_bvh_tests + subdivision_tests
+    return (brush_tests + brush_tests_after_reordering + dyntopo_detail_tests + flood_fill_tests + bvh_tests +
+            spatial_bvh_tests + subdivision_tests)